@@ -12,6 +12,7 @@
 #include <Bifrost/Core/Engine.h>
 #include <Bifrost/Math/CameraEffects.h>
 #include <ImageOperations/Blur.h>
+#include <ImageOperations/ColorLUT.h>
 #include <ImageOperations/Exposure.h>
 
 #include <AntTweakBar/AntTweakBar.h>
@@ -70,6 +71,39 @@ struct ColorGrader::Implementation final {
     CameraEffects::Uncharted2Settings m_uncharted2 = CameraEffects::Uncharted2Settings::default();
     CameraEffects::FilmicSettings m_unreal4 = CameraEffects::FilmicSettings::default();
 
+    // The tonemapping parameters baked into the LUT. Compared to detect when the LUT must be rebaked.
+    struct TonemapParameters {
+        Operator op;
+        float reinhard_whitepoint;
+        CameraEffects::Uncharted2Settings uncharted2;
+        CameraEffects::FilmicSettings unreal4;
+
+        bool operator==(const TonemapParameters& rhs) const {
+            return op == rhs.op && reinhard_whitepoint == rhs.reinhard_whitepoint &&
+                uncharted2.shoulder_strength == rhs.uncharted2.shoulder_strength && uncharted2.linear_strength == rhs.uncharted2.linear_strength &&
+                uncharted2.linear_angle == rhs.uncharted2.linear_angle && uncharted2.toe_strength == rhs.uncharted2.toe_strength &&
+                uncharted2.toe_numerator == rhs.uncharted2.toe_numerator && uncharted2.toe_denominator == rhs.uncharted2.toe_denominator &&
+                uncharted2.linear_white == rhs.uncharted2.linear_white &&
+                unreal4.black_clip == rhs.unreal4.black_clip && unreal4.toe == rhs.unreal4.toe && unreal4.slope == rhs.unreal4.slope &&
+                unreal4.shoulder == rhs.unreal4.shoulder && unreal4.white_clip == rhs.unreal4.white_clip;
+        }
+    };
+    TonemapParameters tonemap_parameters() const { return { m_operator, m_reinhard_whitepoint, m_uncharted2, m_unreal4 }; }
+
+    // Tonemapping baked into a log2 encoded 3D LUT, so the operator is only evaluated when its parameters change.
+    struct {
+        bool enabled = true;
+        int resolution = 65;
+        float min_log2 = -12.0f;
+        float max_log2 = 8.0f;
+        ColorLUT::Interpolation interpolation = ColorLUT::Interpolation::Tetrahedral;
+        ColorLUT::LUT3D lut;
+        bool baked = false;
+        TonemapParameters baked_parameters = {};
+        bool imported = false; // Imported LUTs replace the tonemapping operator and are never rebaked.
+        std::string export_path;
+    } m_lut;
+
     TwBar* m_gui = nullptr;
 
     // --------------------------------------------------------------------------------------------
@@ -176,7 +210,11 @@ struct ColorGrader::Implementation final {
             "     | --uncharted2: Apply Uncharted 2 filmic tonemapper.\n"
             "     | --unreal4: Apply Unreal Engine 4 filmic tonemapper.\n"
             "     | --input <path>: Path to the image to be tonemapped.\n"
-            "     | --output <path>: Path to where to store the final image.\n";
+            "     | --output <path>: Path to where to store the final image.\n"
+            "     | --exact: Evaluate the tonemapper pr pixel instead of through a baked 3D LUT.\n"
+            "     | --lut-resolution <N>: Resolution of the baked 3D LUT. Default 65.\n"
+            "     | --import-lut <path>: Apply the .cube LUT at path to the exposed image instead of the tonemapper.\n"
+            "     | --export-lut <path>: Path to where to store the baked tonemapping LUT as a .cube file.\n";
 
         printf("%s", usage);
     }
@@ -200,6 +238,15 @@ struct ColorGrader::Implementation final {
                 input_path = args[++i];
             else if (arg.compare("--output") == 0)
                 m_output_path = args[++i];
+            else if (arg.compare("--exact") == 0)
+                m_lut.enabled = false;
+            else if (arg.compare("--lut-resolution") == 0)
+                m_lut.resolution = max(2, atoi(args[++i]));
+            else if (arg.compare("--import-lut") == 0) {
+                m_lut.lut = ColorLUT::read_cube(args[++i]);
+                m_lut.imported = m_lut.lut.is_valid();
+            } else if (arg.compare("--export-lut") == 0)
+                m_lut.export_path = args[++i];
             else
                 printf("Unknown argument: %s\n", args[i]);
         }
@@ -298,6 +345,25 @@ struct ColorGrader::Implementation final {
             TwAddVarCB(bar, "Support", TW_TYPE_FLOAT, WRAP_ANT_PROPERTY(m_bloom.support, float), this, "step=0.01 group=Bloom");
         }
 
+        { // LUT
+            TwAddVarCB(bar, "Use LUT", TW_TYPE_BOOLCPP, WRAP_ANT_PROPERTY(m_lut.enabled, bool), this, "group=LUT");
+            TwAddVarCB(bar, "Resolution", TW_TYPE_INT32, WRAP_ANT_PROPERTY(m_lut.resolution, int), this, "min=2 max=129 group=LUT");
+
+            TwEnumVal interpolations[] = { { int(ColorLUT::Interpolation::Trilinear), "Trilinear" },
+                                           { int(ColorLUT::Interpolation::Tetrahedral), "Tetrahedral" } };
+            TwType AntInterpolationEnum = TwDefineEnum("Interpolations", interpolations, 2);
+            TwAddVarCB(bar, "Interpolation", AntInterpolationEnum, WRAP_ANT_PROPERTY(m_lut.interpolation, ColorLUT::Interpolation), this, "group=LUT");
+
+            if (m_lut.export_path.size() != 0) {
+                auto export_lut = [](void* client_data) {
+                    ColorGrader::Implementation* data = (ColorGrader::Implementation*)client_data;
+                    data->update_lut();
+                    ColorLUT::write_cube(data->m_lut.lut, data->m_lut.export_path, "Komodo");
+                };
+                TwAddButton(bar, "Export LUT", export_lut, this, "group=LUT");
+            }
+        }
+
         { // Tonemapping
             TwEnumVal operators[] = { { int(Operator::Linear), "Linear" },
                                       { int(Operator::Reinhard), "Reinhard" }, 
@@ -445,6 +511,11 @@ struct ColorGrader::Implementation final {
                 color_grade_image(m_input, pixels);
                 store_image(output_image, m_output_path);
             }
+
+            if (m_lut.export_path.size() != 0) {
+                update_lut();
+                ColorLUT::write_cube(m_lut.lut, m_lut.export_path, "Komodo");
+            }
         } else {
             auto create_texture = []() -> GLuint {
                 GLuint tex_ID = 0;
@@ -481,6 +552,34 @@ struct ColorGrader::Implementation final {
         return gammacorrect(color, 2.2f);
     }
 
+    // Tonemaps the exposed color and applies display gamma.
+    RGB tonemap(RGB color) {
+        if (m_operator == Operator::Reinhard)
+            color = CameraEffects::reinhard(color, m_reinhard_whitepoint * m_reinhard_whitepoint);
+        else if (m_operator == Operator::FilmicAlu)
+            color = tonemap_filmic_ALU(color);
+        else if (m_operator == Operator::Uncharted2)
+            color = CameraEffects::uncharted2(color, m_uncharted2);
+        else if (m_operator == Operator::Unreal4)
+            color = CameraEffects::unreal4(color, m_unreal4);
+        return gammacorrect(color, 1.0f / 2.2f);
+    }
+
+    // Rebakes the tonemapping LUT if the resolution or the tonemapping parameters have changed.
+    void update_lut() {
+        if (m_lut.imported)
+            return;
+
+        TonemapParameters parameters = tonemap_parameters();
+        if (m_lut.baked && parameters == m_lut.baked_parameters && m_lut.lut.get_resolution() == m_lut.resolution)
+            return;
+
+        m_lut.lut = ColorLUT::LUT3D::log2(m_lut.resolution, m_lut.min_log2, m_lut.max_log2);
+        m_lut.lut.bake([&](RGB color) { return tonemap(color); });
+        m_lut.baked_parameters = parameters;
+        m_lut.baked = true;
+    }
+
     void color_grade_image(Image image, RGB* output) {
         float l_scale = luminance_scale();
         int width = image.get_width(), height = image.get_height();
@@ -509,21 +608,20 @@ struct ColorGrader::Implementation final {
 
         { // Tonemap
             float bloom_threshold = m_bloom.enabled ? m_bloom.threshold : INFINITY;
+            bool use_lut = m_lut.enabled || m_lut.imported;
+            if (use_lut)
+                update_lut();
             #pragma omp parallel for schedule(dynamic, 16)
             for (int i = 0; i < (int)image.get_pixel_count(); ++i) {
                 RGB pixel = image.get_pixel(i).rgb();
                 RGB bloom = m_bloom.enabled ? bloom_image.get_pixel(i).rgb() : RGB::black();
                 RGB adjusted_color = (RGB(min(pixel.r, bloom_threshold), min(pixel.g, bloom_threshold), min(pixel.b, bloom_threshold)) + bloom) * l_scale;
-                if (m_operator == Operator::Reinhard)
-                    adjusted_color = CameraEffects::reinhard(adjusted_color, m_reinhard_whitepoint * m_reinhard_whitepoint);
-                else if (m_operator == Operator::FilmicAlu)
-                    adjusted_color = tonemap_filmic_ALU(adjusted_color);
-                else if (m_operator == Operator::Uncharted2)
-                    adjusted_color = CameraEffects::uncharted2(adjusted_color, m_uncharted2);
-                else if (m_operator == Operator::Unreal4)
-                    adjusted_color = CameraEffects::unreal4(adjusted_color, m_unreal4);
-                output[i] = gammacorrect(adjusted_color, 1.0f / 2.2f);
+                output[i] = use_lut ? adjusted_color : tonemap(adjusted_color);
             }
+
+            // Tonemap the exposed colors in place through the LUT.
+            if (use_lut)
+                m_lut.lut.apply(output, output, (int)image.get_pixel_count(), m_lut.interpolation);
         }
     }
 
@@ -9,6 +9,7 @@
 #include <Bifrost/Core/Engine.h>
 
 #include <GLFWDriver.h>
+#include <HeadlessDriver.h>
 
 #include <Blurer.h>
 #include <ColorGrader.h>
@@ -76,10 +77,11 @@ int main(int argc, char** argv) {
             g_args.push_back(argv[i]);
 
     if (headless) {
-        Engine* engine = new Engine("");
-        initialize(*engine);
-        engine->get_window().resize(0, 0);
-        window_initialized(*engine, engine->get_window());
+        // The operations process their images when they are created, so there is no need to tick the engine.
+        HeadlessDriver::Settings settings;
+        settings.max_tick_count = 0;
+        settings.print_statistics = false;
+        HeadlessDriver::run(initialize, window_initialized, settings);
     } else
         GLFWDriver::run(initialize, window_initialized);
 }
@@ -63,6 +63,12 @@ RenderingGUI::~RenderingGUI() {
     delete m_state; 
 }
 
+void RenderingGUI::write_screenshots() {
+    for (const ResolvedScreenshot& screenshot : m_resolved_screenshots)
+        if (!StbImageWriter::write(screenshot.image_ID, screenshot.path))
+            printf("Failed to output screenshot to '%s'\n", screenshot.path.c_str());
+}
+
 void RenderingGUI::layout_frame() {
     // ImGui::ShowDemoWindow();
 
@@ -70,16 +76,17 @@ void RenderingGUI::layout_frame() {
     ImGui::PushItemWidth(180);
 
     { // Screenshotting
-        { // Resolve existing screenshots
+        { // Resolve existing screenshots. They are written to disk by write_screenshots in the non-mutating phase.
+            // Screenshots from the previous frame have been written and can be destroyed.
+            for (ResolvedScreenshot& screenshot : m_resolved_screenshots)
+                Images::destroy(screenshot.image_ID);
+            m_resolved_screenshots.clear();
+
             for (auto cam_ID : Cameras::get_iterable()) {
                 auto output_screenshot = [&](Screenshot::Content content, char* file_extension) {
                     auto image_ID = Cameras::resolve_screenshot(cam_ID, content, "ss");
-                    if (Images::has(image_ID)) {
-                        std::string path = std::string(m_screenshot.path) + file_extension;
-                        if (!StbImageWriter::write(image_ID, path))
-                            printf("Failed to output screenshot to '%s'\n", path.c_str());
-                        Images::destroy(image_ID);
-                    }
+                    if (Images::has(image_ID))
+                        m_resolved_screenshots.push_back({ image_ID, std::string(m_screenshot.path) + file_extension });
                 };
                 output_screenshot(Screenshot::Content::ColorLDR, ".png");
                 output_screenshot(Screenshot::Content::ColorHDR, ".hdr");
@@ -13,6 +13,9 @@
 
 #include <ImGui/ImGuiAdaptor.h>
 
+#include <string>
+#include <vector>
+
 // ------------------------------------------------------------------------------------------------
 // Forward declarations
 // ------------------------------------------------------------------------------------------------
@@ -33,6 +36,10 @@ public:
 
     void layout_frame();
 
+    // Writes the screenshots resolved by the latest layout_frame to disk.
+    // Only reads the screenshot images, so it is safe to run concurrently with other non-mutating callbacks.
+    void write_screenshots();
+
 private:
     DX11Renderer::Compositor* m_compositor;
     DX11Renderer::Renderer* m_dx_renderer;
@@ -45,6 +52,12 @@ private:
         Bifrost::Scene::Cameras::ScreenshotContent screenshot_content;
     } m_screenshot;
 
+    struct ResolvedScreenshot {
+        Bifrost::Assets::Images::UID image_ID;
+        std::string path;
+    };
+    std::vector<ResolvedScreenshot> m_resolved_screenshots;
+
     // Pimpl the state to avoid exposing dependencies.
     struct State;
     State* m_state;
@@ -602,10 +602,14 @@ int win32_window_initialized(Engine& engine, Window& window, HWND& hwnd) {
     { // Setup GUI
         imgui = new ImGui::ImGuiAdaptor();
 #ifdef OPTIX_FOUND
-        imgui->add_frame(std::make_unique<GUI::RenderingGUI>(compositor, dx11_renderer, optix_renderer));
+        auto rendering_GUI = std::make_unique<GUI::RenderingGUI>(compositor, dx11_renderer, optix_renderer);
 #else
-        imgui->add_frame(std::make_unique<GUI::RenderingGUI>(compositor, dx11_renderer));
+        auto rendering_GUI = std::make_unique<GUI::RenderingGUI>(compositor, dx11_renderer);
 #endif
+        GUI::RenderingGUI* screenshot_writer = rendering_GUI.get();
+        imgui->add_frame(std::move(rendering_GUI));
+        // Writing screenshots only reads the resolved images, so it can run concurrently with the compositor.
+        engine.add_non_mutating_callback([=] { screenshot_writer->write_screenshots(); }, "Screenshot writer", Engine::CallbackThread::Any);
         engine.add_mutating_callback([=, &engine] {
             auto* keyboard = engine.get_keyboard();
             auto* imgui_adaptor = static_cast<ImGui::ImGuiAdaptor*>(imgui);
@@ -624,7 +628,7 @@ int win32_window_initialized(Engine& engine, Window& window, HWND& hwnd) {
     for (auto camera_ID : Cameras::get_iterable())
         Cameras::set_renderer_ID(camera_ID, default_renderer);
 
-    engine.add_non_mutating_callback([=] { compositor->render(); });
+    engine.add_non_mutating_callback([=] { compositor->render(); }, "Compositor");
 
     return initialize_scene(engine);
 }
@@ -11,20 +11,66 @@
 #define _CRT_SECURE_NO_WARNINGS
 #endif
 
+#include <raystream.h>
 #include <smallpt.h>
 
+#include <Bifrost/Assets/Image.h>
 #include <Bifrost/Core/Array.h>
 
+#include <TinyExr/TinyExr.h>
+
 #include <glfw/glfw3.h>
 
+#include <chrono>
 #include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
 
 using Bifrost::Core::Array;
+using namespace Bifrost::Assets;
 using namespace Bifrost::Math;
 
 inline float clamp(float x) { return x < 0.0f ? 0.0f : x > 1.0f ? 1.0f : x; }
 inline int toInt(float x) { return int(pow(clamp(x), 1.0f / 2.2f) * 255.0f + .5f); }
 
+// Writes the image as a binary PPM with gamma 2.2. The pixels are converted into a single buffer that is written at once.
+bool writePPM(const std::string& path, const RGB* pixels, int width, int height) {
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f == nullptr)
+        return false;
+
+    int pixelCount = width * height;
+    std::vector<unsigned char> bytes(3 * pixelCount);
+    for (int i = 0; i < pixelCount; ++i) {
+        bytes[3 * i + 0] = (unsigned char)toInt(pixels[i].r);
+        bytes[3 * i + 1] = (unsigned char)toInt(pixels[i].g);
+        bytes[3 * i + 2] = (unsigned char)toInt(pixels[i].b);
+    }
+    fprintf(f, "P6\n%d %d\n%d\n", width, height, 255);
+    bool success = fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    fclose(f);
+    return success;
+}
+
+// Writes the linear radiance as a float EXR.
+bool writeEXR(const std::string& path, const RGB* pixels, int width, int height) {
+    Image image = Images::create2D(path, PixelFormat::RGB_Float, 1.0f, Vector2ui(width, height));
+    memcpy(image.get_pixels<RGB>(), pixels, sizeof(RGB) * width * height);
+    bool success = TinyExr::store(image.get_ID(), path) == TinyExr::Result::Success;
+    Images::destroy(image.get_ID());
+    return success;
+}
+
+bool writeImage(const std::string& path, const RGB* pixels, int width, int height) {
+    bool isEXR = path.size() >= 4 && path.compare(path.size() - 4, 4, ".exr") == 0;
+    return isEXR ? writeEXR(path, pixels, width, height) : writePPM(path, pixels, width, height);
+}
+
+smallpt::Ray createCamera() {
+    return smallpt::Ray(Vector3d(50, 52, 295.6), normalize(Vector3d(0, -0.042612, -1))); // cam pos, dir
+}
+
 bool gRestartAccumulation = true;
 RGB* gBackbuffer = nullptr;
 int gWindowWidth = 0;
@@ -46,12 +92,7 @@ static void keyCallback(GLFWwindow* window, int key, int scancode, int action, i
     case GLFW_KEY_P:
         if (action == GLFW_RELEASE) {
             // Write image to PPM file.
-            FILE *f = fopen("image.ppm", "w");
-            fprintf(f, "P3\n%d %d\n%d\n", gWindowWidth, gWindowHeight, 255);
-            for (int i = 0; i < gWindowWidth * gWindowHeight; ++i) {
-                RGB& c = gBackbuffer[i];
-                fprintf(f, "%d %d %d ", toInt(c.r), toInt(c.g), toInt(c.b));
-            }
+            writePPM("image.ppm", gBackbuffer, gWindowWidth, gWindowHeight);
         }
         break;
     }
@@ -66,7 +107,101 @@ inline bool is_power_of_two_or_zero(unsigned int v) {
     return (v & (v - 1)) == 0;
 }
 
-void main(int argc, char** argv) {
+// Renders sample_count samples pr pixel without a window and prints the throughput of the ray stream tracer.
+// If validate is true, then the image is also rendered by the recursive reference and the two images are compared bitwise.
+int renderHeadless(int sampleCount, int width, int height, const std::string& outputPath, bool validate) {
+    smallpt::Ray camera = createCamera();
+    int pixelCount = width * height;
+    std::vector<RGB> backbuffer(pixelCount, RGB::black());
+
+    printf("Rendering %d samples of %dx%d pixels on %d threads.\n", sampleCount, width, height, Bifrost::Core::Parallel::get_thread_count());
+    auto startTime = std::chrono::steady_clock::now();
+    int accumulations = 0;
+    unsigned long long rayCount = 0;
+    while (accumulations < sampleCount)
+        rayCount += smallpt::accumulateRadiance(camera, width, height, backbuffer.data(), accumulations);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    printf("  Ray stream: %.3f seconds, %llu rays, %.2f Mrays/s\n", seconds, rayCount, rayCount / seconds * 1e-6);
+
+    int result = 0;
+    if (validate) {
+        std::vector<RGB> referenceBackbuffer(pixelCount, RGB::black());
+        startTime = std::chrono::steady_clock::now();
+        int referenceAccumulations = 0;
+        while (referenceAccumulations < sampleCount)
+            smallpt::accumulateRadianceReference(camera, width, height, referenceBackbuffer.data(), referenceAccumulations);
+        double referenceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        // The reference traces the same rays, so the ray count is shared.
+        printf("  Reference:  %.3f seconds, %.2f Mrays/s\n", referenceSeconds, rayCount / referenceSeconds * 1e-6);
+
+        int mismatchCount = 0;
+        float maxError = 0.0f;
+        for (int i = 0; i < pixelCount; ++i) {
+            RGB pixel = backbuffer[i], referencePixel = referenceBackbuffer[i];
+            if (memcmp(&pixel, &referencePixel, sizeof(RGB)) != 0) {
+                ++mismatchCount;
+                maxError = fmaxf(maxError, fmaxf(fabsf(pixel.r - referencePixel.r), fmaxf(fabsf(pixel.g - referencePixel.g), fabsf(pixel.b - referencePixel.b))));
+            }
+        }
+        if (mismatchCount == 0)
+            printf("  Validation: all pixels are identical to the reference.\n");
+        else {
+            printf("  Validation: %d of %d pixels differ from the reference, max error %f.\n", mismatchCount, pixelCount, maxError);
+            result = 1;
+        }
+    }
+
+    if (!outputPath.empty()) {
+        if (writeImage(outputPath, backbuffer.data(), width, height))
+            printf("Image written to '%s'\n", outputPath.c_str());
+        else {
+            printf("Could not write image to '%s'\n", outputPath.c_str());
+            result = 1;
+        }
+    }
+
+    return result;
+}
+
+void printUsage() {
+    printf("usage: SmallPT [--headless <sample_count> [--size <width> <height>] [--output <path.ppm|path.exr>] [--validate]]\n");
+}
+
+int main(int argc, char** argv) {
+
+    Images::allocate(1);
+
+    if (argc > 1) {
+        if (strcmp(argv[1], "--headless") != 0 || argc < 3) {
+            printUsage();
+            return 1;
+        }
+
+        int sampleCount = atoi(argv[2]);
+        int width = 512, height = 384;
+        std::string outputPath;
+        bool validate = false;
+        for (int a = 3; a < argc; ++a) {
+            if (strcmp(argv[a], "--size") == 0 && a + 2 < argc) {
+                width = atoi(argv[++a]);
+                height = atoi(argv[++a]);
+            } else if (strcmp(argv[a], "--output") == 0 && a + 1 < argc)
+                outputPath = argv[++a];
+            else if (strcmp(argv[a], "--validate") == 0)
+                validate = true;
+            else {
+                printUsage();
+                return 1;
+            }
+        }
+
+        if (sampleCount <= 0 || width <= 0 || height <= 0) {
+            printUsage();
+            return 1;
+        }
+
+        return renderHeadless(sampleCount, width, height, outputPath, validate);
+    }
 
     if (!glfwInit())
         exit(EXIT_FAILURE);
@@ -84,7 +219,7 @@ void main(int argc, char** argv) {
     glfwSetWindowSizeCallback(window, windowSizeCallback);
 
     // Initialization
-    smallpt::Ray camera(Vector3d(50, 52, 295.6), normalize(Vector3d(0, -0.042612, -1))); // cam pos, dir
+    smallpt::Ray camera = createCamera();
     gRestartAccumulation = true;
     int accumulations = 0;
     GLuint tex_ID; {
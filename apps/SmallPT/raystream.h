@@ -0,0 +1,353 @@
+// Smallpt ray stream tracer.
+// ----------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ----------------------------------------------------------------------------
+
+#ifndef _SMALL_PT_RAY_STREAM_H_
+#define _SMALL_PT_RAY_STREAM_H_
+
+#include <smallpt.h>
+
+#include <Bifrost/Core/Parallel.h>
+
+#include <memory>
+
+// Rays are intersected four at a time with AVX and two at a time with SSE2.
+#if defined(__AVX__)
+#define SMALL_PT_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SMALL_PT_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace smallpt {
+
+// ----------------------------------------------------------------------------
+// Iterative ray stream version of radiance() and accumulateRadiance().
+// The image is split into tiles that are distributed over the threads. All paths in a tile are traced
+// in lockstep, such that the current rays of the paths form a stream that is intersected against the
+// scene with SIMD, one ray pr lane. The recursion is replaced by a stack of path vertices pr path.
+// The rays, random numbers and floating point operations are the same as in the recursive reference,
+// so the two produce bitwise identical images, as long as the compiler does not contract to FMA.
+// ----------------------------------------------------------------------------
+
+const int MAX_DEPTH = 20;
+const int SPLIT_DEPTH = 2; // Glass vertices up to and including this depth trace both reflection and transmission.
+const int TILE_SIZE = 16;
+
+// Vertex on the stack of a path. The radiance of the vertex is emission + f * (L * weight),
+// where L is the radiance along the outgoing ray, or emission + f * (L_reflected * weight + L_transmitted * transmitted_weight)
+// if the path splits at the vertex.
+struct PathVertex {
+    enum class Type { Single, SplitReflecting, SplitTransmitting };
+
+    RGB emission;
+    RGB f;
+    float weight;
+    float transmitted_weight;
+    Type type;
+};
+
+struct Path {
+    Ray ray; // The next ray to trace.
+    int depth; // The depth of the next ray.
+    LinearCongruential rng = LinearCongruential(0);
+    int pixel_index;
+    RGB radiance; // Radiance of the completed path.
+
+    int vertex_count;
+    PathVertex vertices[MAX_DEPTH + 1];
+
+    // Transmitted rays and reflected radiance of the split vertices, which can only be the first vertices.
+    Ray transmitted_rays[SPLIT_DEPTH];
+    RGB reflected_radiance[SPLIT_DEPTH];
+};
+
+// Terminates the current ray of the path with radiance L and propagates the radiance down the stack.
+// Returns true if the path continues along the transmitted ray of a split vertex
+// and false if the path is complete, in which case the radiance of the path is stored.
+inline bool terminateRay(Path& path, RGB L) {
+    while (path.vertex_count > 0) {
+        int vertex_index = path.vertex_count - 1;
+        PathVertex& vertex = path.vertices[vertex_index];
+        if (vertex.type == PathVertex::Type::SplitReflecting) {
+            vertex.type = PathVertex::Type::SplitTransmitting;
+            path.reflected_radiance[vertex_index] = L;
+            path.ray = path.transmitted_rays[vertex_index];
+            path.depth = vertex_index + 1;
+            return true;
+        } else if (vertex.type == PathVertex::Type::SplitTransmitting)
+            L = vertex.emission + vertex.f * (path.reflected_radiance[vertex_index] * vertex.weight + L * vertex.transmitted_weight);
+        else
+            L = vertex.emission + vertex.f * (L * vertex.weight);
+        --path.vertex_count;
+    }
+    path.radiance = L;
+    return false;
+}
+
+// Shades the intersection of the path's current ray, which mirrors the body of radiance().
+// Returns true if the path continues with a new ray and false if the path is complete.
+inline bool shade(Path& path, bool hit, double t, int id) {
+    if (!hit)
+        return terminateRay(path, RGB::black());
+
+    Ray ray = path.ray;
+    int depth = path.depth;
+    LinearCongruential& rng = path.rng;
+
+    const Sphere &obj = scene[id];
+    Vector3d pos = ray.origin + ray.direction * t;
+    Vector3d norm = normalize(pos - obj.position);
+    Vector3d nl = dot(norm, ray.direction) < 0 ? norm : norm*-1;
+    RGB f = obj.color;
+    float maxRefl = f.r>f.g && f.r>f.b ? f.r : f.g>f.b ? f.g : f.b;
+    if (++depth > 5) {
+        if (rng.sample1D() < maxRefl) f = f * (1 / maxRefl);
+        else return terminateRay(path, obj.emission); // Russion roulette
+    }
+
+    int vertex_index = path.vertex_count++;
+    PathVertex& vertex = path.vertices[vertex_index];
+    vertex.emission = obj.emission;
+    vertex.f = f;
+    vertex.weight = 1.0f; // Multiplying by one is exact, so single vertices reproduce emission + f * L.
+    vertex.type = PathVertex::Type::Single;
+    path.depth = depth;
+
+    if (obj.bsdf == BSDF::Diffuse) {
+        double r1 = 2.0f * PI<float>() * rng.sample1D();
+        double r2 = rng.sample1D();
+        double r2s = sqrt(r2);
+        // Tangent space
+        Vector3d w = nl;
+        Vector3d u = normalize(cross(fabs(w.x) > 0.1 ? Vector3d(0, 1, 0) : Vector3d(1, 0, 0), w));
+        Vector3d v = cross(w, u);
+        Vector3d dir = normalize(u * cos(r1) * r2s + v * sin(r1) * r2s + w * sqrt(1 - r2));
+        path.ray = Ray(pos, dir);
+    } else if (obj.bsdf == BSDF::Specular) {
+        Vector3d reflect = ray.direction - nl * 2 * dot(nl, ray.direction);
+        path.ray = Ray(pos, reflect);
+    } else { // Ideal dielectric refraction, glass.
+        Ray reflRay(pos, ray.direction - norm * 2 * dot(norm, ray.direction));
+        bool into = dot(norm, nl) > 0; // Ray from outside going in?
+        const float nc = 1, nt = 1.5;
+        double nnt = into ? nc / nt : nt / nc, ddn = dot(ray.direction, nl), cos2t;
+        if ((cos2t = 1 - nnt*nnt*(1 - ddn*ddn))<0) { // Total internal reflection
+            path.ray = reflRay;
+            return true;
+        }
+        Vector3d tdir = normalize(ray.direction*nnt - norm*((into ? 1 : -1)*(ddn*nnt + sqrt(cos2t))));
+        float a = nt - nc, b = nt + nc;
+        float R0 = a*a / (b*b);
+        float c = 1.0f - float(into ? -ddn : dot(tdir, norm)); // cosTheta
+        float Re = R0 + (1.0f - R0)*c*c*c*c*c; // Schlick's fresnel approximation.
+        float Tr = 1.0f - Re;
+        float P = .25f + .5f * Re;
+        float RP = Re / P;
+        float TP = Tr / (1.0f - P);
+        if (depth > SPLIT_DEPTH) { // Russian roulette
+            if (rng.sample1D() < P) {
+                path.ray = reflRay;
+                vertex.weight = RP;
+            } else {
+                path.ray = Ray(pos, tdir);
+                vertex.weight = TP;
+            }
+        } else {
+            // Trace the reflected ray first and the transmitted ray when the reflected radiance is known.
+            vertex.type = PathVertex::Type::SplitReflecting;
+            vertex.weight = Re;
+            vertex.transmitted_weight = Tr;
+            path.transmitted_rays[vertex_index] = Ray(pos, tdir);
+            path.ray = reflRay;
+        }
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Stream of rays in structure of arrays layout.
+// The capacity is padded to the SIMD width and unused lanes are filled with copies of the last ray.
+// ----------------------------------------------------------------------------
+struct RayStream {
+    static const int capacity = TILE_SIZE * TILE_SIZE;
+
+    int count;
+    int path_indices[capacity];
+    double origin_x[capacity], origin_y[capacity], origin_z[capacity];
+    double direction_x[capacity], direction_y[capacity], direction_z[capacity];
+
+    // Intersection results. Rays that miss the scene have distance 1e20.
+    double distance[capacity];
+    int sphere_ids[capacity];
+};
+
+// Intersects all rays in the stream with the scene.
+// The intersection performs the same operations as Sphere::intersect() and the spheres are tested in the same order
+// as intersect(), such that ties are resolved identically.
+inline void intersect(RayStream& rays) {
+    const int sphere_count = int(sizeof(scene) / sizeof(Sphere));
+    const double eps = 1e-4, inf = 1e20;
+
+#if defined(SMALL_PT_AVX)
+    const int lane_count = 4;
+#elif defined(SMALL_PT_SSE2)
+    const int lane_count = 2;
+#else
+    const int lane_count = 1;
+#endif
+
+    int padded_count = (rays.count + lane_count - 1) / lane_count * lane_count;
+    for (int r = rays.count; r < padded_count; ++r) {
+        rays.origin_x[r] = rays.origin_x[r - 1]; rays.origin_y[r] = rays.origin_y[r - 1]; rays.origin_z[r] = rays.origin_z[r - 1];
+        rays.direction_x[r] = rays.direction_x[r - 1]; rays.direction_y[r] = rays.direction_y[r - 1]; rays.direction_z[r] = rays.direction_z[r - 1];
+    }
+
+    for (int r = 0; r < padded_count; r += lane_count) {
+#if defined(SMALL_PT_AVX)
+        __m256d origin_x = _mm256_loadu_pd(rays.origin_x + r), origin_y = _mm256_loadu_pd(rays.origin_y + r), origin_z = _mm256_loadu_pd(rays.origin_z + r);
+        __m256d direction_x = _mm256_loadu_pd(rays.direction_x + r), direction_y = _mm256_loadu_pd(rays.direction_y + r), direction_z = _mm256_loadu_pd(rays.direction_z + r);
+        __m256d zero = _mm256_setzero_pd(), eps_v = _mm256_set1_pd(eps);
+        __m256d t = _mm256_set1_pd(inf), id = _mm256_setzero_pd();
+        for (int i = sphere_count; i--;) {
+            const Sphere& sphere = scene[i];
+            __m256d op_x = _mm256_sub_pd(_mm256_set1_pd(sphere.position.x), origin_x);
+            __m256d op_y = _mm256_sub_pd(_mm256_set1_pd(sphere.position.y), origin_y);
+            __m256d op_z = _mm256_sub_pd(_mm256_set1_pd(sphere.position.z), origin_z);
+            __m256d b = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(op_x, direction_x), _mm256_mul_pd(op_y, direction_y)), _mm256_mul_pd(op_z, direction_z));
+            __m256d op_squared = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(op_x, op_x), _mm256_mul_pd(op_y, op_y)), _mm256_mul_pd(op_z, op_z));
+            __m256d det = _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(b, b), op_squared), _mm256_set1_pd(sphere.radius * sphere.radius));
+            __m256d valid = _mm256_cmp_pd(det, zero, _CMP_NLT_UQ);
+            det = _mm256_sqrt_pd(det);
+            __m256d t0 = _mm256_sub_pd(b, det), t1 = _mm256_add_pd(b, det);
+            __m256d d = _mm256_blendv_pd(_mm256_and_pd(t1, _mm256_cmp_pd(t1, eps_v, _CMP_GT_OQ)), t0, _mm256_cmp_pd(t0, eps_v, _CMP_GT_OQ));
+            d = _mm256_and_pd(d, valid);
+            __m256d hit = _mm256_and_pd(_mm256_cmp_pd(d, zero, _CMP_NEQ_UQ), _mm256_cmp_pd(d, t, _CMP_LT_OQ));
+            t = _mm256_blendv_pd(t, d, hit);
+            id = _mm256_blendv_pd(id, _mm256_set1_pd(i), hit);
+        }
+        _mm256_storeu_pd(rays.distance + r, t);
+        __m128i ids = _mm256_cvttpd_epi32(id);
+        _mm_storeu_si128((__m128i*)(rays.sphere_ids + r), ids);
+#elif defined(SMALL_PT_SSE2)
+        __m128d origin_x = _mm_loadu_pd(rays.origin_x + r), origin_y = _mm_loadu_pd(rays.origin_y + r), origin_z = _mm_loadu_pd(rays.origin_z + r);
+        __m128d direction_x = _mm_loadu_pd(rays.direction_x + r), direction_y = _mm_loadu_pd(rays.direction_y + r), direction_z = _mm_loadu_pd(rays.direction_z + r);
+        __m128d zero = _mm_setzero_pd(), eps_v = _mm_set1_pd(eps);
+        __m128d t = _mm_set1_pd(inf), id = _mm_setzero_pd();
+        for (int i = sphere_count; i--;) {
+            const Sphere& sphere = scene[i];
+            __m128d op_x = _mm_sub_pd(_mm_set1_pd(sphere.position.x), origin_x);
+            __m128d op_y = _mm_sub_pd(_mm_set1_pd(sphere.position.y), origin_y);
+            __m128d op_z = _mm_sub_pd(_mm_set1_pd(sphere.position.z), origin_z);
+            __m128d b = _mm_add_pd(_mm_add_pd(_mm_mul_pd(op_x, direction_x), _mm_mul_pd(op_y, direction_y)), _mm_mul_pd(op_z, direction_z));
+            __m128d op_squared = _mm_add_pd(_mm_add_pd(_mm_mul_pd(op_x, op_x), _mm_mul_pd(op_y, op_y)), _mm_mul_pd(op_z, op_z));
+            __m128d det = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b, b), op_squared), _mm_set1_pd(sphere.radius * sphere.radius));
+            __m128d valid = _mm_cmpnlt_pd(det, zero);
+            det = _mm_sqrt_pd(det);
+            __m128d t0 = _mm_sub_pd(b, det), t1 = _mm_add_pd(b, det);
+            __m128d t0_valid = _mm_cmpgt_pd(t0, eps_v);
+            __m128d d = _mm_or_pd(_mm_and_pd(t0_valid, t0), _mm_andnot_pd(t0_valid, _mm_and_pd(t1, _mm_cmpgt_pd(t1, eps_v))));
+            d = _mm_and_pd(d, valid);
+            __m128d hit = _mm_and_pd(_mm_cmpneq_pd(d, zero), _mm_cmplt_pd(d, t));
+            t = _mm_or_pd(_mm_and_pd(hit, d), _mm_andnot_pd(hit, t));
+            id = _mm_or_pd(_mm_and_pd(hit, _mm_set1_pd(i)), _mm_andnot_pd(hit, id));
+        }
+        _mm_storeu_pd(rays.distance + r, t);
+        rays.sphere_ids[r] = _mm_cvttsd_si32(id);
+        rays.sphere_ids[r + 1] = _mm_cvttsd_si32(_mm_unpackhi_pd(id, id));
+#else
+        Ray ray = Ray(Vector3d(rays.origin_x[r], rays.origin_y[r], rays.origin_z[r]),
+                      Vector3d(rays.direction_x[r], rays.direction_y[r], rays.direction_z[r]));
+        double t = inf, d;
+        int id = 0;
+        for (int i = sphere_count; i--;) if ((d = scene[i].intersect(ray)) && d<t) { t = d; id = i; }
+        rays.distance[r] = t;
+        rays.sphere_ids[r] = id;
+#endif
+    }
+}
+
+// Traces one sample through every pixel in the tile and blends it into the backbuffer.
+// Returns the number of rays traced.
+inline unsigned long long accumulateTile(Ray cam, Vector3d cx, Vector3d cy, int w, int h, int tile_x, int tile_y,
+                                         int accumulations, float blendFactor, RGB *const backbuffer, Path* paths, RayStream& rays) {
+    int x_begin = tile_x * TILE_SIZE, x_end = x_begin + TILE_SIZE < w ? x_begin + TILE_SIZE : w;
+    int y_begin = tile_y * TILE_SIZE, y_end = y_begin + TILE_SIZE < h ? y_begin + TILE_SIZE : h;
+
+    rays.count = 0;
+    for (int y = y_begin; y < y_end; ++y)
+        for (int x = x_begin; x < x_end; ++x) {
+            Path& path = paths[rays.count];
+            path.ray = sampleCameraRay(cam, cx, cy, w, h, x, y, accumulations, path.rng);
+            path.depth = 0;
+            path.vertex_count = 0;
+            path.pixel_index = (h - y - 1) * w + x;
+            rays.path_indices[rays.count] = rays.count;
+            ++rays.count;
+        }
+
+    unsigned long long ray_count = 0;
+    while (rays.count > 0) {
+        for (int r = 0; r < rays.count; ++r) {
+            const Ray& ray = paths[rays.path_indices[r]].ray;
+            rays.origin_x[r] = ray.origin.x; rays.origin_y[r] = ray.origin.y; rays.origin_z[r] = ray.origin.z;
+            rays.direction_x[r] = ray.direction.x; rays.direction_y[r] = ray.direction.y; rays.direction_z[r] = ray.direction.z;
+        }
+        intersect(rays);
+        ray_count += rays.count;
+
+        // Shade the intersections and compact the paths that continue.
+        int active_count = 0;
+        for (int r = 0; r < rays.count; ++r) {
+            int path_index = rays.path_indices[r];
+            Path& path = paths[path_index];
+            bool active = shade(path, rays.distance[r] < 1e20, rays.distance[r], rays.sphere_ids[r]);
+            // Rays beyond the maximal depth are terminated without being traced.
+            while (active && path.depth > MAX_DEPTH)
+                active = terminateRay(path, RGB::black());
+
+            if (active)
+                rays.path_indices[active_count++] = path_index;
+            else
+                backbuffer[path.pixel_index] = lerp(backbuffer[path.pixel_index], path.radiance, blendFactor);
+        }
+        rays.count = active_count;
+    }
+
+    return ray_count;
+}
+
+// Ray stream version of accumulateRadiance. Returns the number of rays traced.
+inline unsigned long long accumulateRadiance(Ray cam, int w, int h, RGB *const backbuffer, int& accumulations) {
+    ++accumulations;
+    float blendFactor = 1.0f / accumulations;
+
+    Vector3d cx = Vector3d(w * 0.5135 / h, 0, 0), cy = normalize(cross(cx, cam.direction)) * 0.5135;
+
+    struct TileState {
+        std::unique_ptr<Path[]> paths;
+        std::unique_ptr<RayStream> rays;
+        unsigned long long ray_count;
+    };
+
+    int tile_count_x = (w + TILE_SIZE - 1) / TILE_SIZE, tile_count_y = (h + TILE_SIZE - 1) / TILE_SIZE;
+    unsigned long long ray_count = 0;
+    Bifrost::Core::Parallel::for_range(0, tile_count_x * tile_count_y,
+        [&]() -> TileState { return { std::unique_ptr<Path[]>(new Path[RayStream::capacity]), std::unique_ptr<RayStream>(new RayStream()), 0 }; },
+        [&](int tile_index, TileState& state) {
+            state.ray_count += accumulateTile(cam, cx, cy, w, h, tile_index % tile_count_x, tile_index / tile_count_x,
+                                              accumulations, blendFactor, backbuffer, state.paths.get(), *state.rays);
+        },
+        [&](TileState& state) { ray_count += state.ray_count; });
+
+    return ray_count;
+}
+
+} // NS smallpt
+
+#endif // _SMALL_PT_RAY_STREAM_H_
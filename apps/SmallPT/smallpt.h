@@ -74,6 +74,7 @@ inline unsigned int reverseBits(unsigned int v) {
 
 struct Ray { 
     Vector3d origin, direction; 
+    Ray() = default;
     Ray(Vector3d o, Vector3d d)
         : origin(o), direction(d) {}
 };
@@ -162,14 +163,33 @@ RGB radiance(const Ray &ray, int depth, LinearCongruential& rng) {
             float P = .25f + .5f * Re;
             float RP = Re / P;
             float TP = Tr / (1.0f - P);
-            return obj.emission + f * (depth>2 ? (rng.sample1D()<P ?   // Russian roulette
-                radiance(reflRay, depth, rng)*RP : radiance(Ray(pos, tdir), depth, rng)*TP) :
-                radiance(reflRay, depth, rng)*Re + radiance(Ray(pos, tdir), depth, rng)*Tr);
+            if (depth > 2) // Russian roulette
+                return obj.emission + f * (rng.sample1D()<P ? radiance(reflRay, depth, rng)*RP : radiance(Ray(pos, tdir), depth, rng)*TP);
+            // Trace reflection before transmission, as the evaluation order of operands is unspecified and both consume random numbers.
+            RGB reflected = radiance(reflRay, depth, rng);
+            RGB transmitted = radiance(Ray(pos, tdir), depth, rng);
+            return obj.emission + f * (reflected*Re + transmitted*Tr);
         }
 }
 
-void accumulateRadiance(Ray cam, int w, int h,
-                        RGB *const backbuffer, int& accumulations) {
+// Samples the camera ray through pixel (x, y) and seeds the pixel's random number generator for the accumulation.
+inline Ray sampleCameraRay(Ray cam, Vector3d cx, Vector3d cy, int w, int h, int x, int y, int accumulations, LinearCongruential& rng) {
+    // Stratify samples in 2x2 in image plane.
+    int sx = accumulations % 2;
+    int sy = (accumulations >> 1) % 2;
+    int index = (y * 2 + sy) * (w * 2) + x * 2 + sx;
+    rng = LinearCongruential(RobertJenkinsHash(unsigned int(index)) ^ reverseBits(unsigned int(accumulations)));
+    double r1 = 2 * rng.sample1D(), dx = r1 < 1 ? sqrt(r1) - 1 : 1 - sqrt(2 - r1);
+    double r2 = 2 * rng.sample1D(), dy = r2 < 1 ? sqrt(r2) - 1 : 1 - sqrt(2 - r2);
+    Vector3d d = cx * (((sx + .5 + dx) / 2 + x) / w - .5) +
+        cy * (((sy + .5 + dy) / 2 + y) / h - .5) + cam.direction;
+    return Ray(cam.origin + d * 140, normalize(d));
+    //     Camera rays are pushed ^^^^^ forward to start in interior
+}
+
+// Recursive reference implementation. Used to validate the ray stream tracer.
+void accumulateRadianceReference(Ray cam, int w, int h,
+                                 RGB *const backbuffer, int& accumulations) {
 
     ++accumulations;
     float blendFactor = 1.0f / accumulations;
@@ -178,19 +198,11 @@ void accumulateRadiance(Ray cam, int w, int h,
 
     #pragma omp parallel for schedule(dynamic, 16)
     for (int y = 0; y < h; ++y) {
-        for (unsigned short x = 0; x < w; ++x) {
-            // Stratify samples in 2x2 in image plane.
-            int sx = accumulations % 2;
-            int sy = (accumulations >> 1) % 2;
-            int index = (y * 2 + sy) * (w * 2) + x * 2 + sx;
-            LinearCongruential rng = LinearCongruential(RobertJenkinsHash(unsigned int(index)) ^ reverseBits(unsigned int(accumulations)));
-            double r1 = 2 * rng.sample1D(), dx = r1 < 1 ? sqrt(r1) - 1 : 1 - sqrt(2 - r1);
-            double r2 = 2 * rng.sample1D(), dy = r2 < 1 ? sqrt(r2) - 1 : 1 - sqrt(2 - r2);
-            Vector3d d = cx * (((sx + .5 + dx) / 2 + x) / w - .5) +
-                cy * (((sy + .5 + dy) / 2 + y) / h - .5) + cam.direction;
+        for (int x = 0; x < w; ++x) {
+            LinearCongruential rng = LinearCongruential(0);
+            Ray ray = sampleCameraRay(cam, cx, cy, w, h, x, y, accumulations, rng);
             int i = (h - y - 1) * w + x;
-            RGB r = radiance(Ray(cam.origin + d * 140, normalize(d)), 0, rng);
-            //            Camera rays are pushed ^^^^^ forward to start in interior
+            RGB r = radiance(ray, 0, rng);
             backbuffer[i] = lerp(backbuffer[i], r, blendFactor);
         }
     }
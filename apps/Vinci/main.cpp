@@ -324,7 +324,7 @@ int win32_window_initialized(Engine& engine, Window& window, HWND& hwnd) {
     for (auto camera_ID : Cameras::get_iterable())
         Cameras::set_renderer_ID(camera_ID, default_renderer);
 
-    engine.add_non_mutating_callback([=] { g_compositor->render(); });
+    engine.add_non_mutating_callback([=] { g_compositor->render(); }, "Compositor");
 
     return setup_scene(engine, g_options);
 }
@@ -30,6 +30,7 @@
 #include <atomic>
 #include <array>
 #include <chrono>
+#include <filesystem>
 
 using namespace Bifrost::Assets;
 using namespace Bifrost::Core;
@@ -38,7 +39,7 @@ using namespace Bifrost::Math;
 using namespace Bifrost::Math::Distributions;
 
 enum class ConvolutionType {
-    MIS, Light, BSDF, Recursive, Separable, SeparableRecursive
+    MIS, Light, BSDF, Recursive, Separable, SeparableRecursive, Prefiltered
 };
 
 bool is_recursive(ConvolutionType convolution) {
@@ -67,9 +68,10 @@ struct Options {
     ConvolutionType sample_method;
     int sample_count;
     bool headless;
+    std::filesystem::path cache_directory;
 
     static Options parse(int argc, char** argv) {
-        Options options = { ConvolutionType::MIS, 256, false };
+        Options options = { ConvolutionType::MIS, 256, false, std::filesystem::temp_directory_path() / "Bifrost" / "IBLCache" };
 
         // Skip the first two arguments, the application name and image path.
         for (int argument = 2; argument < argc; ++argument) {
@@ -85,6 +87,10 @@ struct Options {
                 options.sample_method = ConvolutionType::Separable;
             else if (strcmp(argv[argument], "--separable-recursive-filtering") == 0)
                 options.sample_method = ConvolutionType::SeparableRecursive;
+            else if (strcmp(argv[argument], "--filtered-importance-sampling") == 0 || strcmp(argv[argument], "-f") == 0)
+                options.sample_method = ConvolutionType::Prefiltered;
+            else if (strcmp(argv[argument], "--cache-directory") == 0)
+                options.cache_directory = argv[++argument];
             else if (strcmp(argv[argument], "--sample-count") == 0 || strcmp(argv[argument], "-s") == 0)
                 options.sample_count = atoi(argv[++argument]);
             else if (strcmp(argv[argument], "--headless") == 0)
@@ -103,6 +109,7 @@ struct Options {
         case ConvolutionType::Recursive: out << "Recursive sampling"; break;
         case ConvolutionType::Separable: out << "Separable convolution"; break;
         case ConvolutionType::SeparableRecursive: out << "Separable recursive convolution"; break;
+        case ConvolutionType::Prefiltered: out << "Filtered importance sampling"; break;
         }
         if (sample_method != ConvolutionType::Separable && sample_method != ConvolutionType::SeparableRecursive)
             out << ", " << sample_count << " samples pr pixel";
@@ -363,11 +370,34 @@ int initialize(Engine& engine) {
 
     auto starttime = std::chrono::system_clock::now();
 
-    printf("\rProgress: %.2f%%", 0.0f);
+    if (g_options.sample_method == ConvolutionType::Prefiltered) {
+        // Prefilter all roughness levels in one pass, or read them from the cache if the environment has been prefiltered before.
+        using namespace InfiniteAreaLightUtils;
+        InfiniteAreaLight light = InfiniteAreaLight(texture_ID);
+        std::vector<IBLConvolution<RGB>> convolutions = std::vector<IBLConvolution<RGB>>(g_convoluted_images.size());
+        for (int r = 0; r < g_convoluted_images.size(); ++r) {
+            g_convoluted_images[r] = Images::create2D("Convoluted image", PixelFormat::RGB_Float, 1.0f, Vector2ui(image.get_width(), image.get_height()));
+            convolutions[r].Pixels = g_convoluted_images[r].get_pixels<RGB>();
+            convolutions[r].Width = image.get_width();
+            convolutions[r].Height = image.get_height();
+            convolutions[r].Roughness = r / (g_convoluted_images.size() - 1.0f);
+            convolutions[r].sample_count = g_options.sample_count;
+        }
+        bool cached = prefilter_cached(light, convolutions.data(), convolutions.data() + convolutions.size(), [](RGB c) -> RGB { return c; }, g_options.cache_directory);
+        if (cached)
+            printf("Read prefiltered environment from cache '%s'\n", g_options.cache_directory.string().c_str());
+
+        if (g_options.headless)
+            for (int r = 0; r < g_convoluted_images.size(); ++r)
+                output_convoluted_image(g_image_file, g_convoluted_images[r], convolutions[r].Roughness);
+    }
+
+    if (g_options.sample_method != ConvolutionType::Prefiltered)
+        printf("\rProgress: %.2f%%", 0.0f);
 
     std::atomic_int finished_pixel_count;
     finished_pixel_count = 0;
-    for (int r = 0; r < g_convoluted_images.size(); ++r) {
+    for (int r = 0; r < g_convoluted_images.size() && g_options.sample_method != ConvolutionType::Prefiltered; ++r) {
         int width = image.get_width(), height = image.get_height();
 
         g_convoluted_images[r] = Images::create2D("Convoluted image", PixelFormat::RGB_Float, 1.0f, Vector2ui(width, height));
@@ -515,7 +545,8 @@ int initialize(Engine& engine) {
             output_convoluted_image(g_image_file, g_convoluted_images[r], roughness);
     }
 
-    printf("\rProgress: 100.00%%\n");
+    if (g_options.sample_method != ConvolutionType::Prefiltered)
+        printf("\rProgress: 100.00%%\n");
 
     // Print convolution time
     auto endtime = std::chrono::system_clock::now();
@@ -540,6 +571,8 @@ void print_usage() {
         "  -r | --recursive-sampling: Convolute based on the previous convoluted image.\n"
         "     | --separable-filtering: Two-pass convolution using a separable GGX filter.\n"
         "     | --separable-recursive-filtering: Two-pass convolution using a separable GGX filter that uses the previous convoluted image as input.\n"
+        "  -f | --filtered-importance-sampling: Prefilter all roughness levels from a mipmapped environment and cache the result.\n"
+        "     | --cache-directory: The directory of cached prefiltered environments. Defaults to the temporary directory.\n"
         "     | --headless: Launch without a window and instead output the convoluted images.\n"
         "\n"
         "Keys:\n"
@@ -7,13 +7,15 @@
 #include "SPTD.h"
 
 #include <Bifrost/Assets/Image.h>
-#include <Bifrost/Math/NelderMead.h>
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Math/TableFitting.h>
 #include <StbImageWriter/StbImageWriter.h>
 
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 using namespace SPTD;
 
@@ -50,155 +52,166 @@ DirectionAndRho compute_average_sample(BRDF brdf, float3 wo, float alpha) {
     return { normalize(summed_direction), norm / float(sample_count * sample_count) };
 }
 
-// compute the error between the BRDF and the pivot using Multiple Importance Sampling
-template <typename BRDF>
-float compute_error(Pivot pivot, BRDF brdf, float3 wo, float alpha) {
-    double error = 0.0;
-    int valid_sample_count = 0;
+// BRDF samples of a cell in structure of arrays layout.
+// The samples are independent of the pivot, so they are drawn once pr cell instead of once pr error evaluation.
+struct BRDFSamples {
+    std::vector<float> wi_x, wi_y, wi_z;
+    std::vector<float> reflectance;
+    std::vector<float> PDF;
 
+    inline int size() const { return int(PDF.size()); }
+};
+
+template <typename BRDF>
+BRDFSamples sample_brdf(BRDF brdf, float3 wo, float alpha) {
+    BRDFSamples samples;
     for (int j = 0; j < sample_count; ++j)
         for (int i = 0; i < sample_count; ++i) {
-
             const float U1 = (i + 0.5f) / (float)sample_count;
             const float U2 = (j + 0.5f) / (float)sample_count;
 
-            /*
-            // error with MIS weight
-            auto error_from_wi = [&](float3 wi) -> double {
-                auto brdf_response = brdf.eval(wo, wi, alpha);
-                float eval_pivot = pivot.eval(wi);
-                float pdf_pivot = eval_pivot / pivot.amplitude;
-                double error = brdf_response.reflectance.x - eval_pivot;
-                return error * error / (pdf_pivot + brdf_response.PDF);
-            };
-
-            { // importance sample LTC
-                const float3 wi = pivot.sample(U1, U2);
-                if (wi.z >= 0.0f) {
-                    error += error_from_wi(wi);
-                    ++valid_sample_count;
-                }
-            }
-
-            { // importance sample BRDF
-                const float3 wi = brdf.sample_direction(wo, alpha, U1, U2);
-                if (wi.z >= 0.0f) {
-                    error += error_from_wi(wi);
-                    ++valid_sample_count;
-                }
-            }
-            */
-
-            // error with MIS weight
-            auto compute_error = [&](float3 sampled_wi, BSDFResponse brdf_response) -> double {
-                float eval_pivot = pivot.eval(sampled_wi);
-                float pdf_pivot = eval_pivot / pivot.amplitude;
-                double error = brdf_response.reflectance.x - eval_pivot;
-                return error * error / (pdf_pivot + brdf_response.PDF);
-            };
-
-            { // importance sample LTC
-                const float3 wi = pivot.sample(U1, U2);
-                if (wi.z >= 0.0f) {
-                    auto brdf_response = brdf.eval(wo, wi, alpha);
-                    error += compute_error(wi, brdf_response);
-                    ++valid_sample_count;
-                }
-            }
-
-            { // importance sample BRDF
-                auto brdf_sample = brdf.sample(wo, alpha, U1, U2);
-                if (is_PDF_valid(brdf_sample.PDF)) {
-                    BSDFResponse brdf_response = { brdf_sample.reflectance, brdf_sample.PDF };
-                    error += compute_error(brdf_sample.direction, brdf_response);
-                    ++valid_sample_count;
-                }
+            auto brdf_sample = brdf.sample(wo, alpha, U1, U2);
+            if (is_PDF_valid(brdf_sample.PDF)) {
+                samples.wi_x.push_back(brdf_sample.direction.x);
+                samples.wi_y.push_back(brdf_sample.direction.y);
+                samples.wi_z.push_back(brdf_sample.direction.z);
+                samples.reflectance.push_back(brdf_sample.reflectance.x);
+                samples.PDF.push_back(brdf_sample.PDF);
             }
         }
-
-    return float(error / valid_sample_count);
+    return samples;
 }
 
+// compute the error between the BRDF and the pivot using Multiple Importance Sampling
 template <typename BRDF>
-struct PivotFitter {
-
-    PivotFitter(Pivot& pivot, BRDF brdf, float3 wo, float alpha)
-        : pivot(pivot), brdf(brdf), wo(wo), alpha(alpha) { }
-
-    void update(float* params) {
-        pivot.distance = clamp(params[0], 0.001f, 0.999f);
-        pivot.theta = clamp(params[1], -1.5707f, 0.0f);
+float compute_error(Pivot pivot, BRDF brdf, float3 wo, float alpha, const BRDFSamples& brdf_samples) {
+    double error = 0.0;
+    int valid_sample_count = 0;
 
-        // Mirror around the borders of the domain.
-        float distance_diff = pivot.distance - params[0];
-        pivot.distance = params[0] += 1.1f * distance_diff;
-        float theta_diff = pivot.theta - params[1];
-        pivot.theta = params[1] += 1.1f * theta_diff;
-    }
+    // error with MIS weight
+    auto compute_error = [&](float3 sampled_wi, BSDFResponse brdf_response) -> double {
+        float eval_pivot = pivot.eval(sampled_wi);
+        float pdf_pivot = eval_pivot / pivot.amplitude;
+        double error = brdf_response.reflectance.x - eval_pivot;
+        return error * error / (pdf_pivot + brdf_response.PDF);
+    };
 
-    float operator()(float* params) {
-        update(params);
+    // importance sample LTC
+    for (int j = 0; j < sample_count; ++j)
+        for (int i = 0; i < sample_count; ++i) {
+            const float U1 = (i + 0.5f) / (float)sample_count;
+            const float U2 = (j + 0.5f) / (float)sample_count;
 
-        // NOTE Ideally we'd assign a higher weight to errors where the distance and theta are outside the valid domain, 
-        // but in practice that yields less diserable results than simply mirroring vertices around the domain border.
-        // float distance_offset = params[0] - pivot.distance;
-        // float theta_offset = params[1] - pivot.theta;
-        // float error_scale = 1.0f + 32.0f * (distance_offset * distance_offset + theta_offset * theta_offset);
+            const float3 wi = pivot.sample(U1, U2);
+            if (wi.z >= 0.0f) {
+                auto brdf_response = brdf.eval(wo, wi, alpha);
+                error += compute_error(wi, brdf_response);
+                ++valid_sample_count;
+            }
+        }
 
-        return compute_error(pivot, brdf, wo, alpha);
+    { // importance sample BRDF
+        // Pivot::eval inlined over the precomputed samples, which lets the compiler vectorize the loop.
+        float3 xi = pivot.position();
+        float pivot_numerator = 1.0f - dot(xi, xi);
+        float pdf_normalization = 1.0f / (4.0f * PIf);
+        float brdf_sample_error = 0.0f;
+        for (int s = 0; s < brdf_samples.size(); ++s) {
+            float dx = brdf_samples.wi_x[s] - xi.x, dy = brdf_samples.wi_y[s] - xi.y, dz = brdf_samples.wi_z[s] - xi.z;
+            float p = pivot_numerator / (dx * dx + dy * dy + dz * dz);
+            float pdf_pivot = p * p * pdf_normalization;
+            float sample_error = brdf_samples.reflectance[s] - pivot.amplitude * pdf_pivot;
+            brdf_sample_error += sample_error * sample_error / (pdf_pivot + brdf_samples.PDF[s]);
+        }
+        error += brdf_sample_error;
+        valid_sample_count += brdf_samples.size();
     }
 
-    BRDF brdf;
-    Pivot& pivot;
-
-    const float3& wo;
-    float alpha;
-};
-
-// Fit using nelder-mead.
-template <typename BRDF>
-void fit(Pivot& pivot, BRDF brdf, float3 wo, float alpha, float epsilon = 0.05f) {
+    return float(error / valid_sample_count);
+}
 
-    float start_fit[2] = { pivot.distance, pivot.theta };
-    float result_fit[2];
+// Set the pivot's distance and theta from the fitting parameters.
+// Parameters outside the valid domain are mirrored around the border of the domain.
+// NOTE Ideally we'd assign a higher weight to errors where the distance and theta are outside the valid domain,
+// but in practice that yields less diserable results than simply mirroring vertices around the domain border.
+inline void set_pivot_parameters(Pivot& pivot, float* params) {
+    pivot.distance = clamp(params[0], 0.001f, 0.999f);
+    pivot.theta = clamp(params[1], -1.5707f, 0.0f);
+
+    float distance_diff = pivot.distance - params[0];
+    pivot.distance = params[0] += 1.1f * distance_diff;
+    float theta_diff = pivot.theta - params[1];
+    pivot.theta = params[1] += 1.1f * theta_diff;
+}
 
-    PivotFitter<BRDF> fitter(pivot, brdf, wo, alpha);
-    float error = Bifrost::Math::nelder_mead<2>(result_fit, start_fit, epsilon, 1e-5f, 200, fitter);
+inline float3 wo_from_cell(int t, int size) {
+    float cos_theta = t / float(size - 1);
+    float theta = fminf(1.57f, acosf(cos_theta));
+    return make_float3(sinf(theta), 0, cosf(theta));
+}
 
-    // Update pivot with best fitting values
-    fitter.update(result_fit);
+inline float alpha_from_cell(int r, int size) {
+    float roughness = r / float(size - 1);
+    return fmaxf(roughness * roughness, 0.001f); // OptiXRenderer::Shading::BSDFs::GGX::alpha_from_roughness(roughness); // TODO The minimal alpha should be reduced, but that leads to bad fits on nearly specular surfaces.
 }
 
-// fit data
+// Fit the pivots of all (theta, roughness) cells using nelder-mead.
+// Cells are fitted in parallel and warm started from their neighbours, see Bifrost::Math::fit_table.
 template <typename BRDF>
-void fit_pivot(Pivot* pivots, const int size, BRDF brdf) {
-
-    // Loop over theta and alpha.
-    #pragma omp parallel for
-    for (int i = 0; i < size * size; ++i) {
+Bifrost::Math::TableFittingReport fit_pivot(Pivot* pivots, const int size, BRDF brdf, int start_count) {
+    using namespace Bifrost;
+
+    // Compute the initial pivot and the BRDF samples of all cells.
+    struct Cell {
+        float3 wo;
+        float alpha;
+        Pivot initial_pivot;
+        BRDFSamples brdf_samples;
+    };
+    std::vector<Cell> cells(size * size);
+    Core::Parallel::parallel_for(0, size * size, [&](int i) {
         int t = i % size, r = i / size;
+        Cell& cell = cells[i];
+        cell.wo = wo_from_cell(t, size);
+        cell.alpha = alpha_from_cell(r, size);
+        cell.brdf_samples = sample_brdf(brdf, cell.wo, cell.alpha);
+
+        auto average_sample = compute_average_sample(brdf, cell.wo, cell.alpha);
+        cell.initial_pivot.distance = 0.5f + 0.49f * (1.0f - cell.alpha);
+        cell.initial_pivot.theta = acos(average_sample.direction.z) * sign(average_sample.direction.x);
+        cell.initial_pivot.amplitude = average_sample.rho;
+    }, 1);
+
+    auto initial_guess = [&](int t, int r, float* params) {
+        const Pivot& pivot = cells[t + r * size].initial_pivot;
+        params[0] = pivot.distance;
+        params[1] = pivot.theta;
+    };
 
-        float cos_theta = t / float(size - 1);
-        float theta = fminf(1.57f, acosf(cos_theta));
-        // std::cout << "cos_theta: " << cos_theta << ", theta: " << theta << ", cos(theta): " << cosf(theta) << std::endl;
-        const float3 wo = make_float3(sinf(theta), 0, cosf(theta));
-
-        float roughness = r / float(size - 1);
-        float alpha = fmaxf(roughness * roughness, 0.001f); // OptiXRenderer::Shading::BSDFs::GGX::alpha_from_roughness(roughness); // TODO The minimal alpha should be reduced, but that leads to bad fits on nearly specular surfaces.
-        auto average_sample = compute_average_sample(brdf, wo, alpha);
+    auto error_function = [&](int t, int r, float* params) -> float {
+        const Cell& cell = cells[t + r * size];
+        Pivot pivot = cell.initial_pivot;
+        set_pivot_parameters(pivot, params);
+        return compute_error(pivot, brdf, cell.wo, cell.alpha, cell.brdf_samples);
+    };
 
-        // init
-        Pivot& pivot = pivots[t + r * size];
-        pivot.distance = 0.5f + 0.49f * (1.0f - alpha);
-        pivot.theta = acos(average_sample.direction.z) * sign(average_sample.direction.x);
-        pivot.amplitude = average_sample.rho;
+    Math::TableFittingSettings settings;
+    settings.width = settings.height = size;
+    settings.simplex_size = 0.05f;
+    settings.tolerance = 1e-5f;
+    settings.max_iterations = 200;
+    settings.start_count = start_count;
 
-        // Fit
-        float epsilon = 0.05f;
-        fit(pivot, brdf, wo, alpha, epsilon);
+    std::vector<Math::TableFit<2>> fits(size * size);
+    auto report = Math::fit_table(settings, fits.data(), initial_guess, error_function);
 
-        // std::cout << "  [cos_theta: " << V.z << ", roughness: " << roughness << "]: Pivot: [theta: " << pivot.theta << ", distance: " << pivot.distance << ", rho: " << pivot.amplitude << "]" << std::endl;
+    // Update pivots with best fitting values.
+    for (int i = 0; i < size * size; ++i) {
+        pivots[i] = cells[i].initial_pivot;
+        set_pivot_parameters(pivots[i], fits[i].parameters);
     }
+
+    return report;
 }
 
 void output_fit_header(Pivot* pivots, unsigned int width, unsigned int height, const std::string& filename, const std::string& data_name, const std::string& description) {
@@ -286,24 +299,22 @@ void output_fit_image(Pivot* pivots, unsigned int width, unsigned int height, co
 }
 
 template <typename BRDF>
-void output_error(const Pivot* const pivots, BRDF brdf, int width, int height, const std::string& distribution_name) {
+void output_error(const Pivot* const pivots, BRDF brdf, int size, const std::string& distribution_name) {
     double error = 0.0;
-    for (int i = 0; i < width * height; ++i) {
-        int t = i % width, a = i / width;
-
-        float cos_theta = t / float(height - 1);
-        float theta = fminf(1.57f, acosf(cos_theta));
-        const float3 wo = make_float3(sinf(theta), 0, cosf(theta));
-
-        float roughness = a / float(width - 1);
-        float alpha = fmaxf(roughness * roughness, 0.001f); // OptiXRenderer::Shading::BSDFs::GGX::alpha_from_roughness(roughness); // TODO The minimal alpha should be reduced, but that leads to bad fits on nearly specular surfaces.
-
-        const Pivot& pivot = pivots[t + a * width];
-
-        error += compute_error(pivot, brdf, wo, alpha);
+    for (int i = 0; i < size * size; ++i) {
+        int t = i % size, r = i / size;
+        const float3 wo = wo_from_cell(t, size);
+        float alpha = alpha_from_cell(r, size);
+        error += compute_error(pivots[i], brdf, wo, alpha, sample_brdf(brdf, wo, alpha));
     }
 
-    std::cout << distribution_name << " error: " << error / (width * height) << std::endl;
+    std::cout << distribution_name << " error: " << error / (size * size) << std::endl;
+}
+
+void output_fitting_report(const Bifrost::Math::TableFittingReport& report, const std::string& distribution_name) {
+    std::cout << distribution_name << " fitting: " << report.seconds << " seconds, mean error: " << report.mean_error << ", max error: " << report.max_error <<
+        ", mean iterations: " << report.mean_iteration_count << ", mean error evaluations: " << report.mean_evaluation_count <<
+        ", unconverged cells: " << report.unconverged_cell_count << std::endl;
 }
 
 template <typename BRDF>
@@ -346,6 +357,10 @@ int main(int argc, char* argv[]) {
     std::string output_dir = argc >= 2 ? argv[1] : std::string(BIFROST_SHADING_DIR);
     printf("output_dir: %s\n", output_dir.c_str());
 
+    // Number of starting points refined pr cell. More starts are slower, but less likely to get stuck in local minima.
+    int start_count = argc >= 3 ? atoi(argv[2]) : 1;
+    printf("start_count: %i\n", start_count);
+
     Bifrost::Assets::Images::allocate(2);
 
     // size of precomputed table (theta, roughness)
@@ -356,12 +371,13 @@ int main(int argc, char* argv[]) {
 
     { // GGX
         BRDF::GGX brdf;
-        fit_pivot(pivots, size, brdf);
+        auto report = fit_pivot(pivots, size, brdf, start_count);
+        output_fitting_report(report, "GGX");
 
         output_fit_header(pivots, size, size, output_dir + "GGXSPTDFit.cpp", "GGX", "GGX fit for spherical pivot transformed distributions.");
         output_fit_image(pivots, size, size, output_dir + "GGXSPTDFit.png");
 
-        output_error(pivots, brdf, size, size, "GGX");
+        output_error(pivots, brdf, size, "GGX");
         output_gradient_error(pivots, brdf, size, size, "GGX");
     }
 
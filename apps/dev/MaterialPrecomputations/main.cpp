@@ -10,10 +10,9 @@
 #include <OptiXRenderer/Shading/BSDFs/GGX.h>
 #include <OptiXRenderer/Shading/BSDFs/OrenNayar.h>
 #include <OptiXRenderer/Shading/ShadingModels/DefaultShading.h>
-#include <OptiXRenderer/RNG.h>
 
 #include <Bifrost/Assets/Image.h>
-#include <Bifrost/Core/Array.h>
+#include <Bifrost/Assets/Shading/RhoTable.h>
 #include <Bifrost/Math/Utils.h>
 
 #include <StbImageWriter/StbImageWriter.h>
@@ -22,6 +21,7 @@
 
 using namespace Bifrost;
 using namespace Bifrost::Assets;
+using namespace Bifrost::Assets::Shading;
 using namespace optix;
 using namespace OptiXRenderer;
 using namespace OptiXRenderer::Shading::BSDFs;
@@ -29,41 +29,50 @@ using namespace OptiXRenderer::Shading::ShadingModels;
 
 typedef BSDFSample(*SampleRoughBSDF)(float3 tint, float roughness, float3 wo, float2 random_sample);
 
-double estimate_rho(float3 wo, float roughness, unsigned int sample_count, SampleRoughBSDF sample_rough_BSDF) {
+// Version of the binary rho tables. Bump when the BSDFs change to invalidate tables loaded at runtime.
+const unsigned int rho_table_version = 2;
+
+RhoTable::Settings rho_table_settings(unsigned int width, unsigned int height, unsigned int channel_count, unsigned int max_sample_count) {
+    RhoTable::Settings settings;
+    settings.angle_sample_count = width;
+    settings.roughness_sample_count = height;
+    settings.channel_count = channel_count;
+    settings.max_sample_count = max_sample_count;
+    settings.max_standard_error = 0.0002f;
+    return settings;
+}
 
+RhoTable estimate_rho(unsigned int width, unsigned int height, unsigned int sample_count, SampleRoughBSDF sample_rough_BSDF) {
     const float3 tint = make_float3(1.0f, 1.0f, 1.0f);
 
-    Core::Array<double> throughput = Core::Array<double>(sample_count);
-    for (unsigned int s = 0; s < sample_count; ++s) {
-        float2 rng_sample = RNG::sample02(s);
-        BSDFSample sample = sample_rough_BSDF(tint, roughness, wo, rng_sample);
-        if (is_PDF_valid(sample.PDF))
-            throughput[s] = sample.reflectance.x * sample.direction.z / sample.PDF;
-        else
-            throughput[s] = 0.0;
-    }
-
-    return Math::sort_and_pairwise_summation(throughput.begin(), throughput.end()) / sample_count;
+    return RhoTable::generate(rho_table_settings(width, height, 1, sample_count),
+        [=](float cos_theta, float roughness, unsigned int s, const Math::RNG::OwenScrambledSobol& sampler, float* throughputs) {
+            roughness = fmaxf(0.000001f, roughness);
+            float3 wo = make_float3(sqrt(1.0f - cos_theta * cos_theta), 0.0f, cos_theta);
+            BSDFSample sample = sample_rough_BSDF(tint, roughness, wo, make_float2(sampler.sample1f(s, 0), sampler.sample1f(s, 1)));
+            throughputs[0] = is_PDF_valid(sample.PDF) ? sample.reflectance.x * sample.direction.z / sample.PDF : 0.0f;
+        });
 }
 
-Image estimate_rho(unsigned int width, unsigned int height, unsigned int sample_count, SampleRoughBSDF sample_rough_BSDF) {
+// Converts the first two channels of the rho table to an image.
+Image to_image(const RhoTable& rho) {
+    unsigned int width = rho.get_angle_sample_count(), height = rho.get_roughness_sample_count();
+    unsigned int channel_count = rho.get_channel_count();
     Image rho_image = Images::create2D("rho", PixelFormat::RGB_Float, 1.0f, Math::Vector2ui(width, height));
     Math::RGB* rho_image_pixels = rho_image.get_pixels<Math::RGB>();
-    
-    for (int y = 0; y < int(height); ++y) {
-        float roughness = fmaxf(0.000001f, y / float(height - 1u));
-        #pragma omp parallel for
-        for (int x = 0; x < int(width); ++x) {
-            float cos_theta = (x + 0.5f) / float(width);
-            float3 wo = make_float3(sqrt(1.0f - cos_theta * cos_theta), 0.0f, cos_theta);
-            double rho = estimate_rho(wo, roughness, sample_count, sample_rough_BSDF);
-            rho_image_pixels[x + y * width] = Math::RGB(float(rho));
-        }
+    for (unsigned int i = 0; i < width * height; ++i) {
+        const float* entry_rho = rho.get_rho() + i * channel_count;
+        rho_image_pixels[i] = channel_count == 1 ? Math::RGB(entry_rho[0]) : Math::RGB(entry_rho[0], entry_rho[1], 0.0f);
     }
-
     return rho_image;
 }
 
+void store_rho(const RhoTable& rho, const std::string& output_dir, const std::string& filename) {
+    if (!rho.write(output_dir + filename + ".rho", rho_table_version))
+        printf("Could not write %s.rho\n", filename.c_str());
+    printf("%s max standard error: %f\n", filename.c_str(), rho.get_max_standard_error());
+}
+
 std::string format_float(float v) {
     std::ostringstream out;
     out << v;
@@ -324,60 +333,57 @@ int main(int argc, char** argv) {
         material_params.metallic = 0.0f;
         material_params.specularity = 0.0f;
 
-        Image rho = Images::create2D("rho", PixelFormat::RGB_Float, 1.0f, Math::Vector2ui(width, height));
-        Math::RGB* rho_pixels = rho.get_pixels<Math::RGB>();
-
-        for (int y = 0; y < int(height); ++y) {
-            material_params.roughness = y / float(height - 1u);
-            #pragma omp parallel for
-            for (int x = 0; x < int(width); ++x) {
-
-                float cos_theta = (x + 0.5f) / float(width);
+        // Estimate the total rho in the first channel and the specular rho in the second.
+        RhoTable rho_table = RhoTable::generate(rho_table_settings(width, height, 2, sample_count),
+            [=](float cos_theta, float roughness, unsigned int s, const Math::RNG::OwenScrambledSobol& sampler, float* throughputs) {
+                OptiXRenderer::Material sample_material_params = material_params;
+                sample_material_params.roughness = roughness;
                 float3 wo = make_float3(sqrt(1.0f - cos_theta * cos_theta), 0.0f, cos_theta);
-
-                DefaultShading material = DefaultShading(material_params, wo.z);
-
-                Core::Array<double> specular_throughput = Core::Array<double>(sample_count);
-                Core::Array<double> total_throughput = Core::Array<double>(sample_count);
-                for (unsigned int s = 0; s < sample_count; ++s) {
-
-                    float3 rng_sample = make_float3(RNG::sample02(s), float(s) / float(sample_count));
-                    BSDFSample sample = material.sample_all(wo, rng_sample);
-                    if (is_PDF_valid(sample.PDF)) {
-                        total_throughput[s] = sample.reflectance.x * sample.direction.z / sample.PDF;
-                        specular_throughput[s] = sample.reflectance.y * sample.direction.z / sample.PDF;
-                    } else
-                        total_throughput[s] = specular_throughput[s] = 0.0;
-                }
-
-                double specular_rho = Math::sort_and_pairwise_summation(specular_throughput.begin(), specular_throughput.end()) / sample_count;
-                double total_rho = Math::sort_and_pairwise_summation(total_throughput.begin(), total_throughput.end()) / sample_count;
-                double diffuse_rho = total_rho - specular_rho;
-                rho_pixels[x + y * width] = Math::RGB(float(diffuse_rho), float(specular_rho), 0.0f);
-            }
+                DefaultShading material = DefaultShading(sample_material_params, wo.z);
+
+                // The third dimension selects the lobe and is stratified in every batch, independently of the sample budget.
+                float3 rng_sample = make_float3(sampler.sample1f(s, 0), sampler.sample1f(s, 1), sampler.sample1f(s, 2));
+                BSDFSample sample = material.sample_all(wo, rng_sample);
+                bool valid_sample = is_PDF_valid(sample.PDF);
+                throughputs[0] = valid_sample ? sample.reflectance.x * sample.direction.z / sample.PDF : 0.0f;
+                throughputs[1] = valid_sample ? sample.reflectance.y * sample.direction.z / sample.PDF : 0.0f;
+            });
+
+        // Separate the diffuse and specular rho.
+        for (unsigned int i = 0; i < rho_table.get_entry_count(); ++i) {
+            float* entry_rho = rho_table.get_rho() + 2 * i;
+            entry_rho[0] -= entry_rho[1];
+            float* entry_standard_errors = rho_table.get_standard_errors() + 2 * i;
+            entry_standard_errors[0] = sqrt(entry_standard_errors[0] * entry_standard_errors[0] + entry_standard_errors[1] * entry_standard_errors[1]);
         }
+        Image rho = to_image(rho_table);
 
         // Store.
         StbImageWriter::write(rho, output_dir + "DefaultShadingRho.png");
+        store_rho(rho_table, output_dir, "DefaultShadingRho");
         output_brdf<2>(rho, sample_count, output_dir + "DefaultShadingRho.cpp", "default_shading",
             "Directional-hemispherical reflectance for default shaded material.");
     }
 
     { // Compute Burley rho.
 
-        Image rho = estimate_rho(width, height, sample_count, Burley::sample);
+        RhoTable rho_table = estimate_rho(width, height, sample_count, Burley::sample);
+        Image rho = to_image(rho_table);
 
         // Store.
         StbImageWriter::write(rho, output_dir + "BurleyRho.png");
+        store_rho(rho_table, output_dir, "BurleyRho");
         output_brdf<1>(rho, sample_count, output_dir + "BurleyRho.cpp", "burley", "Directional-hemispherical reflectance for Burley.");
     }
 
     { // Compute OrenNayar rho.
 
-        Image rho = estimate_rho(width, height, sample_count, OrenNayar::sample);
+        RhoTable rho_table = estimate_rho(width, height, sample_count, OrenNayar::sample);
+        Image rho = to_image(rho_table);
 
         // Store.
         StbImageWriter::write(rho, output_dir + "OrenNayarRho.png");
+        store_rho(rho_table, output_dir, "OrenNayarRho");
         output_brdf<1>(rho, sample_count, output_dir + "OrenNayarRho.cpp", "oren_nayar", "Directional-hemispherical reflectance for OrenNayar.");
     }
 
@@ -388,10 +394,12 @@ int main(int argc, char** argv) {
             return GGX::sample(alpha, 1, wo, random_sample);
         };
 
-        Image rho = estimate_rho(width, height, sample_count, sample_ggx);
+        RhoTable rho_table = estimate_rho(width, height, sample_count, sample_ggx);
+        Image rho = to_image(rho_table);
 
         // Store.
         StbImageWriter::write(rho, output_dir + "GGXRho.png");
+        store_rho(rho_table, output_dir, "GGXRho");
         output_brdf<1>(rho, sample_count, output_dir + "GGXRho.cpp", "GGX", "Directional-hemispherical reflectance for GGX.");
     }
 
@@ -402,10 +410,12 @@ int main(int argc, char** argv) {
             return GGX::sample(alpha, 0, wo, random_sample);
         };
 
-        Image rho = estimate_rho(width, height, sample_count, sample_ggx_with_fresnel);
+        RhoTable rho_table = estimate_rho(width, height, sample_count, sample_ggx_with_fresnel);
+        Image rho = to_image(rho_table);
 
         // Store.
         StbImageWriter::write(rho, output_dir + "GGXWithFresnelRho.png");
+        store_rho(rho_table, output_dir, "GGXWithFresnelRho");
         output_brdf<1>(rho, sample_count, output_dir + "GGXWithFresnelRho.cpp", "GGX_with_fresnel",
             "Directional-hemispherical reflectance for GGX with fresnel factor.");
     }
@@ -0,0 +1,59 @@
+// Optimizes screen space seed textures, such that the Monte Carlo error is distributed as blue noise.
+// A Low-Discrepancy Sampler that Distributes Monte Carlo Errors as a Blue Noise in Screen Space, Heitz et al., 2019.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Math/SeedTexture.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace Bifrost::Math::RNG;
+
+int main(int argc, char** argv) {
+    printf("Seed texture optimizer\n");
+
+    if (argc < 2) {
+        printf("usage: SeedTextureOptimizer <output_path> [size] [sample_count] [pass_count]\n");
+        return 1;
+    }
+
+    std::string output_path = argv[1];
+    SeedTexture::OptimizationSettings settings;
+    if (argc >= 3)
+        settings.width = settings.height = atoi(argv[2]);
+    if (argc >= 4)
+        settings.sample_count = atoi(argv[3]);
+    if (argc >= 5)
+        settings.pass_count = atoi(argv[4]);
+
+    printf("Optimizing %ux%u seeds for %u samples with %u passes on %d threads.\n", settings.width, settings.height, settings.sample_count,
+           settings.pass_count, Bifrost::Core::Parallel::get_thread_count());
+
+    SeedTexture::OptimizationReport report;
+    SeedTexture texture = SeedTexture::optimize(settings, &report);
+    if (!texture.is_valid())
+        return 1;
+
+    printf("Optimized in %.2f seconds with %u accepted swaps.\n", report.seconds, report.accepted_swap_count);
+    printf("  Energy: %f -> %f\n", report.initial_energy, report.energy);
+
+    // Compare against white noise seeds, i.e. the initial seeds.
+    settings.pass_count = 0;
+    SeedTexture white_noise_texture = SeedTexture::optimize(settings);
+    for (unsigned int sample_count = 1; sample_count <= settings.sample_count; sample_count *= 2)
+        printf("  %u spp filtered RMS error: white noise %f, optimized %f\n", sample_count,
+               SeedTexture::filtered_rms_error(white_noise_texture, sample_count), SeedTexture::filtered_rms_error(texture, sample_count));
+
+    if (!texture.write(output_path)) {
+        printf("Could not write seed texture to '%s'\n", output_path.c_str());
+        return 1;
+    }
+    printf("Seed texture written to '%s'\n", output_path.c_str());
+}
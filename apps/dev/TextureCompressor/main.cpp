@@ -0,0 +1,254 @@
+// Batch block compression of textures to DDS files.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#include <Bifrost/Assets/BlockCompression.h>
+#include <Bifrost/Core/Parallel.h>
+
+#include <StbImageLoader/StbImageLoader.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace Bifrost::Assets;
+using namespace Bifrost::Math;
+
+// ------------------------------------------------------------------------------------------------
+// DDS output.
+// ------------------------------------------------------------------------------------------------
+
+// Writes the blocks of all mipmap levels to a DDS file with a FourCC pixel format.
+// BC6H and BC7 have no FourCC and are described by the DX10 header extension instead.
+// DDS stores the top row first, so the image is expected to be flipped vertically.
+bool write_DDS(const std::string& path, Image image) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    const unsigned int DXGI_FORMAT_BC6H_UF16 = 95, DXGI_FORMAT_BC7_UNORM = 98, DXGI_FORMAT_BC7_UNORM_SRGB = 99;
+    const char* four_CC;
+    unsigned int DXGI_format = 0;
+    switch (image.get_pixel_format()) {
+    case PixelFormat::BC1_RGB: four_CC = "DXT1"; break;
+    case PixelFormat::BC4_Intensity: four_CC = "ATI1"; break;
+    case PixelFormat::BC5_RG: four_CC = "ATI2"; break;
+    case PixelFormat::BC6H_RGB: four_CC = "DX10"; DXGI_format = DXGI_FORMAT_BC6H_UF16; break;
+    case PixelFormat::BC7_RGBA:
+        // Linear images, e.g. normal maps and masks, must not be decoded as sRGB.
+        four_CC = "DX10";
+        DXGI_format = image.get_gamma() == 1.0f ? DXGI_FORMAT_BC7_UNORM : DXGI_FORMAT_BC7_UNORM_SRGB;
+        break;
+    default: return false;
+    }
+
+    const unsigned int DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000;
+    const unsigned int DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+    const unsigned int DDPF_FOURCC = 0x4;
+    const unsigned int DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+
+    unsigned int mipmap_count = image.get_mipmap_count();
+    bool has_mipmaps = mipmap_count > 1;
+
+    // The 124 byte header following the magic number, with the 32 byte pixel format at dword 18.
+    unsigned int header[31] = {};
+    header[0] = 124;
+    header[1] = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE | (has_mipmaps ? DDSD_MIPMAPCOUNT : 0);
+    header[2] = image.get_height();
+    header[3] = image.get_width();
+    header[4] = image.get_pixel_data_size(0);
+    header[6] = mipmap_count;
+    header[18] = 32;
+    header[19] = DDPF_FOURCC;
+    memcpy(header + 20, four_CC, 4);
+    header[26] = DDSCAPS_TEXTURE | (has_mipmaps ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+    file.write("DDS ", 4);
+    file.write((const char*)header, sizeof(header));
+    if (DXGI_format != 0) {
+        // The DX10 header: DXGI format, 2D texture resource dimension, misc flags, array size and alpha mode.
+        const unsigned int D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+        unsigned int DX10_header[5] = { DXGI_format, D3D10_RESOURCE_DIMENSION_TEXTURE2D, 0, 1, 0 };
+        file.write((const char*)DX10_header, sizeof(DX10_header));
+    }
+    for (unsigned int m = 0; m < mipmap_count; ++m)
+        file.write((const char*)image.get_pixels(m), image.get_pixel_data_size(m));
+    return file.good();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Compression.
+// ------------------------------------------------------------------------------------------------
+
+// Peak signal to noise ratio of the gamma encoded colors in the first mipmap level.
+float compute_PSNR(Image reference_image, Image compressed_image) {
+    int channel_count = Bifrost::Assets::channel_count(compressed_image.get_pixel_format());
+    float inverse_gamma = 1.0f / reference_image.get_gamma();
+    double summed_squared_error = 0.0;
+    for (unsigned int p = 0; p < reference_image.get_pixel_count(); ++p) {
+        RGBA reference = gammacorrect(reference_image.get_pixel(p), inverse_gamma);
+        RGBA compressed = gammacorrect(compressed_image.get_pixel(p), inverse_gamma);
+        for (int c = 0; c < channel_count; ++c) {
+            double error = 255.0 * (reference[c] - compressed[c]);
+            summed_squared_error += error * error;
+        }
+    }
+    double mean_squared_error = summed_squared_error / (reference_image.get_pixel_count() * channel_count);
+    if (mean_squared_error == 0.0)
+        return INFINITY;
+    return float(10.0 * log10(255.0 * 255.0 / mean_squared_error));
+}
+
+// Copies the first mipmap level into a vertically flipped image with room for the mipmap chain.
+Image create_flipped_image(Image image, bool generate_mipmaps) {
+    unsigned int width = image.get_width(), height = image.get_height();
+    unsigned int mipmap_count = generate_mipmaps ? unsigned int(log2(float(max(width, height)))) + 1 : 1;
+    Image flipped_image = Images::create2D(image.get_name(), image.get_pixel_format(), image.get_gamma(), Vector2ui(width, height), mipmap_count);
+
+    unsigned int row_size = width * size_of(image.get_pixel_format());
+    unsigned char* pixels = (unsigned char*)image.get_pixels();
+    unsigned char* flipped_pixels = (unsigned char*)flipped_image.get_pixels();
+    for (unsigned int y = 0; y < height; ++y)
+        memcpy(flipped_pixels + (height - 1 - y) * row_size, pixels + y * row_size, row_size);
+
+    if (generate_mipmaps)
+        ImageUtils::fill_mipmap_chain(flipped_image.get_ID());
+    return flipped_image;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Options
+// ------------------------------------------------------------------------------------------------
+
+struct Options {
+    PixelFormat format = PixelFormat::BC1_RGB;
+    BlockCompression::Quality quality = BlockCompression::Quality::Normal;
+    bool generate_mipmaps = false;
+    int thread_count = 0;
+    std::string output_directory;
+    std::vector<std::string> image_paths;
+
+    static Options parse(int argc, char** argv) {
+        char** argument_end = argv + argc;
+        Options res;
+        for (char** argument = argv + 1; argument < argument_end; ++argument) {
+            if (strcmp(*argument, "--bc1") == 0)
+                res.format = PixelFormat::BC1_RGB;
+            else if (strcmp(*argument, "--bc4") == 0)
+                res.format = PixelFormat::BC4_Intensity;
+            else if (strcmp(*argument, "--bc5") == 0)
+                res.format = PixelFormat::BC5_RG;
+            else if (strcmp(*argument, "--bc6h") == 0)
+                res.format = PixelFormat::BC6H_RGB;
+            else if (strcmp(*argument, "--bc7") == 0)
+                res.format = PixelFormat::BC7_RGBA;
+            else if (strcmp(*argument, "--fast") == 0)
+                res.quality = BlockCompression::Quality::Fast;
+            else if (strcmp(*argument, "--normal") == 0)
+                res.quality = BlockCompression::Quality::Normal;
+            else if (strcmp(*argument, "--high") == 0)
+                res.quality = BlockCompression::Quality::High;
+            else if (strcmp(*argument, "-m") == 0 || strcmp(*argument, "--mipmaps") == 0)
+                res.generate_mipmaps = true;
+            else if ((strcmp(*argument, "-t") == 0 || strcmp(*argument, "--threads") == 0) && argument + 1 < argument_end)
+                res.thread_count = atoi(*(++argument));
+            else if ((strcmp(*argument, "-o") == 0 || strcmp(*argument, "--output") == 0) && argument + 1 < argument_end)
+                res.output_directory = *(++argument);
+            else if ((*argument)[0] == '-')
+                printf("Unsupported argument: '%s'\n", *argument);
+            else
+                res.image_paths.push_back(*argument);
+        }
+        return res;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+// Main
+// ------------------------------------------------------------------------------------------------
+
+void print_usage() {
+    char* usage =
+        "usage TextureCompressor [options] <path/to/image.ext>...\n"
+        "  -h | --help: Show command line usage.\n"
+        "     | --bc1: Compress the RGB channels to BC1. Default.\n"
+        "     | --bc4: Compress the red channel, or alpha of alpha images, to BC4.\n"
+        "     | --bc5: Compress the red and green channels to BC5.\n"
+        "     | --bc6h: Compress the RGB channels of HDR images to BC6H.\n"
+        "     | --bc7: Compress the RGBA channels to BC7.\n"
+        "     | --fast: Fast compression.\n"
+        "     | --normal: Normal quality compression. Default.\n"
+        "     | --high: High quality compression.\n"
+        "  -m | --mipmaps: Generate and compress the full mipmap chain.\n"
+        "  -t | --threads: The number of threads used for compression. Defaults to all hardware threads.\n"
+        "  -o | --output: Output directory. Defaults to the directory of the image.\n";
+    printf("%s", usage);
+}
+
+int main(int argc, char** argv) {
+    printf("Texture compressor\n");
+
+    if (argc == 1 || strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0) {
+        print_usage();
+        return 0;
+    }
+
+    auto options = Options::parse(argc, argv);
+    if (options.thread_count > 0)
+        Bifrost::Core::Parallel::set_thread_count(options.thread_count);
+
+    Images::allocate(4);
+
+    int failure_count = 0;
+    for (const std::string& image_path : options.image_paths) {
+        Image image = StbImageLoader::load(image_path);
+        if (!image.exists()) {
+            printf("Could not load '%s'\n", image_path.c_str());
+            ++failure_count;
+            continue;
+        }
+
+        bool is_HDR = is_float_format(image.get_pixel_format()) || is_half_format(image.get_pixel_format());
+        if (is_HDR && options.format != PixelFormat::BC6H_RGB)
+            printf("Warning: '%s' is an HDR image and is clamped to [0, 1] when compressed. Use --bc6h to preserve HDR.\n", image_path.c_str());
+
+        Image source_image = create_flipped_image(image, options.generate_mipmaps);
+        Images::destroy(image.get_ID());
+
+        auto start_time = std::chrono::system_clock::now();
+        Image compressed_image = BlockCompression::compress(source_image.get_ID(), options.format, options.quality);
+        auto end_time = std::chrono::system_clock::now();
+        float delta_milliseconds = (float)std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+        unsigned int source_size = 0, compressed_size = 0;
+        for (unsigned int m = 0; m < source_image.get_mipmap_count(); ++m) {
+            source_size += source_image.get_pixel_data_size(m);
+            compressed_size += compressed_image.get_pixel_data_size(m);
+        }
+
+        std::filesystem::path output_path = image_path;
+        output_path.replace_extension(".dds");
+        if (!options.output_directory.empty())
+            output_path = std::filesystem::path(options.output_directory) / output_path.filename();
+
+        printf("%s: %ux%u with %u mipmaps compressed %.1fx in %.3f seconds. PSNR %.2fdB.\n", output_path.string().c_str(),
+               source_image.get_width(), source_image.get_height(), source_image.get_mipmap_count(),
+               source_size / float(compressed_size), delta_milliseconds / 1000, compute_PSNR(source_image, compressed_image));
+
+        if (!write_DDS(output_path.string(), compressed_image)) {
+            printf("Could not write '%s'\n", output_path.string().c_str());
+            ++failure_count;
+        }
+
+        Images::destroy(source_image.get_ID());
+        Images::destroy(compressed_image.get_ID());
+    }
+
+    return failure_count == 0 ? 0 : 1;
+}
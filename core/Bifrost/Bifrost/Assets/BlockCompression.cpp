@@ -0,0 +1,1658 @@
+// Bifrost block compression of images.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#include <Bifrost/Assets/BlockCompression.h>
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Core/Profiler.h>
+#include <Bifrost/Math/HalfFloat.h>
+
+#include <algorithm>
+#include <assert.h>
+#include <climits>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BIFROST_BLOCK_COMPRESSION_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace Bifrost::Math;
+
+namespace Bifrost {
+namespace Assets {
+namespace BlockCompression {
+
+static const int texel_count = 16;
+
+// ------------------------------------------------------------------------------------------------
+// BC1.
+// ------------------------------------------------------------------------------------------------
+
+inline unsigned short to_RGB565(Vector3f color) {
+    int r = clamp(int(color.x * (31.0f / 255.0f) + 0.5f), 0, 31);
+    int g = clamp(int(color.y * (63.0f / 255.0f) + 0.5f), 0, 63);
+    int b = clamp(int(color.z * (31.0f / 255.0f) + 0.5f), 0, 31);
+    return (unsigned short)((r << 11) | (g << 5) | b);
+}
+
+inline Vector3i from_RGB565(unsigned short color) {
+    int r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+    return Vector3i((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+}
+
+// The opaque four color palette of the endpoints. Requires color0 > color1.
+inline void BC1_palette(unsigned short color0, unsigned short color1, Vector3i palette[4]) {
+    palette[0] = from_RGB565(color0);
+    palette[1] = from_RGB565(color1);
+    palette[2] = (palette[0] * 2 + palette[1] + 1) / 3;
+    palette[3] = (palette[0] + palette[1] * 2 + 1) / 3;
+}
+
+// The texels of a block in structure of arrays layout.
+struct BC1Texels {
+    float r[texel_count], g[texel_count], b[texel_count];
+
+    inline Vector3f get(int t) const { return Vector3f(r[t], g[t], b[t]); }
+};
+
+// Selects the palette entry closest to each texel and returns the summed squared error.
+static float select_BC1_indices(const BC1Texels& texels, const Vector3i palette[4], unsigned char indices[16]) {
+#ifdef BIFROST_BLOCK_COMPRESSION_SSE2
+    // Four texels at a time.
+    __m128 summed_error = _mm_setzero_ps();
+    for (int t = 0; t < texel_count; t += 4) {
+        __m128 r = _mm_loadu_ps(texels.r + t), g = _mm_loadu_ps(texels.g + t), b = _mm_loadu_ps(texels.b + t);
+        __m128 best_distance = _mm_set1_ps(1e30f);
+        __m128i best_index = _mm_setzero_si128();
+        for (int p = 0; p < 4; ++p) {
+            __m128 dr = _mm_sub_ps(r, _mm_set1_ps(float(palette[p].x)));
+            __m128 dg = _mm_sub_ps(g, _mm_set1_ps(float(palette[p].y)));
+            __m128 db = _mm_sub_ps(b, _mm_set1_ps(float(palette[p].z)));
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+            __m128i is_closer = _mm_castps_si128(_mm_cmplt_ps(distance, best_distance));
+            best_index = _mm_or_si128(_mm_and_si128(is_closer, _mm_set1_epi32(p)), _mm_andnot_si128(is_closer, best_index));
+            best_distance = _mm_min_ps(distance, best_distance);
+        }
+        summed_error = _mm_add_ps(summed_error, best_distance);
+
+        int best_indices[4];
+        _mm_storeu_si128((__m128i*)best_indices, best_index);
+        for (int i = 0; i < 4; ++i)
+            indices[t + i] = (unsigned char)best_indices[i];
+    }
+    float errors[4];
+    _mm_storeu_ps(errors, summed_error);
+    return (errors[0] + errors[1]) + (errors[2] + errors[3]);
+#else
+    float summed_error = 0.0f;
+    for (int t = 0; t < texel_count; ++t) {
+        float best_distance = 1e30f;
+        for (int p = 0; p < 4; ++p) {
+            Vector3f delta = texels.get(t) - Vector3f(float(palette[p].x), float(palette[p].y), float(palette[p].z));
+            float distance = dot(delta, delta);
+            if (distance < best_distance) {
+                best_distance = distance;
+                indices[t] = (unsigned char)p;
+            }
+        }
+        summed_error += best_distance;
+    }
+    return summed_error;
+#endif
+}
+
+struct BC1Block {
+    unsigned short color0, color1;
+    unsigned char indices[16];
+    float error;
+};
+
+// Quantizes the endpoints and selects the texel indices.
+static BC1Block evaluate_BC1_endpoints(const BC1Texels& texels, Vector3f endpoint0, Vector3f endpoint1) {
+    BC1Block block;
+    block.color0 = to_RGB565(endpoint0);
+    block.color1 = to_RGB565(endpoint1);
+    if (block.color0 < block.color1)
+        std::swap(block.color0, block.color1);
+
+    if (block.color0 == block.color1) {
+        // Degenerate endpoints. Every texel uses the first endpoint.
+        Vector3i color = from_RGB565(block.color0);
+        Vector3f colorf = Vector3f(float(color.x), float(color.y), float(color.z));
+        block.error = 0.0f;
+        for (int t = 0; t < texel_count; ++t) {
+            block.indices[t] = 0;
+            Vector3f delta = texels.get(t) - colorf;
+            block.error += dot(delta, delta);
+        }
+        return block;
+    }
+
+    Vector3i palette[4];
+    BC1_palette(block.color0, block.color1, palette);
+    block.error = select_BC1_indices(texels, palette, block.indices);
+    return block;
+}
+
+// Computes the endpoints that minimize the squared error given the texel indices.
+static bool least_squares_BC1_endpoints(const BC1Texels& texels, const BC1Block& block, Vector3f& endpoint0, Vector3f& endpoint1) {
+    static const float endpoint0_weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+    float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+    Vector3f ax = Vector3f::zero(), bx = Vector3f::zero();
+    for (int t = 0; t < texel_count; ++t) {
+        float a = endpoint0_weights[block.indices[t]], b = 1.0f - a;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        ax += texels.get(t) * a;
+        bx += texels.get(t) * b;
+    }
+
+    float determinant = aa * bb - ab * ab;
+    if (abs(determinant) < 1e-6f)
+        return false;
+
+    float inv_determinant = 1.0f / determinant;
+    endpoint0 = clamp((ax * bb - bx * ab) * inv_determinant, Vector3f::zero(), Vector3f(255.0f));
+    endpoint1 = clamp((bx * aa - ax * ab) * inv_determinant, Vector3f::zero(), Vector3f(255.0f));
+    return true;
+}
+
+static void bounding_box_BC1_endpoints(const BC1Texels& texels, Vector3f& endpoint0, Vector3f& endpoint1) {
+    Vector3f min_color = texels.get(0), max_color = texels.get(0);
+    Vector3f mean = Vector3f::zero();
+    for (int t = 0; t < texel_count; ++t) {
+        min_color = min(min_color, texels.get(t));
+        max_color = max(max_color, texels.get(t));
+        mean += texels.get(t);
+    }
+    mean /= float(texel_count);
+
+    // Pick the box diagonal that follows the correlation of red and blue with green.
+    float red_green_covariance = 0.0f, blue_green_covariance = 0.0f;
+    for (int t = 0; t < texel_count; ++t) {
+        Vector3f delta = texels.get(t) - mean;
+        red_green_covariance += delta.x * delta.y;
+        blue_green_covariance += delta.z * delta.y;
+    }
+    if (red_green_covariance < 0.0f)
+        std::swap(min_color.x, max_color.x);
+    if (blue_green_covariance < 0.0f)
+        std::swap(min_color.z, max_color.z);
+
+    // Inset the endpoints slightly, as the extreme texels are rarely all on the diagonal.
+    Vector3f inset = (max_color - min_color) / 16.0f;
+    endpoint0 = max_color - inset;
+    endpoint1 = min_color + inset;
+}
+
+static void principal_axis_BC1_endpoints(const BC1Texels& texels, Vector3f& endpoint0, Vector3f& endpoint1) {
+    Vector3f mean = Vector3f::zero();
+    for (int t = 0; t < texel_count; ++t)
+        mean += texels.get(t);
+    mean /= float(texel_count);
+
+    // Symmetric covariance matrix, [xx, xy, xz, yy, yz, zz].
+    float covariance[6] = {};
+    for (int t = 0; t < texel_count; ++t) {
+        Vector3f delta = texels.get(t) - mean;
+        covariance[0] += delta.x * delta.x; covariance[1] += delta.x * delta.y; covariance[2] += delta.x * delta.z;
+        covariance[3] += delta.y * delta.y; covariance[4] += delta.y * delta.z; covariance[5] += delta.z * delta.z;
+    }
+
+    // Power iteration starting from the bounding box diagonal.
+    Vector3f box_endpoint0, box_endpoint1;
+    bounding_box_BC1_endpoints(texels, box_endpoint0, box_endpoint1);
+    Vector3f axis = box_endpoint0 - box_endpoint1;
+    if (dot(axis, axis) < 1e-6f)
+        axis = Vector3f(1.0f);
+    for (int i = 0; i < 8; ++i) {
+        axis = Vector3f(covariance[0] * axis.x + covariance[1] * axis.y + covariance[2] * axis.z,
+                        covariance[1] * axis.x + covariance[3] * axis.y + covariance[4] * axis.z,
+                        covariance[2] * axis.x + covariance[4] * axis.y + covariance[5] * axis.z);
+        float axis_length_squared = dot(axis, axis);
+        if (axis_length_squared < 1e-12f) {
+            // All texels are identical.
+            endpoint0 = endpoint1 = mean;
+            return;
+        }
+        axis /= sqrt(axis_length_squared);
+    }
+
+    float min_t = 1e30f, max_t = -1e30f;
+    for (int t = 0; t < texel_count; ++t) {
+        float projection = dot(texels.get(t) - mean, axis);
+        min_t = min(min_t, projection);
+        max_t = max(max_t, projection);
+    }
+    endpoint0 = clamp(mean + axis * max_t, Vector3f::zero(), Vector3f(255.0f));
+    endpoint1 = clamp(mean + axis * min_t, Vector3f::zero(), Vector3f(255.0f));
+}
+
+void encode_BC1(const RGBA32 texels[16], unsigned char block[8], Quality quality) {
+    BC1Texels soa_texels;
+    for (int t = 0; t < texel_count; ++t) {
+        soa_texels.r[t] = texels[t].r;
+        soa_texels.g[t] = texels[t].g;
+        soa_texels.b[t] = texels[t].b;
+    }
+
+    Vector3f endpoint0, endpoint1;
+    BC1Block best_block;
+    if (quality == Quality::Fast) {
+        bounding_box_BC1_endpoints(soa_texels, endpoint0, endpoint1);
+        best_block = evaluate_BC1_endpoints(soa_texels, endpoint0, endpoint1);
+    } else {
+        principal_axis_BC1_endpoints(soa_texels, endpoint0, endpoint1);
+        best_block = evaluate_BC1_endpoints(soa_texels, endpoint0, endpoint1);
+
+        if (quality == Quality::High) {
+            bounding_box_BC1_endpoints(soa_texels, endpoint0, endpoint1);
+            BC1Block box_block = evaluate_BC1_endpoints(soa_texels, endpoint0, endpoint1);
+            if (box_block.error < best_block.error)
+                best_block = box_block;
+        }
+
+        // Refine the endpoints while the error decreases.
+        int refinement_count = quality == Quality::High ? 8 : 1;
+        for (int i = 0; i < refinement_count && best_block.error > 0.0f; ++i) {
+            if (!least_squares_BC1_endpoints(soa_texels, best_block, endpoint0, endpoint1))
+                break;
+            BC1Block refined_block = evaluate_BC1_endpoints(soa_texels, endpoint0, endpoint1);
+            if (refined_block.error >= best_block.error)
+                break;
+            best_block = refined_block;
+        }
+    }
+
+    block[0] = (unsigned char)(best_block.color0 & 0xFF);
+    block[1] = (unsigned char)(best_block.color0 >> 8);
+    block[2] = (unsigned char)(best_block.color1 & 0xFF);
+    block[3] = (unsigned char)(best_block.color1 >> 8);
+    unsigned int indices = 0;
+    for (int t = 0; t < texel_count; ++t)
+        indices |= best_block.indices[t] << (2 * t);
+    for (int i = 0; i < 4; ++i)
+        block[4 + i] = (unsigned char)(indices >> (8 * i));
+}
+
+inline RGBA32 decode_BC1_texel(const unsigned char block[8], int texel) {
+    unsigned short color0 = (unsigned short)(block[0] | (block[1] << 8));
+    unsigned short color1 = (unsigned short)(block[2] | (block[3] << 8));
+    int index = (block[4 + texel / 4] >> (2 * (texel % 4))) & 3;
+
+    Vector3i color;
+    if (color0 > color1) {
+        Vector3i palette[4];
+        BC1_palette(color0, color1, palette);
+        color = palette[index];
+    } else {
+        // Three color mode. The fourth color is transparent black, which is decoded as black, as the format is opaque.
+        Vector3i c0 = from_RGB565(color0), c1 = from_RGB565(color1);
+        Vector3i palette[4] = { c0, c1, (c0 + c1) / 2, Vector3i::zero() };
+        color = palette[index];
+    }
+    return { (unsigned char)color.x, (unsigned char)color.y, (unsigned char)color.z, 255 };
+}
+
+void decode_BC1(const unsigned char block[8], RGBA32 texels[16]) {
+    for (int t = 0; t < texel_count; ++t)
+        texels[t] = decode_BC1_texel(block, t);
+}
+
+// ------------------------------------------------------------------------------------------------
+// BC4 and BC5.
+// ------------------------------------------------------------------------------------------------
+
+// Eight value palette if value0 > value1, otherwise six values plus 0 and 255.
+inline void BC4_palette(int value0, int value1, int palette[8]) {
+    palette[0] = value0;
+    palette[1] = value1;
+    if (value0 > value1) {
+        for (int i = 1; i < 7; ++i)
+            palette[i + 1] = ((7 - i) * value0 + i * value1 + 3) / 7;
+    } else {
+        for (int i = 1; i < 5; ++i)
+            palette[i + 1] = ((5 - i) * value0 + i * value1 + 2) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+struct BC4Block {
+    unsigned char value0, value1;
+    unsigned char indices[16];
+    int error;
+};
+
+static BC4Block evaluate_BC4_endpoints(const unsigned char values[16], int value0, int value1) {
+    BC4Block block;
+    block.value0 = (unsigned char)value0;
+    block.value1 = (unsigned char)value1;
+    int palette[8];
+    BC4_palette(value0, value1, palette);
+
+    block.error = 0;
+    for (int t = 0; t < texel_count; ++t) {
+        int best_distance = INT_MAX;
+        for (int p = 0; p < 8; ++p) {
+            int distance = (values[t] - palette[p]) * (values[t] - palette[p]);
+            if (distance < best_distance) {
+                best_distance = distance;
+                block.indices[t] = (unsigned char)p;
+            }
+        }
+        block.error += best_distance;
+    }
+    return block;
+}
+
+void encode_BC4(const unsigned char values[16], unsigned char block[8], Quality quality) {
+    int min_value = 255, max_value = 0;
+    int min_inner_value = 255, max_inner_value = 0; // Extremes excluding 0 and 255.
+    for (int t = 0; t < texel_count; ++t) {
+        min_value = min(min_value, int(values[t]));
+        max_value = max(max_value, int(values[t]));
+        if (0 < values[t] && values[t] < 255) {
+            min_inner_value = min(min_inner_value, int(values[t]));
+            max_inner_value = max(max_inner_value, int(values[t]));
+        }
+    }
+
+    BC4Block best_block;
+    if (min_value == max_value)
+        // Constant block. Six value mode where every texel uses the first endpoint.
+        best_block = evaluate_BC4_endpoints(values, min_value, max_value);
+    else {
+        best_block = evaluate_BC4_endpoints(values, max_value, min_value);
+
+        if (quality != Quality::Fast) {
+            // Six value mode represents 0 and 255 exactly and spends the interpolated values on the remaining texels.
+            bool has_extremes = min_value == 0 || max_value == 255;
+            if (has_extremes && min_inner_value <= max_inner_value) {
+                BC4Block six_value_block = evaluate_BC4_endpoints(values, min_inner_value, max_inner_value);
+                if (six_value_block.error < best_block.error)
+                    best_block = six_value_block;
+            }
+        }
+
+        if (quality == Quality::High) {
+            // Search the endpoints around the extremes.
+            for (int d0 = -4; d0 <= 4; ++d0)
+                for (int d1 = -4; d1 <= 4; ++d1) {
+                    int value0 = clamp(max_value + d0, 0, 255), value1 = clamp(min_value + d1, 0, 255);
+                    if (value0 <= value1)
+                        continue;
+                    BC4Block candidate_block = evaluate_BC4_endpoints(values, value0, value1);
+                    if (candidate_block.error < best_block.error)
+                        best_block = candidate_block;
+                }
+        }
+    }
+
+    block[0] = best_block.value0;
+    block[1] = best_block.value1;
+    unsigned long long indices = 0;
+    for (int t = 0; t < texel_count; ++t)
+        indices |= (unsigned long long)best_block.indices[t] << (3 * t);
+    for (int i = 0; i < 6; ++i)
+        block[2 + i] = (unsigned char)(indices >> (8 * i));
+}
+
+inline unsigned char decode_BC4_texel(const unsigned char block[8], int texel) {
+    int bit = 3 * texel;
+    int byte = 2 + bit / 8;
+    int shifted_bits = block[byte] | (byte + 1 < 8 ? block[byte + 1] << 8 : 0);
+    int index = (shifted_bits >> (bit % 8)) & 7;
+
+    int palette[8];
+    BC4_palette(block[0], block[1], palette);
+    return (unsigned char)palette[index];
+}
+
+void decode_BC4(const unsigned char block[8], unsigned char values[16]) {
+    for (int t = 0; t < texel_count; ++t)
+        values[t] = decode_BC4_texel(block, t);
+}
+
+void encode_BC5(const unsigned char reds[16], const unsigned char greens[16], unsigned char block[16], Quality quality) {
+    encode_BC4(reds, block, quality);
+    encode_BC4(greens, block + 8, quality);
+}
+
+void decode_BC5(const unsigned char block[16], unsigned char reds[16], unsigned char greens[16]) {
+    decode_BC4(block, reds);
+    decode_BC4(block + 8, greens);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Partitions, bit streams and endpoint fitting shared by BC6H and BC7.
+// ------------------------------------------------------------------------------------------------
+
+// Subset of each texel in the two subset partitions. Bit t holds the subset of texel t.
+static const unsigned short two_subset_partitions[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+};
+
+// Subset of each texel in the three subset partitions.
+static const unsigned char three_subset_partitions[64][16] = {
+    { 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 },
+    { 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+    { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 },
+    { 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 },
+    { 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 },
+    { 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 },
+    { 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 },
+    { 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+    { 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 },
+    { 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 },
+    { 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 },
+    { 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+    { 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 },
+    { 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 },
+    { 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 },
+    { 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 },
+    { 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 },
+    { 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 },
+    { 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 },
+    { 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 },
+    { 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 },
+    { 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 },
+    { 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+    { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 },
+    { 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 },
+    { 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 },
+    { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 },
+    { 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 },
+    { 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 },
+    { 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 },
+    { 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 },
+    { 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 },
+    { 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 },
+    { 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 },
+    { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 },
+    { 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 },
+    { 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 },
+    { 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 },
+    { 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 },
+    { 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 },
+    { 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 },
+    { 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 },
+    { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+    { 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 },
+    { 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 },
+    { 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 },
+    { 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 },
+    { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 }
+};
+
+// Anchor texel of the second subset in the two subset partitions. Texel 0 is always the anchor of the first subset.
+static const unsigned char two_subset_anchors[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+};
+
+// Anchor texels of the second and third subset in the three subset partitions.
+static const unsigned char three_subset_anchors[64][2] = {
+    {  3, 15 }, {  3,  8 }, { 15,  8 }, { 15,  3 }, {  8, 15 }, {  3, 15 }, { 15,  3 }, { 15,  8 },
+    {  8, 15 }, {  8, 15 }, {  6, 15 }, {  6, 15 }, {  6, 15 }, {  5, 15 }, {  3, 15 }, {  3,  8 },
+    {  3, 15 }, {  3,  8 }, {  8, 15 }, { 15,  3 }, {  3, 15 }, {  3,  8 }, {  6, 15 }, { 10,  8 },
+    {  5,  3 }, {  8, 15 }, {  8,  6 }, {  6, 10 }, {  8, 15 }, {  5, 15 }, { 15, 10 }, { 15,  8 },
+    {  8, 15 }, { 15,  3 }, {  3, 15 }, {  5, 10 }, {  6, 10 }, { 10,  8 }, {  8,  9 }, { 15, 10 },
+    { 15,  6 }, {  3, 15 }, { 15,  8 }, {  5, 15 }, { 15,  3 }, { 15,  6 }, { 15,  6 }, { 15,  8 },
+    {  3, 15 }, { 15,  3 }, {  5, 15 }, {  5, 15 }, {  5, 15 }, {  8, 15 }, {  5, 15 }, { 10, 15 },
+    {  5, 15 }, { 10, 15 }, {  8, 15 }, { 13, 15 }, { 15,  3 }, { 12, 15 }, {  3, 15 }, {  3,  8 }
+};
+
+inline int subset_of(int subset_count, int partition, int texel) {
+    if (subset_count == 2)
+        return (two_subset_partitions[partition] >> texel) & 1;
+    if (subset_count == 3)
+        return three_subset_partitions[partition][texel];
+    return 0;
+}
+
+inline int anchor_of(int subset_count, int partition, int subset) {
+    if (subset == 0)
+        return 0;
+    return subset_count == 2 ? two_subset_anchors[partition] : three_subset_anchors[partition][subset - 1];
+}
+
+// The index of an anchor texel is stored without its most significant bit, which is always zero.
+inline bool is_anchor(int subset_count, int partition, int texel) {
+    for (int s = 0; s < subset_count; ++s)
+        if (anchor_of(subset_count, partition, s) == texel)
+            return true;
+    return false;
+}
+
+// Interpolation weights in 64ths for 2, 3 and 4 bit indices.
+static const int index_weights2[4] = { 0, 21, 43, 64 };
+static const int index_weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const int index_weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+inline const int* index_weights(int index_bits) {
+    return index_bits == 2 ? index_weights2 : (index_bits == 3 ? index_weights3 : index_weights4);
+}
+
+inline int interpolate(int value0, int value1, int weight) {
+    return ((64 - weight) * value0 + weight * value1 + 32) >> 6;
+}
+
+// Reads the bits of a 128 bit block, starting with the least significant bit of the first byte.
+struct BlockReader {
+    const unsigned char* block;
+    int position;
+
+    inline int read(int bit_count) {
+        int value = 0;
+        for (int b = 0; b < bit_count; ++b, ++position)
+            value |= ((block[position >> 3] >> (position & 7)) & 1) << b;
+        return value;
+    }
+};
+
+// Writes the bits of a zero initialized 128 bit block in the order that BlockReader reads them.
+struct BlockWriter {
+    unsigned char* block;
+    int position;
+
+    inline void write(int value, int bit_count) {
+        for (int b = 0; b < bit_count; ++b, ++position)
+            block[position >> 3] |= (unsigned char)(((value >> b) & 1) << (position & 7));
+    }
+};
+
+// Texels with up to four channels. BC7 stores RGBA in [0, 255] and BC6H stores RGB in the 16 bit interpolation domain.
+typedef float BlockTexels[16][4];
+
+struct SubsetStatistics {
+    float mean[4];
+    float covariance[4][4];
+    int texel_count;
+};
+
+static SubsetStatistics subset_statistics(const BlockTexels& texels, const unsigned char subsets[16], int subset, int first_channel, int channel_count) {
+    int channel_end = first_channel + channel_count;
+    SubsetStatistics statistics = {};
+    for (int t = 0; t < texel_count; ++t)
+        if (subsets[t] == subset) {
+            for (int c = first_channel; c < channel_end; ++c)
+                statistics.mean[c] += texels[t][c];
+            ++statistics.texel_count;
+        }
+    if (statistics.texel_count == 0)
+        return statistics;
+    for (int c = first_channel; c < channel_end; ++c)
+        statistics.mean[c] /= float(statistics.texel_count);
+
+    for (int t = 0; t < texel_count; ++t)
+        if (subsets[t] == subset)
+            for (int c0 = first_channel; c0 < channel_end; ++c0)
+                for (int c1 = first_channel; c1 < channel_end; ++c1)
+                    statistics.covariance[c0][c1] += (texels[t][c0] - statistics.mean[c0]) * (texels[t][c1] - statistics.mean[c1]);
+    return statistics;
+}
+
+// Finds the principal axis of the covariance by power iteration and returns the summed squared distance along it.
+// Returns zero and leaves the axis undefined if all texels are identical.
+static float principal_axis(const SubsetStatistics& statistics, int first_channel, int channel_count, float axis[4]) {
+    int channel_end = first_channel + channel_count;
+
+    // Start from the covariance of the channel with the largest variance, which is usually close to the axis.
+    int largest_channel = first_channel;
+    for (int c = first_channel; c < channel_end; ++c)
+        if (statistics.covariance[c][c] > statistics.covariance[largest_channel][largest_channel])
+            largest_channel = c;
+    for (int c = first_channel; c < channel_end; ++c)
+        axis[c] = statistics.covariance[largest_channel][c];
+
+    float variance = 0.0f;
+    for (int i = 0; i < 8; ++i) {
+        float next_axis[4] = {};
+        float axis_length_squared = 0.0f;
+        for (int c0 = first_channel; c0 < channel_end; ++c0) {
+            for (int c1 = first_channel; c1 < channel_end; ++c1)
+                next_axis[c0] += statistics.covariance[c0][c1] * axis[c1];
+            axis_length_squared += next_axis[c0] * next_axis[c0];
+        }
+        if (axis_length_squared < 1e-12f)
+            return 0.0f;
+        // The axis is normalized after the first iteration, so the length of the product is the variance along it.
+        variance = sqrt(axis_length_squared);
+        for (int c = first_channel; c < channel_end; ++c)
+            axis[c] = next_axis[c] / variance;
+    }
+    return variance;
+}
+
+// Endpoints spanning the projection of the subset's texels onto their principal axis, clamped to [0, max_value].
+static void principal_axis_endpoints(const BlockTexels& texels, const unsigned char subsets[16], int subset, int first_channel, int channel_count,
+                                     float max_value, float endpoint0[4], float endpoint1[4]) {
+    int channel_end = first_channel + channel_count;
+    SubsetStatistics statistics = subset_statistics(texels, subsets, subset, first_channel, channel_count);
+    float axis[4];
+    if (principal_axis(statistics, first_channel, channel_count, axis) == 0.0f) {
+        for (int c = first_channel; c < channel_end; ++c)
+            endpoint0[c] = endpoint1[c] = statistics.mean[c];
+        return;
+    }
+
+    float min_t = 1e30f, max_t = -1e30f;
+    for (int t = 0; t < texel_count; ++t)
+        if (subsets[t] == subset) {
+            float projection = 0.0f;
+            for (int c = first_channel; c < channel_end; ++c)
+                projection += (texels[t][c] - statistics.mean[c]) * axis[c];
+            min_t = min(min_t, projection);
+            max_t = max(max_t, projection);
+        }
+    for (int c = first_channel; c < channel_end; ++c) {
+        endpoint0[c] = clamp(statistics.mean[c] + axis[c] * min_t, 0.0f, max_value);
+        endpoint1[c] = clamp(statistics.mean[c] + axis[c] * max_t, 0.0f, max_value);
+    }
+}
+
+// Computes the endpoints of the subset that minimize the squared error given the texel indices.
+static bool least_squares_endpoints(const BlockTexels& texels, const unsigned char subsets[16], int subset, const unsigned char indices[16], const int* weights,
+                                    int first_channel, int channel_count, float max_value, float endpoint0[4], float endpoint1[4]) {
+    int channel_end = first_channel + channel_count;
+    float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+    float ax[4] = {}, bx[4] = {};
+    for (int t = 0; t < texel_count; ++t)
+        if (subsets[t] == subset) {
+            float b = weights[indices[t]] / 64.0f, a = 1.0f - b;
+            aa += a * a;
+            bb += b * b;
+            ab += a * b;
+            for (int c = first_channel; c < channel_end; ++c) {
+                ax[c] += texels[t][c] * a;
+                bx[c] += texels[t][c] * b;
+            }
+        }
+
+    float determinant = aa * bb - ab * ab;
+    if (abs(determinant) < 1e-6f)
+        return false;
+
+    float inv_determinant = 1.0f / determinant;
+    for (int c = first_channel; c < channel_end; ++c) {
+        endpoint0[c] = clamp((ax[c] * bb - bx[c] * ab) * inv_determinant, 0.0f, max_value);
+        endpoint1[c] = clamp((bx[c] * aa - ax[c] * ab) * inv_determinant, 0.0f, max_value);
+    }
+    return true;
+}
+
+// Ranks the partitions by how well the subsets are approximated by lines, best first.
+static void rank_partitions(const BlockTexels& texels, int subset_count, int partition_count, int channel_count, int ranked_partitions[64]) {
+    float residuals[64];
+    for (int p = 0; p < partition_count; ++p) {
+        unsigned char subsets[16];
+        for (int t = 0; t < texel_count; ++t)
+            subsets[t] = (unsigned char)subset_of(subset_count, p, t);
+
+        // The squared distance to the principal axes.
+        residuals[p] = 0.0f;
+        for (int s = 0; s < subset_count; ++s) {
+            SubsetStatistics statistics = subset_statistics(texels, subsets, s, 0, channel_count);
+            float axis[4];
+            residuals[p] -= principal_axis(statistics, 0, channel_count, axis);
+            for (int c = 0; c < channel_count; ++c)
+                residuals[p] += statistics.covariance[c][c];
+        }
+        ranked_partitions[p] = p;
+    }
+    std::sort(ranked_partitions, ranked_partitions + partition_count, [&](int lhs, int rhs) {
+        return residuals[lhs] < residuals[rhs] || (residuals[lhs] == residuals[rhs] && lhs < rhs);
+    });
+}
+
+// ------------------------------------------------------------------------------------------------
+// BC6H.
+// Endpoints are interpolated in the bits of unsigned halfs scaled to 16 bits,
+// so the interpolation is roughly logarithmic in the decoded values.
+// ------------------------------------------------------------------------------------------------
+
+// Fields of the block header. W, X, Y and Z are the endpoints of the subsets and D is the partition.
+enum BC6HField : unsigned char { End, RW, GW, BW, RX, GX, BX, RY, GY, BY, RZ, GZ, BZ, D };
+
+// Bits of a field in the order they are stored. The bits are reversed if first_bit > last_bit.
+struct BC6HBits {
+    BC6HField field;
+    unsigned char first_bit, last_bit;
+};
+
+struct BC6HModeInfo {
+    int mode_value;
+    int mode_bit_count;
+    int subset_count;
+    bool is_transformed; // The X, Y and Z endpoints are stored as deltas from W.
+    int endpoint_bits;
+    int delta_bits[3];
+    BC6HBits header[24];
+};
+
+static const BC6HModeInfo BC6H_modes[14] = {
+    { 0x00, 2, 2, true, 10, { 5, 5, 5 },
+      { { GY, 4, 4 }, { BY, 4, 4 }, { BZ, 4, 4 }, { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 4 }, { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 4 },
+        { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 }, { BZ, 3, 3 }, { D, 0, 4 } } },
+    { 0x01, 2, 2, true, 7, { 6, 6, 6 },
+      { { GY, 5, 5 }, { GZ, 4, 4 }, { GZ, 5, 5 }, { RW, 0, 6 }, { BZ, 0, 0 }, { BZ, 1, 1 }, { BY, 4, 4 }, { GW, 0, 6 }, { BY, 5, 5 }, { BZ, 2, 2 },
+        { GY, 4, 4 }, { BW, 0, 6 }, { BZ, 3, 3 }, { BZ, 5, 5 }, { BZ, 4, 4 }, { RX, 0, 5 }, { GY, 0, 3 }, { GX, 0, 5 }, { GZ, 0, 3 }, { BX, 0, 5 },
+        { BY, 0, 3 }, { RY, 0, 5 }, { RZ, 0, 5 }, { D, 0, 4 } } },
+    { 0x02, 5, 2, true, 11, { 5, 4, 4 },
+      { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 4 }, { RW, 10, 10 }, { GY, 0, 3 }, { GX, 0, 3 }, { GW, 10, 10 }, { BZ, 0, 0 }, { GZ, 0, 3 },
+        { BX, 0, 3 }, { BW, 10, 10 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 }, { BZ, 3, 3 }, { D, 0, 4 } } },
+    { 0x06, 5, 2, true, 11, { 4, 5, 4 },
+      { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 3 }, { RW, 10, 10 }, { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 4 }, { GW, 10, 10 }, { GZ, 0, 3 },
+        { BX, 0, 3 }, { BW, 10, 10 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 3 }, { BZ, 0, 0 }, { BZ, 2, 2 }, { RZ, 0, 3 }, { GY, 4, 4 }, { BZ, 3, 3 },
+        { D, 0, 4 } } },
+    { 0x0A, 5, 2, true, 11, { 4, 4, 5 },
+      { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 3 }, { RW, 10, 10 }, { BY, 4, 4 }, { GY, 0, 3 }, { GX, 0, 3 }, { GW, 10, 10 }, { BZ, 0, 0 },
+        { GZ, 0, 3 }, { BX, 0, 4 }, { BW, 10, 10 }, { BY, 0, 3 }, { RY, 0, 3 }, { BZ, 1, 1 }, { BZ, 2, 2 }, { RZ, 0, 3 }, { BZ, 4, 4 }, { BZ, 3, 3 },
+        { D, 0, 4 } } },
+    { 0x0E, 5, 2, true, 9, { 5, 5, 5 },
+      { { RW, 0, 8 }, { BY, 4, 4 }, { GW, 0, 8 }, { GY, 4, 4 }, { BW, 0, 8 }, { BZ, 4, 4 }, { RX, 0, 4 }, { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 4 },
+        { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 }, { BZ, 3, 3 }, { D, 0, 4 } } },
+    { 0x12, 5, 2, true, 8, { 6, 5, 5 },
+      { { RW, 0, 7 }, { GZ, 4, 4 }, { BY, 4, 4 }, { GW, 0, 7 }, { BZ, 2, 2 }, { GY, 4, 4 }, { BW, 0, 7 }, { BZ, 3, 3 }, { BZ, 4, 4 }, { RX, 0, 5 },
+        { GY, 0, 3 }, { GX, 0, 4 }, { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 5 }, { RZ, 0, 5 }, { D, 0, 4 } } },
+    { 0x16, 5, 2, true, 8, { 5, 6, 5 },
+      { { RW, 0, 7 }, { BZ, 0, 0 }, { BY, 4, 4 }, { GW, 0, 7 }, { GY, 5, 5 }, { GY, 4, 4 }, { BW, 0, 7 }, { GZ, 5, 5 }, { BZ, 4, 4 }, { RX, 0, 4 },
+        { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 5 }, { GZ, 0, 3 }, { BX, 0, 4 }, { BZ, 1, 1 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 },
+        { BZ, 3, 3 }, { D, 0, 4 } } },
+    { 0x1A, 5, 2, true, 8, { 5, 5, 6 },
+      { { RW, 0, 7 }, { BZ, 1, 1 }, { BY, 4, 4 }, { GW, 0, 7 }, { BY, 5, 5 }, { GY, 4, 4 }, { BW, 0, 7 }, { BZ, 5, 5 }, { BZ, 4, 4 }, { RX, 0, 4 },
+        { GZ, 4, 4 }, { GY, 0, 3 }, { GX, 0, 4 }, { BZ, 0, 0 }, { GZ, 0, 3 }, { BX, 0, 5 }, { BY, 0, 3 }, { RY, 0, 4 }, { BZ, 2, 2 }, { RZ, 0, 4 },
+        { BZ, 3, 3 }, { D, 0, 4 } } },
+    { 0x1E, 5, 2, false, 6, { 6, 6, 6 },
+      { { RW, 0, 5 }, { GZ, 4, 4 }, { BZ, 0, 0 }, { BZ, 1, 1 }, { BY, 4, 4 }, { GW, 0, 5 }, { GY, 5, 5 }, { BY, 5, 5 }, { BZ, 2, 2 }, { GY, 4, 4 },
+        { BW, 0, 5 }, { GZ, 5, 5 }, { BZ, 3, 3 }, { BZ, 5, 5 }, { BZ, 4, 4 }, { RX, 0, 5 }, { GY, 0, 3 }, { GX, 0, 5 }, { GZ, 0, 3 }, { BX, 0, 5 },
+        { BY, 0, 3 }, { RY, 0, 5 }, { RZ, 0, 5 }, { D, 0, 4 } } },
+    { 0x03, 5, 1, false, 10, { 10, 10, 10 },
+      { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 9 }, { GX, 0, 9 }, { BX, 0, 9 } } },
+    { 0x07, 5, 1, true, 11, { 9, 9, 9 },
+      { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 8 }, { RW, 10, 10 }, { GX, 0, 8 }, { GW, 10, 10 }, { BX, 0, 8 }, { BW, 10, 10 } } },
+    { 0x0B, 5, 1, true, 12, { 8, 8, 8 },
+      { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 7 }, { RW, 11, 10 }, { GX, 0, 7 }, { GW, 11, 10 }, { BX, 0, 7 }, { BW, 11, 10 } } },
+    { 0x0F, 5, 1, true, 16, { 4, 4, 4 },
+      { { RW, 0, 9 }, { GW, 0, 9 }, { BW, 0, 9 }, { RX, 0, 3 }, { RW, 15, 10 }, { GX, 0, 3 }, { GW, 15, 10 }, { BX, 0, 3 }, { BW, 15, 10 } } }
+};
+
+struct BC6HBlock {
+    int mode; // Index into BC6H_modes. Negative for reserved modes.
+    int partition;
+    int endpoints[4][3]; // Quantized endpoints W, X, Y and Z. Deltas are resolved.
+    unsigned char indices[16];
+    float error;
+};
+
+inline int sign_extend(int value, int bit_count) {
+    return (value & (1 << (bit_count - 1))) ? value - (1 << bit_count) : value;
+}
+
+inline int unquantize_BC6H_channel(int value, int bit_count) {
+    if (bit_count >= 15)
+        return value;
+    if (value == 0)
+        return 0;
+    if (value == (1 << bit_count) - 1)
+        return 0xFFFF;
+    return ((value << 16) + 0x8000) >> bit_count;
+}
+
+inline int quantize_BC6H_channel(float value, int bit_count) {
+    // Pick the quantized value whose unquantized value is closest.
+    int max_value = (1 << bit_count) - 1;
+    int quantized_value = clamp(int(value * (1 << bit_count) / 65536.0f), 0, max_value);
+    float error = abs(unquantize_BC6H_channel(quantized_value, bit_count) - value);
+    for (int neighbour : { quantized_value - 1, quantized_value + 1 })
+        if (0 <= neighbour && neighbour <= max_value && abs(unquantize_BC6H_channel(neighbour, bit_count) - value) < error) {
+            error = abs(unquantize_BC6H_channel(neighbour, bit_count) - value);
+            quantized_value = neighbour;
+        }
+    return quantized_value;
+}
+
+// Scales the interpolated value to the bits of a half. The largest value is the largest finite half.
+inline unsigned short finish_BC6H_channel(int value) {
+    return (unsigned short)((value * 31) >> 6);
+}
+
+inline float half_bits_to_float(unsigned short bits) {
+    return to_float(*(half*)&bits);
+}
+
+inline unsigned short float_to_half_bits(float value) {
+    // Negative values and NaNs are clamped to zero.
+    half half_value = to_half(value > 0.0f ? min(value, 65504.0f) : 0.0f);
+    return *(unsigned short*)&half_value;
+}
+
+static BC6HBlock unpack_BC6H(const unsigned char bytes[16]) {
+    BC6HBlock block = {};
+    BlockReader reader = { bytes, 0 };
+    int mode_value = reader.read(2);
+    if (mode_value > 1)
+        mode_value |= reader.read(3) << 2;
+    block.mode = -1;
+    for (int m = 0; m < 14; ++m)
+        if (BC6H_modes[m].mode_value == mode_value)
+            block.mode = m;
+    if (block.mode < 0)
+        return block;
+
+    const BC6HModeInfo& info = BC6H_modes[block.mode];
+    for (const BC6HBits& bits : info.header) {
+        if (bits.field == End)
+            break;
+        int step = bits.first_bit <= bits.last_bit ? 1 : -1;
+        for (int b = bits.first_bit; b != bits.last_bit + step; b += step) {
+            int bit = reader.read(1);
+            if (bits.field == D)
+                block.partition |= bit << b;
+            else
+                block.endpoints[(bits.field - RW) / 3][(bits.field - RW) % 3] |= bit << b;
+        }
+    }
+
+    if (info.is_transformed) {
+        int endpoint_mask = (1 << info.endpoint_bits) - 1;
+        for (int e = 1; e < 2 * info.subset_count; ++e)
+            for (int c = 0; c < 3; ++c)
+                block.endpoints[e][c] = (block.endpoints[0][c] + sign_extend(block.endpoints[e][c], info.delta_bits[c])) & endpoint_mask;
+    }
+
+    int index_bits = info.subset_count == 2 ? 3 : 4;
+    for (int t = 0; t < texel_count; ++t)
+        block.indices[t] = (unsigned char)reader.read(index_bits - is_anchor(info.subset_count, block.partition, t));
+    return block;
+}
+
+// Returns false if the endpoint deltas do not fit in the delta bits of the mode.
+static bool pack_BC6H(const BC6HBlock& block, unsigned char bytes[16]) {
+    const BC6HModeInfo& info = BC6H_modes[block.mode];
+
+    int stored_endpoints[4][3];
+    for (int e = 0; e < 2 * info.subset_count; ++e)
+        for (int c = 0; c < 3; ++c) {
+            stored_endpoints[e][c] = block.endpoints[e][c];
+            if (info.is_transformed && e > 0) {
+                int delta = block.endpoints[e][c] - block.endpoints[0][c];
+                int delta_limit = 1 << (info.delta_bits[c] - 1);
+                if (delta < -delta_limit || delta >= delta_limit)
+                    return false;
+                stored_endpoints[e][c] = delta & ((1 << info.delta_bits[c]) - 1);
+            }
+        }
+
+    memset(bytes, 0, 16);
+    BlockWriter writer = { bytes, 0 };
+    writer.write(info.mode_value, info.mode_bit_count);
+    for (const BC6HBits& bits : info.header) {
+        if (bits.field == End)
+            break;
+        int step = bits.first_bit <= bits.last_bit ? 1 : -1;
+        for (int b = bits.first_bit; b != bits.last_bit + step; b += step) {
+            int value = bits.field == D ? block.partition : stored_endpoints[(bits.field - RW) / 3][(bits.field - RW) % 3];
+            writer.write(value >> b, 1);
+        }
+    }
+
+    int index_bits = info.subset_count == 2 ? 3 : 4;
+    for (int t = 0; t < texel_count; ++t)
+        writer.write(block.indices[t], index_bits - is_anchor(info.subset_count, block.partition, t));
+    return true;
+}
+
+// The half bits of the palette of each subset.
+static void BC6H_palettes(const BC6HBlock& block, unsigned short palettes[2][16][3]) {
+    const BC6HModeInfo& info = BC6H_modes[block.mode];
+    int index_bits = info.subset_count == 2 ? 3 : 4;
+    const int* weights = index_weights(index_bits);
+    for (int s = 0; s < info.subset_count; ++s)
+        for (int c = 0; c < 3; ++c) {
+            int value0 = unquantize_BC6H_channel(block.endpoints[2 * s][c], info.endpoint_bits);
+            int value1 = unquantize_BC6H_channel(block.endpoints[2 * s + 1][c], info.endpoint_bits);
+            for (int i = 0; i < (1 << index_bits); ++i)
+                palettes[s][i][c] = finish_BC6H_channel(interpolate(value0, value1, weights[i]));
+        }
+}
+
+static RGB decode_BC6H_texel(const BC6HBlock& block, int texel) {
+    if (block.mode < 0)
+        return RGB::black();
+
+    unsigned short palettes[2][16][3];
+    BC6H_palettes(block, palettes);
+    int subset = subset_of(BC6H_modes[block.mode].subset_count, block.partition, texel);
+    const unsigned short* color = palettes[subset][block.indices[texel]];
+    return RGB(half_bits_to_float(color[0]), half_bits_to_float(color[1]), half_bits_to_float(color[2]));
+}
+
+void decode_BC6H(const unsigned char block[16], RGB texels[16]) {
+    BC6HBlock unpacked_block = unpack_BC6H(block);
+    for (int t = 0; t < texel_count; ++t)
+        texels[t] = decode_BC6H_texel(unpacked_block, t);
+}
+
+// Selects the palette entries closest to the texels' half bits and returns the summed squared error.
+static float select_BC6H_indices(const unsigned short texel_bits[16][3], const unsigned char subsets[16], BC6HBlock& block) {
+    unsigned short palettes[2][16][3];
+    BC6H_palettes(block, palettes);
+    int index_count = BC6H_modes[block.mode].subset_count == 2 ? 8 : 16;
+
+    float summed_error = 0.0f;
+    for (int t = 0; t < texel_count; ++t) {
+        float best_distance = 1e30f;
+        for (int i = 0; i < index_count; ++i) {
+            const unsigned short* color = palettes[subsets[t]][i];
+            float distance = 0.0f;
+            for (int c = 0; c < 3; ++c) {
+                float delta = float(color[c]) - float(texel_bits[t][c]);
+                distance += delta * delta;
+            }
+            if (distance < best_distance) {
+                best_distance = distance;
+                block.indices[t] = (unsigned char)i;
+            }
+        }
+        summed_error += best_distance;
+    }
+    return summed_error;
+}
+
+// Encodes the texels with the given mode and partition.
+// The error is infinite if the endpoint deltas do not fit in the mode.
+static BC6HBlock encode_BC6H_mode(const BlockTexels& texels, const unsigned short texel_bits[16][3], int mode, int partition, int refinement_count) {
+    const BC6HModeInfo& info = BC6H_modes[mode];
+    BC6HBlock block = {};
+    block.mode = mode;
+    block.partition = partition;
+
+    unsigned char subsets[16];
+    for (int t = 0; t < texel_count; ++t)
+        subsets[t] = (unsigned char)subset_of(info.subset_count, partition, t);
+
+    float endpoints[4][4];
+    auto quantize_endpoints = [&](BC6HBlock& quantized_block) {
+        for (int e = 0; e < 2 * info.subset_count; ++e)
+            for (int c = 0; c < 3; ++c)
+                quantized_block.endpoints[e][c] = quantize_BC6H_channel(endpoints[e][c], info.endpoint_bits);
+    };
+
+    for (int s = 0; s < info.subset_count; ++s)
+        principal_axis_endpoints(texels, subsets, s, 0, 3, 65535.0f, endpoints[2 * s], endpoints[2 * s + 1]);
+    quantize_endpoints(block);
+    block.error = select_BC6H_indices(texel_bits, subsets, block);
+
+    // Refine the endpoints while the error decreases.
+    const int* weights = index_weights(info.subset_count == 2 ? 3 : 4);
+    for (int i = 0; i < refinement_count && block.error > 0.0f; ++i) {
+        for (int s = 0; s < info.subset_count; ++s)
+            least_squares_endpoints(texels, subsets, s, block.indices, weights, 0, 3, 65535.0f, endpoints[2 * s], endpoints[2 * s + 1]);
+        BC6HBlock refined_block = block;
+        quantize_endpoints(refined_block);
+        refined_block.error = select_BC6H_indices(texel_bits, subsets, refined_block);
+        if (refined_block.error >= block.error)
+            break;
+        block = refined_block;
+    }
+
+    // Swap the endpoints of subsets whose anchor index has its most significant bit set, as that bit is not stored.
+    int max_index = info.subset_count == 2 ? 7 : 15;
+    for (int s = 0; s < info.subset_count; ++s)
+        if (block.indices[anchor_of(info.subset_count, partition, s)] > max_index / 2) {
+            for (int c = 0; c < 3; ++c)
+                std::swap(block.endpoints[2 * s][c], block.endpoints[2 * s + 1][c]);
+            for (int t = 0; t < texel_count; ++t)
+                if (subsets[t] == s)
+                    block.indices[t] = (unsigned char)(max_index - block.indices[t]);
+        }
+
+    unsigned char bytes[16];
+    if (!pack_BC6H(block, bytes))
+        block.error = INFINITY;
+    return block;
+}
+
+void encode_BC6H(const RGB texels[16], unsigned char block[16], Quality quality) {
+    // The texels as half bits, which the error is measured in, and scaled to the 16 bit interpolation domain for fitting.
+    unsigned short texel_bits[16][3];
+    BlockTexels scaled_texels = {};
+    for (int t = 0; t < texel_count; ++t)
+        for (int c = 0; c < 3; ++c) {
+            texel_bits[t][c] = float_to_half_bits(texels[t][c]);
+            // The smallest value that finishes to the half bits.
+            scaled_texels[t][c] = float((texel_bits[t][c] * 64 + 30) / 31);
+        }
+
+    int refinement_count = quality == Quality::Fast ? 0 : (quality == Quality::Normal ? 1 : 4);
+    // Mode 11 stores a single subset with 10 bit endpoints and can represent any block.
+    BC6HBlock best_block = encode_BC6H_mode(scaled_texels, texel_bits, 10, 0, refinement_count);
+    auto try_mode = [&](int mode, int partition) {
+        if (best_block.error == 0.0f)
+            return;
+        BC6HBlock block = encode_BC6H_mode(scaled_texels, texel_bits, mode, partition, refinement_count);
+        if (block.error < best_block.error)
+            best_block = block;
+    };
+
+    if (quality != Quality::Fast) {
+        // More precise single subset endpoints, if the endpoints are close enough to be stored as deltas.
+        for (int mode = 11; mode < 14; ++mode)
+            try_mode(mode, 0);
+
+        // Two subsets in the partitions where the subsets are closest to lines.
+        int partition_count = quality == Quality::High ? 4 : 1;
+        int ranked_partitions[64];
+        rank_partitions(scaled_texels, 2, 32, 3, ranked_partitions);
+        for (int p = 0; p < partition_count; ++p)
+            for (int mode = 0; mode < 10; ++mode)
+                try_mode(mode, ranked_partitions[p]);
+    }
+
+    pack_BC6H(best_block, block);
+}
+
+// ------------------------------------------------------------------------------------------------
+// BC7.
+// ------------------------------------------------------------------------------------------------
+
+struct BC7ModeInfo {
+    int subset_count;
+    int partition_bits;
+    int rotation_bits;
+    int index_selection_bits;
+    int color_bits;
+    int alpha_bits; // Zero for opaque modes.
+    int endpoint_pbits; // One p-bit pr endpoint.
+    int shared_pbits; // One p-bit pr subset.
+    int index_bits;
+    int secondary_index_bits; // Separate alpha indices.
+};
+
+static const BC7ModeInfo BC7_modes[8] = {
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+};
+
+struct BC7Block {
+    int mode; // Negative for the reserved mode.
+    int partition;
+    int rotation; // Alpha is swapped with red, green or blue after decoding, if non-zero.
+    int index_selection; // Color uses the secondary indices and alpha the primary ones, if non-zero.
+    int endpoints[6][4]; // Quantized endpoints without their p-bits.
+    int pbits[6]; // Shared p-bits are stored in both endpoints of the subset.
+    unsigned char color_indices[16];
+    unsigned char alpha_indices[16]; // Only used by modes with separate alpha indices.
+    float error;
+};
+
+inline bool has_pbits(const BC7ModeInfo& info) { return info.endpoint_pbits || info.shared_pbits; }
+inline bool has_separate_alpha(const BC7ModeInfo& info) { return info.secondary_index_bits > 0; }
+
+inline int color_index_bits(const BC7ModeInfo& info, int index_selection) {
+    return index_selection ? info.secondary_index_bits : info.index_bits;
+}
+
+inline int alpha_index_bits(const BC7ModeInfo& info, int index_selection) {
+    if (!has_separate_alpha(info))
+        return info.index_bits;
+    return index_selection ? info.index_bits : info.secondary_index_bits;
+}
+
+// The 8 bit value of a quantized endpoint channel.
+inline int BC7_endpoint_value(const BC7ModeInfo& info, int quantized_value, int pbit, int channel) {
+    if (channel == 3 && info.alpha_bits == 0)
+        return 255;
+    int bit_count = channel < 3 ? info.color_bits : info.alpha_bits;
+    if (has_pbits(info)) {
+        quantized_value = (quantized_value << 1) | pbit;
+        ++bit_count;
+    }
+    return (quantized_value << (8 - bit_count)) | (quantized_value >> (2 * bit_count - 8));
+}
+
+inline int quantize_BC7_channel(const BC7ModeInfo& info, float value, int pbit, int channel) {
+    int bit_count = channel < 3 ? info.color_bits : info.alpha_bits;
+    int max_value = (1 << bit_count) - 1;
+    if (!has_pbits(info))
+        return clamp(int(value * max_value / 255.0f + 0.5f), 0, max_value);
+    // Quantize to the combined range of the value and p-bit and drop the p-bit.
+    float scaled_value = value * ((2 << bit_count) - 1) / 255.0f;
+    return clamp(int((scaled_value - pbit) * 0.5f + 0.5f), 0, max_value);
+}
+
+static BC7Block unpack_BC7(const unsigned char bytes[16]) {
+    BC7Block block = {};
+    BlockReader reader = { bytes, 0 };
+    while (block.mode < 8 && reader.read(1) == 0)
+        ++block.mode;
+    if (block.mode == 8) {
+        block.mode = -1;
+        return block;
+    }
+
+    const BC7ModeInfo& info = BC7_modes[block.mode];
+    block.partition = reader.read(info.partition_bits);
+    block.rotation = reader.read(info.rotation_bits);
+    block.index_selection = reader.read(info.index_selection_bits);
+
+    // All reds are stored first, then greens, blues and alphas, and finally the p-bits.
+    int endpoint_count = 2 * info.subset_count;
+    for (int c = 0; c < 3; ++c)
+        for (int e = 0; e < endpoint_count; ++e)
+            block.endpoints[e][c] = reader.read(info.color_bits);
+    for (int e = 0; e < endpoint_count; ++e)
+        block.endpoints[e][3] = reader.read(info.alpha_bits);
+    if (info.endpoint_pbits)
+        for (int e = 0; e < endpoint_count; ++e)
+            block.pbits[e] = reader.read(1);
+    else if (info.shared_pbits)
+        for (int s = 0; s < info.subset_count; ++s)
+            block.pbits[2 * s] = block.pbits[2 * s + 1] = reader.read(1);
+
+    unsigned char* primary_indices = block.index_selection ? block.alpha_indices : block.color_indices;
+    for (int t = 0; t < texel_count; ++t)
+        primary_indices[t] = (unsigned char)reader.read(info.index_bits - is_anchor(info.subset_count, block.partition, t));
+    if (has_separate_alpha(info)) {
+        unsigned char* secondary_indices = block.index_selection ? block.color_indices : block.alpha_indices;
+        for (int t = 0; t < texel_count; ++t)
+            secondary_indices[t] = (unsigned char)reader.read(info.secondary_index_bits - (t == 0));
+    }
+    return block;
+}
+
+static void pack_BC7(const BC7Block& block, unsigned char bytes[16]) {
+    const BC7ModeInfo& info = BC7_modes[block.mode];
+    memset(bytes, 0, 16);
+    BlockWriter writer = { bytes, 0 };
+    writer.write(1 << block.mode, block.mode + 1);
+    writer.write(block.partition, info.partition_bits);
+    writer.write(block.rotation, info.rotation_bits);
+    writer.write(block.index_selection, info.index_selection_bits);
+
+    int endpoint_count = 2 * info.subset_count;
+    for (int c = 0; c < 3; ++c)
+        for (int e = 0; e < endpoint_count; ++e)
+            writer.write(block.endpoints[e][c], info.color_bits);
+    for (int e = 0; e < endpoint_count; ++e)
+        writer.write(block.endpoints[e][3], info.alpha_bits);
+    if (info.endpoint_pbits)
+        for (int e = 0; e < endpoint_count; ++e)
+            writer.write(block.pbits[e], 1);
+    else if (info.shared_pbits)
+        for (int s = 0; s < info.subset_count; ++s)
+            writer.write(block.pbits[2 * s], 1);
+
+    const unsigned char* primary_indices = block.index_selection ? block.alpha_indices : block.color_indices;
+    for (int t = 0; t < texel_count; ++t)
+        writer.write(primary_indices[t], info.index_bits - is_anchor(info.subset_count, block.partition, t));
+    if (has_separate_alpha(info)) {
+        const unsigned char* secondary_indices = block.index_selection ? block.color_indices : block.alpha_indices;
+        for (int t = 0; t < texel_count; ++t)
+            writer.write(secondary_indices[t], info.secondary_index_bits - (t == 0));
+    }
+}
+
+// The 8 bit endpoints of the subsets.
+static void BC7_endpoint_values(const BC7Block& block, int endpoint_values[6][4]) {
+    const BC7ModeInfo& info = BC7_modes[block.mode];
+    for (int e = 0; e < 2 * info.subset_count; ++e)
+        for (int c = 0; c < 4; ++c)
+            endpoint_values[e][c] = BC7_endpoint_value(info, block.endpoints[e][c], block.pbits[e], c);
+}
+
+static RGBA32 decode_BC7_texel(const BC7Block& block, int texel) {
+    if (block.mode < 0)
+        return { 0, 0, 0, 0 };
+
+    const BC7ModeInfo& info = BC7_modes[block.mode];
+    int endpoint_values[6][4];
+    BC7_endpoint_values(block, endpoint_values);
+    int subset = subset_of(info.subset_count, block.partition, texel);
+    const int* endpoint0 = endpoint_values[2 * subset];
+    const int* endpoint1 = endpoint_values[2 * subset + 1];
+
+    int channels[4];
+    int color_weight = index_weights(color_index_bits(info, block.index_selection))[block.color_indices[texel]];
+    for (int c = 0; c < 3; ++c)
+        channels[c] = interpolate(endpoint0[c], endpoint1[c], color_weight);
+    int alpha_index = has_separate_alpha(info) ? block.alpha_indices[texel] : block.color_indices[texel];
+    channels[3] = interpolate(endpoint0[3], endpoint1[3], index_weights(alpha_index_bits(info, block.index_selection))[alpha_index]);
+
+    if (block.rotation)
+        std::swap(channels[3], channels[block.rotation - 1]);
+    return { (unsigned char)channels[0], (unsigned char)channels[1], (unsigned char)channels[2], (unsigned char)channels[3] };
+}
+
+void decode_BC7(const unsigned char block[16], RGBA32 texels[16]) {
+    BC7Block unpacked_block = unpack_BC7(block);
+    for (int t = 0; t < texel_count; ++t)
+        texels[t] = decode_BC7_texel(unpacked_block, t);
+}
+
+// Quantizes the endpoints and picks the p-bits that minimize the quantization error.
+static void quantize_BC7_endpoints(const float endpoints[6][4], BC7Block& block) {
+    const BC7ModeInfo& info = BC7_modes[block.mode];
+    int channel_count = info.alpha_bits > 0 ? 4 : 3;
+
+    auto quantize_endpoint = [&](int e, int pbit) -> float {
+        float error = 0.0f;
+        for (int c = 0; c < channel_count; ++c) {
+            block.endpoints[e][c] = quantize_BC7_channel(info, endpoints[e][c], pbit, c);
+            float delta = BC7_endpoint_value(info, block.endpoints[e][c], pbit, c) - endpoints[e][c];
+            error += delta * delta;
+        }
+        block.pbits[e] = pbit;
+        return error;
+    };
+
+    for (int s = 0; s < info.subset_count; ++s) {
+        int e0 = 2 * s, e1 = 2 * s + 1;
+        if (info.endpoint_pbits) {
+            for (int e : { e0, e1 }) {
+                // Opaque and fully transparent alpha can only be represented with a specific p-bit,
+                // and must be exact, as opaque surfaces would otherwise become slightly transparent.
+                if (channel_count == 4 && endpoints[e][3] >= 254.5f)
+                    quantize_endpoint(e, 1);
+                else if (channel_count == 4 && endpoints[e][3] < 0.5f)
+                    quantize_endpoint(e, 0);
+                else {
+                    float pbit1_error = quantize_endpoint(e, 1);
+                    if (quantize_endpoint(e, 0) > pbit1_error)
+                        quantize_endpoint(e, 1);
+                }
+            }
+        } else if (info.shared_pbits) {
+            float pbit1_error = quantize_endpoint(e0, 1) + quantize_endpoint(e1, 1);
+            if (quantize_endpoint(e0, 0) + quantize_endpoint(e1, 0) > pbit1_error) {
+                quantize_endpoint(e0, 1);
+                quantize_endpoint(e1, 1);
+            }
+        } else {
+            quantize_endpoint(e0, 0);
+            quantize_endpoint(e1, 0);
+        }
+    }
+}
+
+// Selects the palette entries closest to the rotated texels and returns the summed squared error.
+static float select_BC7_indices(const BlockTexels& texels, const unsigned char subsets[16], BC7Block& block) {
+    const BC7ModeInfo& info = BC7_modes[block.mode];
+    int endpoint_values[6][4];
+    BC7_endpoint_values(block, endpoint_values);
+
+    bool separate_alpha = has_separate_alpha(info);
+    int color_channel_count = separate_alpha ? 3 : 4;
+    int color_index_count = 1 << color_index_bits(info, block.index_selection);
+    int alpha_index_count = 1 << alpha_index_bits(info, block.index_selection);
+    const int* color_weights = index_weights(color_index_bits(info, block.index_selection));
+    const int* alpha_weights = index_weights(alpha_index_bits(info, block.index_selection));
+
+    float summed_error = 0.0f;
+    for (int t = 0; t < texel_count; ++t) {
+        const int* endpoint0 = endpoint_values[2 * subsets[t]];
+        const int* endpoint1 = endpoint_values[2 * subsets[t] + 1];
+
+        float best_distance = 1e30f;
+        for (int i = 0; i < color_index_count; ++i) {
+            float distance = 0.0f;
+            for (int c = 0; c < color_channel_count; ++c) {
+                float delta = interpolate(endpoint0[c], endpoint1[c], color_weights[i]) - texels[t][c];
+                distance += delta * delta;
+            }
+            if (distance < best_distance) {
+                best_distance = distance;
+                block.color_indices[t] = (unsigned char)i;
+            }
+        }
+        summed_error += best_distance;
+
+        if (separate_alpha) {
+            best_distance = 1e30f;
+            for (int i = 0; i < alpha_index_count; ++i) {
+                float delta = interpolate(endpoint0[3], endpoint1[3], alpha_weights[i]) - texels[t][3];
+                if (delta * delta < best_distance) {
+                    best_distance = delta * delta;
+                    block.alpha_indices[t] = (unsigned char)i;
+                }
+            }
+            summed_error += best_distance;
+        }
+    }
+    return summed_error;
+}
+
+// Encodes the texels with the given mode, partition, rotation and index selection.
+static BC7Block encode_BC7_mode(const BlockTexels& texels, int mode, int partition, int rotation, int index_selection, int refinement_count) {
+    const BC7ModeInfo& info = BC7_modes[mode];
+    BC7Block block = {};
+    block.mode = mode;
+    block.partition = partition;
+    block.rotation = rotation;
+    block.index_selection = index_selection;
+
+    BlockTexels rotated_texels;
+    memcpy(rotated_texels, texels, sizeof(BlockTexels));
+    if (rotation)
+        for (int t = 0; t < texel_count; ++t)
+            std::swap(rotated_texels[t][3], rotated_texels[t][rotation - 1]);
+
+    unsigned char subsets[16];
+    for (int t = 0; t < texel_count; ++t)
+        subsets[t] = (unsigned char)subset_of(info.subset_count, partition, t);
+
+    // Opaque modes only fit the color channels. Modes with separate alpha indices fit color and alpha independently.
+    bool separate_alpha = has_separate_alpha(info);
+    int color_channel_count = info.alpha_bits > 0 && !separate_alpha ? 4 : 3;
+    float endpoints[6][4];
+    for (int s = 0; s < info.subset_count; ++s) {
+        principal_axis_endpoints(rotated_texels, subsets, s, 0, color_channel_count, 255.0f, endpoints[2 * s], endpoints[2 * s + 1]);
+        if (separate_alpha)
+            principal_axis_endpoints(rotated_texels, subsets, s, 3, 1, 255.0f, endpoints[2 * s], endpoints[2 * s + 1]);
+    }
+    quantize_BC7_endpoints(endpoints, block);
+    block.error = select_BC7_indices(rotated_texels, subsets, block);
+
+    // Refine the endpoints while the error decreases.
+    const int* color_weights = index_weights(color_index_bits(info, index_selection));
+    const int* alpha_weights = index_weights(alpha_index_bits(info, index_selection));
+    for (int i = 0; i < refinement_count && block.error > 0.0f; ++i) {
+        for (int s = 0; s < info.subset_count; ++s) {
+            least_squares_endpoints(rotated_texels, subsets, s, block.color_indices, color_weights, 0, color_channel_count, 255.0f,
+                                    endpoints[2 * s], endpoints[2 * s + 1]);
+            if (separate_alpha)
+                least_squares_endpoints(rotated_texels, subsets, s, block.alpha_indices, alpha_weights, 3, 1, 255.0f,
+                                        endpoints[2 * s], endpoints[2 * s + 1]);
+        }
+        BC7Block refined_block = block;
+        quantize_BC7_endpoints(endpoints, refined_block);
+        refined_block.error = select_BC7_indices(rotated_texels, subsets, refined_block);
+        if (refined_block.error >= block.error)
+            break;
+        block = refined_block;
+    }
+
+    return block;
+}
+
+// Swaps the endpoints of subsets whose anchor index has its most significant bit set, as that bit is not stored.
+static void fix_BC7_anchor_indices(BC7Block& block) {
+    const BC7ModeInfo& info = BC7_modes[block.mode];
+    bool separate_alpha = has_separate_alpha(info);
+    int max_color_index = (1 << color_index_bits(info, block.index_selection)) - 1;
+    int max_alpha_index = (1 << alpha_index_bits(info, block.index_selection)) - 1;
+
+    for (int s = 0; s < info.subset_count; ++s) {
+        int anchor = anchor_of(info.subset_count, block.partition, s);
+        int* endpoint0 = block.endpoints[2 * s];
+        int* endpoint1 = block.endpoints[2 * s + 1];
+
+        if (block.color_indices[anchor] > max_color_index / 2) {
+            for (int c = 0; c < (separate_alpha ? 3 : 4); ++c)
+                std::swap(endpoint0[c], endpoint1[c]);
+            std::swap(block.pbits[2 * s], block.pbits[2 * s + 1]);
+            for (int t = 0; t < texel_count; ++t)
+                if (subset_of(info.subset_count, block.partition, t) == s)
+                    block.color_indices[t] = (unsigned char)(max_color_index - block.color_indices[t]);
+        }
+
+        if (separate_alpha && block.alpha_indices[anchor] > max_alpha_index / 2) {
+            std::swap(endpoint0[3], endpoint1[3]);
+            for (int t = 0; t < texel_count; ++t)
+                block.alpha_indices[t] = (unsigned char)(max_alpha_index - block.alpha_indices[t]);
+        }
+    }
+}
+
+void encode_BC7(const RGBA32 texels[16], unsigned char block[16], Quality quality) {
+    BlockTexels float_texels;
+    bool is_opaque = true;
+    for (int t = 0; t < texel_count; ++t) {
+        float_texels[t][0] = texels[t].r;
+        float_texels[t][1] = texels[t].g;
+        float_texels[t][2] = texels[t].b;
+        float_texels[t][3] = texels[t].a;
+        is_opaque &= texels[t].a == 255;
+    }
+
+    int refinement_count = quality == Quality::Fast ? 0 : (quality == Quality::Normal ? 1 : 4);
+    // Mode 6 stores a single subset with 7 bit RGBA endpoints, p-bits and 4 bit indices, and is a good fit for most blocks.
+    BC7Block best_block = encode_BC7_mode(float_texels, 6, 0, 0, 0, refinement_count);
+    auto try_mode = [&](int mode, int partition, int rotation, int index_selection) {
+        if (best_block.error == 0.0f)
+            return;
+        BC7Block block = encode_BC7_mode(float_texels, mode, partition, rotation, index_selection, refinement_count);
+        if (block.error < best_block.error)
+            best_block = block;
+    };
+
+    if (quality != Quality::Fast) {
+        // Separate alpha indices, for alpha that does not follow the color.
+        if (!is_opaque)
+            try_mode(5, 0, 0, 0);
+
+        // Two subsets in the partitions where the subsets are closest to lines.
+        // Opaque blocks spend the alpha bits on color precision.
+        int channel_count = is_opaque ? 3 : 4;
+        int partition_count = quality == Quality::High ? 4 : 1;
+        int ranked_partitions[64];
+        rank_partitions(float_texels, 2, 64, channel_count, ranked_partitions);
+        for (int p = 0; p < partition_count; ++p) {
+            if (is_opaque) {
+                try_mode(1, ranked_partitions[p], 0, 0);
+                if (quality == Quality::High)
+                    try_mode(3, ranked_partitions[p], 0, 0);
+            } else
+                try_mode(7, ranked_partitions[p], 0, 0);
+        }
+
+        if (quality == Quality::High) {
+            // Three subsets for opaque blocks. Mode 0 can only use the first 16 partitions.
+            if (is_opaque) {
+                rank_partitions(float_texels, 3, 64, channel_count, ranked_partitions);
+                for (int p = 0; p < partition_count; ++p)
+                    try_mode(2, ranked_partitions[p], 0, 0);
+                rank_partitions(float_texels, 3, 16, channel_count, ranked_partitions);
+                for (int p = 0; p < partition_count; ++p)
+                    try_mode(0, ranked_partitions[p], 0, 0);
+            }
+
+            // Separate alpha indices with every rotation, so any channel can be encoded independently.
+            for (int rotation = 0; rotation < 4; ++rotation) {
+                try_mode(4, 0, rotation, 0);
+                try_mode(4, 0, rotation, 1);
+                try_mode(5, 0, rotation, 0);
+            }
+        }
+    }
+
+    fix_BC7_anchor_indices(best_block);
+    pack_BC7(best_block, block);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Images.
+// ------------------------------------------------------------------------------------------------
+
+RGBA decode_pixel(Images::UID image_ID, Vector3ui index, unsigned int mipmap_level) {
+    Image image = image_ID;
+    PixelFormat format = image.get_pixel_format();
+    assert(is_block_compressed(format));
+
+    unsigned int blocks_x = (image.get_width(mipmap_level) + 3) / 4, blocks_y = (image.get_height(mipmap_level) + 3) / 4;
+    unsigned int block_index = index.x / 4 + blocks_x * (index.y / 4 + blocks_y * index.z);
+    const unsigned char* block = (const unsigned char*)image.get_pixels(mipmap_level) + block_index * block_size_of(format);
+    int texel = index.x % 4 + 4 * (index.y % 4);
+
+    const float normalizer = 1.0f / 255.0f;
+    RGBA color = RGBA::black();
+    switch (format) {
+    case PixelFormat::BC1_RGB: {
+        RGBA32 texel_color = decode_BC1_texel(block, texel);
+        color = RGBA(texel_color.r * normalizer, texel_color.g * normalizer, texel_color.b * normalizer, 1.0f);
+        break;
+    }
+    case PixelFormat::BC4_Intensity: {
+        float value = decode_BC4_texel(block, texel) * normalizer;
+        color = RGBA(value, value, value, 1.0f);
+        break;
+    }
+    case PixelFormat::BC5_RG:
+        color = RGBA(decode_BC4_texel(block, texel) * normalizer, decode_BC4_texel(block + 8, texel) * normalizer, 0.0f, 1.0f);
+        break;
+    case PixelFormat::BC6H_RGB:
+        color = RGBA(decode_BC6H_texel(unpack_BC6H(block), texel), 1.0f);
+        break;
+    case PixelFormat::BC7_RGBA: {
+        RGBA32 texel_color = decode_BC7_texel(unpack_BC7(block), texel);
+        color = RGBA(texel_color.r * normalizer, texel_color.g * normalizer, texel_color.b * normalizer, texel_color.a * normalizer);
+        break;
+    }
+    default:
+        break;
+    }
+    return gammacorrect(color, image.get_gamma());
+}
+
+inline unsigned char to_byte(float value) {
+    return (unsigned char)clamp(value * 255.0f + 0.5f, 0.0f, 255.0f);
+}
+
+void compress_mipmap(Images::UID image_ID, unsigned int mipmap_level, PixelFormat format, float gamma, Quality quality, void* blocks) {
+    BIFROST_PROFILE_FUNCTION();
+    assert(is_block_compressed(format));
+
+    Image image = image_ID;
+    PixelFormat source_format = image.get_pixel_format();
+    unsigned int width = image.get_width(mipmap_level), height = image.get_height(mipmap_level), depth = image.get_depth(mipmap_level);
+    int blocks_x = (width + 3) / 4, blocks_y = (height + 3) / 4;
+    int block_size = block_size_of(format);
+
+    // Bytes are read directly if they are already encoded with the target gamma.
+    bool is_byte_format = source_format == PixelFormat::Alpha8 || source_format == PixelFormat::Intensity8 ||
+                          source_format == PixelFormat::RGB24 || source_format == PixelFormat::RGBA32;
+    bool read_bytes = is_byte_format && (image.get_gamma() == gamma || source_format == PixelFormat::Alpha8);
+    const unsigned char* source_bytes = read_bytes ? (const unsigned char*)image.get_pixels(mipmap_level) : nullptr;
+    int source_pixel_size = size_of(source_format);
+    float inverse_gamma = 1.0f / gamma;
+
+    auto read_texel = [&](unsigned int x, unsigned int y, unsigned int z) -> RGBA32 {
+        unsigned int pixel_index = x + width * (y + height * z);
+        if (read_bytes) {
+            const unsigned char* pixel = source_bytes + pixel_index * source_pixel_size;
+            switch (source_format) {
+            case PixelFormat::Alpha8: return { 255, 255, 255, pixel[0] };
+            case PixelFormat::Intensity8: return { pixel[0], pixel[0], pixel[0], 255 };
+            case PixelFormat::RGB24: return { pixel[0], pixel[1], pixel[2], 255 };
+            default: return { pixel[0], pixel[1], pixel[2], pixel[3] };
+            }
+        }
+        RGBA color = gammacorrect(image.get_pixel(Vector3ui(x, y, z), mipmap_level), inverse_gamma);
+        return { to_byte(color.r), to_byte(color.g), to_byte(color.b), to_byte(color.a) };
+    };
+
+    // BC4 compresses the alpha channel of alpha images.
+    int BC4_channel = source_format == PixelFormat::Alpha8 ? 3 : 0;
+
+    Core::Parallel::parallel_for(0, blocks_y * int(depth), [&](int block_row) {
+        unsigned int z = block_row / blocks_y, block_y = block_row % blocks_y;
+        unsigned char* block = (unsigned char*)blocks + block_row * blocks_x * block_size;
+        for (int block_x = 0; block_x < blocks_x; ++block_x) {
+            // Gather the texels and replicate the edge texels of partial blocks.
+            auto texel_index = [&](int t) {
+                unsigned int x = min<unsigned int>(block_x * 4 + t % 4, width - 1);
+                unsigned int y = min(block_y * 4 + t / 4, height - 1);
+                return Vector3ui(x, y, z);
+            };
+
+            if (format == PixelFormat::BC6H_RGB) {
+                // HDR texels are read as floats.
+                RGB texels[16];
+                for (int t = 0; t < texel_count; ++t)
+                    texels[t] = gammacorrect(image.get_pixel(texel_index(t), mipmap_level), inverse_gamma).rgb();
+                encode_BC6H(texels, block, quality);
+                block += block_size;
+                continue;
+            }
+
+            RGBA32 texels[16];
+            for (int t = 0; t < texel_count; ++t) {
+                Vector3ui index = texel_index(t);
+                texels[t] = read_texel(index.x, index.y, index.z);
+            }
+
+            if (format == PixelFormat::BC1_RGB)
+                encode_BC1(texels, block, quality);
+            else if (format == PixelFormat::BC7_RGBA)
+                encode_BC7(texels, block, quality);
+            else {
+                unsigned char reds[16], greens[16];
+                for (int t = 0; t < texel_count; ++t) {
+                    const unsigned char* channels = &texels[t].r;
+                    reds[t] = format == PixelFormat::BC4_Intensity ? channels[BC4_channel] : texels[t].r;
+                    greens[t] = texels[t].g;
+                }
+                if (format == PixelFormat::BC4_Intensity)
+                    encode_BC4(reds, block, quality);
+                else
+                    encode_BC5(reds, greens, block, quality);
+            }
+            block += block_size;
+        }
+    }, 1);
+}
+
+Images::UID compress(Images::UID image_ID, PixelFormat format, Quality quality) {
+    BIFROST_PROFILE_FUNCTION();
+    Image image = image_ID;
+    // Alpha images and BC6H images store linear values.
+    float gamma = image.get_pixel_format() == PixelFormat::Alpha8 || format == PixelFormat::BC6H_RGB ? 1.0f : image.get_gamma();
+    unsigned int mipmap_count = image.get_mipmap_count();
+    Vector3ui size = Vector3ui(image.get_width(), image.get_height(), image.get_depth());
+    Image compressed_image = Images::create3D(image.get_name(), format, gamma, size, mipmap_count);
+
+    for (unsigned int m = 0; m < mipmap_count; ++m)
+        compress_mipmap(image_ID, m, format, gamma, quality, compressed_image.get_pixels(m));
+
+    return compressed_image.get_ID();
+}
+
+} // NS BlockCompression
+} // NS Assets
+} // NS Bifrost
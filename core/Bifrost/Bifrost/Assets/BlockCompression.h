@@ -0,0 +1,70 @@
+// Bifrost block compression of images.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _BIFROST_ASSETS_BLOCK_COMPRESSION_H_
+#define _BIFROST_ASSETS_BLOCK_COMPRESSION_H_
+
+#include <Bifrost/Assets/Image.h>
+
+namespace Bifrost {
+namespace Assets {
+namespace BlockCompression {
+
+// ------------------------------------------------------------------------------------------------
+// Encoding and decoding of the BC1, BC4, BC5, BC6H and BC7 block formats.
+// A block stores 4x4 texels, where texel (x, y) has index x + 4 * y.
+// BC1 blocks are always encoded in the opaque four color mode.
+// BC6H blocks store unsigned half precision RGB and BC7 blocks store RGBA.
+// ------------------------------------------------------------------------------------------------
+
+enum class Quality {
+    Fast,   // Endpoints from the bounding box of the texels. BC6H and BC7 use a single subset.
+    Normal, // Endpoints along the principal axis of the texels, refined once by least squares.
+            // BC6H and BC7 also try the two subset partition that best fits the texels.
+    High    // Iterated least squares refinement and endpoint search. Several times slower than Normal.
+            // BC6H and BC7 search more partitions and modes. BC7 tries all channel rotations.
+};
+
+void encode_BC1(const Math::RGBA32 texels[16], unsigned char block[8], Quality quality);
+void encode_BC4(const unsigned char values[16], unsigned char block[8], Quality quality);
+void encode_BC5(const unsigned char reds[16], const unsigned char greens[16], unsigned char block[16], Quality quality);
+// Negative values are clamped to zero and large values to the largest half, 65504.
+void encode_BC6H(const Math::RGB texels[16], unsigned char block[16], Quality quality);
+void encode_BC7(const Math::RGBA32 texels[16], unsigned char block[16], Quality quality);
+
+// Alpha is always one in the decoded BC1 texels.
+void decode_BC1(const unsigned char block[8], Math::RGBA32 texels[16]);
+void decode_BC4(const unsigned char block[8], unsigned char values[16]);
+void decode_BC5(const unsigned char block[16], unsigned char reds[16], unsigned char greens[16]);
+// Reserved modes decode to black.
+void decode_BC6H(const unsigned char block[16], Math::RGB texels[16]);
+// Reserved modes decode to transparent black.
+void decode_BC7(const unsigned char block[16], Math::RGBA32 texels[16]);
+
+// Decodes the texel at pixel index x, y, z in the given mipmap level of a block compressed image.
+Math::RGBA decode_pixel(Images::UID image_ID, Math::Vector3ui index, unsigned int mipmap_level);
+
+// ------------------------------------------------------------------------------------------------
+// Image compression.
+// BC1_RGB encodes the RGB channels, BC4_Intensity encodes the red channel, or alpha for Alpha8 images,
+// BC5_RG encodes the red and green channels and BC7_RGBA encodes all four channels.
+// BC6H_RGB encodes the linear RGB channels as halfs, so it keeps values above one.
+// ------------------------------------------------------------------------------------------------
+
+// Compresses a mipmap level of the image into blocks, which must hold pixel_data_size(format, ...) bytes.
+// The texels are encoded with the given gamma. The blocks are compressed in parallel.
+void compress_mipmap(Images::UID image_ID, unsigned int mipmap_level, PixelFormat format, float gamma, Quality quality, void* blocks);
+
+// Returns a compressed copy of the image, including all its mipmap levels.
+Images::UID compress(Images::UID image_ID, PixelFormat format, Quality quality = Quality::Normal);
+
+} // NS BlockCompression
+} // NS Assets
+} // NS Bifrost
+
+#endif // _BIFROST_ASSETS_BLOCK_COMPRESSION_H_
@@ -6,7 +6,11 @@
 // See LICENSE.txt for more detail.
 // ---------------------------------------------------------------------------
 
+#include <Bifrost/Assets/BlockCompression.h>
 #include <Bifrost/Assets/Image.h>
+#include <Bifrost/Core/Hash.h>
+#include <Bifrost/Core/Profiler.h>
+#include <Bifrost/Math/HalfFloat.h>
 
 #include <assert.h>
 
@@ -90,18 +94,37 @@ static inline Images::PixelData allocate_pixels(PixelFormat format, unsigned int
         return new RGB[pixel_count];
     case PixelFormat::RGBA_Float:
         return new RGBA[pixel_count];
+    case PixelFormat::Intensity_Half:
+    case PixelFormat::RGB_Half:
+    case PixelFormat::RGBA_Half:
+        return new half[channel_count(format) * pixel_count];
+    case PixelFormat::BC1_RGB:
+    case PixelFormat::BC4_Intensity:
+    case PixelFormat::BC5_RG:
+    case PixelFormat::BC6H_RGB:
+    case PixelFormat::BC7_RGBA:
+        // Block compressed pixels are allocated from their size in bytes. See allocate_blocks.
     case PixelFormat::Unknown:
         return nullptr;
     }
     return nullptr;
 }
 
+static inline Images::PixelData allocate_blocks(unsigned int byte_count) {
+    return new unsigned char[byte_count];
+}
+
 static inline void deallocate_pixels(PixelFormat format, Images::PixelData data) {
     switch (format) {
     case PixelFormat::Alpha8:
     case PixelFormat::Intensity8:
     case PixelFormat::RGB24:
     case PixelFormat::RGBA32:
+    case PixelFormat::BC1_RGB:
+    case PixelFormat::BC4_Intensity:
+    case PixelFormat::BC5_RG:
+    case PixelFormat::BC6H_RGB:
+    case PixelFormat::BC7_RGBA:
         delete[] (unsigned char*)data;
         break;
     case PixelFormat::Intensity_Float:
@@ -113,6 +136,11 @@ static inline void deallocate_pixels(PixelFormat format, Images::PixelData data)
     case PixelFormat::RGBA_Float:
         delete[] (RGBA*)data;
         break;
+    case PixelFormat::Intensity_Half:
+    case PixelFormat::RGB_Half:
+    case PixelFormat::RGBA_Half:
+        delete[] (half*)data;
+        break;
     case PixelFormat::Unknown:
         printf("WARNING: Deallocating unknown pixel format.\n");
     }
@@ -141,17 +169,19 @@ Images::UID Images::create3D(const std::string& name, PixelFormat format, float
     metainfo.height = size.y;
     metainfo.depth = size.z;
     unsigned int total_pixel_count = 0u;
+    unsigned int total_data_size = 0u;
     unsigned int mip_count = 0u;
     while (mip_count != mipmap_count) {
         unsigned int mip_pixel_count = Images::get_width(id, mip_count) * Images::get_height(id, mip_count) * Images::get_depth(id, mip_count);
         total_pixel_count += mip_pixel_count;
+        total_data_size += pixel_data_size(format, Images::get_width(id, mip_count), Images::get_height(id, mip_count), Images::get_depth(id, mip_count));
         ++mip_count;
         if (mip_pixel_count == 1u)
             break;
     }
     metainfo.mipmap_count = mip_count;
     metainfo.is_mipmapable = false;
-    m_pixels[id] = allocate_pixels(format, total_pixel_count);
+    m_pixels[id] = is_block_compressed(format) ? allocate_blocks(total_data_size) : allocate_pixels(format, total_pixel_count);
     m_changes.set_change(id, Change::Created);
 
     return id;
@@ -209,10 +239,8 @@ void Images::set_mipmapable(Images::UID image_ID, bool value) {
 
 Images::PixelData Images::get_pixels(Images::UID image_ID, int mipmap_level) {
     char* pixel_data = (char*)m_pixels[image_ID];
-    int bytes_pr_pixel = size_of(get_pixel_format(image_ID));
-    for (int l = 0; l < mipmap_level; ++l) {
-        pixel_data += get_pixel_count(image_ID, l) * bytes_pr_pixel;
-    }
+    for (int l = 0; l < mipmap_level; ++l)
+        pixel_data += get_pixel_data_size(image_ID, l);
     return pixel_data;
 }
 
@@ -245,6 +273,24 @@ static RGBA get_nonlinear_pixel(Images::PixelData pixels, PixelFormat format, un
     case PixelFormat::RGBA_Float: {
         return ((RGBA*)pixels)[index];
     }
+    case PixelFormat::Intensity_Half: {
+        float value = to_float(((half*)pixels)[index]);
+        return RGBA(value, value, value, 1.0f);
+    }
+    case PixelFormat::RGB_Half: {
+        half* pixel = ((half*)pixels) + index * 3;
+        return RGBA(to_float(pixel[0]), to_float(pixel[1]), to_float(pixel[2]), 1.0f);
+    }
+    case PixelFormat::RGBA_Half: {
+        half* pixel = ((half*)pixels) + index * 4;
+        return RGBA(to_float(pixel[0]), to_float(pixel[1]), to_float(pixel[2]), to_float(pixel[3]));
+    }
+    case PixelFormat::BC1_RGB:
+    case PixelFormat::BC4_Intensity:
+    case PixelFormat::BC5_RG:
+    case PixelFormat::BC6H_RGB:
+    case PixelFormat::BC7_RGBA:
+        // Block compressed pixels cannot be looked up by index. See BlockCompression::decode_pixel.
     case PixelFormat::Unknown:
         return RGBA::red();
     }
@@ -261,6 +307,12 @@ static inline RGBA get_linear_pixel(Images::UID image_ID, unsigned int index) {
 RGBA Images::get_pixel(Images::UID image_ID, unsigned int index, unsigned int mipmap_level) {
     assert(index < Images::get_pixel_count(image_ID, mipmap_level));
 
+    if (is_block_compressed(get_pixel_format(image_ID))) {
+        unsigned int width = get_width(image_ID, mipmap_level), height = get_height(image_ID, mipmap_level);
+        Vector3ui pixel_index = Vector3ui(index % width, (index / width) % height, index / (width * height));
+        return BlockCompression::decode_pixel(image_ID, pixel_index, mipmap_level);
+    }
+
     while (mipmap_level)
         index += Images::get_width(image_ID, --mipmap_level);
     return get_linear_pixel(image_ID, index);
@@ -270,6 +322,9 @@ RGBA Images::get_pixel(Images::UID image_ID, Vector2ui index, unsigned int mipma
     assert(index.x < Images::get_width(image_ID, mipmap_level));
     assert(index.y < Images::get_height(image_ID, mipmap_level));
 
+    if (is_block_compressed(get_pixel_format(image_ID)))
+        return BlockCompression::decode_pixel(image_ID, Vector3ui(index.x, index.y, 0u), mipmap_level);
+
     Image image = image_ID;
     unsigned int pixel_index = index.x + image.get_width(mipmap_level) * index.y;
 
@@ -285,6 +340,9 @@ RGBA Images::get_pixel(Images::UID image_ID, Vector3ui index, unsigned int mipma
     assert(index.y < Images::get_height(image_ID, mipmap_level));
     assert(index.z < Images::get_depth(image_ID, mipmap_level));
 
+    if (is_block_compressed(get_pixel_format(image_ID)))
+        return BlockCompression::decode_pixel(image_ID, index, mipmap_level);
+
     Image image = image_ID;
     unsigned int pixel_index = index.x + image.get_width(mipmap_level) * (index.y + image.get_height(mipmap_level) * index.z);
     while (mipmap_level) {
@@ -334,6 +392,31 @@ static void set_linear_pixel(Images::PixelData pixels, PixelFormat pixel_format,
         ((RGBA*)pixels)[index] = color;
         break;
     }
+    case PixelFormat::Intensity_Half: {
+        ((half*)pixels)[index] = to_half(color.r);
+        break;
+    }
+    case PixelFormat::RGB_Half: {
+        half* pixel = ((half*)pixels) + index * 3;
+        pixel[0] = to_half(color.r);
+        pixel[1] = to_half(color.g);
+        pixel[2] = to_half(color.b);
+        break;
+    }
+    case PixelFormat::RGBA_Half: {
+        half* pixel = ((half*)pixels) + index * 4;
+        pixel[0] = to_half(color.r);
+        pixel[1] = to_half(color.g);
+        pixel[2] = to_half(color.b);
+        pixel[3] = to_half(color.a);
+        break;
+    }
+    case PixelFormat::BC1_RGB:
+    case PixelFormat::BC4_Intensity:
+    case PixelFormat::BC5_RG:
+    case PixelFormat::BC6H_RGB:
+    case PixelFormat::BC7_RGBA:
+        // Block compressed images are read only.
     case PixelFormat::Unknown:
         ;
     }
@@ -342,6 +425,7 @@ static void set_linear_pixel(Images::PixelData pixels, PixelFormat pixel_format,
 static inline void set_linear_pixel(Images::UID image_ID, RGBA color, unsigned int index) {
     Images::PixelData pixels = Images::get_pixels(image_ID);
     PixelFormat format = Images::get_pixel_format(image_ID);
+    assert(!is_block_compressed(format)); // Block compressed images are read only.
     set_linear_pixel(pixels, format, index, color, Images::get_gamma(image_ID));
 }
 
@@ -386,6 +470,7 @@ void Images::set_pixel(Images::UID image_ID, RGBA color, Vector3ui index, unsign
 }
 
 void Images::change_format(Images::UID image_ID, PixelFormat new_format, float new_gamma) {
+    BIFROST_PROFILE_FUNCTION();
     Image image = image_ID;
     PixelFormat old_format = image.get_pixel_format();
     float old_gamma = image.get_gamma();
@@ -402,7 +487,55 @@ void Images::change_format(Images::UID image_ID, PixelFormat new_format, float n
         }
     };
 
-    if (old_format == PixelFormat::Intensity8 && new_format == PixelFormat::Alpha8) {
+    bool is_float_half_conversion = (is_float_format(old_format) && is_half_format(new_format)) || (is_half_format(old_format) && is_float_format(new_format));
+    if (is_block_compressed(new_format)) {
+        // Alpha images and BC6H images store linear values, see BlockCompression::compress.
+        if (old_format == PixelFormat::Alpha8 || new_format == PixelFormat::BC6H_RGB)
+            new_gamma = 1.0f;
+
+        // Compress each mipmap level.
+        unsigned int total_data_size = 0;
+        for (unsigned int m = 0; m < image.get_mipmap_count(); ++m)
+            total_data_size += pixel_data_size(new_format, image.get_width(m), image.get_height(m), image.get_depth(m));
+        PixelData new_pixels = allocate_blocks(total_data_size);
+
+        unsigned char* mipmap_blocks = (unsigned char*)new_pixels;
+        for (unsigned int m = 0; m < image.get_mipmap_count(); ++m) {
+            BlockCompression::compress_mipmap(image_ID, m, new_format, new_gamma, BlockCompression::Quality::Normal, mipmap_blocks);
+            mipmap_blocks += pixel_data_size(new_format, image.get_width(m), image.get_height(m), image.get_depth(m));
+        }
+
+        deallocate_pixels(old_format, m_pixels[image_ID]);
+        m_pixels[image_ID] = new_pixels;
+    } else if (is_block_compressed(old_format)) {
+        // Decompress each mipmap level.
+        PixelData new_pixels = allocate_pixels(new_format, total_pixel_count);
+        unsigned int pixel_offset = 0;
+        for (unsigned int m = 0; m < image.get_mipmap_count(); ++m) {
+            unsigned int width = image.get_width(m), height = image.get_height(m), depth = image.get_depth(m);
+            for (unsigned int z = 0; z < depth; ++z)
+                for (unsigned int y = 0; y < height; ++y)
+                    for (unsigned int x = 0; x < width; ++x) {
+                        RGBA pixel = BlockCompression::decode_pixel(image_ID, Vector3ui(x, y, z), m);
+                        set_linear_pixel(new_pixels, new_format, pixel_offset + x + width * (y + height * z), pixel, new_gamma);
+                    }
+            pixel_offset += width * height * depth;
+        }
+
+        deallocate_pixels(old_format, m_pixels[image_ID]);
+        m_pixels[image_ID] = new_pixels;
+    } else if (is_float_half_conversion && channel_count(old_format) == channel_count(new_format) && old_gamma == new_gamma) {
+        // Convert the channels in bulk between float and half precision.
+        PixelData new_pixels = allocate_pixels(new_format, total_pixel_count);
+        int value_count = total_pixel_count * channel_count(new_format);
+        if (is_half_format(new_format))
+            to_half((float*)m_pixels[image_ID], (half*)new_pixels, value_count);
+        else
+            to_float((half*)m_pixels[image_ID], (float*)new_pixels, value_count);
+
+        deallocate_pixels(old_format, m_pixels[image_ID]);
+        m_pixels[image_ID] = new_pixels;
+    } else if (old_format == PixelFormat::Intensity8 && new_format == PixelFormat::Alpha8) {
         // Gamma correct if intensity values have been gamma corrected.
         // Alpha is not affected by gamma, so new gamma is effectively one.
         if (old_gamma != 1.0f)
@@ -447,6 +580,7 @@ void Images::change_format(Images::UID image_ID, PixelFormat new_format, float n
     }
 
     m_metainfo[image_ID].pixel_format = new_format;
+    m_metainfo[image_ID].gamma = new_format == PixelFormat::Alpha8 ? 1.0f : new_gamma;
     m_changes.add_change(image_ID, Change::PixelsUpdated);
 }
 
@@ -458,10 +592,12 @@ void Images::change_format(Images::UID image_ID, PixelFormat new_format, float n
 namespace ImageUtils {
 
 void fill_mipmap_chain(Images::UID image_ID) {
+    BIFROST_PROFILE_FUNCTION();
     // assert that depth is 1, since 3D textures are not supported.
 
     // Future work: Optimize for the most used data formats.
     Image image = image_ID;
+    assert(!is_block_compressed(image.get_pixel_format())); // Compress the image after filling the mipmap chain.
     for (unsigned int m = 0; m < image.get_mipmap_count() - 1; ++m) {
         for (unsigned int y = 0; y + 1 < image.get_height(m); y += 2) { // TODO Doesn't work with 1D textures does it?
             for (unsigned int x = 0; x + 1 < image.get_width(m); x += 2) {
@@ -515,6 +651,7 @@ void fill_mipmap_chain(Images::UID image_ID) {
 }
 
 void compute_summed_area_table(Images::UID image_ID, RGBA* sat_result) {
+    BIFROST_PROFILE_FUNCTION();
     Image img = image_ID;
     unsigned int width = img.get_width(), height = img.get_height();
 
@@ -547,6 +684,7 @@ void compute_summed_area_table(Images::UID image_ID, RGBA* sat_result) {
 }
 
 Image combine_tint_roughness(const Image tint, const Image roughness, int roughness_channel) {
+    BIFROST_PROFILE_FUNCTION();
     PixelFormat tint_format = tint.get_pixel_format();
     PixelFormat roughness_format = roughness.get_pixel_format();
 
@@ -659,6 +797,38 @@ Image combine_tint_roughness(const Image tint, const Image roughness, int roughn
     }
 }
 
+unsigned long long hash(Images::UID image_ID) {
+    BIFROST_PROFILE_FUNCTION();
+    Image image = image_ID;
+    PixelFormat format = image.get_pixel_format();
+    float gamma = image.get_gamma();
+    unsigned int mipmap_count = image.get_mipmap_count();
+    Vector3ui size = Vector3ui(image.get_width(), image.get_height(), image.get_depth());
+
+    unsigned long long hash = Core::hash64(&format, sizeof(format));
+    hash = Core::hash64(&gamma, sizeof(gamma), hash);
+    hash = Core::hash64(&mipmap_count, sizeof(mipmap_count), hash);
+    hash = Core::hash64(&size, sizeof(size), hash);
+    for (unsigned int m = 0; m < mipmap_count; ++m)
+        hash = Core::hash64(image.get_pixels(m), image.get_pixel_data_size(m), hash);
+    return hash;
+}
+
+bool has_identical_pixels(Images::UID image_ID, Images::UID other_image_ID) {
+    BIFROST_PROFILE_FUNCTION();
+    Image image = image_ID, other_image = other_image_ID;
+    PixelFormat format = image.get_pixel_format();
+    unsigned int mipmap_count = image.get_mipmap_count();
+    if (format != other_image.get_pixel_format() || image.get_gamma() != other_image.get_gamma() || mipmap_count != other_image.get_mipmap_count() ||
+        image.get_width() != other_image.get_width() || image.get_height() != other_image.get_height() || image.get_depth() != other_image.get_depth())
+        return false;
+
+    for (unsigned int m = 0; m < mipmap_count; ++m)
+        if (memcmp(image.get_pixels(m), other_image.get_pixels(m), image.get_pixel_data_size(m)) != 0)
+            return false;
+    return true;
+}
+
 } // NS ImageUtils
 
 } // NS Assets
@@ -32,18 +32,55 @@ enum class PixelFormat {
     Intensity_Float, // Uses the red channel when getting and setting pixels. Alpha is always one when getting a pixel. Green and blue are undefined.
     RGB_Float,
     RGBA_Float,
+    Intensity_Half, // Uses the red channel when getting and setting pixels. Alpha is always one when getting a pixel. Green and blue are undefined.
+    RGB_Half,
+    RGBA_Half,
+    BC1_RGB, // Block compressed. Read only, see BlockCompression.h.
+    BC4_Intensity, // Block compressed. Uses the red channel when getting pixels. Read only, see BlockCompression.h.
+    BC5_RG, // Block compressed. Blue is zero when getting pixels. Read only, see BlockCompression.h.
+    BC6H_RGB, // Block compressed unsigned halfs. Read only, see BlockCompression.h.
+    BC7_RGBA, // Block compressed. Read only, see BlockCompression.h.
 };
 
+inline bool is_block_compressed(PixelFormat format) {
+    return format == PixelFormat::BC1_RGB || format == PixelFormat::BC4_Intensity || format == PixelFormat::BC5_RG ||
+           format == PixelFormat::BC6H_RGB || format == PixelFormat::BC7_RGBA;
+}
+
+// Bytes pr 4x4 block of a block compressed format.
+inline int block_size_of(PixelFormat format) {
+    switch (format) {
+    case PixelFormat::BC1_RGB:
+    case PixelFormat::BC4_Intensity:
+        return 8;
+    case PixelFormat::BC5_RG:
+    case PixelFormat::BC6H_RGB:
+    case PixelFormat::BC7_RGBA:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
 inline int size_of(PixelFormat format) {
     switch (format) {
     case PixelFormat::Alpha8:
     case PixelFormat::Intensity8: return 1;
+    case PixelFormat::Intensity_Half: return 2;
     case PixelFormat::RGB24: return 3;
     case PixelFormat::RGBA32:
     case PixelFormat::Intensity_Float:
         return 4;
+    case PixelFormat::RGB_Half: return 6;
+    case PixelFormat::RGBA_Half: return 8;
     case PixelFormat::RGB_Float: return 12;
     case PixelFormat::RGBA_Float: return 16;
+    case PixelFormat::BC1_RGB:
+    case PixelFormat::BC4_Intensity:
+    case PixelFormat::BC5_RG:
+    case PixelFormat::BC6H_RGB:
+    case PixelFormat::BC7_RGBA:
+        return 0; // Block compressed formats have no pr pixel size. See block_size_of.
     case PixelFormat::Unknown:
     default:
         return 0;
@@ -54,13 +91,22 @@ inline int channel_count(PixelFormat format) {
     switch (format) {
     case PixelFormat::RGBA32:
     case PixelFormat::RGBA_Float:
+    case PixelFormat::RGBA_Half:
+    case PixelFormat::BC7_RGBA:
         return 4;
     case PixelFormat::RGB24:
     case PixelFormat::RGB_Float:
+    case PixelFormat::RGB_Half:
+    case PixelFormat::BC1_RGB:
+    case PixelFormat::BC6H_RGB:
         return 3;
+    case PixelFormat::BC5_RG:
+        return 2;
     case PixelFormat::Alpha8:
     case PixelFormat::Intensity8:
     case PixelFormat::Intensity_Float:
+    case PixelFormat::Intensity_Half:
+    case PixelFormat::BC4_Intensity:
         return 1;
     case PixelFormat::Unknown:
     default:
@@ -69,7 +115,23 @@ inline int channel_count(PixelFormat format) {
 }
 
 inline bool has_alpha(PixelFormat format) {
-    return format == PixelFormat::Alpha8 || format == PixelFormat::RGBA32 || format == PixelFormat::RGBA_Float;
+    return format == PixelFormat::Alpha8 || format == PixelFormat::RGBA32 || format == PixelFormat::RGBA_Float || format == PixelFormat::RGBA_Half ||
+           format == PixelFormat::BC7_RGBA;
+}
+
+inline bool is_half_format(PixelFormat format) {
+    return format == PixelFormat::Intensity_Half || format == PixelFormat::RGB_Half || format == PixelFormat::RGBA_Half;
+}
+
+inline bool is_float_format(PixelFormat format) {
+    return format == PixelFormat::Intensity_Float || format == PixelFormat::RGB_Float || format == PixelFormat::RGBA_Float;
+}
+
+// Bytes used by the pixels of an image or mipmap level of the given size. Block compressed images are padded to whole blocks.
+inline unsigned int pixel_data_size(PixelFormat format, unsigned int width, unsigned int height, unsigned int depth = 1u) {
+    if (is_block_compressed(format))
+        return ((width + 3) / 4) * ((height + 3) / 4) * depth * block_size_of(format);
+    return width * height * depth * size_of(format);
 }
 
 //----------------------------------------------------------------------------
@@ -136,6 +198,9 @@ public:
     static void set_mipmapable(Images::UID image_ID, bool value);
 
     static PixelData get_pixels(Images::UID image_ID, int mipmap_level = 0);
+    static unsigned int get_pixel_data_size(Images::UID image_ID, int mipmap_level = 0) {
+        return pixel_data_size(get_pixel_format(image_ID), get_width(image_ID, mipmap_level), get_height(image_ID, mipmap_level), get_depth(image_ID, mipmap_level));
+    }
     template <typename T>
     static T* get_pixels(Images::UID image_ID, int mipmap_level = 0) {
         assert(sizeof(T) == size_of(get_pixel_format(image_ID)));
@@ -236,6 +301,7 @@ public:
 
     inline Images::PixelData get_pixels(unsigned int mipmap_level = 0) { return Images::get_pixels(m_ID, mipmap_level); }
     inline const Images::PixelData get_pixels(unsigned int mipmap_level = 0) const { return Images::get_pixels(m_ID, mipmap_level); }
+    inline unsigned int get_pixel_data_size(unsigned int mipmap_level = 0) const { return Images::get_pixel_data_size(m_ID, mipmap_level); }
     template <typename T>
     inline T* get_pixels(int mipmap_level = 0) { return Images::get_pixels<T>(m_ID, mipmap_level); }
     template <typename T>
@@ -302,6 +368,11 @@ inline Math::RGBA* compute_summed_area_table(Images::UID image_ID) {
 
 Image combine_tint_roughness(const Image tint, const Image roughness, int roughness_channel = 3);
 
+// 64 bit hash of the image's format, gamma, size and pixels. Images with identical pixels have identical hashes.
+unsigned long long hash(Images::UID image_ID);
+// Returns true if the images have the same format, gamma and size and identical pixels.
+bool has_identical_pixels(Images::UID image_ID, Images::UID other_image_ID);
+
 } // NS ImageUtils
 
 } // NS Assets
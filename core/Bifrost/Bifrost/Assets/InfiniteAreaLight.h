@@ -11,7 +11,9 @@
 
 #include <Bifrost/Assets/Texture.h>
 #include <Bifrost/Math/Distribution2D.h>
+#include <Bifrost/Math/SphericalHarmonics.h>
 
+#include <filesystem>
 #include <memory>
 
 namespace Bifrost {
@@ -141,6 +143,35 @@ inline void convolute(const InfiniteAreaLight& light, IBLConvolution<Math::RGB>*
     convolute(light, begin, end, [](Math::RGB c) -> Math::RGB { return c; });
 }
 
+// Prefilters the environment with the same GGX kernel as convolute, but using filtered importance sampling.
+// Each GGX sample reads a mipmap level of the environment whose texels cover roughly the same solid angle as the sample,
+// so a low number of samples produce a smooth result. All output pixels of all convolutions are filtered in one parallel pass.
+// See Krivanek and Colbert, Real-time Shading with Filtered Importance Sampling, 2008.
+template <typename T, typename F>
+inline void prefilter(const InfiniteAreaLight& light, IBLConvolution<T>* begin, IBLConvolution<T>* end, F color_conversion);
+
+inline void prefilter(const InfiniteAreaLight& light, IBLConvolution<Math::RGB>* begin, IBLConvolution<Math::RGB>* end) {
+    prefilter(light, begin, end, [](Math::RGB c) -> Math::RGB { return c; });
+}
+
+// Version of the prefiltering algorithm. Bump it whenever prefilter changes its output, to invalidate cached environments.
+static const unsigned int prefilter_cache_version = 1;
+
+// Prefilters the environment as above, but caches the result in the cache directory.
+// The cache file is keyed by a hash of the prefilter cache version, the environment's pixels and the convolution parameters,
+// so repeated prefiltering of the same environment only reads the cached pixels.
+// The color conversion is not part of the key and must be the same for all prefiltered environments with the same pixel type.
+// Returns true if the pixels were read from the cache.
+template <typename T, typename F>
+inline bool prefilter_cached(const InfiniteAreaLight& light, IBLConvolution<T>* begin, IBLConvolution<T>* end, F color_conversion,
+                             const std::filesystem::path& cache_directory);
+
+// Projects the radiance of the light onto spherical harmonics with the given number of bands.
+// Each pixel is weighted by the solid angle it subtends and all pixels are processed in a single parallel pass.
+// Evaluating the irradiance of the resulting coefficients approximates convolution with a roughness 1 / diffuse lobe.
+template <int ORDER>
+inline Math::SphericalHarmonics<Math::RGB, ORDER> project_to_spherical_harmonics(const InfiniteAreaLight& light);
+
 // Reconstructs the solid angle per pixel PDF from the CDFs.
 // WARNING: The PDF has not been scaled by sin_theta. This can only be done when the final sample direction is known.
 inline void reconstruct_solid_angle_PDF_sans_sin_theta(const InfiniteAreaLight& light, float* per_pixel_PDF);
@@ -8,11 +8,16 @@
 
 #include <Bifrost/Assets/InfiniteAreaLight.h>
 
+#include <Bifrost/Core/Hash.h>
+#include <Bifrost/Core/Parallel.h>
 #include <Bifrost/Math/Constants.h>
 #include <Bifrost/Math/Distributions.h>
 #include <Bifrost/Math/Quaternion.h>
 #include <Bifrost/Math/RNG.h>
 
+#include <fstream>
+#include <vector>
+
 namespace Bifrost {
 namespace Assets {
 
@@ -122,9 +127,9 @@ inline void convolute(const InfiniteAreaLight& light, IBLConvolution<T>* begin,
     // Precompute light samples.
     std::vector<LightSample> light_samples = std::vector<LightSample>();
     light_samples.resize(max_sample_count * 4);
-    #pragma omp parallel for schedule(dynamic, 16)
-    for (int s = 0; s < light_samples.size(); ++s)
+    Core::Parallel::parallel_for(0, int(light_samples.size()), [&](int s) {
         light_samples[s] = light.sample(RNG::sample02(s));
+    });
 
     for (; begin != end; ++begin) {
 
@@ -135,22 +140,20 @@ inline void convolute(const InfiniteAreaLight& light, IBLConvolution<T>* begin,
         // Handle nearly specular case.
         if (alpha < 0.00000000001f) {
             Textures::UID env_map_ID = light.get_texture_ID();
-            #pragma omp parallel for schedule(dynamic, 16)
-            for (int i = 0; i < width * height; ++i) {
+            Core::Parallel::parallel_for(0, width * height, [&](int i) {
                 int x = i % width, y = i / width;
                 begin->Pixels[x + y * width] = color_conversion(sample2D(env_map_ID, Vector2f((x + 0.5f) / width, (y + 0.5f) / height)).rgb());
-            }
+            });
             continue;
         }
 
         std::vector<GGX::Sample> ggx_samples = std::vector<GGX::Sample>();
         ggx_samples.resize(begin->sample_count * 4);
-        #pragma omp parallel for schedule(dynamic, 16)
-        for (int s = 0; s < ggx_samples.size(); ++s)
+        Core::Parallel::parallel_for(0, int(ggx_samples.size()), [&](int s) {
             ggx_samples[s] = GGX::sample(alpha, RNG::sample02(s));
+        });
 
-        #pragma omp parallel for schedule(dynamic, 16)
-        for (int i = 0; i < width * height; ++i) {
+        Core::Parallel::parallel_for(0, width * height, [&](int i) {
 
             int x = i % width;
             int y = i / width;
@@ -191,8 +194,237 @@ inline void convolute(const InfiniteAreaLight& light, IBLConvolution<T>* begin,
             // Account for the samples being split evenly between BSDF and light.
             radiance *= 2.0f;
             begin->Pixels[x + y * width] = color_conversion(radiance / float(begin->sample_count));
+        });
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Mipmapped latlong radiance used for filtered importance sampling.
+// Each level is a 2x2 box filtered version of the previous level. Sampling is bilinear within a level,
+// repeats horizontally and clamps vertically, and is linear between levels.
+// ------------------------------------------------------------------------------------------------
+class LatLongMipmaps final {
+    struct Level {
+        int width, height;
+        std::vector<Math::RGB> pixels;
+    };
+    std::vector<Level> m_levels;
+
+public:
+    LatLongMipmaps(Image image) {
+        using namespace Bifrost::Math;
+
+        Level level0 = { int(image.get_width()), int(image.get_height()), std::vector<RGB>(image.get_pixel_count()) };
+        Core::Parallel::parallel_for(0, level0.height, [&](int y) {
+            for (int x = 0; x < level0.width; ++x)
+                level0.pixels[x + y * level0.width] = image.get_pixel(Vector2ui(x, y)).rgb();
+        });
+        m_levels.push_back(std::move(level0));
+
+        while (m_levels.back().width > 1 || m_levels.back().height > 1) {
+            const Level& previous = m_levels.back();
+            Level level = { std::max(1, previous.width / 2), std::max(1, previous.height / 2), {} };
+            level.pixels.resize(level.width * level.height);
+            Core::Parallel::parallel_for(0, level.height, [&](int y) {
+                int y0 = std::min(2 * y, previous.height - 1), y1 = std::min(2 * y + 1, previous.height - 1);
+                for (int x = 0; x < level.width; ++x) {
+                    int x0 = std::min(2 * x, previous.width - 1), x1 = std::min(2 * x + 1, previous.width - 1);
+                    RGB sum = previous.pixels[x0 + y0 * previous.width] + previous.pixels[x1 + y0 * previous.width] +
+                              previous.pixels[x0 + y1 * previous.width] + previous.pixels[x1 + y1 * previous.width];
+                    level.pixels[x + y * level.width] = sum * 0.25f;
+                }
+            });
+            m_levels.push_back(std::move(level));
+        }
+    }
+
+    inline int get_level_count() const { return int(m_levels.size()); }
+    inline int get_width() const { return m_levels[0].width; }
+    inline int get_height() const { return m_levels[0].height; }
+
+    Math::RGB sample(Math::Vector2f uv, int level_index) const {
+        const Level& level = m_levels[level_index];
+        float x = uv.x * level.width - 0.5f, y = uv.y * level.height - 0.5f;
+        float floor_x = floorf(x), floor_y = floorf(y);
+        float tx = x - floor_x, ty = y - floor_y;
+
+        int x0 = int(floor_x) % level.width;
+        x0 = x0 < 0 ? x0 + level.width : x0;
+        int x1 = x0 + 1 == level.width ? 0 : x0 + 1;
+        int y0 = Math::clamp(int(floor_y), 0, level.height - 1);
+        int y1 = Math::clamp(int(floor_y) + 1, 0, level.height - 1);
+
+        const Math::RGB* row0 = level.pixels.data() + y0 * level.width;
+        const Math::RGB* row1 = level.pixels.data() + y1 * level.width;
+        Math::RGB lower = Math::lerp(row0[x0], row0[x1], tx);
+        Math::RGB upper = Math::lerp(row1[x0], row1[x1], tx);
+        return Math::lerp(lower, upper, ty);
+    }
+
+    Math::RGB sample(Math::Vector2f uv, float level) const {
+        level = Math::clamp(level, 0.0f, float(get_level_count() - 1));
+        int lower_level = int(level);
+        float t = level - lower_level;
+        Math::RGB radiance = sample(uv, lower_level);
+        if (t > 0.0f)
+            radiance = Math::lerp(radiance, sample(uv, lower_level + 1), t);
+        return radiance;
+    }
+};
+
+template <typename T, typename F>
+inline void prefilter(const InfiniteAreaLight& light, IBLConvolution<T>* begin, IBLConvolution<T>* end, F color_conversion) {
+    using namespace Bifrost::Math;
+    using namespace Bifrost::Math::Distributions;
+
+    const LatLongMipmaps mipmaps = LatLongMipmaps(light.get_image_ID());
+    // Solid angle of a texel in the first level at the equator.
+    float texel_solid_angle = 2.0f * PI<float>() * PI<float>() / (mipmaps.get_width() * mipmaps.get_height());
+
+    // Precompute the GGX samples and the pixel offsets of the convolutions, so all pixels can be filtered in one pass.
+    int convolution_count = int(end - begin);
+    std::vector<std::vector<GGX::Sample>> ggx_samples(convolution_count);
+    std::vector<int> pixel_offsets(convolution_count + 1);
+    pixel_offsets[0] = 0;
+    for (int c = 0; c < convolution_count; ++c) {
+        const IBLConvolution<T>& convolution = begin[c];
+        float alpha = convolution.Roughness * convolution.Roughness;
+        if (alpha >= 0.00000000001f) {
+            ggx_samples[c].resize(convolution.sample_count);
+            for (int s = 0; s < convolution.sample_count; ++s)
+                ggx_samples[c][s] = GGX::sample(alpha, RNG::sample02(s));
+        }
+        pixel_offsets[c + 1] = pixel_offsets[c] + convolution.Width * convolution.Height;
+    }
+
+    Core::Parallel::parallel_for(0, pixel_offsets[convolution_count], [&](int global_index) {
+        int c = 0;
+        while (pixel_offsets[c + 1] <= global_index)
+            ++c;
+        const IBLConvolution<T>& convolution = begin[c];
+        int i = global_index - pixel_offsets[c];
+        int width = convolution.Width, height = convolution.Height;
+        int x = i % width, y = i / width;
+        Vector2f up_uv = Vector2f((x + 0.5f) / width, (y + 0.5f) / height);
+
+        // Handle nearly specular case.
+        const std::vector<GGX::Sample>& samples = ggx_samples[c];
+        if (samples.empty()) {
+            convolution.Pixels[i] = color_conversion(mipmaps.sample(up_uv, 0));
+            return;
+        }
+
+        Vector3f up_vector = latlong_texcoord_to_direction(up_uv);
+        Quaternionf up_rotation = Quaternionf::look_in(up_vector);
+
+        RGB radiance = RGB::black();
+        for (const GGX::Sample& sample : samples) {
+            if (sample.PDF < 0.000000001f)
+                continue;
+
+            Vector3f direction = normalize(up_rotation * sample.direction);
+
+            // Select the level where a texel covers the solid angle of the sample.
+            // Texels only shrink horizontally towards the poles, so the solid angle at the equator is used
+            // to avoid blurring the environment vertically near the poles.
+            float sample_solid_angle = 1.0f / (samples.size() * sample.PDF);
+            float level = 0.5f * log2f(sample_solid_angle / texel_solid_angle) + 1.0f;
+
+            radiance += mipmaps.sample(direction_to_latlong_texcoord(direction), level);
         }
+
+        convolution.Pixels[i] = color_conversion(radiance / float(samples.size()));
+    }, 64);
+}
+
+template <typename T, typename F>
+inline bool prefilter_cached(const InfiniteAreaLight& light, IBLConvolution<T>* begin, IBLConvolution<T>* end, F color_conversion,
+                             const std::filesystem::path& cache_directory) {
+    // Key the cache on the algorithm version, the environment's pixels and the convolution parameters.
+    Image image = light.get_image_ID();
+    unsigned long long key = Core::hash64(&prefilter_cache_version, sizeof(prefilter_cache_version));
+    key = Core::hash64(image.get_pixels(), image.get_pixel_data_size(0), key);
+    unsigned int image_description[4] = { image.get_width(), image.get_height(), (unsigned int)image.get_pixel_format(), (unsigned int)sizeof(T) };
+    key = Core::hash64(image_description, sizeof(image_description), key);
+    float gamma = image.get_gamma();
+    key = Core::hash64(&gamma, sizeof(gamma), key);
+    size_t pixel_count = 0;
+    for (IBLConvolution<T>* itr = begin; itr != end; ++itr) {
+        int parameters[3] = { itr->Width, itr->Height, itr->sample_count };
+        key = Core::hash64(parameters, sizeof(parameters), key);
+        key = Core::hash64(&itr->Roughness, sizeof(float), key);
+        pixel_count += itr->Width * itr->Height;
     }
+
+    char filename[32];
+    snprintf(filename, sizeof(filename), "%016llx.ibl", key);
+    std::filesystem::path cache_path = cache_directory / filename;
+
+    { // Read the pixels from the cache if they have been prefiltered before.
+        std::error_code error;
+        std::ifstream file(cache_path, std::ios::binary);
+        if (file && std::filesystem::file_size(cache_path, error) == sizeof(key) + pixel_count * sizeof(T)) {
+            unsigned long long file_key;
+            file.read((char*)&file_key, sizeof(file_key));
+            if (file_key == key) {
+                for (IBLConvolution<T>* itr = begin; itr != end; ++itr)
+                    file.read((char*)itr->Pixels, itr->Width * itr->Height * sizeof(T));
+                if (file)
+                    return true;
+            }
+        }
+    }
+
+    prefilter(light, begin, end, color_conversion);
+
+    { // Write the prefiltered pixels to the cache.
+        std::error_code error;
+        std::filesystem::create_directories(cache_directory, error);
+        std::ofstream file(cache_path, std::ios::binary);
+        if (file) {
+            file.write((const char*)&key, sizeof(key));
+            for (IBLConvolution<T>* itr = begin; itr != end; ++itr)
+                file.write((const char*)itr->Pixels, itr->Width * itr->Height * sizeof(T));
+        }
+        if (!file)
+            printf("Could not write prefiltered environment to '%s'\n", cache_path.string().c_str());
+    }
+
+    return false;
+}
+
+template <int ORDER>
+inline Math::SphericalHarmonics<Math::RGB, ORDER> project_to_spherical_harmonics(const InfiniteAreaLight& light) {
+    using namespace Bifrost::Math;
+    typedef SphericalHarmonics<RGB, ORDER> SH;
+
+    Image image = light.get_image_ID();
+    int width = light.get_width(), height = light.get_height();
+
+    auto project_rows = [&](int row_begin, int row_end, SH sh) -> SH {
+        for (int y = row_begin; y < row_end; ++y) {
+            // The solid angle of a pixel in the row is the area of the band between its polar angles divided by the width.
+            float cos_theta_begin = cosf(PI<float>() * y / height);
+            float cos_theta_end = cosf(PI<float>() * (y + 1) / height);
+            float pixel_solid_angle = 2.0f * PI<float>() * (cos_theta_begin - cos_theta_end) / width;
+
+            // Accumulate the row separately to reduce round off error when adding it to the coefficients.
+            SH row_sh = SH::zero();
+            float v = (y + 0.5f) / height;
+            for (int x = 0; x < width; ++x) {
+                Vector3f direction = latlong_texcoord_to_direction(Vector2f((x + 0.5f) / width, v));
+                row_sh.add(direction, image.get_pixel(Vector2ui(x, y)).rgb(), 1.0f);
+            }
+
+            for (int i = 0; i < SH::COEFFICIENT_COUNT; ++i)
+                sh.coefficients[i] += row_sh.coefficients[i] * pixel_solid_angle;
+        }
+        return sh;
+    };
+    auto merge = [](SH lhs, const SH& rhs) -> SH { return lhs += rhs; };
+
+    const int row_grain_size = 4;
+    return Core::Parallel::parallel_reduce(0, height, SH::zero(), project_rows, merge, row_grain_size);
 }
 
 inline void reconstruct_solid_angle_PDF_sans_sin_theta(const InfiniteAreaLight& light, float* per_pixel_PDF) {
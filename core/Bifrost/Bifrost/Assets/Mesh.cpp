@@ -7,16 +7,25 @@
 // ---------------------------------------------------------------------------
 
 #include <Bifrost/Assets/Mesh.h>
+#include <Bifrost/Core/Hash.h>
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Core/Profiler.h>
 
 #include <Bifrost/Math/Conversions.h>
+#include <Bifrost/Math/Packet.h>
 
+#include <algorithm>
 #include <assert.h>
+#include <vector>
 
 using namespace Bifrost::Math;
 
 namespace Bifrost {
 namespace Assets {
 
+// The number of vertices processed by each task in bulk vertex operations.
+static const int vertex_grain_size = 16384;
+
 Meshes::UIDGenerator Meshes::m_UID_generator = UIDGenerator(0u);
 std::string* Meshes::m_names = nullptr;
 Meshes::Buffers* Meshes::m_buffers = nullptr;
@@ -53,6 +62,7 @@ void Meshes::deallocate() {
         delete[] buffers.positions;
         delete[] buffers.normals;
         delete[] buffers.texcoords;
+        delete[] buffers.clusters;
     }
     delete[] m_names; m_names = nullptr;
     delete[] m_buffers; m_buffers = nullptr;
@@ -107,6 +117,8 @@ Meshes::UID Meshes::create(const std::string& name, unsigned int primitive_count
     m_buffers[id].positions = (buffer_bitmask & MeshFlag::Position) ? new Vector3f[vertex_count] : nullptr;
     m_buffers[id].normals = (buffer_bitmask & MeshFlag::Normal) ? new Vector3f[vertex_count] : nullptr;
     m_buffers[id].texcoords = (buffer_bitmask & MeshFlag::Texcoord) ? new Vector2f[vertex_count] : nullptr;
+    m_buffers[id].cluster_count = 0u;
+    m_buffers[id].clusters = nullptr;
     m_bounds[id] = AABB::invalid();
     m_changes.set_change(id, Change::Created);
 
@@ -121,6 +133,7 @@ void Meshes::destroy(Meshes::UID mesh_ID) {
         delete[] buffers.positions;
         delete[] buffers.normals;
         delete[] buffers.texcoords;
+        delete[] buffers.clusters;
 
         m_changes.set_change(mesh_ID, Change::Destroyed);
     }
@@ -128,15 +141,29 @@ void Meshes::destroy(Meshes::UID mesh_ID) {
 
 AABB Meshes::compute_bounds(Meshes::UID mesh_ID) {
     Buffers& buffers = m_buffers[mesh_ID];
-
-    AABB bounds = AABB(buffers.positions[0], buffers.positions[0]);
-    for (Vector3f* position_itr = buffers.positions + 1; position_itr < (buffers.positions + buffers.vertex_count); ++position_itr)
-        bounds.grow_to_contain(*position_itr);
+    const Vector3f* positions = buffers.positions;
+
+    auto compute_range_bounds = [=](int begin, int end, AABB bounds) -> AABB {
+        bounds.grow_to_contain(Math::compute_bounds(positions + begin, end - begin));
+        return bounds;
+    };
+    auto merge_bounds = [](AABB lhs, AABB rhs) -> AABB {
+        lhs.grow_to_contain(rhs);
+        return lhs;
+    };
+    AABB bounds = Core::Parallel::parallel_reduce(0, int(buffers.vertex_count), AABB::invalid(), compute_range_bounds, merge_bounds, vertex_grain_size);
 
     m_bounds[mesh_ID] = bounds;
     return bounds;
 }
 
+void Meshes::set_clusters(Meshes::UID mesh_ID, MeshCluster* clusters, unsigned int cluster_count) {
+    Buffers& buffers = m_buffers[mesh_ID];
+    delete[] buffers.clusters;
+    buffers.clusters = clusters;
+    buffers.cluster_count = cluster_count;
+}
+
 //-----------------------------------------------------------------------------
 // Mesh utils.
 //-----------------------------------------------------------------------------
@@ -144,6 +171,7 @@ AABB Meshes::compute_bounds(Meshes::UID mesh_ID) {
 namespace MeshUtils {
 
 Meshes::UID deep_clone(Meshes::UID mesh_ID) {
+    BIFROST_PROFILE_FUNCTION();
     Mesh mesh = mesh_ID;
     Meshes::UID new_ID = Meshes::create(mesh.get_name() + "_clone", mesh.get_primitive_count(), mesh.get_vertex_count(), mesh.get_flags());
 
@@ -168,34 +196,81 @@ Meshes::UID deep_clone(Meshes::UID mesh_ID) {
     return new_ID;
 }
 
+unsigned long long hash(Meshes::UID mesh_ID) {
+    BIFROST_PROFILE_FUNCTION();
+    Mesh mesh = mesh_ID;
+    unsigned int primitive_count = mesh.get_primitive_count();
+    unsigned int vertex_count = mesh.get_vertex_count();
+    unsigned char flags = mesh.get_flags().raw();
+
+    unsigned long long hash = Core::hash64(&primitive_count, sizeof(primitive_count));
+    hash = Core::hash64(&vertex_count, sizeof(vertex_count), hash);
+    hash = Core::hash64(&flags, sizeof(flags), hash);
+    if (mesh.get_primitives() != nullptr)
+        hash = Core::hash64(mesh.get_primitives(), primitive_count * sizeof(Vector3ui), hash);
+    if (mesh.get_positions() != nullptr)
+        hash = Core::hash64(mesh.get_positions(), vertex_count * sizeof(Vector3f), hash);
+    if (mesh.get_normals() != nullptr)
+        hash = Core::hash64(mesh.get_normals(), vertex_count * sizeof(Vector3f), hash);
+    if (mesh.get_texcoords() != nullptr)
+        hash = Core::hash64(mesh.get_texcoords(), vertex_count * sizeof(Vector2f), hash);
+    return hash;
+}
+
+bool has_identical_buffers(Meshes::UID mesh_ID, Meshes::UID other_mesh_ID) {
+    BIFROST_PROFILE_FUNCTION();
+    Mesh mesh = mesh_ID, other_mesh = other_mesh_ID;
+    unsigned int primitive_count = mesh.get_primitive_count();
+    unsigned int vertex_count = mesh.get_vertex_count();
+    if (primitive_count != other_mesh.get_primitive_count() || vertex_count != other_mesh.get_vertex_count() ||
+        mesh.get_flags() != other_mesh.get_flags())
+        return false;
+
+    auto identical_buffers = [](const void* lhs, const void* rhs, size_t byte_count) -> bool {
+        return lhs == nullptr || memcmp(lhs, rhs, byte_count) == 0;
+    };
+    return identical_buffers(mesh.get_primitives(), other_mesh.get_primitives(), primitive_count * sizeof(Vector3ui)) &&
+           identical_buffers(mesh.get_positions(), other_mesh.get_positions(), vertex_count * sizeof(Vector3f)) &&
+           identical_buffers(mesh.get_normals(), other_mesh.get_normals(), vertex_count * sizeof(Vector3f)) &&
+           identical_buffers(mesh.get_texcoords(), other_mesh.get_texcoords(), vertex_count * sizeof(Vector2f));
+}
+
 void transform_mesh(Meshes::UID mesh_ID, Matrix3x4f affine_transform) {
+    BIFROST_PROFILE_FUNCTION();
     Mesh mesh = mesh_ID;
 
     Matrix3x3f rotation;
     rotation.set_column(0, affine_transform.get_column(0));
     rotation.set_column(1, affine_transform.get_column(1));
     rotation.set_column(2, affine_transform.get_column(2));
-    Vector3f translation = affine_transform.get_column(3);
+
+    // The cluster bounds are no longer valid.
+    Meshes::set_clusters(mesh_ID, nullptr, 0);
+
+    int vertex_count = int(mesh.get_vertex_count());
 
     // Transform positions.
-    Vector3f* positions_itr = mesh.get_positions();
-    if (positions_itr != nullptr) {
-        AABB bounding_box = AABB(Vector3f(std::numeric_limits<float>::infinity()), Vector3f(-std::numeric_limits<float>::infinity()));
-        Vector3f* positions_end = positions_itr + mesh.get_vertex_count();
-        for (; positions_itr != positions_end; ++positions_itr) {
-            *positions_itr = rotation * *positions_itr + translation;
-            bounding_box.grow_to_contain(*positions_itr);
-        }
+    Vector3f* positions = mesh.get_positions();
+    if (positions != nullptr) {
+        auto transform_range = [=](int begin, int end, AABB bounds) -> AABB {
+            bounds.grow_to_contain(transform_points(affine_transform, positions + begin, positions + begin, end - begin));
+            return bounds;
+        };
+        auto merge_bounds = [](AABB lhs, AABB rhs) -> AABB {
+            lhs.grow_to_contain(rhs);
+            return lhs;
+        };
+        AABB bounding_box = Core::Parallel::parallel_reduce(0, vertex_count, AABB::invalid(), transform_range, merge_bounds, vertex_grain_size);
         mesh.set_bounds(bounding_box);
     }
 
     // Transform normals.
-    Vector3f* normals_itr = mesh.get_normals();
-    if (normals_itr != nullptr) {
+    Vector3f* normals = mesh.get_normals();
+    if (normals != nullptr) {
         Matrix3x3f normal_rotation = transpose(invert(rotation));
-        Vector3f* normals_end = normals_itr + mesh.get_vertex_count();
-        for (; normals_itr != normals_end; ++normals_itr)
-            *normals_itr = normal_rotation * *normals_itr;
+        Core::Parallel::parallel_for_range(0, vertex_count, [=](int begin, int end) {
+            transform_vectors(normal_rotation, normals + begin, normals + begin, end - begin);
+        }, vertex_grain_size);
     }
 }
 
@@ -207,6 +282,7 @@ Meshes::UID combine(const std::string& name,
                     const TransformedMesh* const meshes_begin,
                     const TransformedMesh* const meshes_end,
                     MeshFlags flags) {
+    BIFROST_PROFILE_FUNCTION();
 
     auto meshes = Core::Iterable<const TransformedMesh* const>(meshes_begin, meshes_end);
 
@@ -241,8 +317,8 @@ Meshes::UID combine(const std::string& name,
         Vector3f* positions = merged_mesh.get_positions();
         for (TransformedMesh transformed_mesh : meshes) {
             Mesh mesh = transformed_mesh.mesh_ID;
-            for (Vector3f position : mesh.get_position_iterable())
-                *(positions++) = transformed_mesh.transform * position;
+            transform_points(transformed_mesh.transform, mesh.get_positions(), positions, mesh.get_vertex_count());
+            positions += mesh.get_vertex_count();
         }
     }
 
@@ -250,8 +326,8 @@ Meshes::UID combine(const std::string& name,
         Vector3f* normals = merged_mesh.get_normals();
         for (TransformedMesh transformed_mesh : meshes) {
             Mesh mesh = transformed_mesh.mesh_ID;
-            for (Vector3f normal : mesh.get_normal_iterable())
-                *(normals++) = transformed_mesh.transform.rotation * normal;
+            rotate_vectors(transformed_mesh.transform.rotation, mesh.get_normals(), normals, mesh.get_vertex_count());
+            normals += mesh.get_vertex_count();
         }
     }
 
@@ -270,6 +346,7 @@ Meshes::UID combine(const std::string& name,
 }
 
 void compute_hard_normals(Vector3f* positions_begin, Vector3f* positions_end, Vector3f* normals_begin) {
+    BIFROST_PROFILE_FUNCTION();
     while (positions_begin < positions_end) {
         Vector3f p0 = *positions_begin++;
         Vector3f p1 = *positions_begin++;
@@ -282,31 +359,745 @@ void compute_hard_normals(Vector3f* positions_begin, Vector3f* positions_end, Ve
     }
 }
 
+namespace NormalGeneration {
+
+// Vertex to primitive corner adjacency in compressed sparse row format.
+// The corners adjacent to vertex v are corners[offsets[v]] to corners[offsets[v+1]], where corner c is vertex c % 3 of primitive c / 3.
+// The corners are sorted by primitive index, which makes the order of the per vertex sums independent of the number of threads.
+struct VertexAdjacency {
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> corners;
+
+    VertexAdjacency(const Vector3ui* primitives, unsigned int primitive_count, unsigned int vertex_count)
+        : offsets(vertex_count + 1, 0u), corners(primitive_count * 3) {
+        const unsigned int* indices = &primitives->x;
+        for (unsigned int c = 0; c < primitive_count * 3; ++c)
+            ++offsets[indices[c] + 1];
+        for (unsigned int v = 0; v < vertex_count; ++v)
+            offsets[v + 1] += offsets[v];
+
+        auto next_corner = std::vector<unsigned int>(offsets.begin(), offsets.end() - 1);
+        for (unsigned int c = 0; c < primitive_count * 3; ++c)
+            corners[next_corner[indices[c]]++] = c;
+    }
+};
+
+// Computes the weighted primitive normal of each primitive corner.
+// Area weighted normals are the unnormalized cross products, which are proportional to the area of the primitive.
+// Angle weighted normals are unit length primitive normals scaled by the angle of the corner.
+std::vector<Vector3f> compute_weighted_corner_normals(const Vector3ui* primitives, unsigned int primitive_count,
+                                                      const Vector3f* positions, NormalWeighting weighting) {
+    auto corner_normals = std::vector<Vector3f>(primitive_count * 3);
+
+    Core::Parallel::parallel_for(0, int(primitive_count), [&](int p) {
+        Vector3ui primitive = primitives[p];
+        Vector3f corner_positions[3] = { positions[primitive.x], positions[primitive.y], positions[primitive.z] };
+        Vector3f normal = cross(corner_positions[1] - corner_positions[0], corner_positions[2] - corner_positions[0]);
+
+        if (weighting == NormalWeighting::Area) {
+            for (int i = 0; i < 3; ++i)
+                corner_normals[3 * p + i] = normal;
+        } else {
+            float normal_length = magnitude(normal);
+            Vector3f unit_normal = normal_length > 0.0f ? normal / normal_length : Vector3f::zero();
+            for (int i = 0; i < 3; ++i) {
+                Vector3f edge0 = corner_positions[(i + 1) % 3] - corner_positions[i];
+                Vector3f edge1 = corner_positions[(i + 2) % 3] - corner_positions[i];
+                float edge_lengths = magnitude(edge0) * magnitude(edge1);
+                float cos_angle = edge_lengths > 0.0f ? clamp(dot(edge0, edge1) / edge_lengths, -1.0f, 1.0f) : 1.0f;
+                corner_normals[3 * p + i] = unit_normal * acosf(cos_angle);
+            }
+        }
+    });
+
+    return corner_normals;
+}
+
+} // NS NormalGeneration
+
 void compute_normals(Vector3ui* primitives_begin, Vector3ui* primitives_end,
-                     Vector3f* normals_begin, Vector3f* normals_end, Vector3f* positions_begin) {
-    std::fill(normals_begin, normals_end, Vector3f::zero());
+                     Vector3f* normals_begin, Vector3f* normals_end, Vector3f* positions_begin, NormalWeighting weighting) {
+    BIFROST_PROFILE_FUNCTION();
+    using namespace NormalGeneration;
+
+    unsigned int primitive_count = unsigned int(primitives_end - primitives_begin);
+    unsigned int vertex_count = unsigned int(normals_end - normals_begin);
+    auto adjacency = VertexAdjacency(primitives_begin, primitive_count, vertex_count);
+    auto corner_normals = compute_weighted_corner_normals(primitives_begin, primitive_count, positions_begin, weighting);
+
+    // Gather the weighted normals pr vertex.
+    Core::Parallel::parallel_for(0, int(vertex_count), [&](int v) {
+        Vector3f normal = Vector3f::zero();
+        for (unsigned int a = adjacency.offsets[v]; a < adjacency.offsets[v + 1]; ++a)
+            normal += corner_normals[adjacency.corners[a]];
+        normals_begin[v] = normalize(normal);
+    });
+}
+
+void compute_normals(Meshes::UID mesh_ID, NormalWeighting weighting) {
+    Mesh mesh = mesh_ID;
+    compute_normals(mesh.get_primitives(), mesh.get_primitives() + mesh.get_primitive_count(),
+                    mesh.get_normals(), mesh.get_normals() + mesh.get_vertex_count(),
+                    mesh.get_positions(), weighting);
+}
+
+Meshes::UID compute_creased_normals(Meshes::UID mesh_ID, float crease_angle, NormalWeighting weighting) {
+    BIFROST_PROFILE_FUNCTION();
+    using namespace NormalGeneration;
+
+    Mesh mesh = mesh_ID;
+    unsigned int primitive_count = mesh.get_primitive_count();
+    unsigned int vertex_count = mesh.get_vertex_count();
+    const Vector3ui* primitives = mesh.get_primitives();
+    auto adjacency = VertexAdjacency(primitives, primitive_count, vertex_count);
+    auto corner_normals = compute_weighted_corner_normals(primitives, primitive_count, mesh.get_positions(), weighting);
+    float cos_crease_angle = cosf(crease_angle);
+
+    // Compute the normal of each corner from the adjacent primitives within the crease angle of the corner's primitive
+    // and assign the corner to a new vertex pr unique normal.
+    // The new vertices are counted pr original vertex, such that the vertex order is independent of the number of threads.
+    auto smooth_corner_normals = std::vector<Vector3f>(primitive_count * 3);
+    auto corner_vertex_offsets = std::vector<unsigned int>(primitive_count * 3); // Offset of the corner's new vertex relative to the first new vertex of the original vertex.
+    auto new_vertex_offsets = std::vector<unsigned int>(vertex_count + 1, 0u); // Counts the new vertices pr vertex before the prefix sum.
+
+    Core::Parallel::parallel_for(0, int(vertex_count), [&](int v) {
+        unsigned int adjacency_begin = adjacency.offsets[v], adjacency_end = adjacency.offsets[v + 1];
+        for (unsigned int a = adjacency_begin; a < adjacency_end; ++a) {
+            unsigned int corner = adjacency.corners[a];
+            Vector3f primitive_normal = normalize(corner_normals[corner]);
+
+            Vector3f normal = Vector3f::zero();
+            for (unsigned int n = adjacency_begin; n < adjacency_end; ++n) {
+                Vector3f neighbour_normal = corner_normals[adjacency.corners[n]];
+                float neighbour_normal_length = magnitude(neighbour_normal);
+                bool is_smooth = n == a || (neighbour_normal_length > 0.0f && dot(primitive_normal, neighbour_normal) >= cos_crease_angle * neighbour_normal_length);
+                if (is_smooth)
+                    normal += neighbour_normal;
+            }
+            normal = normalize(normal);
+            smooth_corner_normals[corner] = normal;
+
+            // Reuse the new vertex of a previous corner with the same normal.
+            unsigned int vertex_offset = new_vertex_offsets[v + 1];
+            for (unsigned int n = adjacency_begin; n < a; ++n) {
+                unsigned int previous_corner = adjacency.corners[n];
+                if (smooth_corner_normals[previous_corner] == normal) {
+                    vertex_offset = corner_vertex_offsets[previous_corner];
+                    break;
+                }
+            }
+            corner_vertex_offsets[corner] = vertex_offset;
+            if (vertex_offset == new_vertex_offsets[v + 1])
+                ++new_vertex_offsets[v + 1];
+        }
+    });
+
+    // Unreferenced vertices are kept as they are.
+    for (unsigned int v = 0; v < vertex_count; ++v) {
+        if (new_vertex_offsets[v + 1] == 0)
+            new_vertex_offsets[v + 1] = 1;
+        new_vertex_offsets[v + 1] += new_vertex_offsets[v];
+    }
+    unsigned int new_vertex_count = new_vertex_offsets[vertex_count];
+
+    MeshFlags flags = mesh.get_flags() | MeshFlag::Normal;
+    Mesh new_mesh = Meshes::create(mesh.get_name() + "_creased", primitive_count, new_vertex_count, flags);
+    Vector3ui* new_primitives = new_mesh.get_primitives();
+    Vector3f* new_positions = new_mesh.get_positions();
+    Vector3f* new_normals = new_mesh.get_normals();
+    Vector2f* new_texcoords = new_mesh.get_texcoords();
+    const Vector3f* positions = mesh.get_positions();
+    const Vector3f* normals = mesh.get_normals();
+    const Vector2f* texcoords = mesh.get_texcoords();
+
+    Core::Parallel::parallel_for(0, int(vertex_count), [&](int v) {
+        unsigned int new_vertex_begin = new_vertex_offsets[v];
+        unsigned int new_vertex_end = new_vertex_offsets[v + 1];
+        for (unsigned int new_v = new_vertex_begin; new_v < new_vertex_end; ++new_v) {
+            new_positions[new_v] = positions[v];
+            if (new_texcoords != nullptr)
+                new_texcoords[new_v] = texcoords[v];
+        }
+        if (adjacency.offsets[v] == adjacency.offsets[v + 1])
+            new_normals[new_vertex_begin] = normals != nullptr ? normals[v] : Vector3f::zero();
+
+        for (unsigned int a = adjacency.offsets[v]; a < adjacency.offsets[v + 1]; ++a) {
+            unsigned int corner = adjacency.corners[a];
+            unsigned int new_vertex_index = new_vertex_begin + corner_vertex_offsets[corner];
+            new_normals[new_vertex_index] = smooth_corner_normals[corner];
+            (&new_primitives->x)[corner] = new_vertex_index;
+        }
+    });
+
+    new_mesh.set_bounds(mesh.get_bounds());
+
+    return new_mesh.get_ID();
+}
+
+//-----------------------------------------------------------------------------
+// Mesh optimization.
+//-----------------------------------------------------------------------------
+
+VertexCacheStatistics compute_vertex_cache_statistics(const Vector3ui* primitives_begin, const Vector3ui* primitives_end,
+                                                      unsigned int vertex_count, unsigned int cache_size) {
+    unsigned int primitive_count = unsigned int(primitives_end - primitives_begin);
+    if (primitive_count == 0 || vertex_count == 0)
+        return { 0.0f, 0.0f };
+
+    // Simulate a FIFO cache by timestamping vertices when they are transformed.
+    // A vertex is still in the cache if less than cache_size vertices have been transformed since.
+    auto timestamps = std::vector<unsigned int>(vertex_count, 0u);
+    unsigned int timestamp = cache_size + 1;
+    unsigned int cache_misses = 0;
+    for (const unsigned int* index_itr = &primitives_begin->x; index_itr != &primitives_end->x; ++index_itr) {
+        unsigned int vertex_index = *index_itr;
+        if (timestamp - timestamps[vertex_index] > cache_size) {
+            timestamps[vertex_index] = timestamp++;
+            ++cache_misses;
+        }
+    }
+
+    return { cache_misses / float(primitive_count), cache_misses / float(vertex_count) };
+}
+
+namespace VertexCacheOptimization {
+
+static const int cache_size = 32;
+
+// Vertex score as defined by Forsyth.
+// Vertices used by the last primitive get a fixed score to avoid favouring strips and the score of the rest decays with their cache position.
+// Vertices with few remaining primitives are boosted to avoid leaving lone primitives behind.
+inline float vertex_score(int cache_position, unsigned int remaining_valence) {
+    if (remaining_valence == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cache_position >= 0) {
+        if (cache_position < 3)
+            score = 0.75f;
+        else {
+            float scaler = 1.0f - (cache_position - 3) / float(cache_size - 3);
+            score = powf(scaler, 1.5f);
+        }
+    }
+
+    return score + 2.0f / sqrtf(float(remaining_valence));
+}
+
+} // NS VertexCacheOptimization
+
+void optimize_vertex_cache(Vector3ui* primitives_begin, Vector3ui* primitives_end, unsigned int vertex_count) {
+    BIFROST_PROFILE_FUNCTION();
+    using namespace VertexCacheOptimization;
+
+    unsigned int primitive_count = unsigned int(primitives_end - primitives_begin);
+    if (primitive_count == 0)
+        return;
+
+    // Vertex to primitive adjacency. The first remaining_valence[v] primitives in a vertex' range have not been emitted yet.
+    auto adjacency_offsets = std::vector<unsigned int>(vertex_count + 1, 0u);
+    for (Vector3ui primitive : Core::Iterable<Vector3ui*>(primitives_begin, primitives_end))
+        for (int i = 0; i < 3; ++i)
+            ++adjacency_offsets[primitive[i] + 1];
+    for (unsigned int v = 0; v < vertex_count; ++v)
+        adjacency_offsets[v + 1] += adjacency_offsets[v];
+
+    auto remaining_valence = std::vector<unsigned int>(vertex_count, 0u);
+    auto adjacency = std::vector<unsigned int>(primitive_count * 3);
+    for (unsigned int p = 0; p < primitive_count; ++p)
+        for (int i = 0; i < 3; ++i) {
+            unsigned int v = primitives_begin[p][i];
+            adjacency[adjacency_offsets[v] + remaining_valence[v]++] = p;
+        }
+
+    auto cache_positions = std::vector<int>(vertex_count, -1);
+    auto vertex_scores = std::vector<float>(vertex_count);
+    for (unsigned int v = 0; v < vertex_count; ++v)
+        vertex_scores[v] = vertex_score(-1, remaining_valence[v]);
+
+    auto emitted = std::vector<bool>(primitive_count, false);
+    int best_primitive = 0;
+    float best_score = -1.0f;
+    for (unsigned int p = 0; p < primitive_count; ++p) {
+        Vector3ui primitive = primitives_begin[p];
+        float score = vertex_scores[primitive.x] + vertex_scores[primitive.y] + vertex_scores[primitive.z];
+        if (score > best_score) {
+            best_score = score;
+            best_primitive = p;
+        }
+    }
+
+    // The cache has room for the vertices of a new primitive before it is truncated.
+    unsigned int cache[cache_size + 3];
+    int cache_count = 0;
+    unsigned int fallback_cursor = 0;
+
+    auto optimized_primitives = std::vector<Vector3ui>();
+    optimized_primitives.reserve(primitive_count);
+    while (optimized_primitives.size() < primitive_count) {
+        if (best_primitive < 0) {
+            // No primitives are connected to the vertices in the cache. Continue from the next unemitted primitive.
+            while (emitted[fallback_cursor])
+                ++fallback_cursor;
+            best_primitive = fallback_cursor;
+        }
+
+        Vector3ui primitive = primitives_begin[best_primitive];
+        optimized_primitives.push_back(primitive);
+        emitted[best_primitive] = true;
+
+        // Remove the primitive from its vertices' list of remaining primitives.
+        for (int i = 0; i < 3; ++i) {
+            unsigned int v = primitive[i];
+            unsigned int* adjacent_primitives = adjacency.data() + adjacency_offsets[v];
+            unsigned int* last_adjacent_primitive = adjacent_primitives + remaining_valence[v] - 1;
+            unsigned int* primitive_itr = std::find(adjacent_primitives, last_adjacent_primitive, unsigned int(best_primitive));
+            std::swap(*primitive_itr, *last_adjacent_primitive);
+            --remaining_valence[v];
+        }
+
+        // Move the primitive's vertices to the front of the cache.
+        unsigned int new_cache[cache_size + 3];
+        int new_cache_count = 0;
+        for (int i = 0; i < 3; ++i)
+            new_cache[new_cache_count++] = primitive[i];
+        for (int c = 0; c < cache_count; ++c) {
+            unsigned int v = cache[c];
+            if (v != primitive.x && v != primitive.y && v != primitive.z)
+                new_cache[new_cache_count++] = v;
+        }
+
+        // Update the scores of all vertices that are in the cache or was evicted from it.
+        for (int c = 0; c < new_cache_count; ++c) {
+            unsigned int v = new_cache[c];
+            cache_positions[v] = c < cache_size ? c : -1;
+            vertex_scores[v] = vertex_score(cache_positions[v], remaining_valence[v]);
+        }
+        cache_count = min(new_cache_count, cache_size);
+        std::copy_n(new_cache, cache_count, cache);
+
+        // Score the primitives adjacent to the cache and pick the best as the next primitive.
+        best_primitive = -1;
+        best_score = -1.0f;
+        for (int c = 0; c < new_cache_count; ++c) {
+            unsigned int v = new_cache[c];
+            const unsigned int* adjacent_primitives = adjacency.data() + adjacency_offsets[v];
+            for (unsigned int a = 0; a < remaining_valence[v]; ++a) {
+                unsigned int p = adjacent_primitives[a];
+                Vector3ui adjacent_primitive = primitives_begin[p];
+                float score = vertex_scores[adjacent_primitive.x] + vertex_scores[adjacent_primitive.y] + vertex_scores[adjacent_primitive.z];
+                if (score > best_score) {
+                    best_score = score;
+                    best_primitive = p;
+                }
+            }
+        }
+    }
+
+    std::copy(optimized_primitives.begin(), optimized_primitives.end(), primitives_begin);
+}
+
+void optimize_overdraw(Vector3ui* primitives_begin, Vector3ui* primitives_end, const Vector3f* positions, unsigned int cache_size) {
+    BIFROST_PROFILE_FUNCTION();
+    unsigned int primitive_count = unsigned int(primitives_end - primitives_begin);
+    if (primitive_count == 0)
+        return;
+
+    unsigned int vertex_count = 0;
+    for (Vector3ui primitive : Core::Iterable<Vector3ui*>(primitives_begin, primitives_end))
+        vertex_count = max(vertex_count, max(primitive.x, max(primitive.y, primitive.z)) + 1);
+
+    // Split the primitives into clusters whenever a primitive misses the cache on all its vertices,
+    // as the cache is effectively flushed at that point and the clusters can be reordered without adding cache misses.
+    auto cluster_offsets = std::vector<unsigned int>();
+    {
+        auto timestamps = std::vector<unsigned int>(vertex_count, 0u);
+        unsigned int timestamp = cache_size + 1;
+        for (unsigned int p = 0; p < primitive_count; ++p) {
+            int cache_misses = 0;
+            for (int i = 0; i < 3; ++i) {
+                unsigned int v = primitives_begin[p][i];
+                if (timestamp - timestamps[v] > cache_size) {
+                    timestamps[v] = timestamp++;
+                    ++cache_misses;
+                }
+            }
+            if (p == 0 || cache_misses == 3)
+                cluster_offsets.push_back(p);
+        }
+        cluster_offsets.push_back(primitive_count);
+    }
+    unsigned int cluster_count = unsigned int(cluster_offsets.size() - 1);
+    if (cluster_count == 1)
+        return;
+
+    // Compute the area weighted centroid and normal of the clusters and the mesh.
+    auto cluster_centroids = std::vector<Vector3f>(cluster_count);
+    auto cluster_normals = std::vector<Vector3f>(cluster_count);
+    Vector3f mesh_centroid = Vector3f::zero();
+    float mesh_area = 0.0f;
+    for (unsigned int c = 0; c < cluster_count; ++c) {
+        Vector3f centroid = Vector3f::zero();
+        Vector3f normal = Vector3f::zero();
+        float area = 0.0f;
+        for (unsigned int p = cluster_offsets[c]; p < cluster_offsets[c + 1]; ++p) {
+            Vector3ui primitive = primitives_begin[p];
+            Vector3f p0 = positions[primitive.x], p1 = positions[primitive.y], p2 = positions[primitive.z];
+            Vector3f primitive_normal = cross(p1 - p0, p2 - p0);
+            float primitive_area = magnitude(primitive_normal);
+            centroid += (p0 + p1 + p2) * (primitive_area / 3.0f);
+            normal += primitive_normal;
+            area += primitive_area;
+        }
+        mesh_centroid += centroid;
+        mesh_area += area;
+        cluster_centroids[c] = area > 0.0f ? centroid / area : positions[primitives_begin[cluster_offsets[c]].x];
+        cluster_normals[c] = normal;
+    }
+    if (mesh_area > 0.0f)
+        mesh_centroid /= mesh_area;
+
+    // Sort the clusters by how much they face away from the center of the mesh.
+    auto cluster_sort_keys = std::vector<float>(cluster_count);
+    auto cluster_order = std::vector<unsigned int>(cluster_count);
+    for (unsigned int c = 0; c < cluster_count; ++c) {
+        float normal_length = magnitude(cluster_normals[c]);
+        cluster_sort_keys[c] = normal_length > 0.0f ? dot(cluster_centroids[c] - mesh_centroid, cluster_normals[c]) / normal_length : 0.0f;
+        cluster_order[c] = c;
+    }
+    std::stable_sort(cluster_order.begin(), cluster_order.end(), 
+        [&](unsigned int lhs, unsigned int rhs) { return cluster_sort_keys[lhs] > cluster_sort_keys[rhs]; });
+
+    auto sorted_primitives = std::vector<Vector3ui>();
+    sorted_primitives.reserve(primitive_count);
+    for (unsigned int c : cluster_order)
+        sorted_primitives.insert(sorted_primitives.end(), primitives_begin + cluster_offsets[c], primitives_begin + cluster_offsets[c + 1]);
+    std::copy(sorted_primitives.begin(), sorted_primitives.end(), primitives_begin);
+}
+
+template <typename T>
+inline void remap_vertex_buffer(T* buffer, const std::vector<unsigned int>& remapping) {
+    if (buffer == nullptr)
+        return;
+
+    auto old_buffer = std::vector<T>(buffer, buffer + remapping.size());
+    for (unsigned int v = 0; v < remapping.size(); ++v)
+        buffer[remapping[v]] = old_buffer[v];
+}
+
+void optimize_vertex_fetch(Meshes::UID mesh_ID) {
+    BIFROST_PROFILE_FUNCTION();
+    Mesh mesh = mesh_ID;
+    unsigned int vertex_count = mesh.get_vertex_count();
+
+    // Assign new vertex indices in the order the vertices are referenced.
+    const unsigned int unassigned = 0xFFFFFFFF;
+    auto remapping = std::vector<unsigned int>(vertex_count, unassigned);
+    unsigned int next_vertex_index = 0;
+    unsigned int* indices = mesh.get_indices();
+    for (unsigned int i = 0; i < mesh.get_index_count(); ++i) {
+        unsigned int& new_vertex_index = remapping[indices[i]];
+        if (new_vertex_index == unassigned)
+            new_vertex_index = next_vertex_index++;
+        indices[i] = new_vertex_index;
+    }
+    for (unsigned int& new_vertex_index : remapping)
+        if (new_vertex_index == unassigned)
+            new_vertex_index = next_vertex_index++;
+
+    remap_vertex_buffer(mesh.get_positions(), remapping);
+    remap_vertex_buffer(mesh.get_normals(), remapping);
+    remap_vertex_buffer(mesh.get_texcoords(), remapping);
+}
+
+OptimizationReport optimize(Meshes::UID mesh_ID) {
+    BIFROST_PROFILE_FUNCTION();
+    Mesh mesh = mesh_ID;
+    Vector3ui* primitives_begin = mesh.get_primitives();
+    Vector3ui* primitives_end = primitives_begin + mesh.get_primitive_count();
+    unsigned int vertex_count = mesh.get_vertex_count();
+
+    OptimizationReport report;
+    report.before = compute_vertex_cache_statistics(primitives_begin, primitives_end, vertex_count);
+
+    // The clusters reference the primitives that are about to be reordered.
+    Meshes::set_clusters(mesh_ID, nullptr, 0);
+
+    optimize_vertex_cache(primitives_begin, primitives_end, vertex_count);
+    if (mesh.get_positions() != nullptr)
+        optimize_overdraw(primitives_begin, primitives_end, mesh.get_positions());
+    optimize_vertex_fetch(mesh_ID);
+
+    report.after = compute_vertex_cache_statistics(primitives_begin, primitives_end, vertex_count);
+    return report;
+}
+
+void optimize(const Meshes::UID* meshes_begin, const Meshes::UID* meshes_end, OptimizationReport* reports_begin) {
+    int mesh_count = int(meshes_end - meshes_begin);
+
+    Core::Parallel::parallel_for(0, mesh_count, [&](int m) {
+        OptimizationReport report = optimize(meshes_begin[m]);
+        if (reports_begin != nullptr)
+            reports_begin[m] = report;
+    }, 1);
+}
+
+//-----------------------------------------------------------------------------
+// Mesh clusters.
+//-----------------------------------------------------------------------------
 
-    while (primitives_begin < primitives_end) {
-        Vector3ui primitive = *primitives_begin++;
+// Computes the bounding volumes and normal cone of a cluster.
+// The normal cone follows Arseny Kapoulkine's meshoptimizer, https://github.com/zeux/meshoptimizer
+void compute_cluster_bounds(MeshCluster& cluster, const Vector3ui* primitives, const Vector3f* positions) {
+    Core::Iterable<const Vector3ui*> cluster_primitives = Core::Iterable<const Vector3ui*>(primitives + cluster.primitive_offset, cluster.primitive_count);
+
+    AABB bounds = AABB::invalid();
+    Vector3f normal_sum = Vector3f::zero();
+    for (Vector3ui primitive : cluster_primitives) {
+        Vector3f p0 = positions[primitive.x], p1 = positions[primitive.y], p2 = positions[primitive.z];
+        bounds.grow_to_contain(p0);
+        bounds.grow_to_contain(p1);
+        bounds.grow_to_contain(p2);
+        Vector3f normal = cross(p1 - p0, p2 - p0);
+        float normal_length = magnitude(normal);
+        if (normal_length > 0.0f)
+            normal_sum += normal / normal_length;
+    }
+    cluster.bounds = bounds;
+
+    // Bounding sphere centered in the bounding box.
+    cluster.sphere_center = bounds.center();
+    float squared_radius = 0.0f;
+    for (Vector3ui primitive : cluster_primitives)
+        for (int i = 0; i < 3; ++i)
+            squared_radius = max(squared_radius, magnitude_squared(positions[primitive[i]] - cluster.sphere_center));
+    cluster.sphere_radius = sqrt(squared_radius);
+
+    // Normal cone. The cone is disabled if the normals span more than a hemisphere, in which case the cluster can never be backfacing.
+    cluster.cone_apex = cluster.sphere_center;
+    cluster.cone_axis = Vector3f::zero();
+    cluster.cone_cutoff = 1.0f;
+    float normal_sum_length = magnitude(normal_sum);
+    if (normal_sum_length <= 0.0f)
+        return;
+    Vector3f axis = normal_sum / normal_sum_length;
 
-        Vector3f p0 = positions_begin[primitive.x];
-        Vector3f p1 = positions_begin[primitive.y];
-        Vector3f p2 = positions_begin[primitive.z];
+    float min_cos_angle = 1.0f;
+    for (Vector3ui primitive : cluster_primitives) {
+        Vector3f p0 = positions[primitive.x], p1 = positions[primitive.y], p2 = positions[primitive.z];
+        Vector3f normal = cross(p1 - p0, p2 - p0);
+        float normal_length = magnitude(normal);
+        if (normal_length > 0.0f)
+            min_cos_angle = min(min_cos_angle, dot(normal / normal_length, axis));
+    }
+    if (min_cos_angle <= 0.1f)
+        return;
 
+    // Place the apex of the cone behind all primitive planes along the axis, such that a view position
+    // inside the cone is on the back side of all primitives.
+    float max_distance = 0.0f;
+    for (Vector3ui primitive : cluster_primitives) {
+        Vector3f p0 = positions[primitive.x], p1 = positions[primitive.y], p2 = positions[primitive.z];
         Vector3f normal = cross(p1 - p0, p2 - p0);
-        normals_begin[primitive.x] += normal;
-        normals_begin[primitive.y] += normal;
-        normals_begin[primitive.z] += normal;
+        float normal_length = magnitude(normal);
+        if (normal_length <= 0.0f)
+            continue;
+        normal /= normal_length;
+        float distance = dot(cluster.sphere_center - p0, normal) / dot(axis, normal);
+        max_distance = max(max_distance, distance);
     }
 
-    std::for_each(normals_begin, normals_end, [](Vector3f& n) { n = normalize(n); });
+    cluster.cone_apex = cluster.sphere_center - axis * max_distance;
+    cluster.cone_axis = axis;
+    cluster.cone_cutoff = sqrt(1.0f - min_cos_angle * min_cos_angle);
 }
 
-void compute_normals(Meshes::UID mesh_ID) {
+unsigned int build_clusters(Meshes::UID mesh_ID, unsigned int max_vertex_count, unsigned int max_primitive_count) {
+    BIFROST_PROFILE_FUNCTION();
+    assert(max_vertex_count >= 3 && max_primitive_count >= 1);
+
     Mesh mesh = mesh_ID;
-    compute_normals(mesh.get_primitives(), mesh.get_primitives() + mesh.get_primitive_count(),
-                    mesh.get_normals(), mesh.get_normals() + mesh.get_vertex_count(),
-                    mesh.get_positions());
+    unsigned int primitive_count = mesh.get_primitive_count();
+    unsigned int vertex_count = mesh.get_vertex_count();
+    Vector3ui* primitives = mesh.get_primitives();
+    if (primitive_count == 0 || mesh.get_positions() == nullptr) {
+        Meshes::set_clusters(mesh_ID, nullptr, 0);
+        return 0;
+    }
+
+    // Vertex to primitive adjacency. The first remaining_valence[v] primitives in a vertex' range have not been clustered yet.
+    auto adjacency_offsets = std::vector<unsigned int>(vertex_count + 1, 0u);
+    for (Vector3ui primitive : mesh.get_primitive_iterable())
+        for (int i = 0; i < 3; ++i)
+            ++adjacency_offsets[primitive[i] + 1];
+    for (unsigned int v = 0; v < vertex_count; ++v)
+        adjacency_offsets[v + 1] += adjacency_offsets[v];
+
+    auto remaining_valence = std::vector<unsigned int>(vertex_count, 0u);
+    auto adjacency = std::vector<unsigned int>(primitive_count * 3);
+    for (unsigned int p = 0; p < primitive_count; ++p)
+        for (int i = 0; i < 3; ++i) {
+            unsigned int v = primitives[p][i];
+            adjacency[adjacency_offsets[v] + remaining_valence[v]++] = p;
+        }
+
+    const unsigned int no_cluster = 0xFFFFFFFF;
+    auto vertex_cluster = std::vector<unsigned int>(vertex_count, no_cluster);
+    auto clustered = std::vector<bool>(primitive_count, false);
+    auto clustered_primitives = std::vector<Vector3ui>();
+    clustered_primitives.reserve(primitive_count);
+    auto clusters = std::vector<MeshCluster>();
+    auto cluster_vertices = std::vector<unsigned int>();
+    cluster_vertices.reserve(max_vertex_count);
+    unsigned int fallback_cursor = 0;
+
+    auto new_vertex_count = [&](unsigned int primitive_index, unsigned int cluster_index) -> unsigned int {
+        Vector3ui primitive = primitives[primitive_index];
+        return (vertex_cluster[primitive.x] != cluster_index ? 1 : 0) +
+               (vertex_cluster[primitive.y] != cluster_index ? 1 : 0) +
+               (vertex_cluster[primitive.z] != cluster_index ? 1 : 0);
+    };
+
+    MeshCluster cluster = {};
+    while (clustered_primitives.size() < primitive_count) {
+        unsigned int cluster_index = unsigned int(clusters.size());
+
+        // Find the unclustered primitive adjacent to the cluster that adds the fewest new vertices.
+        int best_primitive = -1;
+        unsigned int best_new_vertex_count = 4;
+        for (unsigned int c = 0; c < cluster_vertices.size() && best_new_vertex_count > 0; ++c) {
+            unsigned int v = cluster_vertices[c];
+            const unsigned int* adjacent_primitives = adjacency.data() + adjacency_offsets[v];
+            for (unsigned int a = 0; a < remaining_valence[v]; ++a) {
+                unsigned int p = adjacent_primitives[a];
+                unsigned int primitive_new_vertex_count = new_vertex_count(p, cluster_index);
+                if (primitive_new_vertex_count < best_new_vertex_count) {
+                    best_new_vertex_count = primitive_new_vertex_count;
+                    best_primitive = p;
+                }
+            }
+        }
+
+        // Continue from the next unclustered primitive if no primitives are adjacent to the cluster.
+        if (best_primitive < 0) {
+            while (clustered[fallback_cursor])
+                ++fallback_cursor;
+            best_primitive = fallback_cursor;
+            best_new_vertex_count = new_vertex_count(best_primitive, cluster_index);
+        }
+
+        // Complete the cluster if the primitive does not fit. The primitive starts the next cluster.
+        bool cluster_is_full = cluster.primitive_count == max_primitive_count || 
+                               cluster_vertices.size() + best_new_vertex_count > max_vertex_count;
+        if (cluster_is_full) {
+            cluster.vertex_count = unsigned int(cluster_vertices.size());
+            clusters.push_back(cluster);
+            cluster_vertices.clear();
+            cluster = {};
+            cluster.primitive_offset = unsigned int(clustered_primitives.size());
+            ++cluster_index;
+        }
+
+        // Add the primitive to the cluster.
+        Vector3ui primitive = primitives[best_primitive];
+        for (int i = 0; i < 3; ++i) {
+            unsigned int v = primitive[i];
+            if (vertex_cluster[v] != cluster_index) {
+                vertex_cluster[v] = cluster_index;
+                cluster_vertices.push_back(v);
+            }
+
+            // Remove the primitive from the vertex' list of unclustered primitives.
+            unsigned int* adjacent_primitives = adjacency.data() + adjacency_offsets[v];
+            unsigned int* last_adjacent_primitive = adjacent_primitives + remaining_valence[v] - 1;
+            unsigned int* primitive_itr = std::find(adjacent_primitives, last_adjacent_primitive, unsigned int(best_primitive));
+            if (primitive_itr <= last_adjacent_primitive && *primitive_itr == unsigned int(best_primitive)) {
+                std::swap(*primitive_itr, *last_adjacent_primitive);
+                --remaining_valence[v];
+            }
+        }
+        clustered[best_primitive] = true;
+        clustered_primitives.push_back(primitive);
+        ++cluster.primitive_count;
+    }
+    cluster.vertex_count = unsigned int(cluster_vertices.size());
+    clusters.push_back(cluster);
+
+    std::copy(clustered_primitives.begin(), clustered_primitives.end(), primitives);
+
+    int cluster_count = int(clusters.size());
+    Core::Parallel::parallel_for(0, cluster_count, [&](int c) {
+        compute_cluster_bounds(clusters[c], primitives, mesh.get_positions());
+    });
+
+    MeshCluster* mesh_clusters = new MeshCluster[cluster_count];
+    std::copy(clusters.begin(), clusters.end(), mesh_clusters);
+    Meshes::set_clusters(mesh_ID, mesh_clusters, cluster_count);
+
+    return cluster_count;
+}
+
+void build_clusters(const Meshes::UID* meshes_begin, const Meshes::UID* meshes_end,
+                    unsigned int max_vertex_count, unsigned int max_primitive_count) {
+    int mesh_count = int(meshes_end - meshes_begin);
+
+    Core::Parallel::parallel_for(0, mesh_count, [&](int m) {
+        build_clusters(meshes_begin[m], max_vertex_count, max_primitive_count);
+    }, 1);
+}
+
+unsigned int cull_clusters(Meshes::UID mesh_ID, Transform model_transform, Matrix4x4f view_projection_matrix,
+                           Vector3f view_position, std::vector<unsigned int>& visible_cluster_indices) {
+    BIFROST_PROFILE_FUNCTION();
+    // Extract the world space frustum planes from the view projection matrix. Gribb and Hartmann, 2001.
+    // The planes are normalized, so the signed distance to a point is dot(normal, point) + d.
+    Vector4f frustum_planes[6];
+    {
+        Vector4f row0 = view_projection_matrix.get_row(0);
+        Vector4f row1 = view_projection_matrix.get_row(1);
+        Vector4f row2 = view_projection_matrix.get_row(2);
+        Vector4f row3 = view_projection_matrix.get_row(3);
+        frustum_planes[0] = row3 + row0; // Left
+        frustum_planes[1] = row3 - row0; // Right
+        frustum_planes[2] = row3 + row1; // Bottom
+        frustum_planes[3] = row3 - row1; // Top
+        frustum_planes[4] = row3 + row2; // Near
+        frustum_planes[5] = row3 - row2; // Far
+        for (Vector4f& plane : frustum_planes)
+            plane /= magnitude(Vector3f(plane.x, plane.y, plane.z));
+    }
+
+    Mesh mesh = mesh_ID;
+    unsigned int visible_primitive_count = 0;
+    for (unsigned int c = 0; c < mesh.get_cluster_count(); ++c) {
+        const MeshCluster& cluster = mesh.get_clusters()[c];
+
+        // Frustum culling.
+        Vector3f sphere_center = model_transform * cluster.sphere_center;
+        float sphere_radius = cluster.sphere_radius * model_transform.scale;
+        bool outside_frustum = false;
+        for (int p = 0; p < 6 && !outside_frustum; ++p) {
+            Vector4f plane = frustum_planes[p];
+            float signed_distance = plane.x * sphere_center.x + plane.y * sphere_center.y + plane.z * sphere_center.z + plane.w;
+            outside_frustum = signed_distance < -sphere_radius;
+        }
+        if (outside_frustum)
+            continue;
+
+        // Backface culling.
+        Vector3f cone_apex = model_transform * cluster.cone_apex;
+        Vector3f cone_axis = model_transform.rotation * cluster.cone_axis;
+        Vector3f view_direction = cone_apex - view_position;
+        float view_distance = magnitude(view_direction);
+        bool is_backfacing = view_distance > 0.0f && dot(view_direction, cone_axis) >= cluster.cone_cutoff * view_distance;
+        if (is_backfacing)
+            continue;
+
+        visible_cluster_indices.push_back(c);
+        visible_primitive_count += cluster.primitive_count;
+    }
+
+    return visible_primitive_count;
 }
 
 } // NS MeshUtils
@@ -18,6 +18,8 @@
 #include <Bifrost/Math/Transform.h>
 #include <Bifrost/Math/Vector.h>
 
+#include <vector>
+
 namespace Bifrost {
 namespace Assets {
 
@@ -30,6 +32,23 @@ enum class MeshFlag : unsigned char {
 };
 typedef Core::Bitmask<MeshFlag> MeshFlags;
 
+//----------------------------------------------------------------------------
+// A cluster of spatially coherent primitives, stored contiguously in the mesh's primitive buffer.
+// The normal cone bounds the normals of the cluster's primitives, such that the cluster 
+// is backfacing if dot(normalize(cone_apex - view_position), cone_axis) >= cone_cutoff.
+//----------------------------------------------------------------------------
+struct MeshCluster {
+    unsigned int primitive_offset;
+    unsigned int primitive_count;
+    unsigned int vertex_count;
+    Math::AABB bounds;
+    Math::Vector3f sphere_center;
+    float sphere_radius;
+    Math::Vector3f cone_apex;
+    Math::Vector3f cone_axis;
+    float cone_cutoff;
+};
+
 //----------------------------------------------------------------------------
 // Container for mesh properties and their bufers.
 // Future work:
@@ -74,6 +93,12 @@ public:
     static inline void set_bounds(Meshes::UID mesh_ID, Math::AABB bounds) { m_bounds[mesh_ID] = bounds; }
     static Math::AABB compute_bounds(Meshes::UID mesh_ID);
 
+    // Clusters are built by MeshUtils::build_clusters and must be rebuilt if the primitives or positions are changed.
+    static inline unsigned int get_cluster_count(Meshes::UID mesh_ID) { return m_buffers[mesh_ID].cluster_count; }
+    static inline const MeshCluster* get_clusters(Meshes::UID mesh_ID) { return m_buffers[mesh_ID].clusters; }
+    // Sets the mesh's clusters. The mesh takes ownership of the cluster array.
+    static void set_clusters(Meshes::UID mesh_ID, MeshCluster* clusters, unsigned int cluster_count);
+
     //-------------------------------------------------------------------------
     // Changes since last game loop tick.
     //-------------------------------------------------------------------------
@@ -103,6 +128,9 @@ private:
         Math::Vector3f* positions;
         Math::Vector3f* normals;
         Math::Vector2f* texcoords;
+
+        unsigned int cluster_count;
+        MeshCluster* clusters;
     };
 
     static UIDGenerator m_UID_generator;
@@ -153,6 +181,10 @@ public:
 
     inline Math::AABB compute_bounds() { return Meshes::compute_bounds(m_ID); }
 
+    inline unsigned int get_cluster_count() { return Meshes::get_cluster_count(m_ID); }
+    inline const MeshCluster* get_clusters() { return Meshes::get_clusters(m_ID); }
+    inline Core::Iterable<const MeshCluster*> get_cluster_iterable() { return Core::Iterable<const MeshCluster*>(get_clusters(), get_cluster_count()); }
+
     inline MeshFlags get_flags() {
         MeshFlags mesh_flags = get_positions() ? MeshFlag::Position : MeshFlag::None;
         mesh_flags |= get_normals() ? MeshFlag::Normal : MeshFlag::None;
@@ -169,8 +201,6 @@ private:
 //----------------------------------------------------------------------------
 // Mesh utilities.
 // Future work:
-// * Forsyth index sorting. https://code.google.com/archive/p/vcacne/
-// * What about vertex sorting? Base it on a morton curve or order of appearance in the index array.
 // * Utility function for computing tangents and normals on bump mapped surfaces. Possibly splitting the mesh.
 //----------------------------------------------------------------------------
 namespace MeshUtils {
@@ -179,6 +209,12 @@ Meshes::UID deep_clone(Meshes::UID mesh_ID);
 void transform_mesh(Meshes::UID mesh_ID, Math::Matrix3x4f affine_transform);
 void transform_mesh(Meshes::UID mesh_ID, Math::Transform transform);
 
+// 64 bit hash of the mesh's primitives and vertex buffers. Meshes with identical buffers have identical hashes.
+// The name, bounds and clusters of the mesh are not part of the hash.
+unsigned long long hash(Meshes::UID mesh_ID);
+// Returns true if the meshes have identical primitives and vertex buffers.
+bool has_identical_buffers(Meshes::UID mesh_ID, Meshes::UID other_mesh_ID);
+
 //-------------------------------------------------------------------------
 // Mesh combine utilities.
 //-------------------------------------------------------------------------
@@ -205,11 +241,82 @@ inline Meshes::UID combine(const std::string& name,
 // This function assumes that the positions are used to describe triangles.
 void compute_hard_normals(Math::Vector3f* positions_begin, Math::Vector3f* positions_end, Math::Vector3f* normals_begin);
 
-// Computes a list of hard normals from a list of triangle positions.
-// This function assumes that the positions are used to describe triangles.
+enum class NormalWeighting : unsigned char {
+    Area,  // Primitive normals are weighted by the area of the primitive.
+    Angle, // Primitive normals are weighted by the angle of the primitive at the vertex. Independent of the tessellation.
+};
+
+// Computes smooth vertex normals as the normalized weighted sum of the normals of the adjacent primitives.
+// The normals are gathered pr vertex in parallel and are identical regardless of the number of threads.
 void compute_normals(Math::Vector3ui* primitives_begin, Math::Vector3ui* primitives_end,
-                     Math::Vector3f* normals_begin, Math::Vector3f* normals_end, Math::Vector3f* positions_begin);
-void compute_normals(Meshes::UID mesh_ID);
+                     Math::Vector3f* normals_begin, Math::Vector3f* normals_end, Math::Vector3f* positions_begin,
+                     NormalWeighting weighting = NormalWeighting::Area);
+void compute_normals(Meshes::UID mesh_ID, NormalWeighting weighting = NormalWeighting::Area);
+
+// Computes vertex normals where only adjacent primitives whose normals are within crease_angle radians of each other are smoothed.
+// Vertices are split along creases, so the result is returned as a new mesh.
+Meshes::UID compute_creased_normals(Meshes::UID mesh_ID, float crease_angle, NormalWeighting weighting = NormalWeighting::Area);
+
+//-------------------------------------------------------------------------
+// Mesh optimization utilities.
+//-------------------------------------------------------------------------
+
+// Post transform vertex cache statistics of a list of primitives, simulated with a FIFO cache.
+// ACMR is the average number of transformed vertices pr primitive. The lower bound is 0.5.
+// ATVR is the average number of times each vertex is transformed. The lower bound is 1.0.
+struct VertexCacheStatistics {
+    float ACMR;
+    float ATVR;
+};
+
+VertexCacheStatistics compute_vertex_cache_statistics(const Math::Vector3ui* primitives_begin, const Math::Vector3ui* primitives_end,
+                                                      unsigned int vertex_count, unsigned int cache_size = 16);
+
+// Reorders the primitives to improve post transform vertex cache usage.
+// Implements Tom Forsyth's linear-speed vertex cache optimization, https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+void optimize_vertex_cache(Math::Vector3ui* primitives_begin, Math::Vector3ui* primitives_end, unsigned int vertex_count);
+
+// Splits the primitives into clusters at vertex cache flushes and sorts the clusters such that 
+// outward facing clusters are rendered first and occlude the rest of the mesh.
+// The primitives should be vertex cache optimized before calling this function.
+void optimize_overdraw(Math::Vector3ui* primitives_begin, Math::Vector3ui* primitives_end, 
+                       const Math::Vector3f* positions, unsigned int cache_size = 16);
+
+// Reorders the vertices in the order that they are first referenced by the primitives to improve vertex fetch locality.
+// All vertex buffers are remapped. Unreferenced vertices are moved to the end of the buffers.
+void optimize_vertex_fetch(Meshes::UID mesh_ID);
+
+struct OptimizationReport {
+    VertexCacheStatistics before;
+    VertexCacheStatistics after;
+};
+
+// Optimizes the mesh for vertex cache usage, overdraw and vertex fetch locality, in that order.
+OptimizationReport optimize(Meshes::UID mesh_ID);
+
+// Optimizes the meshes in parallel. If reports_begin is not null, then a report is written pr mesh.
+void optimize(const Meshes::UID* meshes_begin, const Meshes::UID* meshes_end, OptimizationReport* reports_begin = nullptr);
+
+//-------------------------------------------------------------------------
+// Mesh cluster utilities.
+//-------------------------------------------------------------------------
+
+// Partitions the mesh's primitives into clusters of at most max_vertex_count vertices and max_primitive_count primitives
+// and computes their bounding volumes and normal cones. Clusters are grown greedily by the adjacent primitive that adds the fewest vertices.
+// The primitives are reordered such that each cluster's primitives are stored contiguously and the clusters are cached on the mesh.
+// Returns the number of clusters.
+unsigned int build_clusters(Meshes::UID mesh_ID, unsigned int max_vertex_count = 64, unsigned int max_primitive_count = 124);
+
+// Builds clusters for the meshes in parallel.
+void build_clusters(const Meshes::UID* meshes_begin, const Meshes::UID* meshes_end, 
+                    unsigned int max_vertex_count = 64, unsigned int max_primitive_count = 124);
+
+// Culls the mesh's clusters against the view frustum and their normal cones against the view position.
+// The model transform places the mesh in world space and the view projection matrix is typically Cameras::get_view_projection_matrix.
+// The indices of the visible clusters are appended to visible_cluster_indices.
+// Returns the number of primitives in the visible clusters.
+unsigned int cull_clusters(Meshes::UID mesh_ID, Math::Transform model_transform, Math::Matrix4x4f view_projection_matrix,
+                           Math::Vector3f view_position, std::vector<unsigned int>& visible_cluster_indices);
 
 // Expands a buffer and a list of triangle vertex indices into a non-indexed buffer.
 // Useful for expanding meshes that uses indexing into a mesh that does not.
@@ -0,0 +1,505 @@
+// Bifrost mesh simplification utilities.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#include <Bifrost/Assets/MeshSimplification.h>
+
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Math/Utils.h>
+
+#include <algorithm>
+#include <assert.h>
+#include <limits>
+
+using namespace Bifrost::Math;
+
+namespace Bifrost {
+namespace Assets {
+namespace MeshSimplification {
+
+// ------------------------------------------------------------------------------------------------
+// Quadric representing the summed squared distance to a set of planes.
+// The quadric is stored as the symmetric matrix [A b; b^T c], where A = n * n^T, b = n * d and c = d^2 for a plane (n, d).
+// ------------------------------------------------------------------------------------------------
+struct Quadric {
+    double a00, a01, a02, a11, a12, a22;
+    double b0, b1, b2;
+    double c;
+    double weight;
+
+    static Quadric zero() { return { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }; }
+
+    static Quadric from_plane(Vector3d normal, double distance, double weight) {
+        Vector3d n = normal;
+        double d = distance;
+        double w = weight;
+        return { w * n.x * n.x, w * n.x * n.y, w * n.x * n.z, w * n.y * n.y, w * n.y * n.z, w * n.z * n.z,
+                 w * n.x * d, w * n.y * d, w * n.z * d, w * d * d, w };
+    }
+
+    Quadric& operator+=(const Quadric& rhs) {
+        a00 += rhs.a00; a01 += rhs.a01; a02 += rhs.a02; a11 += rhs.a11; a12 += rhs.a12; a22 += rhs.a22;
+        b0 += rhs.b0; b1 += rhs.b1; b2 += rhs.b2;
+        c += rhs.c;
+        weight += rhs.weight;
+        return *this;
+    }
+
+    Quadric operator+(const Quadric& rhs) const { Quadric q = *this; q += rhs; return q; }
+
+    // Weighted mean squared distance from the point to the planes.
+    double mean_squared_error(Vector3f point) const {
+        double x = point.x, y = point.y, z = point.z;
+        double error = x * (a00 * x + a01 * y + a02 * z) +
+                       y * (a01 * x + a11 * y + a12 * z) +
+                       z * (a02 * x + a12 * y + a22 * z) +
+                       2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return weight > 0.0 ? max(error / weight, 0.0) : 0.0;
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+// Simplification of a list of primitives referencing a fixed set of vertex buffers.
+// ------------------------------------------------------------------------------------------------
+
+struct VertexBuffers {
+    const Vector3f* positions;
+    const Vector3f* normals;
+    const Vector2f* texcoords;
+    unsigned int vertex_count;
+};
+
+struct Simplification {
+    std::vector<Vector3ui> primitives;
+    float error;
+};
+
+inline unsigned long long edge_key(unsigned int v0, unsigned int v1) {
+    unsigned int min_v = min(v0, v1), max_v = max(v0, v1);
+    return (unsigned long long(min_v) << 32) | max_v;
+}
+
+inline Vector3f triangle_normal(Vector3f p0, Vector3f p1, Vector3f p2) {
+    return cross(p1 - p0, p2 - p0);
+}
+
+Simplification simplify_primitives(const std::vector<Vector3ui>& primitives, VertexBuffers vertices,
+                                   unsigned int target_primitive_count, float max_error) {
+    unsigned int vertex_count = vertices.vertex_count;
+    const Vector3f* positions = vertices.positions;
+
+    // Weld vertices by position. Vertices with the same position but different normals or texcoords are wedges of the same position.
+    // Identical vertices are merged into a single wedge.
+    auto position_IDs = std::vector<unsigned int>(vertex_count);
+    auto wedge_IDs = std::vector<unsigned int>(vertex_count);
+    auto position_wedge_count = std::vector<unsigned int>();
+    auto position_vertex = std::vector<unsigned int>(); // A wedge pr position. The only wedge if the position has a single wedge.
+    {
+        auto compare_positions = [=](unsigned int lhs, unsigned int rhs) -> int {
+            Vector3f l = positions[lhs], r = positions[rhs];
+            if (l.x != r.x) return l.x < r.x ? -1 : 1;
+            if (l.y != r.y) return l.y < r.y ? -1 : 1;
+            if (l.z != r.z) return l.z < r.z ? -1 : 1;
+            return 0;
+        };
+        auto compare_attributes = [=](unsigned int lhs, unsigned int rhs) -> int {
+            if (vertices.normals != nullptr)
+                for (int i = 0; i < 3; ++i)
+                    if (vertices.normals[lhs][i] != vertices.normals[rhs][i])
+                        return vertices.normals[lhs][i] < vertices.normals[rhs][i] ? -1 : 1;
+            if (vertices.texcoords != nullptr)
+                for (int i = 0; i < 2; ++i)
+                    if (vertices.texcoords[lhs][i] != vertices.texcoords[rhs][i])
+                        return vertices.texcoords[lhs][i] < vertices.texcoords[rhs][i] ? -1 : 1;
+            return 0;
+        };
+
+        auto sorted_vertices = std::vector<unsigned int>(vertex_count);
+        for (unsigned int v = 0; v < vertex_count; ++v)
+            sorted_vertices[v] = v;
+        std::sort(sorted_vertices.begin(), sorted_vertices.end(), [=](unsigned int lhs, unsigned int rhs) -> bool {
+            int position_order = compare_positions(lhs, rhs);
+            return position_order != 0 ? position_order < 0 : compare_attributes(lhs, rhs) < 0;
+        });
+
+        for (unsigned int i = 0; i < vertex_count; ++i) {
+            unsigned int v = sorted_vertices[i];
+            unsigned int previous_v = i > 0 ? sorted_vertices[i - 1] : v;
+            bool new_position = i == 0 || compare_positions(previous_v, v) != 0;
+            if (new_position) {
+                position_wedge_count.push_back(1);
+                position_vertex.push_back(v);
+                wedge_IDs[v] = v;
+            } else if (compare_attributes(previous_v, v) != 0) {
+                ++position_wedge_count.back();
+                wedge_IDs[v] = v;
+            } else
+                wedge_IDs[v] = wedge_IDs[previous_v];
+            position_IDs[v] = unsigned int(position_vertex.size() - 1);
+        }
+    }
+    unsigned int position_count = unsigned int(position_vertex.size());
+
+    // Primitives in welded position space and their corresponding wedges. Primitives that are degenerate in position space are discarded.
+    auto position_primitives = std::vector<Vector3ui>();
+    auto wedge_primitives = std::vector<Vector3ui>();
+    position_primitives.reserve(primitives.size());
+    wedge_primitives.reserve(primitives.size());
+    for (Vector3ui primitive : primitives) {
+        Vector3ui position_primitive = { position_IDs[primitive.x], position_IDs[primitive.y], position_IDs[primitive.z] };
+        if (position_primitive.x == position_primitive.y || position_primitive.x == position_primitive.z || position_primitive.y == position_primitive.z)
+            continue;
+        position_primitives.push_back(position_primitive);
+        wedge_primitives.push_back({ wedge_IDs[primitive.x], wedge_IDs[primitive.y], wedge_IDs[primitive.z] });
+    }
+
+    auto get_position = [&](unsigned int position_ID) -> Vector3f { return positions[position_vertex[position_ID]]; };
+
+    // Lock seam vertices and vertices on borders or non-manifold edges.
+    auto locked = std::vector<bool>(position_count, false);
+    for (unsigned int p = 0; p < position_count; ++p)
+        locked[p] = position_wedge_count[p] > 1;
+    {
+        auto edges = std::vector<unsigned long long>();
+        edges.reserve(position_primitives.size() * 3);
+        for (Vector3ui primitive : position_primitives)
+            for (int i = 0; i < 3; ++i)
+                edges.push_back(edge_key(primitive[i], primitive[(i + 1) % 3]));
+        std::sort(edges.begin(), edges.end());
+
+        for (size_t e = 0; e < edges.size();) {
+            size_t edge_end = e + 1;
+            while (edge_end < edges.size() && edges[edge_end] == edges[e])
+                ++edge_end;
+            if (edge_end - e != 2) {
+                locked[unsigned int(edges[e] >> 32)] = true;
+                locked[unsigned int(edges[e] & 0xFFFFFFFF)] = true;
+            }
+            e = edge_end;
+        }
+    }
+
+    // Accumulate area weighted plane quadrics.
+    auto quadrics = std::vector<Quadric>(position_count, Quadric::zero());
+    for (Vector3ui primitive : position_primitives) {
+        Vector3d p0 = Vector3d(get_position(primitive.x));
+        Vector3d p1 = Vector3d(get_position(primitive.y));
+        Vector3d p2 = Vector3d(get_position(primitive.z));
+        Vector3d normal = cross(p1 - p0, p2 - p0);
+        double double_area = magnitude(normal);
+        if (double_area <= 0.0)
+            continue;
+        normal /= double_area;
+        Quadric quadric = Quadric::from_plane(normal, -dot(normal, p0), 0.5 * double_area);
+        for (int i = 0; i < 3; ++i)
+            quadrics[primitive[i]] += quadric;
+    }
+
+    unsigned int primitive_count = unsigned int(position_primitives.size());
+    double max_squared_error = double(max_error) * max_error;
+    double max_accepted_error = 0.0;
+
+    struct Collapse {
+        unsigned int from, to;
+        double error;
+    };
+
+    auto collapse_remap = std::vector<unsigned int>(position_count);
+    auto collapse_locked = std::vector<bool>(position_count);
+    auto adjacency_offsets = std::vector<unsigned int>(position_count + 1);
+    auto adjacency = std::vector<unsigned int>();
+    auto edges = std::vector<unsigned long long>();
+    auto collapses = std::vector<Collapse>();
+
+    // Collapse edges in passes. Each pass collapses the cheapest independent edges, i.e. edges that do not share a vertex with an already collapsed edge.
+    while (primitive_count > target_primitive_count) {
+        // Position to primitive adjacency.
+        std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0u);
+        for (Vector3ui primitive : position_primitives)
+            for (int i = 0; i < 3; ++i)
+                ++adjacency_offsets[primitive[i] + 1];
+        for (unsigned int p = 0; p < position_count; ++p)
+            adjacency_offsets[p + 1] += adjacency_offsets[p];
+        adjacency.resize(primitive_count * 3);
+        {
+            auto adjacency_fill = std::vector<unsigned int>(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+            for (unsigned int t = 0; t < primitive_count; ++t)
+                for (int i = 0; i < 3; ++i)
+                    adjacency[adjacency_fill[position_primitives[t][i]]++] = t;
+        }
+
+        // Find the unique edges and compute the cheapest valid collapse direction of each.
+        edges.clear();
+        for (Vector3ui primitive : position_primitives)
+            for (int i = 0; i < 3; ++i)
+                edges.push_back(edge_key(primitive[i], primitive[(i + 1) % 3]));
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        int edge_count = int(edges.size());
+        collapses.resize(edge_count);
+        Core::Parallel::parallel_for(0, edge_count, [&](int e) {
+            unsigned int v0 = unsigned int(edges[e] >> 32);
+            unsigned int v1 = unsigned int(edges[e] & 0xFFFFFFFF);
+            Quadric quadric = quadrics[v0] + quadrics[v1];
+
+            // A vertex can be collapsed if it isn't locked and its target has a single wedge, that the collapsed corners can be mapped to.
+            double infinity = std::numeric_limits<double>::infinity();
+            bool can_collapse_0_to_1 = !locked[v0] && position_wedge_count[v1] == 1;
+            double error_0_to_1 = can_collapse_0_to_1 ? quadric.mean_squared_error(get_position(v1)) : infinity;
+            bool can_collapse_1_to_0 = !locked[v1] && position_wedge_count[v0] == 1;
+            double error_1_to_0 = can_collapse_1_to_0 ? quadric.mean_squared_error(get_position(v0)) : infinity;
+
+            if (error_0_to_1 <= error_1_to_0)
+                collapses[e] = { v0, v1, error_0_to_1 };
+            else
+                collapses[e] = { v1, v0, error_1_to_0 };
+        }, 4096);
+        std::sort(collapses.begin(), collapses.end(), [](Collapse lhs, Collapse rhs) { return lhs.error < rhs.error; });
+
+        // Perform collapses.
+        for (unsigned int p = 0; p < position_count; ++p)
+            collapse_remap[p] = p;
+        std::fill(collapse_locked.begin(), collapse_locked.end(), false);
+        unsigned int remaining_primitive_count = primitive_count;
+        unsigned int collapse_count = 0;
+        for (Collapse collapse : collapses) {
+            bool is_valid_collapse = collapse.error < std::numeric_limits<double>::infinity();
+            if (!is_valid_collapse || collapse.error > max_squared_error || remaining_primitive_count <= target_primitive_count)
+                break;
+
+            unsigned int from = collapse.from, to = collapse.to;
+            if (collapse_locked[from] || collapse_locked[to])
+                continue;
+
+            // Reject the collapse if any of the remaining primitives around the collapsed vertex would flip.
+            bool flips = false;
+            unsigned int removed_primitive_count = 0;
+            for (unsigned int a = adjacency_offsets[from]; a < adjacency_offsets[from + 1] && !flips; ++a) {
+                Vector3ui primitive = position_primitives[adjacency[a]];
+                Vector3ui remapped_primitive = { collapse_remap[primitive.x], collapse_remap[primitive.y], collapse_remap[primitive.z] };
+                if (remapped_primitive.x == to || remapped_primitive.y == to || remapped_primitive.z == to) {
+                    ++removed_primitive_count;
+                    continue;
+                }
+
+                Vector3f p0 = get_position(remapped_primitive.x), p1 = get_position(remapped_primitive.y), p2 = get_position(remapped_primitive.z);
+                Vector3f old_normal = triangle_normal(p0, p1, p2);
+                Vector3f target_position = get_position(to);
+                if (remapped_primitive.x == from) p0 = target_position;
+                if (remapped_primitive.y == from) p1 = target_position;
+                if (remapped_primitive.z == from) p2 = target_position;
+                Vector3f new_normal = triangle_normal(p0, p1, p2);
+                flips = dot(old_normal, new_normal) <= 0.0f;
+            }
+            if (flips)
+                continue;
+
+            collapse_remap[from] = to;
+            quadrics[to] += quadrics[from];
+            collapse_locked[from] = collapse_locked[to] = true;
+            remaining_primitive_count -= min(removed_primitive_count, remaining_primitive_count);
+            max_accepted_error = max(max_accepted_error, collapse.error);
+            ++collapse_count;
+        }
+
+        if (collapse_count == 0)
+            break;
+
+        // Apply the collapses and remove degenerate primitives.
+        // A collapsed vertex is always remapped to a vertex with a single wedge, so the collapsed corners use that wedge.
+        unsigned int new_primitive_count = 0;
+        for (unsigned int t = 0; t < primitive_count; ++t) {
+            Vector3ui position_primitive = position_primitives[t];
+            Vector3ui wedge_primitive = wedge_primitives[t];
+            for (int i = 0; i < 3; ++i) {
+                unsigned int position_ID = position_primitive[i];
+                if (collapse_remap[position_ID] != position_ID) {
+                    position_primitive[i] = collapse_remap[position_ID];
+                    wedge_primitive[i] = position_vertex[position_primitive[i]];
+                }
+            }
+
+            bool is_degenerate = position_primitive.x == position_primitive.y || position_primitive.x == position_primitive.z || position_primitive.y == position_primitive.z;
+            if (!is_degenerate) {
+                position_primitives[new_primitive_count] = position_primitive;
+                wedge_primitives[new_primitive_count] = wedge_primitive;
+                ++new_primitive_count;
+            }
+        }
+        position_primitives.resize(new_primitive_count);
+        wedge_primitives.resize(new_primitive_count);
+        primitive_count = new_primitive_count;
+    }
+
+    return { wedge_primitives, float(sqrt(max_accepted_error)) };
+}
+
+// Creates a mesh containing the primitives and the vertices referenced by them.
+Meshes::UID create_mesh(const std::string& name, Mesh source_mesh, const std::vector<Vector3ui>& primitives) {
+    unsigned int source_vertex_count = source_mesh.get_vertex_count();
+    const unsigned int unassigned = 0xFFFFFFFF;
+    auto vertex_remap = std::vector<unsigned int>(source_vertex_count, unassigned);
+    auto used_vertices = std::vector<unsigned int>();
+    for (Vector3ui primitive : primitives)
+        for (int i = 0; i < 3; ++i)
+            if (vertex_remap[primitive[i]] == unassigned) {
+                vertex_remap[primitive[i]] = unsigned int(used_vertices.size());
+                used_vertices.push_back(primitive[i]);
+            }
+
+    unsigned int primitive_count = unsigned int(primitives.size());
+    unsigned int vertex_count = unsigned int(used_vertices.size());
+    Mesh mesh = Meshes::create(name, primitive_count, vertex_count, source_mesh.get_flags());
+
+    for (unsigned int p = 0; p < primitive_count; ++p) {
+        Vector3ui primitive = primitives[p];
+        mesh.get_primitives()[p] = { vertex_remap[primitive.x], vertex_remap[primitive.y], vertex_remap[primitive.z] };
+    }
+
+    for (unsigned int v = 0; v < vertex_count; ++v) {
+        unsigned int source_vertex = used_vertices[v];
+        mesh.get_positions()[v] = source_mesh.get_positions()[source_vertex];
+        if (mesh.get_normals() != nullptr)
+            mesh.get_normals()[v] = source_mesh.get_normals()[source_vertex];
+        if (mesh.get_texcoords() != nullptr)
+            mesh.get_texcoords()[v] = source_mesh.get_texcoords()[source_vertex];
+    }
+
+    if (vertex_count > 0)
+        mesh.compute_bounds();
+
+    return mesh.get_ID();
+}
+
+inline VertexBuffers get_vertex_buffers(Mesh mesh) {
+    return { mesh.get_positions(), mesh.get_normals(), mesh.get_texcoords(), mesh.get_vertex_count() };
+}
+
+inline std::vector<Vector3ui> get_primitives(Mesh mesh) {
+    return std::vector<Vector3ui>(mesh.get_primitives(), mesh.get_primitives() + mesh.get_primitive_count());
+}
+
+// ------------------------------------------------------------------------------------------------
+// Simplification API.
+// ------------------------------------------------------------------------------------------------
+
+Meshes::UID simplify(Meshes::UID mesh_ID, unsigned int target_primitive_count, float max_error, float* result_error) {
+    Mesh mesh = mesh_ID;
+    assert(mesh.get_positions() != nullptr);
+
+    Simplification simplification = simplify_primitives(get_primitives(mesh), get_vertex_buffers(mesh), target_primitive_count, max_error);
+    if (result_error != nullptr)
+        *result_error = simplification.error;
+
+    return create_mesh(mesh.get_name() + "_simplified", mesh, simplification.primitives);
+}
+
+// Simplified primitives of each LOD, referencing the vertices of the source mesh.
+typedef std::vector<Simplification> LODPrimitives;
+
+LODPrimitives simplify_LOD_primitives(Mesh mesh, float max_error, unsigned int max_LOD_count, float reduction_ratio) {
+    auto LODs = LODPrimitives();
+    VertexBuffers vertices = get_vertex_buffers(mesh);
+    std::vector<Vector3ui> primitives = get_primitives(mesh);
+    float error = 0.0f;
+    while (LODs.size() + 1 < max_LOD_count) {
+        unsigned int primitive_count = unsigned int(primitives.size());
+        unsigned int target_primitive_count = unsigned int(primitive_count * reduction_ratio);
+        Simplification LOD = simplify_primitives(primitives, vertices, target_primitive_count, max_error - error);
+
+        // Stop if the simplification stalled.
+        unsigned int LOD_primitive_count = unsigned int(LOD.primitives.size());
+        bool stalled = LOD_primitive_count == 0 || LOD_primitive_count > primitive_count - primitive_count / 10;
+        if (stalled)
+            break;
+
+        // The errors of each simplification are accumulated to bound the error relative to the source mesh.
+        error += LOD.error;
+        LOD.error = error;
+        primitives = LOD.primitives;
+        LODs.push_back(LOD);
+    }
+    return LODs;
+}
+
+LODChain create_LOD_chain(Mesh source_mesh, const LODPrimitives& LOD_primitives) {
+    auto LODs = LODChain();
+    LODs.push_back({ source_mesh.get_ID(), 0.0f });
+    for (int l = 0; l < int(LOD_primitives.size()); ++l) {
+        const Simplification& simplification = LOD_primitives[l];
+        std::string name = source_mesh.get_name() + "_LOD" + std::to_string(l + 1);
+        LODs.push_back({ create_mesh(name, source_mesh, simplification.primitives), simplification.error });
+    }
+    return LODs;
+}
+
+LODChain create_LOD_chain(Meshes::UID mesh_ID, float max_error, unsigned int max_LOD_count, float reduction_ratio) {
+    return create_LOD_chains(&mesh_ID, &mesh_ID + 1, max_error, max_LOD_count, reduction_ratio)[0];
+}
+
+std::vector<LODChain> create_LOD_chains(const Meshes::UID* meshes_begin, const Meshes::UID* meshes_end,
+                                        float max_error, unsigned int max_LOD_count, float reduction_ratio) {
+    int mesh_count = int(meshes_end - meshes_begin);
+
+    // Simplify the meshes in parallel.
+    auto LOD_primitives = std::vector<LODPrimitives>(mesh_count);
+    Core::Parallel::parallel_for(0, mesh_count, [&](int m) {
+        LOD_primitives[m] = simplify_LOD_primitives(meshes_begin[m], max_error, max_LOD_count, reduction_ratio);
+    }, 1);
+
+    // Mesh creation is not thread safe, so the LOD meshes are created serially and then optimized in parallel.
+    auto LOD_chains = std::vector<LODChain>(mesh_count);
+    auto LOD_mesh_IDs = std::vector<Meshes::UID>();
+    for (int m = 0; m < mesh_count; ++m) {
+        LOD_chains[m] = create_LOD_chain(meshes_begin[m], LOD_primitives[m]);
+        for (int l = 1; l < int(LOD_chains[m].size()); ++l)
+            LOD_mesh_IDs.push_back(LOD_chains[m][l].mesh_ID);
+    }
+    MeshUtils::optimize(LOD_mesh_IDs.data(), LOD_mesh_IDs.data() + LOD_mesh_IDs.size());
+
+    return LOD_chains;
+}
+
+// ------------------------------------------------------------------------------------------------
+// LOD selection.
+// ------------------------------------------------------------------------------------------------
+
+unsigned int select_LOD(const LODChain& LODs, MeshModels::UID model_ID, Scene::Cameras::UID camera_ID,
+                        float viewport_height, float max_pixel_error) {
+    if (LODs.size() <= 1)
+        return 0;
+
+    // Bounding sphere of the model in world space.
+    Transform model_transform = MeshModels::get_scene_node_ID(model_ID) != Scene::SceneNodes::UID::invalid_UID() ?
+        Scene::SceneNodes::get_global_transform(MeshModels::get_scene_node_ID(model_ID)) : Transform::identity();
+    AABB bounds = LODs[0].mesh_ID == Meshes::UID::invalid_UID() ? AABB::invalid() : Meshes::get_bounds(LODs[0].mesh_ID);
+    Vector3f center = model_transform * bounds.center();
+    float radius = magnitude(bounds.size()) * 0.5f * model_transform.scale;
+
+    // Conservative distance from the camera to the model. Use the highest LOD if the camera is inside the bounding sphere.
+    Vector3f camera_position = Scene::Cameras::get_transform(camera_ID).translation;
+    float distance = magnitude(center - camera_position) - radius;
+    if (distance <= 0.0f)
+        return 0;
+
+    // Project the world space error onto the viewport. The projection's [1][1] entry is the cotangent of half the vertical field of view.
+    float projection_scale = Scene::Cameras::get_projection_matrix(camera_ID)[1][1];
+    float world_to_pixels = projection_scale * viewport_height * 0.5f / distance;
+
+    unsigned int selected_LOD = 0;
+    for (unsigned int l = 1; l < LODs.size(); ++l) {
+        float pixel_error = LODs[l].error * model_transform.scale * world_to_pixels;
+        if (pixel_error <= max_pixel_error)
+            selected_LOD = l;
+    }
+    return selected_LOD;
+}
+
+} // NS MeshSimplification
+} // NS Assets
+} // NS Bifrost
@@ -0,0 +1,64 @@
+// Bifrost mesh simplification utilities.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_ASSETS_MESH_SIMPLIFICATION_H_
+#define _BIFROST_ASSETS_MESH_SIMPLIFICATION_H_
+
+#include <Bifrost/Assets/Mesh.h>
+#include <Bifrost/Assets/MeshModel.h>
+#include <Bifrost/Scene/Camera.h>
+
+#include <vector>
+
+namespace Bifrost {
+namespace Assets {
+
+//----------------------------------------------------------------------------
+// Quadric error metric mesh simplification and level of detail utilities.
+// See Garland and Heckbert, Surface Simplification Using Quadric Error Metrics, 1997.
+// Future work
+// * Collapse along seams and borders instead of locking the vertices.
+// * Optimize the position of the collapsed vertex instead of collapsing onto an edge endpoint.
+//----------------------------------------------------------------------------
+namespace MeshSimplification {
+
+// Simplifies the mesh by collapsing edges in order of increasing quadric error
+// until the primitive count reaches target_primitive_count or no edge can be collapsed without exceeding max_error.
+// Vertices are only ever collapsed onto other vertices, so the simplified mesh uses a subset of the original vertices.
+// Vertices on borders and on normal or texcoord seams are never moved, which preserves seams and open silhouettes.
+// Collapses that would flip a primitive are rejected.
+// The error is the root mean square distance in object space from a collapsed vertex to the planes of its original primitives.
+// The error of the simplified mesh is written to result_error if it is not null.
+Meshes::UID simplify(Meshes::UID mesh_ID, unsigned int target_primitive_count, float max_error, float* result_error = nullptr);
+
+struct LOD {
+    Meshes::UID mesh_ID;
+    float error; // Object space error relative to the source mesh.
+};
+typedef std::vector<LOD> LODChain;
+
+// Creates a chain of progressively simpler meshes. The first LOD is the source mesh with an error of zero.
+// Each subsequent LOD targets reduction_ratio times the primitive count of the previous LOD.
+// The chain ends when max_error is reached, the simplification stalls or max_LOD_count LODs have been created.
+LODChain create_LOD_chain(Meshes::UID mesh_ID, float max_error, unsigned int max_LOD_count = 8, float reduction_ratio = 0.5f);
+
+// Creates LOD chains for the meshes in parallel.
+std::vector<LODChain> create_LOD_chains(const Meshes::UID* meshes_begin, const Meshes::UID* meshes_end,
+                                        float max_error, unsigned int max_LOD_count = 8, float reduction_ratio = 0.5f);
+
+// Selects the simplest LOD whose error projects to less than max_pixel_error pixels when the model is seen through the camera.
+// The viewport height is given in pixels.
+// Returns the index of the selected LOD in the chain.
+unsigned int select_LOD(const LODChain& LODs, MeshModels::UID model_ID, Scene::Cameras::UID camera_ID,
+                        float viewport_height, float max_pixel_error = 1.0f);
+
+} // NS MeshSimplification
+} // NS Assets
+} // NS Bifrost
+
+#endif // _BIFROST_ASSETS_MESH_SIMPLIFICATION_H_
@@ -0,0 +1,90 @@
+// Bifrost directional-hemispherical reflectance tables.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#include <Bifrost/Assets/Shading/RhoTable.h>
+
+#include <Bifrost/Core/BinaryFile.h>
+
+namespace Bifrost {
+namespace Assets {
+namespace Shading {
+
+// File layout: header, rho, standard errors and sample counts.
+static const unsigned int rho_table_magic = 0x4F484252; // 'RBHO' in little endian.
+static const unsigned int rho_table_format_version = 1;
+
+struct RhoTableHeader {
+    unsigned int version;
+    unsigned int angle_sample_count;
+    unsigned int roughness_sample_count;
+    unsigned int channel_count;
+};
+
+RhoTable::RhoTable(unsigned int angle_sample_count, unsigned int roughness_sample_count, unsigned int channel_count)
+    : m_angle_sample_count(angle_sample_count), m_roughness_sample_count(roughness_sample_count), m_channel_count(channel_count) {
+    if (channel_count == 0 || channel_count > MAX_CHANNEL_COUNT) {
+        printf("Rho tables support between 1 and %u channels, but %u were requested.\n", MAX_CHANNEL_COUNT, channel_count);
+        m_angle_sample_count = m_roughness_sample_count = m_channel_count = 0;
+        return;
+    }
+
+    unsigned int entry_count = angle_sample_count * roughness_sample_count;
+    m_rho.resize(entry_count * channel_count, 0.0f);
+    m_standard_errors.resize(entry_count * channel_count, 0.0f);
+    m_sample_counts.resize(entry_count, 0u);
+}
+
+float RhoTable::get_max_standard_error() const {
+    float max_standard_error = 0.0f;
+    for (float standard_error : m_standard_errors)
+        max_standard_error = std::max(max_standard_error, standard_error);
+    return max_standard_error;
+}
+
+float RhoTable::sample(float wo_dot_normal, float roughness, unsigned int channel) const {
+    float angle_coord = std::min(std::max(wo_dot_normal * m_angle_sample_count - 0.5f, 0.0f), m_angle_sample_count - 1.0f);
+    float roughness_coord = std::min(std::max(roughness, 0.0f), 1.0f) * (m_roughness_sample_count - 1);
+    unsigned int entry = unsigned(angle_coord) + unsigned(roughness_coord) * m_angle_sample_count;
+    return m_rho[entry * m_channel_count + channel];
+}
+
+bool RhoTable::write(const std::filesystem::path& path, unsigned int version) const {
+    if (!is_valid())
+        return false;
+
+    Core::BinaryFileWriter file = Core::BinaryFileWriter(path, rho_table_magic, rho_table_format_version);
+    RhoTableHeader header = { version, m_angle_sample_count, m_roughness_sample_count, m_channel_count };
+    file.write(header);
+    file.write(m_rho.data(), m_rho.size());
+    file.write(m_standard_errors.data(), m_standard_errors.size());
+    file.write(m_sample_counts.data(), m_sample_counts.size());
+    return file.is_good();
+}
+
+RhoTable RhoTable::read(const std::filesystem::path& path, unsigned int version) {
+    Core::BinaryFileReader file = Core::BinaryFileReader(path, rho_table_magic, rho_table_format_version);
+    RhoTableHeader header;
+    file.read(header);
+    if (!file.is_good() || header.version != version || header.channel_count == 0 || header.channel_count > MAX_CHANNEL_COUNT)
+        return RhoTable();
+
+    unsigned long long entry_count = (unsigned long long)header.angle_sample_count * header.roughness_sample_count;
+    file.expect_remaining_size(entry_count * (2 * header.channel_count * sizeof(float) + sizeof(unsigned int)));
+    if (entry_count == 0 || !file.is_good())
+        return RhoTable();
+
+    RhoTable table = RhoTable(header.angle_sample_count, header.roughness_sample_count, header.channel_count);
+    file.read(table.m_rho.data(), table.m_rho.size());
+    file.read(table.m_standard_errors.data(), table.m_standard_errors.size());
+    file.read(table.m_sample_counts.data(), table.m_sample_counts.size());
+    return file.is_good() ? table : RhoTable();
+}
+
+} // NS Shading
+} // NS Assets
+} // NS Bifrost
@@ -0,0 +1,188 @@
+// Bifrost directional-hemispherical reflectance tables.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _BIFROST_ASSETS_SHADING_RHO_TABLE_H_
+#define _BIFROST_ASSETS_SHADING_RHO_TABLE_H_
+
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Math/RNG.h>
+#include <Bifrost/Math/Statistics.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Bifrost {
+namespace Assets {
+namespace Shading {
+
+// ------------------------------------------------------------------------------------------------
+// Table of the directional-hemispherical reflectance, rho, of a BSDF pr cos(theta) and roughness.
+// Each entry has one to four channels, fx the specular and diffuse rho of a layered material,
+// and stores the standard error of the estimate alongside the estimate.
+// The layout matches the generated tables in Fittings.h, i.e. cos(theta) is sampled at the center
+// of angle_sample_count intervals and roughness at roughness_sample_count points in [0, 1].
+// ------------------------------------------------------------------------------------------------
+class RhoTable final {
+public:
+    static const unsigned int MAX_CHANNEL_COUNT = 4;
+
+    // --------------------------------------------------------------------------------------------
+    // Settings for generating tables.
+    // Each entry is estimated progressively in batches of batch_sample_count samples, until the
+    // standard error of all channels is below max_standard_error or max_sample_count samples have been used.
+    // Every batch uses an independently scrambled Sobol sequence, i.e. randomized quasi-Monte Carlo,
+    // so the batch estimates are independent and the standard error is estimated from their variance.
+    // The estimated standard error is only trusted after min_batch_count batches, which is clamped to at least two.
+    // max_sample_count is rounded down to a whole number of batches.
+    // --------------------------------------------------------------------------------------------
+    struct Settings {
+        unsigned int angle_sample_count = 64;
+        unsigned int roughness_sample_count = 64;
+        unsigned int channel_count = 1;
+        unsigned int batch_sample_count = 256;
+        unsigned int min_batch_count = 8;
+        unsigned int max_sample_count = 4096;
+        float max_standard_error = 0.0005f;
+    };
+
+    RhoTable() = default;
+    RhoTable(unsigned int angle_sample_count, unsigned int roughness_sample_count, unsigned int channel_count);
+
+    //*********************************************************************************************
+    // Getters.
+    //*********************************************************************************************
+    inline bool is_valid() const { return !m_rho.empty(); }
+    inline unsigned int get_angle_sample_count() const { return m_angle_sample_count; }
+    inline unsigned int get_roughness_sample_count() const { return m_roughness_sample_count; }
+    inline unsigned int get_channel_count() const { return m_channel_count; }
+    inline unsigned int get_entry_count() const { return m_angle_sample_count * m_roughness_sample_count; }
+
+    // The rho and standard errors of all entries with get_channel_count() channels pr entry.
+    inline const float* get_rho() const { return m_rho.data(); }
+    inline float* get_rho() { return m_rho.data(); }
+    inline const float* get_standard_errors() const { return m_standard_errors.data(); }
+    inline float* get_standard_errors() { return m_standard_errors.data(); }
+    inline const unsigned int* get_sample_counts() const { return m_sample_counts.data(); }
+    inline unsigned int* get_sample_counts() { return m_sample_counts.data(); }
+
+    // The maximal standard error of any channel in any entry.
+    float get_max_standard_error() const;
+
+    // Nearest neighbour lookup, equivalent to the sample functions in Fittings.h.
+    float sample(float wo_dot_normal, float roughness, unsigned int channel = 0) const;
+
+    //*********************************************************************************************
+    // Generation.
+    //*********************************************************************************************
+
+    // Estimates the table in parallel over all entries.
+    // The estimator is called as estimator(wo_dot_normal, roughness, sample_index, sampler, throughputs),
+    // where the sample's random numbers are sampler.sample1f(sample_index, dimension) and sample_index is the index in the batch.
+    // It should store the throughput, i.e. f * cos(theta) / PDF, of the sample in the first channel_count throughputs.
+    // The estimator must be safe to call concurrently. The result is independent of the number of threads.
+    template <typename Estimator>
+    static RhoTable generate(const Settings& settings, Estimator estimator);
+
+    //*********************************************************************************************
+    // Binary cache.
+    // Tables are stored with a version, which should be bumped whenever the shading model changes.
+    // Reading fails if the file is missing, corrupt or of a different version.
+    //*********************************************************************************************
+    bool write(const std::filesystem::path& path, unsigned int version) const;
+    static RhoTable read(const std::filesystem::path& path, unsigned int version);
+
+    // Reads the table from the cache directory or generates and writes it if no valid table is cached.
+    // The cached table is also regenerated if it was generated with different settings.
+    template <typename Estimator>
+    static RhoTable load_or_generate(const std::filesystem::path& cache_directory, const std::string& name, unsigned int version,
+                                     const Settings& settings, Estimator estimator);
+
+private:
+    unsigned int m_angle_sample_count = 0;
+    unsigned int m_roughness_sample_count = 0;
+    unsigned int m_channel_count = 0;
+    std::vector<float> m_rho;
+    std::vector<float> m_standard_errors;
+    std::vector<unsigned int> m_sample_counts;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Implementation.
+// ------------------------------------------------------------------------------------------------
+
+template <typename Estimator>
+RhoTable RhoTable::generate(const Settings& settings, Estimator estimator) {
+    RhoTable table = RhoTable(settings.angle_sample_count, settings.roughness_sample_count, settings.channel_count);
+    unsigned int channel_count = settings.channel_count;
+    // The standard error is undefined for less than two batches.
+    unsigned int min_batch_count = std::max(2u, settings.min_batch_count);
+    unsigned int max_batch_count = std::max(min_batch_count, settings.max_sample_count / settings.batch_sample_count);
+
+    Core::Parallel::parallel_for(0, int(table.get_entry_count()), [&](int e) {
+        int x = e % settings.angle_sample_count, y = e / settings.angle_sample_count;
+        float wo_dot_normal = (x + 0.5f) / settings.angle_sample_count;
+        float roughness = settings.roughness_sample_count == 1 ? 0.0f : y / float(settings.roughness_sample_count - 1);
+
+        // The variance of the batch means is the population variance, so the standard error of their mean divides by batch_count - 1.
+        Math::Statistics<double> batch_statistics[MAX_CHANNEL_COUNT];
+        auto standard_error = [&](unsigned int c) { return std::sqrt(batch_statistics[c].variance() / (batch_statistics[c].sample_count - 1)); };
+
+        unsigned int batch_count = 0;
+        bool converged = false;
+        while (!converged && batch_count < max_batch_count) {
+            Math::RNG::OwenScrambledSobol sampler(Math::RNG::hash_combine(Math::RNG::jenkins_hash(e), batch_count));
+            double batch_sums[MAX_CHANNEL_COUNT] = {};
+            for (unsigned int s = 0; s < settings.batch_sample_count; ++s) {
+                float throughputs[MAX_CHANNEL_COUNT] = {};
+                estimator(wo_dot_normal, roughness, s, sampler, throughputs);
+                for (unsigned int c = 0; c < channel_count; ++c)
+                    batch_sums[c] += throughputs[c];
+            }
+            for (unsigned int c = 0; c < channel_count; ++c)
+                batch_statistics[c].add(batch_sums[c] / settings.batch_sample_count);
+            ++batch_count;
+
+            converged = batch_count >= min_batch_count;
+            for (unsigned int c = 0; c < channel_count && converged; ++c)
+                converged &= standard_error(c) <= settings.max_standard_error;
+        }
+
+        for (unsigned int c = 0; c < channel_count; ++c) {
+            table.m_rho[e * channel_count + c] = float(batch_statistics[c].mean);
+            table.m_standard_errors[e * channel_count + c] = float(standard_error(c));
+        }
+        table.m_sample_counts[e] = batch_count * settings.batch_sample_count;
+    }, 1);
+
+    return table;
+}
+
+template <typename Estimator>
+RhoTable RhoTable::load_or_generate(const std::filesystem::path& cache_directory, const std::string& name, unsigned int version,
+                                    const Settings& settings, Estimator estimator) {
+    std::filesystem::path path = cache_directory / (name + ".rho");
+    RhoTable table = read(path, version);
+    if (table.is_valid() && table.get_angle_sample_count() == settings.angle_sample_count &&
+        table.get_roughness_sample_count() == settings.roughness_sample_count && table.get_channel_count() == settings.channel_count)
+        return table;
+
+    table = generate(settings, estimator);
+    if (!table.write(path, version))
+        printf("Could not write rho table to '%s'\n", path.string().c_str());
+    return table;
+}
+
+} // NS Shading
+} // NS Assets
+} // NS Bifrost
+
+#endif // _BIFROST_ASSETS_SHADING_RHO_TABLE_H_
@@ -0,0 +1,48 @@
+// Bifrost versioned binary files.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#include <Bifrost/Core/BinaryFile.h>
+
+namespace Bifrost {
+namespace Core {
+
+BinaryFileWriter::BinaryFileWriter(const std::filesystem::path& path, unsigned int magic, unsigned int format_version) {
+    if (path.has_parent_path()) {
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+
+    m_file.open(path, std::ios::binary);
+    write(magic);
+    write(format_version);
+}
+
+BinaryFileReader::BinaryFileReader(const std::filesystem::path& path, unsigned int magic, unsigned int format_version) {
+    std::error_code error;
+    m_file_size = std::filesystem::file_size(path, error);
+    if (error)
+        m_file_size = 0;
+
+    m_file.open(path, std::ios::binary);
+    unsigned int file_magic = 0, file_format_version = 0;
+    read(file_magic);
+    read(file_format_version);
+    if (file_magic != magic || file_format_version != format_version)
+        m_file.setstate(std::ios::failbit);
+}
+
+void BinaryFileReader::expect_remaining_size(unsigned long long byte_count) {
+    if (!m_file)
+        return;
+    unsigned long long position = (unsigned long long)m_file.tellg();
+    if (position > m_file_size || m_file_size - position != byte_count)
+        m_file.setstate(std::ios::failbit);
+}
+
+} // NS Core
+} // NS Bifrost
@@ -0,0 +1,74 @@
+// Bifrost versioned binary files.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _BIFROST_CORE_BINARY_FILE_H_
+#define _BIFROST_CORE_BINARY_FILE_H_
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+
+namespace Bifrost {
+namespace Core {
+
+// ------------------------------------------------------------------------------------------------
+// Binary files start with a magic number identifying the file type and a format version,
+// which should be bumped whenever the layout of the file changes. The rest of the file is a
+// format specific header and payload of trivially copyable values.
+// Once an operation fails all following operations are ignored, so the state only has to be
+// checked after all values have been read or written.
+// ------------------------------------------------------------------------------------------------
+class BinaryFileWriter final {
+public:
+    // Creates the parent directories of the path if needed and writes the magic number and format version.
+    BinaryFileWriter(const std::filesystem::path& path, unsigned int magic, unsigned int format_version);
+
+    template <typename T>
+    inline void write(const T* values, size_t count) {
+        if (m_file)
+            m_file.write((const char*)values, count * sizeof(T));
+    }
+
+    template <typename T>
+    inline void write(const T& value) { write(&value, 1); }
+
+    inline bool is_good() const { return bool(m_file); }
+
+private:
+    std::ofstream m_file;
+};
+
+class BinaryFileReader final {
+public:
+    // Opens the file and fails if it does not start with the magic number and format version.
+    BinaryFileReader(const std::filesystem::path& path, unsigned int magic, unsigned int format_version);
+
+    template <typename T>
+    inline void read(T* values, size_t count) {
+        if (m_file)
+            m_file.read((char*)values, count * sizeof(T));
+    }
+
+    template <typename T>
+    inline void read(T& value) { read(&value, 1); }
+
+    // Fails unless exactly byte_count bytes remain in the file.
+    // Call it before allocating the payload, so a corrupt header cannot trigger huge allocations.
+    void expect_remaining_size(unsigned long long byte_count);
+
+    inline bool is_good() const { return bool(m_file); }
+
+private:
+    std::ifstream m_file;
+    unsigned long long m_file_size;
+};
+
+} // NS Core
+} // NS Bifrost
+
+#endif // _BIFROST_CORE_BINARY_FILE_H_
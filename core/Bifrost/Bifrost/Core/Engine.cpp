@@ -8,9 +8,19 @@
 
 #include <Bifrost/Core/Engine.h>
 
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Core/Profiler.h>
 #include <Bifrost/Input/Keyboard.h>
 #include <Bifrost/Input/Mouse.h>
 
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 namespace Bifrost {
 namespace Core {
 
@@ -25,19 +35,127 @@ Engine::Engine(const std::filesystem::path& data_directory)
     , m_data_directory(data_directory) {
 }
 
+inline void run_timed(std::function<void()>& function, double& duration) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+Engine::CallbackID Engine::add_non_mutating_callback(std::function<void()> callback, const std::string& name,
+                                                     CallbackThread thread, const std::vector<CallbackID>& dependencies) {
+    CallbackID callback_ID = CallbackID(m_non_mutating_callbacks.size());
+    for (CallbackID dependency : dependencies) {
+        assert(dependency < callback_ID);
+        m_non_mutating_callbacks[dependency].dependents.push_back(callback_ID);
+    }
+    m_non_mutating_callbacks.push_back({ { callback, name, 0.0 }, thread, unsigned(dependencies.size()), {} });
+    return callback_ID;
+}
+
+std::vector<Engine::CallbackTiming> Engine::get_callback_timings() const {
+    std::vector<CallbackTiming> timings;
+    timings.reserve(m_mutating_callbacks.size() + m_non_mutating_callbacks.size() + m_tick_cleanup_callbacks.size());
+    for (const Callback& callback : m_mutating_callbacks)
+        timings.push_back({ callback.name, CallbackPhase::Mutating, callback.duration });
+    for (const NonMutatingCallback& callback : m_non_mutating_callbacks)
+        timings.push_back({ callback.callback.name, CallbackPhase::NonMutating, callback.callback.duration });
+    for (const Callback& callback : m_tick_cleanup_callbacks)
+        timings.push_back({ callback.name, CallbackPhase::TickCleanup, callback.duration });
+    return timings;
+}
+
+void Engine::run_non_mutating_callbacks() {
+    int callback_count = int(m_non_mutating_callbacks.size());
+    if (callback_count == 0)
+        return;
+
+    // Callbacks whose dependencies have completed are either scheduled on the thread pool
+    // or queued for the calling thread. Callbacks queued for the calling thread run in the order they became ready,
+    // so callbacks without dependencies run in the order they were added, as they did before the task graph.
+    auto pending_dependency_counts = std::unique_ptr<std::atomic<unsigned int>[]>(new std::atomic<unsigned int>[callback_count]);
+    for (int c = 0; c < callback_count; ++c)
+        pending_dependency_counts[c] = m_non_mutating_callbacks[c].dependency_count;
+    std::atomic<int> remaining_callback_count(callback_count);
+
+    std::mutex main_thread_mutex;
+    std::deque<CallbackID> main_thread_callbacks;
+    bool run_in_parallel = Parallel::get_thread_count() > 1;
+    Parallel::TaskGroup group;
+
+    std::function<void(CallbackID)> run_callback;
+    auto callback_ready = [&](CallbackID callback_ID) {
+        if (run_in_parallel && m_non_mutating_callbacks[callback_ID].thread == CallbackThread::Any)
+            group.run([&, callback_ID] { run_callback(callback_ID); });
+        else {
+            std::lock_guard<std::mutex> lock(main_thread_mutex);
+            main_thread_callbacks.push_back(callback_ID);
+        }
+    };
+
+    run_callback = [&](CallbackID callback_ID) {
+        NonMutatingCallback& callback = m_non_mutating_callbacks[callback_ID];
+        run_timed(callback.callback.function, callback.callback.duration);
+        for (CallbackID dependent : callback.dependents)
+            if (pending_dependency_counts[dependent].fetch_sub(1) == 1)
+                callback_ready(dependent);
+        remaining_callback_count.fetch_sub(1);
+    };
+
+    for (int c = 0; c < callback_count; ++c)
+        if (m_non_mutating_callbacks[c].dependency_count == 0)
+            callback_ready(CallbackID(c));
+
+    // Run the main thread callbacks and help the thread pool until all callbacks have completed.
+    while (remaining_callback_count.load() > 0) {
+        CallbackID callback_ID;
+        bool has_main_thread_callback;
+        {
+            std::lock_guard<std::mutex> lock(main_thread_mutex);
+            has_main_thread_callback = !main_thread_callbacks.empty();
+            if (has_main_thread_callback) {
+                callback_ID = main_thread_callbacks.front();
+                main_thread_callbacks.pop_front();
+            }
+        }
+
+        if (has_main_thread_callback)
+            run_callback(callback_ID);
+        else if (!Parallel::execute_pending_task())
+            std::this_thread::yield();
+    }
+
+    group.wait();
+}
+
 void Engine::do_tick(double delta_time) {
-    m_time.tick(delta_time);
+    Profiler::begin_tick();
+
+    {
+        BIFROST_PROFILE_SCOPE("Engine::do_tick");
+
+        m_time.tick(delta_time);
+
+        m_window.reset_change_notifications();
 
-    m_window.reset_change_notifications();
+        {
+            BIFROST_PROFILE_SCOPE("Mutating callbacks");
+            for (Callback& callback : m_mutating_callbacks)
+                run_timed(callback.function, callback.duration);
+        }
 
-    for (auto callback : m_mutating_callbacks)
-        callback();
+        {
+            BIFROST_PROFILE_SCOPE("Non-mutating callbacks");
+            run_non_mutating_callbacks();
+        }
 
-    for (auto callback : m_non_mutating_callbacks)
-        callback();
+        {
+            BIFROST_PROFILE_SCOPE("Tick cleanup callbacks");
+            for (Callback& callback : m_tick_cleanup_callbacks)
+                run_timed(callback.function, callback.duration);
+        }
+    }
 
-    for (auto callback : m_tick_cleanup_callbacks)
-        callback();
+    Profiler::end_tick();
 }
 
 } // NS Core
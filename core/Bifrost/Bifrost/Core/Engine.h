@@ -14,6 +14,7 @@
 
 #include <filesystem>
 #include <functional>
+#include <string>
 #include <vector>
 
 namespace Bifrost::Input {
@@ -26,12 +27,32 @@ namespace Bifrost::Core {
 // ---------------------------------------------------------------------------
 // Engine driver, responsible for invoking the modules and handling all engine
 // 'tick' logic not related to the operating system.
+// A tick runs the mutating callbacks in order on the calling thread, then the
+// non-mutating callbacks as a task graph and finally the tick cleanup callbacks.
+// Non-mutating callbacks run on the calling thread by default, as fx OpenGL
+// renderers need their context, but can be marked as thread safe, in which case
+// they run on the thread pool as soon as their dependencies have completed.
 // Future work
+// * Pipeline the non-mutating callbacks with the next tick's mutating callbacks.
+//   Requires double buffering the assets and not just the change sets, as the
+//   managers are mutated in place.
 // * Add a 'mutation complete' (said in the Zerg voice) callback.
 // * Add on_exit callback and deallocate the managers internal state.
 // ---------------------------------------------------------------------------
 class Engine final {
 public:
+    // Handle to a non-mutating callback, used to declare dependencies between non-mutating callbacks.
+    typedef unsigned int CallbackID;
+
+    enum class CallbackThread : unsigned char { Main, Any };
+    enum class CallbackPhase : unsigned char { Mutating, NonMutating, TickCleanup };
+
+    struct CallbackTiming {
+        std::string name;
+        CallbackPhase phase;
+        double duration; // Wall clock time in seconds.
+    };
+
     Engine(const std::filesystem::path& data_directory);
 
     inline Time& get_time() { return m_time; }
@@ -53,9 +74,22 @@ public:
     // -----------------------------------------------------------------------
     // Callbacks
     // -----------------------------------------------------------------------
-    inline void add_mutating_callback(std::function<void()> callback) { m_mutating_callbacks.push_back(callback); }
-    inline void add_non_mutating_callback(std::function<void()> callback) { m_non_mutating_callbacks.push_back(callback); }
-    inline void add_tick_cleanup_callback(std::function<void()> callback) { m_tick_cleanup_callbacks.push_back(callback); }
+    inline void add_mutating_callback(std::function<void()> callback, const std::string& name = "Mutating") {
+        m_mutating_callbacks.push_back({ callback, name, 0.0 });
+    }
+
+    // Adds a non-mutating callback that runs when all its dependencies have completed.
+    // Callbacks with CallbackThread::Any must be thread safe and may run concurrently with other non-mutating callbacks.
+    // Dependencies must have been added before the callback, which keeps the graph acyclic.
+    CallbackID add_non_mutating_callback(std::function<void()> callback, const std::string& name = "Non-mutating",
+                                         CallbackThread thread = CallbackThread::Main, const std::vector<CallbackID>& dependencies = {});
+
+    inline void add_tick_cleanup_callback(std::function<void()> callback, const std::string& name = "Tick cleanup") {
+        m_tick_cleanup_callbacks.push_back({ callback, name, 0.0 });
+    }
+
+    // Timings of all callbacks from the latest tick.
+    std::vector<CallbackTiming> get_callback_timings() const;
 
     // -----------------------------------------------------------------------
     // Paths
@@ -73,14 +107,29 @@ private:
     Engine(const Engine& rhs) = delete;
     Engine& operator=(Engine& rhs) = delete;
 
+    struct Callback {
+        std::function<void()> function;
+        std::string name;
+        double duration;
+    };
+
+    struct NonMutatingCallback {
+        Callback callback;
+        CallbackThread thread;
+        unsigned int dependency_count;
+        std::vector<CallbackID> dependents;
+    };
+
+    void run_non_mutating_callbacks();
+
     Time m_time;
     Window m_window;
     bool m_quit;
 
     // All engine callbacks.
-    std::vector<std::function<void()>> m_mutating_callbacks;
-    std::vector<std::function<void()>> m_non_mutating_callbacks;
-    std::vector<std::function<void()>> m_tick_cleanup_callbacks;
+    std::vector<Callback> m_mutating_callbacks;
+    std::vector<NonMutatingCallback> m_non_mutating_callbacks;
+    std::vector<Callback> m_tick_cleanup_callbacks;
 
     // Input should only be updated by whoever created it and not by access via the engine.
     const Input::Keyboard* m_keyboard;
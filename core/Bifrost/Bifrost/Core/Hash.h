@@ -0,0 +1,65 @@
+// Bifrost hashing utilities.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_CORE_HASH_H_
+#define _BIFROST_CORE_HASH_H_
+
+#include <string.h>
+
+namespace Bifrost {
+namespace Core {
+
+// ---------------------------------------------------------------------------
+// 64 bit hash of a block of memory. The hash is not cryptographic and only
+// intended for fast content comparisons, e.g. finding duplicate assets.
+// Hashes of multiple blocks can be chained by passing the previous hash as seed.
+// MurmurHash64A by Austin Appleby, https://github.com/aappleby/smhasher, which is in the public domain.
+// ---------------------------------------------------------------------------
+inline unsigned long long hash64(const void* data, size_t byte_count, unsigned long long seed = 0) {
+    const unsigned long long m = 0xc6a4a7935bd1e995ull;
+    const int r = 47;
+
+    unsigned long long hash = seed ^ (byte_count * m);
+
+    const unsigned char* bytes = (const unsigned char*)data;
+    const unsigned char* bytes_end = bytes + (byte_count & ~size_t(7));
+    while (bytes != bytes_end) {
+        unsigned long long k;
+        memcpy(&k, bytes, sizeof(k));
+        bytes += sizeof(k);
+
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+
+        hash ^= k;
+        hash *= m;
+    }
+
+    switch (byte_count & 7) {
+    case 7: hash ^= (unsigned long long)bytes[6] << 48;
+    case 6: hash ^= (unsigned long long)bytes[5] << 40;
+    case 5: hash ^= (unsigned long long)bytes[4] << 32;
+    case 4: hash ^= (unsigned long long)bytes[3] << 24;
+    case 3: hash ^= (unsigned long long)bytes[2] << 16;
+    case 2: hash ^= (unsigned long long)bytes[1] << 8;
+    case 1: hash ^= (unsigned long long)bytes[0];
+        hash *= m;
+    };
+
+    hash ^= hash >> r;
+    hash *= m;
+    hash ^= hash >> r;
+
+    return hash;
+}
+
+} // NS Core
+} // NS Bifrost
+
+#endif // _BIFROST_CORE_HASH_H_
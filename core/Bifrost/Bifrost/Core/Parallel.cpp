@@ -0,0 +1,271 @@
+// Bifrost parallel utility functions.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#include <Bifrost/Core/Parallel.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+
+namespace Bifrost {
+namespace Core {
+namespace Parallel {
+
+// Index of the calling thread's task queue. Threads outside the pool use the shared queue at index 0.
+static thread_local int g_queue_index = 0;
+
+inline int hardware_thread_count() {
+    int thread_count = int(std::thread::hardware_concurrency());
+    return thread_count > 0 ? thread_count : 1;
+}
+
+// Task queue padded to a cache line to avoid false sharing between the queues.
+struct alignas(64) TaskQueue {
+    std::mutex mutex;
+    std::deque<Task*> tasks;
+};
+
+class Scheduler final {
+public:
+    Scheduler(int thread_count, bool pin_threads)
+        : m_queues(thread_count), m_shutdown(false), m_queued_task_count(0), m_sleeping_thread_count(0) {
+        m_workers.reserve(thread_count - 1);
+        for (int w = 1; w < thread_count; ++w)
+            m_workers.emplace_back([this, w, pin_threads]() {
+                if (pin_threads)
+                    pin_current_thread(w % hardware_thread_count());
+                worker_loop(w);
+            });
+    }
+
+    ~Scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_shutdown = true;
+        }
+        m_wake_condition.notify_all();
+        for (std::thread& worker : m_workers)
+            worker.join();
+    }
+
+    int get_thread_count() const { return int(m_queues.size()); }
+
+    void push(Task* task) {
+        TaskQueue& queue = m_queues[g_queue_index];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(task);
+        }
+        m_queued_task_count.fetch_add(1);
+
+        // Wake a sleeping thread. Taking the sleep mutex guarantees that a thread that found no tasks
+        // has started waiting before it is notified.
+        if (m_sleeping_thread_count.load() > 0) {
+            { std::lock_guard<std::mutex> lock(m_sleep_mutex); }
+            m_wake_condition.notify_one();
+        }
+    }
+
+    // Pops the newest task from the thread's own queue or steals the oldest task from another queue.
+    Task* pop() {
+        if (m_queued_task_count.load() == 0)
+            return nullptr;
+
+        int queue_count = int(m_queues.size());
+        for (int q = 0; q < queue_count; ++q) {
+            int queue_index = (g_queue_index + q) % queue_count;
+            TaskQueue& queue = m_queues[queue_index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                Task* task;
+                if (q == 0) {
+                    task = queue.tasks.back();
+                    queue.tasks.pop_back();
+                } else {
+                    task = queue.tasks.front();
+                    queue.tasks.pop_front();
+                }
+                m_queued_task_count.fetch_sub(1);
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    void worker_loop(int queue_index) {
+        g_queue_index = queue_index;
+
+        while (true) {
+            Task* task = pop();
+            if (task != nullptr) {
+                execute_task(task);
+                continue;
+            }
+
+            // Spin briefly before sleeping, as tasks are often scheduled in bursts.
+            for (int s = 0; s < 64 && task == nullptr; ++s) {
+                std::this_thread::yield();
+                task = pop();
+            }
+            if (task != nullptr) {
+                execute_task(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            m_sleeping_thread_count.fetch_add(1);
+            m_wake_condition.wait(lock, [this]() { return m_shutdown || m_queued_task_count.load() > 0; });
+            m_sleeping_thread_count.fetch_sub(1);
+            if (m_shutdown)
+                return;
+        }
+    }
+
+    std::vector<TaskQueue> m_queues;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake_condition;
+    bool m_shutdown;
+    std::atomic<int> m_queued_task_count;
+    std::atomic<int> m_sleeping_thread_count;
+};
+
+static std::unique_ptr<Scheduler> g_scheduler = nullptr;
+
+inline Scheduler& get_scheduler() {
+    // The scheduler is created on first use.
+    static std::once_flag scheduler_created;
+    std::call_once(scheduler_created, []() {
+        if (g_scheduler == nullptr)
+            g_scheduler = std::make_unique<Scheduler>(hardware_thread_count(), false);
+    });
+    return *g_scheduler;
+}
+
+int get_thread_count() {
+    return get_scheduler().get_thread_count();
+}
+
+void set_thread_count(int thread_count, bool pin_threads) {
+    if (thread_count <= 0)
+        thread_count = hardware_thread_count();
+
+    get_scheduler(); // Create the default scheduler first, so it won't replace the new one on first use.
+    g_scheduler = nullptr; // Join the old threads before creating the new ones.
+    g_scheduler = std::make_unique<Scheduler>(thread_count, pin_threads);
+}
+
+bool pin_current_thread(int hardware_thread_index) {
+    if (hardware_thread_index < 0 || hardware_thread_index >= hardware_thread_count())
+        return false;
+#if defined(_WIN32)
+    if (hardware_thread_index >= int(8 * sizeof(DWORD_PTR)))
+        return false; // Processor groups aren't supported.
+    DWORD_PTR affinity_mask = DWORD_PTR(1) << hardware_thread_index;
+    return SetThreadAffinityMask(GetCurrentThread(), affinity_mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(hardware_thread_index, &cpu_set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set) == 0;
+#else
+    return false;
+#endif
+}
+
+void schedule(Task* task) {
+    get_scheduler().push(task);
+}
+
+bool execute_pending_task() {
+    Task* task = get_scheduler().pop();
+    if (task == nullptr)
+        return false;
+    execute_task(task);
+    return true;
+}
+
+void execute_task(Task* task) {
+    task->execute();
+    TaskGroup* group = task->group;
+    delete task;
+    // The group may be destroyed as soon as it has been notified, so it must not be accessed afterwards.
+    if (group != nullptr)
+        group->task_completed();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Task group.
+// ------------------------------------------------------------------------------------------------
+
+void TaskGroup::add_continuation(Task* continuation) {
+    std::lock_guard<std::mutex> lock(m_continuation_mutex);
+    if (m_pending_task_count.load() == 0) {
+        m_pending_task_count.fetch_add(1);
+        schedule(continuation);
+    } else
+        m_continuations.push_back(continuation);
+}
+
+void TaskGroup::task_completed() {
+    // Decrement the pending task count without locking unless this could be the last task.
+    int pending_task_count = m_pending_task_count.load();
+    while (pending_task_count > 1)
+        if (m_pending_task_count.compare_exchange_weak(pending_task_count, pending_task_count - 1))
+            return;
+
+    // The count only reaches zero while the continuation mutex is held, which guarantees that
+    // continuations added concurrently are either scheduled here or by add_continuation.
+    std::lock_guard<std::mutex> lock(m_continuation_mutex);
+    pending_task_count = m_pending_task_count.load();
+    while (true) {
+        if (pending_task_count == 1 && !m_continuations.empty()) {
+            // Schedule the continuations before completing the last task, so the group never appears idle in between.
+            auto continuations = std::move(m_continuations);
+            m_continuations.clear();
+            m_pending_task_count.fetch_add(int(continuations.size()));
+            for (Task* continuation : continuations)
+                schedule(continuation);
+            m_pending_task_count.fetch_sub(1);
+            return;
+        }
+
+        if (m_pending_task_count.compare_exchange_weak(pending_task_count, pending_task_count - 1))
+            return;
+    }
+}
+
+void TaskGroup::wait() {
+    while (true) {
+        if (m_pending_task_count.load() == 0) {
+            // Synchronize with the thread completing the last task, which still holds the mutex when the count reaches zero.
+            std::lock_guard<std::mutex> lock(m_continuation_mutex);
+            if (m_pending_task_count.load() == 0)
+                return;
+        }
+
+        if (!execute_pending_task())
+            std::this_thread::yield();
+    }
+}
+
+} // NS Parallel
+} // NS Core
+} // NS Bifrost
@@ -2,37 +2,205 @@
 // ------------------------------------------------------------------------------------------------
 // Copyright (C) Bifrost. See AUTHORS.txt for authors.
 //
-// This program is open source and distributed under the New BSD License. 
+// This program is open source and distributed under the New BSD License.
 // See LICENSE.txt for more detail.
 // ------------------------------------------------------------------------------------------------
 
 #ifndef _BIFROST_CORE_PARALLEL_H_
 #define _BIFROST_CORE_PARALLEL_H_
 
-#include <functional>
-
-#include <omp.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace Bifrost {
 namespace Core {
 namespace Parallel {
 
-template <typename LocalState>
-void for_range(int begin, int end, std::function<LocalState()> local_init, 
-               std::function<void(int, LocalState&)> body, 
-               std::function<void(LocalState)> local_finally) {
-#pragma omp parallel
-    {
-        auto local_state = local_init();
+// ------------------------------------------------------------------------------------------------
+// Work-stealing task scheduler.
+// Each thread in the pool owns a task queue. Threads execute their own tasks in LIFO order
+// and steal the oldest tasks from other threads when they run out of work.
+// Threads outside the pool, e.g. the main thread, share a single queue and help execute tasks
+// while they wait for a task group to complete.
+// Future work:
+// * Lock-free Chase-Lev deques if the queue locks show up in profiles.
+// ------------------------------------------------------------------------------------------------
+
+class TaskGroup;
+
+struct Task {
+    TaskGroup* group = nullptr;
+
+    virtual ~Task() = default;
+    virtual void execute() = 0;
+};
+
+template <typename Function>
+struct FunctionTask final : public Task {
+    Function function;
+
+    FunctionTask(Function function) : function(std::move(function)) {}
+    void execute() override { function(); }
+};
+
+// The number of threads executing tasks, including the thread waiting for the tasks.
+int get_thread_count();
+
+// Sets the number of threads executing tasks. A thread count of zero uses all hardware threads.
+// If pin_threads is true, then the pool's threads are pinned to the hardware threads from one and up,
+// leaving hardware thread zero to the thread that waits for the tasks.
+// Must not be called while tasks are running.
+void set_thread_count(int thread_count, bool pin_threads = false);
+
+// Pins the calling thread to a hardware thread. Returns false if pinning is unsupported or failed.
+bool pin_current_thread(int hardware_thread_index);
+
+// Schedules the task for execution. The scheduler takes ownership of the task.
+void schedule(Task* task);
+
+// Executes a single pending task on the calling thread. Returns false if no task was pending.
+bool execute_pending_task();
+
+// ------------------------------------------------------------------------------------------------
+// A group of tasks that can be waited on.
+// Continuations are scheduled when all tasks in the group have completed and are part of the group,
+// so wait() also waits for the continuations and any tasks they add to the group.
+// ------------------------------------------------------------------------------------------------
+class TaskGroup final {
+public:
+    TaskGroup() : m_pending_task_count(0) {}
+    ~TaskGroup() { wait(); }
+
+    TaskGroup(const TaskGroup& other) = delete;
+    TaskGroup& operator=(const TaskGroup& rhs) = delete;
+
+    template <typename Function>
+    void run(Function function) {
+        Task* task = new FunctionTask<Function>(std::move(function));
+        task->group = this;
+        m_pending_task_count.fetch_add(1);
+        schedule(task);
+    }
+
+    template <typename Function>
+    void then(Function continuation) {
+        Task* task = new FunctionTask<Function>(std::move(continuation));
+        task->group = this;
+        add_continuation(task);
+    }
+
+    bool is_idle() const { return m_pending_task_count.load() == 0; }
+
+    // Waits for all tasks and continuations in the group to complete. The calling thread executes pending tasks while waiting.
+    void wait();
+
+private:
+    friend void execute_task(Task* task);
 
-        int thread_id = omp_get_thread_num();
-        int thread_count = omp_get_num_threads();
-        for (int i = begin + thread_id; i < end; i += thread_count)
+    void add_continuation(Task* continuation);
+    void task_completed();
+
+    std::atomic<int> m_pending_task_count;
+    std::mutex m_continuation_mutex;
+    std::vector<Task*> m_continuations;
+};
+
+// Executes the task, deletes it and notifies its group.
+void execute_task(Task* task);
+
+// ------------------------------------------------------------------------------------------------
+// Parallel loops.
+// A grain size of zero selects a grain size that gives each thread several ranges to balance the load.
+// ------------------------------------------------------------------------------------------------
+
+inline int compute_grain_size(int element_count) {
+    int grain_size = element_count / (8 * get_thread_count());
+    return grain_size < 1 ? 1 : grain_size;
+}
+
+template <typename RangeBody>
+void split_range(int begin, int end, int grain_size, const RangeBody& body, TaskGroup& group) {
+    // Hand off the upper half of the range until the range is small enough to process.
+    // Idle threads steal the oldest tasks, i.e. the largest ranges, which keeps the number of steals low.
+    while (end - begin > grain_size) {
+        int middle = begin + (end - begin) / 2;
+        group.run([=, &body, &group]() { split_range(middle, end, grain_size, body, group); });
+        end = middle;
+    }
+    body(begin, end);
+}
+
+// Calls body(range_begin, range_end) for disjoint contiguous subranges covering [begin, end).
+template <typename RangeBody>
+void parallel_for_range(int begin, int end, RangeBody body, int grain_size = 0) {
+    if (end <= begin)
+        return;
+    if (grain_size <= 0)
+        grain_size = compute_grain_size(end - begin);
+
+    if (end - begin <= grain_size || get_thread_count() == 1) {
+        body(begin, end);
+        return;
+    }
+
+    TaskGroup group;
+    split_range(begin, end, grain_size, body, group);
+    group.wait();
+}
+
+// Calls body(i) for all i in [begin, end).
+template <typename Body>
+void parallel_for(int begin, int end, Body body, int grain_size = 0) {
+    parallel_for_range(begin, end, [&](int range_begin, int range_end) {
+        for (int i = range_begin; i < range_end; ++i)
+            body(i);
+    }, grain_size);
+}
+
+// Reduces [begin, end) by reducing ranges of grain_size elements with range_reduce(range_begin, range_end, identity)
+// and combining the range results in order with combine(lhs, rhs).
+// The result only depends on the grain size, so pass an explicit grain size to get results
+// that are independent of the number of threads, fx for floating point sums.
+template <typename T, typename RangeReduce, typename Combine>
+T parallel_reduce(int begin, int end, T identity, RangeReduce range_reduce, Combine combine, int grain_size = 0) {
+    if (end <= begin)
+        return identity;
+    if (grain_size <= 0)
+        grain_size = compute_grain_size(end - begin);
+
+    // The range results are stored in an array instead of a vector, as std::vector<bool> packs its elements
+    // into shared words, which would make concurrent writes to neighbouring results race.
+    int range_count = (end - begin + grain_size - 1) / grain_size;
+    auto range_results = std::unique_ptr<T[]>(new T[range_count]);
+    parallel_for(0, range_count, [&](int r) {
+        int range_begin = begin + r * grain_size;
+        int range_end = end - range_begin < grain_size ? end : range_begin + grain_size;
+        range_results[r] = range_reduce(range_begin, range_end, identity);
+    }, 1);
+
+    T result = range_results[0];
+    for (int r = 1; r < range_count; ++r)
+        result = combine(result, range_results[r]);
+    return result;
+}
+
+// Calls body(i, local_state) for all i in [begin, end). A local state is created by local_init() pr range
+// and is passed to local_finally(local_state) after the range has been processed.
+// The calls to local_finally are serialized.
+template <typename LocalInit, typename Body, typename LocalFinally>
+void for_range(int begin, int end, LocalInit local_init, Body body, LocalFinally local_finally) {
+    std::mutex finally_mutex;
+    parallel_for_range(begin, end, [&](int range_begin, int range_end) {
+        auto local_state = local_init();
+        for (int i = range_begin; i < range_end; ++i)
             body(i, local_state);
 
-#pragma omp critical
+        std::lock_guard<std::mutex> lock(finally_mutex);
         local_finally(local_state);
-    }
+    });
 }
 
 } // NS Parallel
@@ -0,0 +1,238 @@
+// Bifrost hierarchical profiler.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#include <Bifrost/Core/Profiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace Bifrost {
+namespace Core {
+namespace Profiler {
+
+// Ring buffer of the scopes recorded by a single thread.
+// Only the owning thread writes events. The event count is published after the event has been written,
+// so readers can read all events below the count as long as the buffer doesn't wrap around meanwhile.
+struct EventBuffer {
+    std::unique_ptr<Event[]> events;
+    std::atomic<unsigned long long> event_count;
+    unsigned int thread_index;
+    unsigned int depth; // Only accessed by the owning thread.
+
+    EventBuffer(unsigned int thread_index)
+        : events(new Event[ring_buffer_capacity]), event_count(0), thread_index(thread_index), depth(0) {}
+};
+
+static std::mutex g_buffers_mutex;
+static std::vector<std::shared_ptr<EventBuffer>> g_buffers;
+
+static std::atomic<unsigned long long> g_tick_begin(0);
+static std::atomic<unsigned long long> g_completed_tick_begin(0);
+static std::atomic<unsigned long long> g_completed_tick_end(0);
+
+static const std::chrono::steady_clock::time_point g_start_time = std::chrono::steady_clock::now();
+
+// The buffers are shared with the registry, so the scopes of a thread outlive the thread.
+static EventBuffer& get_thread_buffer() {
+    thread_local std::shared_ptr<EventBuffer> buffer = nullptr;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(g_buffers_mutex);
+        buffer = std::make_shared<EventBuffer>(unsigned(g_buffers.size()));
+        g_buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+unsigned long long get_timestamp() {
+    auto duration = std::chrono::steady_clock::now() - g_start_time;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Scoped timer.
+// ------------------------------------------------------------------------------------------------
+
+ScopedTimer::ScopedTimer(const char* name) : m_name(name) {
+    ++get_thread_buffer().depth;
+    m_begin = get_timestamp();
+}
+
+ScopedTimer::~ScopedTimer() {
+    unsigned long long end = get_timestamp();
+    EventBuffer& buffer = get_thread_buffer();
+    unsigned int depth = --buffer.depth;
+    unsigned long long event_count = buffer.event_count.load(std::memory_order_relaxed);
+    buffer.events[event_count % ring_buffer_capacity] = { m_name, m_begin, end, depth };
+    buffer.event_count.store(event_count + 1, std::memory_order_release);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Ticks.
+// ------------------------------------------------------------------------------------------------
+
+void begin_tick() {
+    g_tick_begin = get_timestamp();
+}
+
+void end_tick() {
+    // Publish the tick's end before its begin, so readers that see the new begin also see the new end.
+    g_completed_tick_end = get_timestamp();
+    g_completed_tick_begin = g_tick_begin.load();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Event queries.
+// ------------------------------------------------------------------------------------------------
+
+inline std::vector<std::shared_ptr<EventBuffer>> get_buffers() {
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    return g_buffers;
+}
+
+template <typename Callback>
+void for_each_event(const EventBuffer& buffer, Callback callback) {
+    unsigned long long event_count = buffer.event_count.load(std::memory_order_acquire);
+    unsigned long long first_event = event_count > ring_buffer_capacity ? event_count - ring_buffer_capacity : 0;
+    for (unsigned long long e = first_event; e < event_count; ++e)
+        callback(buffer.events[e % ring_buffer_capacity]);
+}
+
+std::vector<Event> get_events(std::vector<unsigned int>* thread_indices) {
+    std::vector<Event> events;
+    if (thread_indices != nullptr)
+        thread_indices->clear();
+
+    for (const auto& buffer : get_buffers())
+        for_each_event(*buffer, [&](const Event& event) {
+            events.push_back(event);
+            if (thread_indices != nullptr)
+                thread_indices->push_back(buffer->thread_index);
+        });
+
+    return events;
+}
+
+std::vector<ScopeSummary> get_tick_summary() {
+    unsigned long long tick_begin = g_completed_tick_begin.load();
+    unsigned long long tick_end = g_completed_tick_end.load();
+
+    std::unordered_map<std::string_view, ScopeSummary> summaries;
+    for (const auto& buffer : get_buffers()) {
+        std::vector<Event> events;
+        for_each_event(*buffer, [&](const Event& event) {
+            if (tick_begin <= event.begin && event.end <= tick_end)
+                events.push_back(event);
+        });
+
+        // Sort the events so parents precede their children and compute the time spent in the children
+        // by keeping a stack of the scopes enclosing the current event.
+        std::sort(events.begin(), events.end(), [](const Event& lhs, const Event& rhs) {
+            return lhs.begin != rhs.begin ? lhs.begin < rhs.begin : lhs.depth < rhs.depth;
+        });
+
+        std::vector<unsigned long long> child_durations(events.size(), 0);
+        std::vector<int> enclosing_events;
+        for (int e = 0; e < int(events.size()); ++e) {
+            const Event& event = events[e];
+            while (!enclosing_events.empty() && events[enclosing_events.back()].depth >= event.depth)
+                enclosing_events.pop_back();
+            if (!enclosing_events.empty())
+                child_durations[enclosing_events.back()] += event.end - event.begin;
+            enclosing_events.push_back(e);
+        }
+
+        for (int e = 0; e < int(events.size()); ++e) {
+            const Event& event = events[e];
+            double duration = (event.end - event.begin) * 1e-9;
+            double self_duration = (event.end - event.begin - child_durations[e]) * 1e-9;
+
+            auto summary_itr = summaries.find(event.name);
+            if (summary_itr == summaries.end())
+                summaries.emplace(event.name, ScopeSummary{ event.name, 1u, duration, self_duration, duration });
+            else {
+                ScopeSummary& summary = summary_itr->second;
+                ++summary.call_count;
+                summary.total_duration += duration;
+                summary.self_duration += self_duration;
+                summary.max_duration = std::max(summary.max_duration, duration);
+            }
+        }
+    }
+
+    std::vector<ScopeSummary> sorted_summaries;
+    sorted_summaries.reserve(summaries.size());
+    for (const auto& summary : summaries)
+        sorted_summaries.push_back(summary.second);
+    std::sort(sorted_summaries.begin(), sorted_summaries.end(), [](const ScopeSummary& lhs, const ScopeSummary& rhs) {
+        return lhs.total_duration > rhs.total_duration;
+    });
+    return sorted_summaries;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Chrome trace export.
+// See https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+// ------------------------------------------------------------------------------------------------
+
+static void write_json_string(std::ostream& output, const char* str) {
+    output << '"';
+    for (; *str != '\0'; ++str) {
+        char c = *str;
+        if (c == '"' || c == '\\')
+            output << '\\' << c;
+        else if ((unsigned char)c < 0x20)
+            output << ' ';
+        else
+            output << c;
+    }
+    output << '"';
+}
+
+void write_chrome_trace(std::ostream& output) {
+    std::vector<unsigned int> thread_indices;
+    std::vector<Event> events = get_events(&thread_indices);
+
+    // Timestamps and durations are in microseconds.
+    output << "{\"traceEvents\":[";
+    for (int e = 0; e < int(events.size()); ++e) {
+        const Event& event = events[e];
+        if (e > 0)
+            output << ",";
+        output << "\n{\"name\":";
+        write_json_string(output, event.name);
+        output << ",\"cat\":\"Bifrost\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread_indices[e]
+               << ",\"ts\":" << event.begin / 1000 << "." << event.begin % 1000 / 100
+               << ",\"dur\":" << (event.end - event.begin) / 1000 << "." << (event.end - event.begin) % 1000 / 100 << "}";
+    }
+    output << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool write_chrome_trace(const std::filesystem::path& path) {
+    std::ofstream output(path);
+    if (!output)
+        return false;
+    write_chrome_trace(output);
+    return output.good();
+}
+
+void clear() {
+    for (const auto& buffer : get_buffers())
+        buffer->event_count.store(0, std::memory_order_release);
+    g_completed_tick_begin = 0;
+    g_completed_tick_end = 0;
+}
+
+} // NS Profiler
+} // NS Core
+} // NS Bifrost
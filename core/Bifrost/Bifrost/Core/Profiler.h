@@ -0,0 +1,103 @@
+// Bifrost hierarchical profiler.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _BIFROST_CORE_PROFILER_H_
+#define _BIFROST_CORE_PROFILER_H_
+
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+// Profiling macros. Scopes are only recorded when BIFROST_PROFILING is defined,
+// otherwise the macros expand to nothing.
+// Scope names must outlive the profiler, i.e. be string literals.
+// ------------------------------------------------------------------------------------------------
+#ifdef BIFROST_PROFILING
+#define BIFROST_PROFILE_CONCAT_IMPL(a, b) a##b
+#define BIFROST_PROFILE_CONCAT(a, b) BIFROST_PROFILE_CONCAT_IMPL(a, b)
+#define BIFROST_PROFILE_SCOPE(name) Bifrost::Core::Profiler::ScopedTimer BIFROST_PROFILE_CONCAT(_profile_scope_, __LINE__)(name)
+#define BIFROST_PROFILE_FUNCTION() BIFROST_PROFILE_SCOPE(__FUNCTION__)
+#else
+#define BIFROST_PROFILE_SCOPE(name)
+#define BIFROST_PROFILE_FUNCTION()
+#endif
+
+namespace Bifrost {
+namespace Core {
+
+// ------------------------------------------------------------------------------------------------
+// Hierarchical scope profiler.
+// Each thread records its scopes into its own ring buffer, so recording never takes a lock.
+// When a ring buffer is full the oldest scopes are overwritten.
+// The recorded scopes can be summarized pr tick or exported as a Chrome trace, which can be
+// inspected in chrome://tracing or Perfetto.
+// Summaries and exports read the ring buffers of all threads and must not run concurrently
+// with threads that record enough scopes to wrap around their buffer.
+// ------------------------------------------------------------------------------------------------
+namespace Profiler {
+
+struct Event {
+    const char* name;
+    unsigned long long begin; // Nanoseconds since the profiler was started.
+    unsigned long long end;
+    unsigned int depth; // Number of enclosing scopes on the recording thread.
+};
+
+// Records the lifetime of the timer as a scope.
+class ScopedTimer final {
+public:
+    ScopedTimer(const char* name);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer& other) = delete;
+    ScopedTimer& operator=(const ScopedTimer& rhs) = delete;
+
+private:
+    const char* m_name;
+    unsigned long long m_begin;
+};
+
+// Nanoseconds since the profiler was started.
+unsigned long long get_timestamp();
+
+// The number of scopes that can be recorded by a thread before the oldest scopes are overwritten.
+const unsigned int ring_buffer_capacity = 1u << 16u;
+
+// Marks the beginning and end of an engine tick. Called by Engine::do_tick.
+void begin_tick();
+void end_tick();
+
+struct ScopeSummary {
+    const char* name;
+    unsigned int call_count;
+    double total_duration; // Seconds.
+    double self_duration; // Seconds spent in the scope, but not in its child scopes.
+    double max_duration; // Seconds.
+};
+
+// Summarizes the scopes recorded during the latest completed tick, sorted by decreasing total duration.
+// Scopes with the same name are combined across threads.
+std::vector<ScopeSummary> get_tick_summary();
+
+// Returns the recorded scopes of all threads. The events of each thread are ordered by their end time.
+// The thread index of each event is written to thread_indices if it is not null.
+std::vector<Event> get_events(std::vector<unsigned int>* thread_indices = nullptr);
+
+// Writes all recorded scopes in Chrome's trace event format.
+void write_chrome_trace(std::ostream& output);
+bool write_chrome_trace(const std::filesystem::path& path);
+
+// Discards all recorded scopes.
+void clear();
+
+} // NS Profiler
+} // NS Core
+} // NS Bifrost
+
+#endif // _BIFROST_CORE_PROFILER_H_
@@ -0,0 +1,62 @@
+// Bifrost half precision floating point conversions.
+// ----------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ----------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_HALF_FLOAT_H_
+#define _BIFROST_MATH_HALF_FLOAT_H_
+
+#include <Bifrost/Core/Defines.h>
+#include <Bifrost/Math/half.h>
+
+// F16C is implied by AVX2 and enabled explicitly by fx -mf16c.
+#if defined(__F16C__) || defined(__AVX2__)
+#define BIFROST_F16C
+#include <immintrin.h>
+#endif
+
+namespace Bifrost {
+namespace Math {
+
+using half = half_float::half;
+
+// ------------------------------------------------------------------------------------------------
+// Conversion of single values. Floats are rounded to the nearest half.
+// ------------------------------------------------------------------------------------------------
+__always_inline__ half to_half(float value) { return half_float::half_cast<half, std::round_to_nearest>(value); }
+__always_inline__ float to_float(half value) { return float(value); }
+
+// ------------------------------------------------------------------------------------------------
+// Bulk conversion of count values. Uses the F16C instructions when they are available.
+// ------------------------------------------------------------------------------------------------
+inline void to_half(const float* values, half* halfs, int count) {
+    int i = 0;
+#ifdef BIFROST_F16C
+    for (; i + 8 <= count; i += 8) {
+        __m128i half8 = _mm256_cvtps_ph(_mm256_loadu_ps(values + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(halfs + i), half8);
+    }
+#endif
+    for (; i < count; ++i)
+        halfs[i] = to_half(values[i]);
+}
+
+inline void to_float(const half* halfs, float* values, int count) {
+    int i = 0;
+#ifdef BIFROST_F16C
+    for (; i + 8 <= count; i += 8) {
+        __m128i half8 = _mm_loadu_si128((const __m128i*)(halfs + i));
+        _mm256_storeu_ps(values + i, _mm256_cvtph_ps(half8));
+    }
+#endif
+    for (; i < count; ++i)
+        values[i] = to_float(halfs[i]);
+}
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_HALF_FLOAT_H_
@@ -7,13 +7,23 @@
 namespace Bifrost {
 namespace Math {
 
+// ------------------------------------------------------------------------------------------------
+// Statistics of a nelder_mead run.
+// ------------------------------------------------------------------------------------------------
+struct NelderMeadStatistics {
+    int iteration_count;
+    int evaluation_count;
+    bool converged; // True if the tolerance was reached before max_iterations.
+};
+
 // ------------------------------------------------------------------------------------------------
 // Downhill simplex solver:
 // http://en.wikipedia.org/wiki/Nelder%E2%80%93Mead_method#One_possible_variation_of_the_NM_algorithm
 // using the termination criterion from Numerical Recipes in C++ (3rd Ed.)
 // ------------------------------------------------------------------------------------------------
 template<int DIM, typename Function>
-float nelder_mead(float* pmin, const float* start, float delta, float tolerance, int max_iterations, Function objective_function) {
+float nelder_mead(float* pmin, const float* start, float delta, float tolerance, int max_iterations, Function objective_function,
+                  NelderMeadStatistics* statistics = nullptr) {
 
     // Standard coefficients from wiki page.
     const float reflect = 1.0f;
@@ -50,11 +60,18 @@ float nelder_mead(float* pmin, const float* start, float delta, float tolerance,
     }
 
     // Evaluate function at each point on simplex.
+    int evaluation_count = 0;
+    auto evaluate = [&](Point p) -> float {
+        ++evaluation_count;
+        return objective_function(p);
+    };
     for (int i = 0; i < NB_POINTS; i++)
-        f[i] = objective_function(s[i]);
+        f[i] = evaluate(s[i]);
 
     int lo = 0, hi, nh;
-    for (int j = 0; j < max_iterations; j++) {
+    int j = 0;
+    bool converged = false;
+    for (; j < max_iterations; j++) {
         // Find lowest, highest and next highest.
         lo = hi = nh = 0;
         for (int i = 1; i < NB_POINTS; i++) {
@@ -71,8 +88,10 @@ float nelder_mead(float* pmin, const float* start, float delta, float tolerance,
         // Stop if we've reached the required tolerance level.
         float a = fabsf(f[lo]);
         float b = fabsf(f[hi]);
-        if (2.0f * fabsf(a - b) < (a + b) * tolerance)
+        if (2.0f * fabsf(a - b) < (a + b) * tolerance) {
+            converged = true;
             break;
+        }
 
         // Compute centroid excluding the worst point.
         Point o;
@@ -90,7 +109,7 @@ float nelder_mead(float* pmin, const float* start, float delta, float tolerance,
         for (int i = 0; i < DIM; i++)
             r[i] = o[i] + reflect * (o[i] - s[hi][i]);
 
-        float fr = objective_function(r);
+        float fr = evaluate(r);
         if (fr < f[nh]) {
             if (fr < f[lo]) {
                 // Expansion.
@@ -98,7 +117,7 @@ float nelder_mead(float* pmin, const float* start, float delta, float tolerance,
                 for (int i = 0; i < DIM; i++)
                     e[i] = o[i] + expand*(o[i] - s[hi][i]);
 
-                float fe = objective_function(e);
+                float fe = evaluate(e);
                 if (fe < fr) {
                     copy(s[hi], e);
                     f[hi] = fe;
@@ -116,7 +135,7 @@ float nelder_mead(float* pmin, const float* start, float delta, float tolerance,
         for (int i = 0; i < DIM; i++)
             c[i] = o[i] - contract*(o[i] - s[hi][i]);
 
-        float fc = objective_function(c);
+        float fc = evaluate(c);
         if (fc < f[hi]) {
             copy(s[hi], c);
             f[hi] = fc;
@@ -128,10 +147,18 @@ float nelder_mead(float* pmin, const float* start, float delta, float tolerance,
             if (k == lo) continue;
             for (int i = 0; i < DIM; i++)
                 s[k][i] = s[lo][i] + shrink*(s[k][i] - s[lo][i]);
-            f[k] = objective_function(s[k]);
+            f[k] = evaluate(s[k]);
         }
     }
 
+    // The simplex may have changed since lo was found if the last iteration did not converge.
+    for (int i = 0; i < NB_POINTS; i++)
+        if (f[i] < f[lo])
+            lo = i;
+
+    if (statistics != nullptr)
+        *statistics = { j, evaluation_count, converged };
+
     // Return best point and its value.
     copy(pmin, s[lo]);
     return f[lo];
@@ -0,0 +1,498 @@
+// Bifrost SIMD packets for batched vector math.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_PACKET_H_
+#define _BIFROST_MATH_PACKET_H_
+
+#include <Bifrost/Core/Defines.h>
+#include <Bifrost/Math/AABB.h>
+#include <Bifrost/Math/Matrix.h>
+#include <Bifrost/Math/Ray.h>
+#include <Bifrost/Math/Transform.h>
+
+#include <cmath>
+#include <cstring>
+
+// Packets are eight wide with AVX and four wide with SSE2 or without SIMD support.
+#if defined(__AVX__)
+#define BIFROST_PACKET_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BIFROST_PACKET_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Bifrost {
+namespace Math {
+
+// ------------------------------------------------------------------------------------------------
+// A packet of floats.
+// Comparisons return masks, where the lanes that compare true have all bits set.
+// ------------------------------------------------------------------------------------------------
+struct FloatPacket final {
+#if defined(BIFROST_PACKET_AVX)
+    static const int width = 8;
+    __m256 v;
+#elif defined(BIFROST_PACKET_SSE2)
+    static const int width = 4;
+    __m128 v;
+#else
+    static const int width = 4;
+    float v[4];
+#endif
+
+    static __always_inline__ FloatPacket broadcast(float value) {
+        FloatPacket res;
+#if defined(BIFROST_PACKET_AVX)
+        res.v = _mm256_set1_ps(value);
+#elif defined(BIFROST_PACKET_SSE2)
+        res.v = _mm_set1_ps(value);
+#else
+        for (int i = 0; i < width; ++i)
+            res.v[i] = value;
+#endif
+        return res;
+    }
+
+    static __always_inline__ FloatPacket zero() { return broadcast(0.0f); }
+
+    static __always_inline__ FloatPacket load(const float* values) {
+        FloatPacket res;
+#if defined(BIFROST_PACKET_AVX)
+        res.v = _mm256_loadu_ps(values);
+#elif defined(BIFROST_PACKET_SSE2)
+        res.v = _mm_loadu_ps(values);
+#else
+        for (int i = 0; i < width; ++i)
+            res.v[i] = values[i];
+#endif
+        return res;
+    }
+
+    __always_inline__ void store(float* values) const {
+#if defined(BIFROST_PACKET_AVX)
+        _mm256_storeu_ps(values, v);
+#elif defined(BIFROST_PACKET_SSE2)
+        _mm_storeu_ps(values, v);
+#else
+        for (int i = 0; i < width; ++i)
+            values[i] = v[i];
+#endif
+    }
+
+    __always_inline__ float operator[](int lane) const {
+        float values[width];
+        store(values);
+        return values[lane];
+    }
+};
+
+#if defined(BIFROST_PACKET_AVX)
+#define BIFROST_PACKET_BINARY_OPERATION(name, avx_op, sse_op, scalar_expression) \
+    __always_inline__ FloatPacket name(FloatPacket lhs, FloatPacket rhs) { FloatPacket res; res.v = avx_op(lhs.v, rhs.v); return res; }
+#elif defined(BIFROST_PACKET_SSE2)
+#define BIFROST_PACKET_BINARY_OPERATION(name, avx_op, sse_op, scalar_expression) \
+    __always_inline__ FloatPacket name(FloatPacket lhs, FloatPacket rhs) { FloatPacket res; res.v = sse_op(lhs.v, rhs.v); return res; }
+#else
+#define BIFROST_PACKET_BINARY_OPERATION(name, avx_op, sse_op, scalar_expression)         \
+    __always_inline__ FloatPacket name(FloatPacket lhs, FloatPacket rhs) {               \
+        FloatPacket res;                                                                 \
+        for (int i = 0; i < FloatPacket::width; ++i) {                                   \
+            float a = lhs.v[i], b = rhs.v[i];                                            \
+            res.v[i] = scalar_expression;                                                \
+        }                                                                                \
+        return res;                                                                      \
+    }
+#endif
+
+// Bitwise operations on the scalar representation of masks.
+inline float bitwise_operation(float lhs, float rhs, bool is_and) {
+    unsigned int lhs_bits, rhs_bits;
+    memcpy(&lhs_bits, &lhs, sizeof(float));
+    memcpy(&rhs_bits, &rhs, sizeof(float));
+    unsigned int res_bits = is_and ? (lhs_bits & rhs_bits) : (lhs_bits | rhs_bits);
+    float res;
+    memcpy(&res, &res_bits, sizeof(float));
+    return res;
+}
+inline float bitwise_and(float lhs, float rhs) { return bitwise_operation(lhs, rhs, true); }
+inline float bitwise_or(float lhs, float rhs) { return bitwise_operation(lhs, rhs, false); }
+inline float all_bits_set() {
+    unsigned int bits = 0xFFFFFFFFu;
+    float res;
+    memcpy(&res, &bits, sizeof(float));
+    return res;
+}
+
+BIFROST_PACKET_BINARY_OPERATION(operator+, _mm256_add_ps, _mm_add_ps, a + b)
+BIFROST_PACKET_BINARY_OPERATION(operator-, _mm256_sub_ps, _mm_sub_ps, a - b)
+BIFROST_PACKET_BINARY_OPERATION(operator*, _mm256_mul_ps, _mm_mul_ps, a * b)
+BIFROST_PACKET_BINARY_OPERATION(operator/, _mm256_div_ps, _mm_div_ps, a / b)
+BIFROST_PACKET_BINARY_OPERATION(min, _mm256_min_ps, _mm_min_ps, a < b ? a : b)
+BIFROST_PACKET_BINARY_OPERATION(max, _mm256_max_ps, _mm_max_ps, a > b ? a : b)
+BIFROST_PACKET_BINARY_OPERATION(operator&, _mm256_and_ps, _mm_and_ps, bitwise_and(a, b))
+BIFROST_PACKET_BINARY_OPERATION(operator|, _mm256_or_ps, _mm_or_ps, bitwise_or(a, b))
+
+#undef BIFROST_PACKET_BINARY_OPERATION
+
+#if defined(BIFROST_PACKET_AVX)
+__always_inline__ FloatPacket operator<(FloatPacket lhs, FloatPacket rhs) { FloatPacket res; res.v = _mm256_cmp_ps(lhs.v, rhs.v, _CMP_LT_OQ); return res; }
+__always_inline__ FloatPacket operator<=(FloatPacket lhs, FloatPacket rhs) { FloatPacket res; res.v = _mm256_cmp_ps(lhs.v, rhs.v, _CMP_LE_OQ); return res; }
+__always_inline__ FloatPacket select(FloatPacket mask, FloatPacket if_true, FloatPacket if_false) { FloatPacket res; res.v = _mm256_blendv_ps(if_false.v, if_true.v, mask.v); return res; }
+__always_inline__ FloatPacket sqrt(FloatPacket value) { FloatPacket res; res.v = _mm256_sqrt_ps(value.v); return res; }
+// Returns a bitmask with bit i set if lane i of the mask is set.
+__always_inline__ int to_bitmask(FloatPacket mask) { return _mm256_movemask_ps(mask.v); }
+#elif defined(BIFROST_PACKET_SSE2)
+__always_inline__ FloatPacket operator<(FloatPacket lhs, FloatPacket rhs) { FloatPacket res; res.v = _mm_cmplt_ps(lhs.v, rhs.v); return res; }
+__always_inline__ FloatPacket operator<=(FloatPacket lhs, FloatPacket rhs) { FloatPacket res; res.v = _mm_cmple_ps(lhs.v, rhs.v); return res; }
+__always_inline__ FloatPacket select(FloatPacket mask, FloatPacket if_true, FloatPacket if_false) { FloatPacket res; res.v = _mm_or_ps(_mm_and_ps(mask.v, if_true.v), _mm_andnot_ps(mask.v, if_false.v)); return res; }
+__always_inline__ FloatPacket sqrt(FloatPacket value) { FloatPacket res; res.v = _mm_sqrt_ps(value.v); return res; }
+// Returns a bitmask with bit i set if lane i of the mask is set.
+__always_inline__ int to_bitmask(FloatPacket mask) { return _mm_movemask_ps(mask.v); }
+#else
+__always_inline__ FloatPacket operator<(FloatPacket lhs, FloatPacket rhs) {
+    FloatPacket res;
+    for (int i = 0; i < FloatPacket::width; ++i)
+        res.v[i] = lhs.v[i] < rhs.v[i] ? all_bits_set() : 0.0f;
+    return res;
+}
+__always_inline__ FloatPacket operator<=(FloatPacket lhs, FloatPacket rhs) {
+    FloatPacket res;
+    for (int i = 0; i < FloatPacket::width; ++i)
+        res.v[i] = lhs.v[i] <= rhs.v[i] ? all_bits_set() : 0.0f;
+    return res;
+}
+__always_inline__ FloatPacket select(FloatPacket mask, FloatPacket if_true, FloatPacket if_false) {
+    FloatPacket res;
+    for (int i = 0; i < FloatPacket::width; ++i)
+        res.v[i] = std::isnan(mask.v[i]) ? if_true.v[i] : if_false.v[i];
+    return res;
+}
+__always_inline__ FloatPacket sqrt(FloatPacket value) {
+    FloatPacket res;
+    for (int i = 0; i < FloatPacket::width; ++i)
+        res.v[i] = std::sqrt(value.v[i]);
+    return res;
+}
+// Returns a bitmask with bit i set if lane i of the mask is set.
+__always_inline__ int to_bitmask(FloatPacket mask) {
+    int res = 0;
+    for (int i = 0; i < FloatPacket::width; ++i)
+        res |= std::isnan(mask.v[i]) ? 1 << i : 0;
+    return res;
+}
+#endif
+
+__always_inline__ FloatPacket operator>(FloatPacket lhs, FloatPacket rhs) { return rhs < lhs; }
+__always_inline__ FloatPacket operator>=(FloatPacket lhs, FloatPacket rhs) { return rhs <= lhs; }
+__always_inline__ FloatPacket operator*(FloatPacket lhs, float rhs) { return lhs * FloatPacket::broadcast(rhs); }
+__always_inline__ FloatPacket operator+(FloatPacket lhs, float rhs) { return lhs + FloatPacket::broadcast(rhs); }
+__always_inline__ FloatPacket operator-(FloatPacket lhs, float rhs) { return lhs - FloatPacket::broadcast(rhs); }
+__always_inline__ FloatPacket& operator+=(FloatPacket& lhs, FloatPacket rhs) { return lhs = lhs + rhs; }
+__always_inline__ FloatPacket& operator*=(FloatPacket& lhs, FloatPacket rhs) { return lhs = lhs * rhs; }
+
+__always_inline__ bool any(FloatPacket mask) { return to_bitmask(mask) != 0; }
+__always_inline__ bool all(FloatPacket mask) { return to_bitmask(mask) == (1 << FloatPacket::width) - 1; }
+
+__always_inline__ float horizontal_min(FloatPacket packet) {
+    float values[FloatPacket::width];
+    packet.store(values);
+    float res = values[0];
+    for (int i = 1; i < FloatPacket::width; ++i)
+        res = values[i] < res ? values[i] : res;
+    return res;
+}
+
+__always_inline__ float horizontal_max(FloatPacket packet) {
+    float values[FloatPacket::width];
+    packet.store(values);
+    float res = values[0];
+    for (int i = 1; i < FloatPacket::width; ++i)
+        res = values[i] > res ? values[i] : res;
+    return res;
+}
+
+// ------------------------------------------------------------------------------------------------
+// A packet of 3D vectors in structure of arrays layout.
+// ------------------------------------------------------------------------------------------------
+struct Vector3fPacket final {
+    static const int width = FloatPacket::width;
+
+    FloatPacket x;
+    FloatPacket y;
+    FloatPacket z;
+
+    Vector3fPacket() = default;
+    Vector3fPacket(FloatPacket x, FloatPacket y, FloatPacket z) : x(x), y(y), z(z) { }
+
+    static __always_inline__ Vector3fPacket broadcast(Vector3f v) {
+        return Vector3fPacket(FloatPacket::broadcast(v.x), FloatPacket::broadcast(v.y), FloatPacket::broadcast(v.z));
+    }
+
+    // Loads width consecutive vectors.
+    static __always_inline__ Vector3fPacket load(const Vector3f* vectors) {
+#if defined(BIFROST_PACKET_SSE2) || defined(BIFROST_PACKET_AVX)
+        // Transposes four vectors, (x0 y0 z0 x1), (y1 z1 x2 y2), (z2 x3 y3 z3), into (x0 x1 x2 x3), (y0 ...) and (z0 ...).
+        auto transpose4 = [](const float* values, __m128& x, __m128& y, __m128& z) {
+            __m128 a = _mm_loadu_ps(values), b = _mm_loadu_ps(values + 4), c = _mm_loadu_ps(values + 8);
+            x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+            y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+            z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        };
+#endif
+
+        Vector3fPacket res;
+#if defined(BIFROST_PACKET_AVX)
+        __m128 x0, y0, z0, x1, y1, z1;
+        transpose4(&vectors[0].x, x0, y0, z0);
+        transpose4(&vectors[4].x, x1, y1, z1);
+        res.x.v = _mm256_insertf128_ps(_mm256_castps128_ps256(x0), x1, 1);
+        res.y.v = _mm256_insertf128_ps(_mm256_castps128_ps256(y0), y1, 1);
+        res.z.v = _mm256_insertf128_ps(_mm256_castps128_ps256(z0), z1, 1);
+#elif defined(BIFROST_PACKET_SSE2)
+        transpose4(&vectors[0].x, res.x.v, res.y.v, res.z.v);
+#else
+        for (int i = 0; i < width; ++i) {
+            res.x.v[i] = vectors[i].x;
+            res.y.v[i] = vectors[i].y;
+            res.z.v[i] = vectors[i].z;
+        }
+#endif
+        return res;
+    }
+
+    // Loads count vectors, where count is less than or equal to width. The remaining lanes replicate the last vector.
+    static __always_inline__ Vector3fPacket load(const Vector3f* vectors, int count) {
+        if (count == width)
+            return load(vectors);
+        Vector3f padded_vectors[width];
+        for (int i = 0; i < width; ++i)
+            padded_vectors[i] = vectors[i < count ? i : count - 1];
+        return load(padded_vectors);
+    }
+
+    // Stores the packet as width consecutive vectors.
+    __always_inline__ void store(Vector3f* vectors) const {
+#if defined(BIFROST_PACKET_SSE2) || defined(BIFROST_PACKET_AVX)
+        // Inverse of the transpose in load.
+        auto transpose4 = [](__m128 x, __m128 y, __m128 z, float* values) {
+            __m128 a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+            _mm_storeu_ps(values, a);
+            _mm_storeu_ps(values + 4, b);
+            _mm_storeu_ps(values + 8, c);
+        };
+#endif
+
+#if defined(BIFROST_PACKET_AVX)
+        transpose4(_mm256_castps256_ps128(x.v), _mm256_castps256_ps128(y.v), _mm256_castps256_ps128(z.v), &vectors[0].x);
+        transpose4(_mm256_extractf128_ps(x.v, 1), _mm256_extractf128_ps(y.v, 1), _mm256_extractf128_ps(z.v, 1), &vectors[4].x);
+#elif defined(BIFROST_PACKET_SSE2)
+        transpose4(x.v, y.v, z.v, &vectors[0].x);
+#else
+        for (int i = 0; i < width; ++i)
+            vectors[i] = Vector3f(x.v[i], y.v[i], z.v[i]);
+#endif
+    }
+
+    // Stores the first count vectors of the packet.
+    __always_inline__ void store(Vector3f* vectors, int count) const {
+        if (count == width)
+            return store(vectors);
+        Vector3f packet_vectors[width];
+        store(packet_vectors);
+        for (int i = 0; i < count; ++i)
+            vectors[i] = packet_vectors[i];
+    }
+
+    __always_inline__ Vector3f operator[](int lane) const { return Vector3f(x[lane], y[lane], z[lane]); }
+};
+
+__always_inline__ Vector3fPacket operator+(Vector3fPacket lhs, Vector3fPacket rhs) { return Vector3fPacket(lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z); }
+__always_inline__ Vector3fPacket operator-(Vector3fPacket lhs, Vector3fPacket rhs) { return Vector3fPacket(lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z); }
+__always_inline__ Vector3fPacket operator*(Vector3fPacket lhs, Vector3fPacket rhs) { return Vector3fPacket(lhs.x * rhs.x, lhs.y * rhs.y, lhs.z * rhs.z); }
+__always_inline__ Vector3fPacket operator*(Vector3fPacket lhs, FloatPacket rhs) { return Vector3fPacket(lhs.x * rhs, lhs.y * rhs, lhs.z * rhs); }
+__always_inline__ Vector3fPacket operator*(Vector3fPacket lhs, float rhs) { return lhs * FloatPacket::broadcast(rhs); }
+__always_inline__ Vector3fPacket operator+(Vector3fPacket lhs, Vector3f rhs) { return lhs + Vector3fPacket::broadcast(rhs); }
+__always_inline__ Vector3fPacket operator+(Vector3f lhs, Vector3fPacket rhs) { return Vector3fPacket::broadcast(lhs) + rhs; }
+__always_inline__ Vector3fPacket operator-(Vector3fPacket lhs, Vector3f rhs) { return lhs - Vector3fPacket::broadcast(rhs); }
+__always_inline__ Vector3fPacket operator-(Vector3f lhs, Vector3fPacket rhs) { return Vector3fPacket::broadcast(lhs) - rhs; }
+
+__always_inline__ Vector3fPacket min(Vector3fPacket lhs, Vector3fPacket rhs) { return Vector3fPacket(min(lhs.x, rhs.x), min(lhs.y, rhs.y), min(lhs.z, rhs.z)); }
+__always_inline__ Vector3fPacket max(Vector3fPacket lhs, Vector3fPacket rhs) { return Vector3fPacket(max(lhs.x, rhs.x), max(lhs.y, rhs.y), max(lhs.z, rhs.z)); }
+__always_inline__ Vector3fPacket select(FloatPacket mask, Vector3fPacket if_true, Vector3fPacket if_false) {
+    return Vector3fPacket(select(mask, if_true.x, if_false.x), select(mask, if_true.y, if_false.y), select(mask, if_true.z, if_false.z));
+}
+
+__always_inline__ FloatPacket dot(Vector3fPacket lhs, Vector3fPacket rhs) { return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z; }
+__always_inline__ FloatPacket magnitude(Vector3fPacket v) { return sqrt(dot(v, v)); }
+__always_inline__ Vector3fPacket normalize(Vector3fPacket v) { return v * (FloatPacket::broadcast(1.0f) / magnitude(v)); }
+__always_inline__ Vector3fPacket cross(Vector3fPacket lhs, Vector3fPacket rhs) {
+    return Vector3fPacket((lhs.y * rhs.z) - (lhs.z * rhs.y),
+                          (lhs.z * rhs.x) - (lhs.x * rhs.z),
+                          (lhs.x * rhs.y) - (lhs.y * rhs.x));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Transformations of packets. The operations are ordered as in their scalar counterparts,
+// so packets produce the same results as transforming the vectors one at a time.
+// ------------------------------------------------------------------------------------------------
+
+__always_inline__ Vector3fPacket operator*(const Matrix3x3f& matrix, Vector3fPacket v) {
+    auto row_dot = [&](int r) -> FloatPacket {
+        return v.x * matrix(r, 0) + v.y * matrix(r, 1) + v.z * matrix(r, 2);
+    };
+    return Vector3fPacket(row_dot(0), row_dot(1), row_dot(2));
+}
+
+// Transforms the points by the affine transformation.
+__always_inline__ Vector3fPacket transform_point(const Matrix3x4f& affine_transform, Vector3fPacket point) {
+    auto row_dot = [&](int r) -> FloatPacket {
+        return (point.x * affine_transform(r, 0) + point.y * affine_transform(r, 1) + point.z * affine_transform(r, 2)) + affine_transform(r, 3);
+    };
+    return Vector3fPacket(row_dot(0), row_dot(1), row_dot(2));
+}
+
+__always_inline__ Vector3fPacket operator*(Quaternionf rotation, Vector3fPacket v) {
+    Vector3fPacket img = Vector3fPacket::broadcast(rotation.imaginary());
+    Vector3fPacket uv = cross(img, v);
+    Vector3fPacket uuv = cross(img, uv);
+
+    Vector3fPacket half_res = (uv * rotation.w) + uuv;
+    return v + half_res * 2.0f;
+}
+
+__always_inline__ Vector3fPacket operator*(const Transform& transform, Vector3fPacket v) {
+    return transform.translation + transform.rotation * v * transform.scale;
+}
+
+// ------------------------------------------------------------------------------------------------
+// A packet of axis-aligned bounding boxes.
+// ------------------------------------------------------------------------------------------------
+struct AABBPacket final {
+    Vector3fPacket minimum;
+    Vector3fPacket maximum;
+
+    AABBPacket() = default;
+    AABBPacket(Vector3fPacket minimum, Vector3fPacket maximum) : minimum(minimum), maximum(maximum) { }
+
+    static __always_inline__ AABBPacket broadcast(AABB aabb) {
+        return AABBPacket(Vector3fPacket::broadcast(aabb.minimum), Vector3fPacket::broadcast(aabb.maximum));
+    }
+
+    static __always_inline__ AABBPacket invalid() { return broadcast(AABB::invalid()); }
+
+    // Loads count boxes, where count is less than or equal to width. The remaining lanes are invalid boxes.
+    static inline AABBPacket load(const AABB* aabbs, int count = FloatPacket::width) {
+        Vector3f minimums[FloatPacket::width], maximums[FloatPacket::width];
+        for (int i = 0; i < FloatPacket::width; ++i) {
+            AABB aabb = i < count ? aabbs[i] : AABB::invalid();
+            minimums[i] = aabb.minimum;
+            maximums[i] = aabb.maximum;
+        }
+        return AABBPacket(Vector3fPacket::load(minimums), Vector3fPacket::load(maximums));
+    }
+
+    __always_inline__ void grow_to_contain(Vector3fPacket point) {
+        minimum = min(minimum, point);
+        maximum = max(maximum, point);
+    }
+
+    __always_inline__ void grow_to_contain(AABBPacket aabb) {
+        minimum = min(minimum, aabb.minimum);
+        maximum = max(maximum, aabb.maximum);
+    }
+
+    // Returns the bounding box containing all boxes in the packet.
+    __always_inline__ AABB reduce() const {
+        return AABB(Vector3f(horizontal_min(minimum.x), horizontal_min(minimum.y), horizontal_min(minimum.z)),
+                    Vector3f(horizontal_max(maximum.x), horizontal_max(maximum.y), horizontal_max(maximum.z)));
+    }
+
+    __always_inline__ AABB operator[](int lane) const { return AABB(minimum[lane], maximum[lane]); }
+};
+
+// Intersects the ray with all boxes in the packet using the slab test.
+// Returns a mask of the boxes that are intersected in the interval [t_min, t_max] along the ray.
+// The slabs are ordered by the sign of the ray direction, so invalid boxes are never intersected.
+__always_inline__ FloatPacket intersect(Ray ray, AABBPacket aabbs, float t_min, float t_max) {
+    auto slab_interval = [](FloatPacket minimum, FloatPacket maximum, float origin, float direction, FloatPacket& t_near, FloatPacket& t_far) {
+        FloatPacket packet_origin = FloatPacket::broadcast(origin);
+        FloatPacket inverse_direction = FloatPacket::broadcast(1.0f / direction);
+        bool positive_direction = !(direction < 0.0f);
+        t_near = ((positive_direction ? minimum : maximum) - packet_origin) * inverse_direction;
+        t_far = ((positive_direction ? maximum : minimum) - packet_origin) * inverse_direction;
+    };
+
+    FloatPacket t_near_x, t_far_x, t_near_y, t_far_y, t_near_z, t_far_z;
+    slab_interval(aabbs.minimum.x, aabbs.maximum.x, ray.origin.x, ray.direction.x, t_near_x, t_far_x);
+    slab_interval(aabbs.minimum.y, aabbs.maximum.y, ray.origin.y, ray.direction.y, t_near_y, t_far_y);
+    slab_interval(aabbs.minimum.z, aabbs.maximum.z, ray.origin.z, ray.direction.z, t_near_z, t_far_z);
+    FloatPacket t_enter = max(max(t_near_x, t_near_y), max(t_near_z, FloatPacket::broadcast(t_min)));
+    FloatPacket t_exit = min(min(t_far_x, t_far_y), min(t_far_z, FloatPacket::broadcast(t_max)));
+    return t_enter <= t_exit;
+}
+
+// ------------------------------------------------------------------------------------------------
+// Batched operations on arrays of vectors. Input and output may be the same array.
+// ------------------------------------------------------------------------------------------------
+
+// Calls operation(packet, count) on consecutive packets of count vectors, where count is width for all but the last packet.
+template <typename Operation>
+inline void for_each_packet(const Vector3f* vectors, int vector_count, Operation operation) {
+    int i = 0;
+    for (; i + Vector3fPacket::width <= vector_count; i += Vector3fPacket::width)
+        operation(Vector3fPacket::load(vectors + i), i, Vector3fPacket::width);
+    if (i < vector_count)
+        operation(Vector3fPacket::load(vectors + i, vector_count - i), i, vector_count - i);
+}
+
+inline AABB compute_bounds(const Vector3f* points, int point_count) {
+    if (point_count == 0)
+        return AABB::invalid();
+    AABBPacket bounds = AABBPacket::invalid();
+    for_each_packet(points, point_count, [&](Vector3fPacket points, int, int) { bounds.grow_to_contain(points); });
+    return bounds.reduce();
+}
+
+// Transforms the points by the affine transformation and returns the bounds of the transformed points.
+inline AABB transform_points(const Matrix3x4f& affine_transform, const Vector3f* points, Vector3f* transformed_points, int point_count) {
+    if (point_count == 0)
+        return AABB::invalid();
+    AABBPacket bounds = AABBPacket::invalid();
+    for_each_packet(points, point_count, [&](Vector3fPacket points, int offset, int count) {
+        Vector3fPacket transformed = transform_point(affine_transform, points);
+        bounds.grow_to_contain(transformed);
+        transformed.store(transformed_points + offset, count);
+    });
+    return bounds.reduce();
+}
+
+inline void transform_vectors(const Matrix3x3f& matrix, const Vector3f* vectors, Vector3f* transformed_vectors, int vector_count) {
+    for_each_packet(vectors, vector_count, [&](Vector3fPacket vectors, int offset, int count) {
+        (matrix * vectors).store(transformed_vectors + offset, count);
+    });
+}
+
+inline void rotate_vectors(Quaternionf rotation, const Vector3f* vectors, Vector3f* rotated_vectors, int vector_count) {
+    for_each_packet(vectors, vector_count, [&](Vector3fPacket vectors, int offset, int count) {
+        (rotation * vectors).store(rotated_vectors + offset, count);
+    });
+}
+
+inline void transform_points(const Transform& transform, const Vector3f* points, Vector3f* transformed_points, int point_count) {
+    for_each_packet(points, point_count, [&](Vector3fPacket points, int offset, int count) {
+        (transform * points).store(transformed_points + offset, count);
+    });
+}
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_PACKET_H_
@@ -9,89 +9,149 @@
 #include <Bifrost/Math/RNG.h>
 #include <Bifrost/Math/Utils.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <functional>
+#include <vector>
 
 namespace Bifrost {
 namespace Math {
 namespace RNG {
 
+// ------------------------------------------------------------------------------------------------
+// Uniform grid over the unit square used to find the nearest neighbour of candidate samples.
+// The grid is rebuilt before each extension of a progressive sequence with a resolution such that
+// every cell contains at most four samples when the extension is done.
+// Distances are measured on the torus, as the samples should be well distributed when tiled.
+// ------------------------------------------------------------------------------------------------
+struct NeighbourGrid final {
+    static const unsigned int CELL_CAPACITY = 4;
+
+    unsigned int size;
+    std::vector<unsigned int> cell_sample_counts;
+    std::vector<unsigned int> cell_samples;
+    const Vector2f* samples;
+
+    void reset(const Vector2f* samples, unsigned int sample_count, unsigned int size) {
+        this->samples = samples;
+        this->size = size;
+        cell_sample_counts.assign(size * size, 0u);
+        cell_samples.resize(size * size * CELL_CAPACITY);
+        for (unsigned int s = 0; s < sample_count; ++s)
+            insert(s);
+    }
+
+    inline unsigned int cell_index(Vector2f p) const {
+        unsigned int x = std::min(unsigned int(p.x * size), size - 1);
+        unsigned int y = std::min(unsigned int(p.y * size), size - 1);
+        return x + y * size;
+    }
+
+    inline void insert(unsigned int sample_index) {
+        unsigned int cell = cell_index(samples[sample_index]);
+        assert(cell_sample_counts[cell] < CELL_CAPACITY);
+        cell_samples[cell * CELL_CAPACITY + cell_sample_counts[cell]++] = sample_index;
+    }
+
+    // Returns the squared toroidal distance to the nearest sample in the grid.
+    float nearest_squared_distance(Vector2f p) const {
+        int cell_x = std::min(int(p.x * size), int(size) - 1);
+        int cell_y = std::min(int(p.y * size), int(size) - 1);
+        float cell_size = 1.0f / size;
+        float best_squared_distance = 2.0f;
+
+        // Search rings of cells around p until the ring is further away than the nearest sample found.
+        int max_ring = int(size) / 2;
+        for (int ring = 0; ring <= max_ring; ++ring) {
+            float ring_distance = (ring - 1) * cell_size;
+            if (ring > 1 && ring_distance * ring_distance >= best_squared_distance)
+                break;
+
+            for (int y = cell_y - ring; y <= cell_y + ring; ++y) {
+                bool is_edge_row = y == cell_y - ring || y == cell_y + ring;
+                int x_step = is_edge_row ? 1 : 2 * ring;
+                for (int x = cell_x - ring; x <= cell_x + ring; x += std::max(x_step, 1)) {
+                    int wrapped_x = (x + int(size)) % int(size);
+                    int wrapped_y = (y + int(size)) % int(size);
+                    unsigned int cell = wrapped_x + wrapped_y * size;
+                    for (unsigned int i = 0; i < cell_sample_counts[cell]; ++i) {
+                        Vector2f neighbour = samples[cell_samples[cell * CELL_CAPACITY + i]];
+                        float dx = fabsf(neighbour.x - p.x), dy = fabsf(neighbour.y - p.y);
+                        dx = fminf(dx, 1.0f - dx);
+                        dy = fminf(dy, 1.0f - dy);
+                        best_squared_distance = fminf(best_squared_distance, dx * dx + dy * dy);
+                    }
+                }
+            }
+        }
+
+        return best_squared_distance;
+    }
+};
+
+// Returns a coordinate jittered inside the stratum.
+// The coordinate is clamped to the stratum, as rounding could otherwise move it to the next stratum.
+static inline float jitter_in_stratum(unsigned int stratum, unsigned int stratum_count, float jitter) {
+    float coordinate = (stratum + jitter) / stratum_count;
+    float stratum_end = float(stratum + 1) / stratum_count;
+    return coordinate < stratum_end ? coordinate : nextafterf(stratum_end, 0.0f);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Generate progressive multi-jittered samples with a blue noise approximation.
 // Progressive Multi-Jittered Sample Sequences - Supplemental materials, Christensen et al., 2018
 // http://graphics.pixar.com/library/ProgressiveMultiJitteredSampling/pmj_suppl.pdf.
-// The nearest neighbour search is implemented by searcing nearby strata for their random samples.
 // ------------------------------------------------------------------------------------------------
-void fill_progressive_multijittered_bluenoise_samples(Vector2f* samples_begin, Vector2f* samples_end, unsigned int blue_noise_samples) {
+void fill_progressive_multijittered_bluenoise_samples(Vector2f* samples_begin, Vector2f* samples_end, unsigned int blue_noise_samples, unsigned int seed) {
     unsigned int total_sample_count = unsigned int(samples_end - samples_begin);
     assert(is_power_of_two(total_sample_count));
 
-    auto rng = RNG::LinearCongruential(19349669);
+    auto rng = RNG::LinearCongruential(seed);
     auto rnd = [&]() -> float { return rng.sample1f(); };
 
     blue_noise_samples = max(1u, blue_noise_samples);
 
-    unsigned short next_sample_index = 0;
-
-    // Create occupied array.
-    const unsigned short FREE_STRATUM = 65535;
-    auto* tmp_storage = new unsigned short[2 * total_sample_count];
-    auto stratum_samples_x = tmp_storage;
-    auto stratum_samples_y = tmp_storage + total_sample_count;
+    unsigned int next_sample_index = 0;
+
+    // Occupied 1D strata.
+    auto occupied_strata_x = std::vector<bool>(total_sample_count);
+    auto occupied_strata_y = std::vector<bool>(total_sample_count);
+    NeighbourGrid grid;
+
+    // Returns a random free stratum in [stratum_begin, stratum_begin + stratum_count).
+    // Picking among the free strata directly, instead of rejection sampling coordinates in the subquadrant,
+    // keeps the cost bounded when only a few strata are left and avoids candidates rounding into the neighbouring stratum.
+    auto random_free_stratum = [&](const std::vector<bool>& occupied_strata, unsigned int stratum_begin, unsigned int stratum_count) -> unsigned int {
+        unsigned int free_stratum_count = 0;
+        for (unsigned int s = stratum_begin; s < stratum_begin + stratum_count; ++s)
+            free_stratum_count += occupied_strata[s] ? 0 : 1;
+        assert(free_stratum_count > 0);
+
+        unsigned int free_index = std::min(unsigned int(rnd() * free_stratum_count), free_stratum_count - 1);
+        for (unsigned int s = stratum_begin; s < stratum_begin + stratum_count; ++s)
+            if (!occupied_strata[s] && free_index-- == 0)
+                return s;
+        return stratum_begin;
+    };
 
-    auto generate_sample_point = [&](Vector2f oldpt, int i, int j, int xhalf, int yhalf, int prev_grid_size, int prev_sample_count) {
-        int next_sample_count = 2 * prev_sample_count;
+    auto generate_sample_point = [&](int i, int j, int xhalf, int yhalf, int prev_grid_size, int prev_sample_count) {
+        unsigned int next_sample_count = 2 * prev_sample_count;
+        unsigned int subquadrant_size = next_sample_count / (2 * prev_grid_size);
+        unsigned int x_begin = (2 * i + xhalf) * subquadrant_size;
+        unsigned int y_begin = (2 * j + yhalf) * subquadrant_size;
 
         Vector2f best_pt = { NAN, NAN };
-        float best_distance = 0;
+        float best_distance = -1.0f;
 
         for (unsigned int s = 0; s < blue_noise_samples; ++s) {
+            // Generate candidate sample in free x and y strata of the subquadrant.
+            unsigned int x_stratum = random_free_stratum(occupied_strata_x, x_begin, subquadrant_size);
+            unsigned int y_stratum = random_free_stratum(occupied_strata_y, y_begin, subquadrant_size);
+            Vector2f pt = Vector2f(jitter_in_stratum(x_stratum, next_sample_count, rnd()), jitter_in_stratum(y_stratum, next_sample_count, rnd()));
 
-            Vector2f pt;
-            // Generate candidate sample x coord
-            do {
-                pt.x = (i + 0.5f * (xhalf + rnd())) / prev_grid_size;
-            } while (stratum_samples_x[int(next_sample_count * pt.x)] != FREE_STRATUM);
-
-            // Generate candidate sample y coord
-            do {
-                pt.y = (j + 0.5f * (yhalf + rnd())) / prev_grid_size;
-            } while (stratum_samples_y[int(next_sample_count * pt.y)] != FREE_STRATUM);
-
-            int xstratum = int(next_sample_count * pt.x);
-            int ystratum = int(next_sample_count * pt.y);
-
-            float distance_to_neighbour = magnitude_squared(oldpt - pt);
-            int max_search_stratum = int(next_sample_count * sqrt(distance_to_neighbour));
-
-            for (int offset = 1; offset <= max_search_stratum; ++offset) {
-                auto test_neighbour_sample = [&](unsigned short neighbour_sample_index) {
-                    if (neighbour_sample_index == FREE_STRATUM)
-                        return;
-
-                    auto neighbour_sample = samples_begin[neighbour_sample_index];
-                    // Samples should be distributed wrt a repeating sample pattern, so modify the sample such that it is closest in this pattern.
-                    if (neighbour_sample.x < pt.x - 0.5f)
-                        neighbour_sample.x += 1.0f;
-                    else if (neighbour_sample.x > pt.x + 0.5f)
-                        neighbour_sample.x -= 1.0f;
-                    if (neighbour_sample.y < pt.y - 0.5f)
-                        neighbour_sample.y += 1.0f;
-                    else if (neighbour_sample.y > pt.y + 0.5f)
-                        neighbour_sample.y -= 1.0f;
-
-                    float local_distance_to_neighbour = magnitude_squared(neighbour_sample - pt);
-                    if (local_distance_to_neighbour < distance_to_neighbour) {
-                        distance_to_neighbour = local_distance_to_neighbour;
-                        max_search_stratum = int(next_sample_count * sqrt(distance_to_neighbour));
-                    }
-                };
-
-                test_neighbour_sample(stratum_samples_x[(xstratum + offset) % next_sample_count]);
-                test_neighbour_sample(stratum_samples_x[(xstratum + next_sample_count - offset) % next_sample_count]);
-                test_neighbour_sample(stratum_samples_y[(ystratum + offset) % next_sample_count]);
-                test_neighbour_sample(stratum_samples_y[(ystratum + next_sample_count - offset) % next_sample_count]);
-            }
-
+            // Only search for the nearest neighbour if there are multiple candidates to choose between.
+            float distance_to_neighbour = blue_noise_samples > 1 ? grid.nearest_squared_distance(pt) : 0.0f;
             if (best_distance < distance_to_neighbour) {
                 best_distance = distance_to_neighbour;
                 best_pt = pt;
@@ -99,25 +159,26 @@ void fill_progressive_multijittered_bluenoise_samples(Vector2f* samples_begin, V
         }
 
         // Mark 1D strata as occupied
-        int xstratum = int(next_sample_count * best_pt.x);
-        int ystratum = int(next_sample_count * best_pt.y);
-        stratum_samples_x[xstratum] = stratum_samples_y[ystratum] = next_sample_index;
+        occupied_strata_x[int(next_sample_count * best_pt.x)] = true;
+        occupied_strata_y[int(next_sample_count * best_pt.y)] = true;
 
         // Assign new sample point
-        samples_begin[next_sample_index++] = best_pt;
+        samples_begin[next_sample_index] = best_pt;
+        grid.insert(next_sample_index++);
     };
 
-    // Mark all occupied 1D strata.
-    auto mark_occupied_strata = [&](unsigned int prev_sample_count) {
+    // Mark all occupied 1D strata and insert the samples into the neighbour grid.
+    auto mark_occupied_strata = [&](unsigned int prev_sample_count, unsigned int grid_size) {
         unsigned int next_sample_count = 2 * prev_sample_count;
-        for (unsigned int i = 0; i < next_sample_count; ++i)
-            stratum_samples_x[i] = stratum_samples_y[i] = FREE_STRATUM;
+        std::fill(occupied_strata_x.begin(), occupied_strata_x.begin() + next_sample_count, false);
+        std::fill(occupied_strata_y.begin(), occupied_strata_y.begin() + next_sample_count, false);
 
         for (unsigned int s = 0; s < prev_sample_count; ++s) {
-            int xstratum = int(next_sample_count * samples_begin[s].x);
-            int ystratum = int(next_sample_count * samples_begin[s].y);
-            stratum_samples_x[xstratum] = stratum_samples_y[ystratum] = unsigned short(s);
+            occupied_strata_x[int(next_sample_count * samples_begin[s].x)] = true;
+            occupied_strata_y[int(next_sample_count * samples_begin[s].y)] = true;
         }
+
+        grid.reset(samples_begin, prev_sample_count, grid_size);
     };
 
     // Generate next N sample points(for N being an even power of two)
@@ -125,7 +186,7 @@ void fill_progressive_multijittered_bluenoise_samples(Vector2f* samples_begin, V
         unsigned int prev_grid_size = (unsigned int)sqrt(prev_sample_count);
 
         // Mark already occupied 1D strata so we can avoid them
-        mark_occupied_strata(prev_sample_count);
+        mark_occupied_strata(prev_sample_count, prev_grid_size);
 
         // Loop over N old samples and generate 1 new sample for each
         for (unsigned int s = 0; s < prev_sample_count; ++s) {
@@ -138,7 +199,7 @@ void fill_progressive_multijittered_bluenoise_samples(Vector2f* samples_begin, V
             xhalf = 1 - xhalf;
             yhalf = 1 - yhalf;
             // Generate a sample point
-            generate_sample_point(oldpt, i, j, xhalf, yhalf, prev_grid_size, prev_sample_count);
+            generate_sample_point(i, j, xhalf, yhalf, prev_grid_size, prev_sample_count);
         }
     };
 
@@ -146,10 +207,10 @@ void fill_progressive_multijittered_bluenoise_samples(Vector2f* samples_begin, V
     auto extend_sequence_odd = [&](unsigned int prev_sample_count) {
         unsigned int prev_grid_size = (unsigned int)sqrt(prev_sample_count / 2);
         // Mark already occupied 1D strata so we can avoid them
-        mark_occupied_strata(prev_sample_count);
+        mark_occupied_strata(prev_sample_count, prev_grid_size);
 
         // Loop over the first half of the samples, the ones used in extend_sequence_even as well,
-        // and generate 2 new samples for each  one at a time to keep the order consecutive (for "greedy" best candidates)
+        // and generate 2 new samples for each, one at a time to keep the order consecutive (for "greedy" best candidates)
 
         // Select one of the two remaining subquadrants
         for (unsigned int s = 0; s < prev_sample_count / 2; ++s) {
@@ -165,7 +226,7 @@ void fill_progressive_multijittered_bluenoise_samples(Vector2f* samples_begin, V
             else
                 yhalf = 1 - yhalf;
             // Generate a sample point
-            generate_sample_point(oldpt, i, j, xhalf, yhalf, prev_grid_size, prev_sample_count);
+            generate_sample_point(i, j, xhalf, yhalf, prev_grid_size, prev_sample_count);
         }
 
         // And finally fill in the last subquadrants opposite to the previous subquadrant filled.
@@ -181,7 +242,7 @@ void fill_progressive_multijittered_bluenoise_samples(Vector2f* samples_begin, V
             int yhalf = 1 - old_yhalf;
 
             // Generate a sample point
-            generate_sample_point(oldpt, i, j, xhalf, yhalf, prev_grid_size, prev_sample_count);
+            generate_sample_point(i, j, xhalf, yhalf, prev_grid_size, prev_sample_count);
         }
     };
 
@@ -193,10 +254,289 @@ void fill_progressive_multijittered_bluenoise_samples(Vector2f* samples_begin, V
             extend_sequence_odd(2 * current_sample_count); // 2 * current_sample_count is odd pow2
         current_sample_count *= 4;
     }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Generate progressive multi-jittered (0,2) samples with a blue noise approximation.
+// Progressive Multi-Jittered Sample Sequences, Christensen et al., 2018, section 4 and
+// Efficient Generation of Points that Satisfy Two-Dimensional Elementary Intervals, Pharr, 2019.
+// Each new sample is placed in the subquadrant chosen by the PMJ construction, in a cell of the finest
+// grid that is free in all elementary intervals. The free cells are found by a depth first search over
+// the bits of the y stratum, pruning prefixes whose elementary interval is already occupied.
+// If the subquadrant has no free cells, the sample is placed anywhere in the unit square where it
+// satisfies the elementary intervals. If that fails as well the extension is restarted.
+// ------------------------------------------------------------------------------------------------
+void fill_progressive_multijittered02_samples(Vector2f* samples_begin, Vector2f* samples_end, unsigned int blue_noise_samples, unsigned int seed) {
+    unsigned int total_sample_count = unsigned int(samples_end - samples_begin);
+    assert(is_power_of_two(total_sample_count));
+
+    auto rng = RNG::LinearCongruential(seed);
+    auto rnd = [&]() -> float { return rng.sample1f(); };
+
+    blue_noise_samples = max(1u, blue_noise_samples);
+
+    // Occupancy of the elementary intervals of the 2^log2_sample_count samples after the current extension.
+    // The intervals of shape i have 2^i columns and 2^(log2_sample_count - i) rows.
+    unsigned int sample_count = 0; // Total number of samples after the current extension.
+    int log2_sample_count = 0;
+    std::vector<std::vector<bool>> occupied_intervals;
+    NeighbourGrid grid;
+
+    auto interval_index = [&](int shape, unsigned int x_stratum, unsigned int y_stratum) -> unsigned int {
+        unsigned int column = x_stratum >> (log2_sample_count - shape);
+        unsigned int row = y_stratum >> shape;
+        return column + (row << shape);
+    };
 
-    delete[] tmp_storage;
+    auto mark_occupied = [&](Vector2f sample) {
+        unsigned int x_stratum = unsigned int(sample.x * sample_count), y_stratum = unsigned int(sample.y * sample_count);
+        for (int shape = 0; shape <= log2_sample_count; ++shape)
+            occupied_intervals[shape][interval_index(shape, x_stratum, y_stratum)] = true;
+    };
+
+    // Finds a y stratum in [y_begin, y_end), such that the x and y strata are free in all elementary intervals.
+    // depth is the number of leading bits of the y stratum that have been set in y_prefix.
+    std::function<bool(unsigned int, int, unsigned int, unsigned int, unsigned int, unsigned int&)> find_free_y_stratum;
+    find_free_y_stratum = [&](unsigned int x_stratum, int depth, unsigned int y_prefix, unsigned int y_begin, unsigned int y_end, unsigned int& y_stratum) -> bool {
+        int remaining_bits = log2_sample_count - depth;
+        unsigned int prefix_begin = y_prefix << remaining_bits, prefix_end = (y_prefix + 1) << remaining_bits;
+        if (prefix_end <= y_begin || y_end <= prefix_begin)
+            return false;
+
+        int shape = log2_sample_count - depth;
+        if (occupied_intervals[shape][interval_index(shape, x_stratum, prefix_begin)])
+            return false;
+
+        if (depth == log2_sample_count) {
+            y_stratum = y_prefix;
+            return true;
+        }
+
+        unsigned int first_bit = rnd() < 0.5f ? 0 : 1;
+        return find_free_y_stratum(x_stratum, depth + 1, (y_prefix << 1) | first_bit, y_begin, y_end, y_stratum) ||
+               find_free_y_stratum(x_stratum, depth + 1, (y_prefix << 1) | (1 - first_bit), y_begin, y_end, y_stratum);
+    };
+
+    // Generates a candidate in a random free cell of the finest grid inside [x_begin, x_end) x [y_begin, y_end).
+    auto generate_candidate = [&](unsigned int x_begin, unsigned int x_end, unsigned int y_begin, unsigned int y_end, Vector2f& candidate) -> bool {
+        unsigned int x_stratum_count = x_end - x_begin;
+        unsigned int x_offset = std::min(unsigned int(rnd() * x_stratum_count), x_stratum_count - 1);
+        for (unsigned int x = 0; x < x_stratum_count; ++x) {
+            unsigned int x_stratum = x_begin + (x + x_offset) % x_stratum_count;
+            unsigned int y_stratum;
+            if (find_free_y_stratum(x_stratum, 0, 0, y_begin, y_end, y_stratum)) {
+                candidate = Vector2f(jitter_in_stratum(x_stratum, sample_count, rnd()), jitter_in_stratum(y_stratum, sample_count, rnd()));
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Generates the next sample in the subquadrant of the grid cell at (i, j).
+    auto generate_sample_point = [&](unsigned int next_sample_index, int i, int j, int xhalf, int yhalf, int grid_size) -> bool {
+        unsigned int subquadrant_size = sample_count / (2 * grid_size);
+        unsigned int x_begin = (2 * i + xhalf) * subquadrant_size;
+        unsigned int y_begin = (2 * j + yhalf) * subquadrant_size;
+
+        Vector2f best_pt;
+        float best_distance = -1.0f;
+        for (unsigned int s = 0; s < blue_noise_samples; ++s) {
+            Vector2f pt;
+            bool found_candidate = generate_candidate(x_begin, x_begin + subquadrant_size, y_begin, y_begin + subquadrant_size, pt) ||
+                                   generate_candidate(0, sample_count, 0, sample_count, pt);
+            if (!found_candidate)
+                return false;
+
+            // Only search for the nearest neighbour if there are multiple candidates to choose between.
+            float distance_to_neighbour = blue_noise_samples > 1 ? grid.nearest_squared_distance(pt) : 0.0f;
+            if (best_distance < distance_to_neighbour) {
+                best_distance = distance_to_neighbour;
+                best_pt = pt;
+            }
+        }
+
+        mark_occupied(best_pt);
+        samples_begin[next_sample_index] = best_pt;
+        grid.insert(next_sample_index);
+        return true;
+    };
+
+    // Prepares the occupied intervals and the neighbour grid for extending the first prev_sample_count samples.
+    auto begin_extension = [&](unsigned int prev_sample_count, unsigned int grid_size) {
+        sample_count = 2 * prev_sample_count;
+        log2_sample_count = 0;
+        while ((1u << log2_sample_count) < sample_count)
+            ++log2_sample_count;
+        occupied_intervals.resize(log2_sample_count + 1);
+        for (auto& intervals : occupied_intervals)
+            intervals.assign(sample_count, false);
+        for (unsigned int s = 0; s < prev_sample_count; ++s)
+            mark_occupied(samples_begin[s]);
+        grid.reset(samples_begin, prev_sample_count, grid_size);
+    };
+
+    auto subquadrant_of = [](Vector2f pt, int grid_size, int& i, int& j, int& xhalf, int& yhalf) {
+        i = int(grid_size * pt.x);
+        j = int(grid_size * pt.y);
+        xhalf = int(2 * (grid_size * pt.x - i));
+        yhalf = int(2 * (grid_size * pt.y - j));
+    };
+
+    // Generate next N sample points (for N being an even power of two)
+    auto extend_sequence_even = [&](unsigned int prev_sample_count) -> bool {
+        int grid_size = int(sqrt(prev_sample_count));
+        begin_extension(prev_sample_count, grid_size);
+
+        for (unsigned int s = 0; s < prev_sample_count; ++s) {
+            int i, j, xhalf, yhalf;
+            subquadrant_of(samples_begin[s], grid_size, i, j, xhalf, yhalf);
+            // Select the diagonally opposite subquadrant
+            if (!generate_sample_point(prev_sample_count + s, i, j, 1 - xhalf, 1 - yhalf, grid_size))
+                return false;
+        }
+        return true;
+    };
+
+    // Generate next N sample points (for N being an odd power of two)
+    auto extend_sequence_odd = [&](unsigned int prev_sample_count) -> bool {
+        int grid_size = int(sqrt(prev_sample_count / 2));
+        begin_extension(prev_sample_count, grid_size);
+
+        // Select one of the two remaining subquadrants of the samples used in extend_sequence_even.
+        for (unsigned int s = 0; s < prev_sample_count / 2; ++s) {
+            int i, j, xhalf, yhalf;
+            subquadrant_of(samples_begin[s], grid_size, i, j, xhalf, yhalf);
+            if (rnd() > 0.5)
+                xhalf = 1 - xhalf;
+            else
+                yhalf = 1 - yhalf;
+            if (!generate_sample_point(prev_sample_count + s, i, j, xhalf, yhalf, grid_size))
+                return false;
+        }
+
+        // And finally fill in the last subquadrants opposite to the previous subquadrant filled.
+        for (unsigned int s = 0; s < prev_sample_count / 2; ++s) {
+            int i, j, xhalf, yhalf;
+            subquadrant_of(samples_begin[s + prev_sample_count], grid_size, i, j, xhalf, yhalf);
+            if (!generate_sample_point(prev_sample_count + prev_sample_count / 2 + s, i, j, 1 - xhalf, 1 - yhalf, grid_size))
+                return false;
+        }
+        return true;
+    };
+
+    samples_begin[0] = { rnd(), rnd() };
+    unsigned int current_sample_count = 1;
+    while (current_sample_count < total_sample_count) {
+        // Restart the extension with new random choices if the greedy placement ran out of free intervals.
+        while (!extend_sequence_even(current_sample_count));
+        if (2 * current_sample_count < total_sample_count)
+            while (!extend_sequence_odd(2 * current_sample_count));
+        current_sample_count *= 4;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Owen scrambled Sobol sequence.
+// ------------------------------------------------------------------------------------------------
+
+// The first dimension is the van der Corput sequence. The remaining dimensions are generated from the
+// primitive polynomials and initial direction numbers in new-joe-kuo-6.21201 by Joe and Kuo, 2008.
+// https://web.maths.unsw.edu.au/~fkuo/sobol/
+const unsigned int sobol_matrices[SOBOL_DIMENSION_COUNT][32] = {
+    { 0x80000000, 0x40000000, 0x20000000, 0x10000000, 0x08000000, 0x04000000, 0x02000000, 0x01000000,
+      0x00800000, 0x00400000, 0x00200000, 0x00100000, 0x00080000, 0x00040000, 0x00020000, 0x00010000,
+      0x00008000, 0x00004000, 0x00002000, 0x00001000, 0x00000800, 0x00000400, 0x00000200, 0x00000100,
+      0x00000080, 0x00000040, 0x00000020, 0x00000010, 0x00000008, 0x00000004, 0x00000002, 0x00000001 },
+    { 0x80000000, 0xc0000000, 0xa0000000, 0xf0000000, 0x88000000, 0xcc000000, 0xaa000000, 0xff000000,
+      0x80800000, 0xc0c00000, 0xa0a00000, 0xf0f00000, 0x88880000, 0xcccc0000, 0xaaaa0000, 0xffff0000,
+      0x80008000, 0xc000c000, 0xa000a000, 0xf000f000, 0x88008800, 0xcc00cc00, 0xaa00aa00, 0xff00ff00,
+      0x80808080, 0xc0c0c0c0, 0xa0a0a0a0, 0xf0f0f0f0, 0x88888888, 0xcccccccc, 0xaaaaaaaa, 0xffffffff },
+    { 0x80000000, 0xc0000000, 0x60000000, 0x90000000, 0xe8000000, 0x5c000000, 0x8e000000, 0xc5000000,
+      0x68800000, 0x9cc00000, 0xee600000, 0x55900000, 0x80680000, 0xc09c0000, 0x60ee0000, 0x90550000,
+      0xe8808000, 0x5cc0c000, 0x8e606000, 0xc5909000, 0x6868e800, 0x9c9c5c00, 0xeeee8e00, 0x5555c500,
+      0x8000e880, 0xc0005cc0, 0x60008e60, 0x9000c590, 0xe8006868, 0x5c009c9c, 0x8e00eeee, 0xc5005555 },
+    { 0x80000000, 0xc0000000, 0x20000000, 0x50000000, 0xf8000000, 0x74000000, 0xa2000000, 0x93000000,
+      0xd8800000, 0x25400000, 0x59e00000, 0xe6d00000, 0x78080000, 0xb40c0000, 0x82020000, 0xc3050000,
+      0x208f8000, 0x51474000, 0xfbea2000, 0x75d93000, 0xa0858800, 0x914e5400, 0xdbe79e00, 0x25db6d00,
+      0x58800080, 0xe54000c0, 0x79e00020, 0xb6d00050, 0x800800f8, 0xc00c0074, 0x200200a2, 0x50050093 },
+    { 0x80000000, 0x40000000, 0x20000000, 0xb0000000, 0xf8000000, 0xdc000000, 0x7a000000, 0x9d000000,
+      0x5a800000, 0x2fc00000, 0xa1600000, 0xf0b00000, 0xda880000, 0x6fc40000, 0x81620000, 0x40bb0000,
+      0x22878000, 0xb3c9c000, 0xfb65a000, 0xddb2d000, 0x78022800, 0x9c0b3c00, 0x5a0fb600, 0x2d0ddb00,
+      0xa2878080, 0xf3c9c040, 0xdb65a020, 0x6db2d0b0, 0x800228f8, 0x400b3cdc, 0x200fb67a, 0xb00ddb9d },
+    { 0x80000000, 0x40000000, 0x60000000, 0x30000000, 0xc8000000, 0x24000000, 0x56000000, 0xfb000000,
+      0xe0800000, 0x70400000, 0xa8600000, 0x14300000, 0x9ec80000, 0xdf240000, 0xb6d60000, 0x8bbb0000,
+      0x48008000, 0x64004000, 0x36006000, 0xcb003000, 0x2880c800, 0x54402400, 0xfe605600, 0xef30fb00,
+      0x7e48e080, 0xaf647040, 0x1eb6a860, 0x9f8b1430, 0xd6c81ec8, 0xbb249f24, 0x80d6d6d6, 0x40bbbbbb },
+    { 0x80000000, 0xc0000000, 0xa0000000, 0xd0000000, 0x58000000, 0x94000000, 0x3e000000, 0xe3000000,
+      0xbe800000, 0x23c00000, 0x1e200000, 0xf3100000, 0x46780000, 0x67840000, 0x78460000, 0x84670000,
+      0xc6788000, 0xa784c000, 0xd846a000, 0x5467d000, 0x9e78d800, 0x33845400, 0xe6469e00, 0xb7673300,
+      0x20f86680, 0x104477c0, 0xf8668020, 0x4477c010, 0x668020f8, 0x77c01044, 0x8020f866, 0xc0104477 },
+    { 0x80000000, 0x40000000, 0xa0000000, 0x50000000, 0x88000000, 0x24000000, 0x12000000, 0x2d000000,
+      0x76800000, 0x9e400000, 0x08200000, 0x64100000, 0xb2280000, 0x7d140000, 0xfea20000, 0xba490000,
+      0x1a248000, 0x491b4000, 0xc4b5a000, 0xe3739000, 0xf6800800, 0xde400400, 0xa8200a00, 0x34100500,
+      0x3a280880, 0x59140240, 0xeca20120, 0x974902d0, 0x6ca48768, 0xd75b49e4, 0xcc95a082, 0x87639641 },
+    { 0x80000000, 0x40000000, 0xa0000000, 0x50000000, 0x28000000, 0xd4000000, 0x6a000000, 0x71000000,
+      0x38800000, 0x58400000, 0xea200000, 0x31100000, 0x98a80000, 0x08540000, 0xc22a0000, 0xe5250000,
+      0xf2b28000, 0x79484000, 0xfaa42000, 0xbd731000, 0x18a80800, 0x48540400, 0x622a0a00, 0xb5250500,
+      0xdab28280, 0xad484d40, 0x90a426a0, 0xcc731710, 0x20280b88, 0x10140184, 0x880a04a2, 0x84350611 },
+    { 0x80000000, 0x40000000, 0xe0000000, 0xb0000000, 0x98000000, 0x94000000, 0x8a000000, 0x5b000000,
+      0x33800000, 0xd9c00000, 0x72200000, 0x3f100000, 0xc1b80000, 0xa6ec0000, 0x53860000, 0x29f50000,
+      0x0a3a8000, 0x1b2ac000, 0xd392e000, 0x69ff7000, 0xea380800, 0xab2c0400, 0x4ba60e00, 0xfde50b00,
+      0x60028980, 0xf006c940, 0x7834e8a0, 0x241a75b0, 0x123a8b38, 0xcf2ac99c, 0xb992e922, 0x82ff78f1 },
+    { 0x80000000, 0x40000000, 0xa0000000, 0x10000000, 0x08000000, 0x6c000000, 0x9e000000, 0x23000000,
+      0x57800000, 0xadc00000, 0x7fa00000, 0x91d00000, 0x49880000, 0xced40000, 0x880a0000, 0x2c0f0000,
+      0x3e0d8000, 0x3317c000, 0x5fb06000, 0xc1f8b000, 0xe18d8800, 0xb2d7c400, 0x1e106a00, 0x6328b100,
+      0xf7858880, 0xbdc3c2c0, 0x77ba63e0, 0xfdf7b330, 0xd7800df8, 0xedc0081c, 0xdfa0041a, 0x81d00a2d },
+    { 0x80000000, 0x40000000, 0x20000000, 0x30000000, 0x58000000, 0xac000000, 0x96000000, 0x2b000000,
+      0xd4800000, 0x09400000, 0xe2a00000, 0x52500000, 0x4e280000, 0xc71c0000, 0x629e0000, 0x12670000,
+      0x6e138000, 0xf731c000, 0x3a98a000, 0xbe449000, 0xf83b8800, 0xdc2dc400, 0xee06a200, 0xb7239300,
+      0x1aa80d80, 0x8e5c0ec0, 0xa03e0b60, 0x703701b0, 0x783b88c8, 0x9c2dca54, 0xce06a74a, 0x87239795 },
+    { 0x80000000, 0xc0000000, 0xa0000000, 0x50000000, 0xf8000000, 0x8c000000, 0xe2000000, 0x33000000,
+      0x0f800000, 0x21400000, 0x95a00000, 0x5e700000, 0xd8080000, 0x1c240000, 0xba160000, 0xef370000,
+      0x15868000, 0x9e6fc000, 0x781b6000, 0x4c349000, 0x420e8800, 0x630bcc00, 0xf7ad6a00, 0xad739500,
+      0x77800780, 0x6d4004c0, 0xd7a00420, 0x3d700630, 0x2f880f78, 0xb1640ad4, 0xcdb6077a, 0x824706d7 },
+    { 0x80000000, 0xc0000000, 0x60000000, 0x90000000, 0x38000000, 0xc4000000, 0x42000000, 0xa3000000,
+      0xf1800000, 0xaa400000, 0xfce00000, 0x85100000, 0xe0080000, 0x500c0000, 0x58060000, 0x54090000,
+      0x7a038000, 0x670c4000, 0xb3842000, 0x094a3000, 0x0d6f1800, 0x2f5aa400, 0x1ce7ce00, 0xd5145100,
+      0xb8000080, 0x040000c0, 0x22000060, 0x33000090, 0xc9800038, 0x6e4000c4, 0xbee00042, 0x261000a3 },
+    { 0x80000000, 0x40000000, 0x20000000, 0xf0000000, 0xa8000000, 0x54000000, 0x9a000000, 0x9d000000,
+      0x1e800000, 0x5cc00000, 0x7d200000, 0x8d100000, 0x24880000, 0x71c40000, 0xeba20000, 0x75df0000,
+      0x6ba28000, 0x35d14000, 0x4ba3a000, 0xc5d2d000, 0xe3a16800, 0x91db8c00, 0x79aef200, 0x0cdf4100,
+      0x672a8080, 0x50154040, 0x1a01a020, 0xdd0dd0f0, 0x3e83e8a8, 0xaccacc54, 0xd52d529a, 0xd91d919d },
+    { 0x80000000, 0xc0000000, 0x20000000, 0xd0000000, 0xd8000000, 0xc4000000, 0x46000000, 0x85000000,
+      0xa5800000, 0x76c00000, 0xada00000, 0x6ab00000, 0x2da80000, 0xaabc0000, 0x0daa0000, 0x7ab10000,
+      0xd5a78000, 0xbebd4000, 0x93a3e000, 0x3bb51000, 0x3629b800, 0x4d727c00, 0x9b836200, 0x27c4d700,
+      0xb629b880, 0x8d727cc0, 0xbb836220, 0xf7c4d7d0, 0x6e29b858, 0x49727c04, 0xfd836266, 0x72c4d755 }
+};
+
+void OwenScrambledSobol::fill(unsigned int index_begin, unsigned int index_count, unsigned int dimension_begin, unsigned int dimension_count, float* samples) const {
+    // The shuffled indices are shared by all dimensions in a block.
+    std::vector<unsigned int> shuffled_indices(index_count);
+    unsigned int shuffled_block = 0xFFFFFFFF;
+
+    for (unsigned int d = 0; d < dimension_count; ++d) {
+        unsigned int dimension = dimension_begin + d;
+        unsigned int block = dimension / SOBOL_DIMENSION_COUNT;
+        if (block != shuffled_block) {
+            unsigned int index_seed = hash_combine(m_seed, block);
+            for (unsigned int i = 0; i < index_count; ++i)
+                shuffled_indices[i] = nested_uniform_scramble(index_begin + i, index_seed);
+            shuffled_block = block;
+        }
+
+        const unsigned int* matrix = sobol_matrices[dimension % SOBOL_DIMENSION_COUNT];
+        unsigned int scramble_seed = hash_combine(m_seed ^ 0xa511e9b3u, dimension);
+        float* dimension_samples = samples + d * index_count;
+        for (unsigned int i = 0; i < index_count; ++i) {
+            unsigned int index = shuffled_indices[i];
+            unsigned int x = 0;
+            for (unsigned int b = 0; b < 32; ++b)
+                x ^= matrix[b] & (0u - ((index >> b) & 1u));
+            dimension_samples[i] = uint_to_unit_float(nested_uniform_scramble(x, scramble_seed));
+        }
+    }
 }
 
 } // NS RNG
 } // NS Math
-} // NS Bifrost
\ No newline at end of file
+} // NS Bifrost
@@ -90,9 +90,21 @@ __always_inline__ float power_heuristic(float pdf1, float pdf2) {
 // Generate progressive multi-jittered samples with a blue noise approximation.
 // Progressive Multi-Jittered Sample Sequences - Supplemental materials, Christensen et al., 2018
 // http://graphics.pixar.com/library/ProgressiveMultiJitteredSampling/pmj_suppl.pdf.
-// The nearest neighbour search is implemented by searcing nearby strata for their random samples.
+// The blue noise approximation picks the best of blue_noise_samples candidates pr sample, i.e. the
+// candidate furthest from its nearest neighbour, which is found using a uniform grid.
+// The number of samples must be a power of two.
 // ------------------------------------------------------------------------------------------------
-void fill_progressive_multijittered_bluenoise_samples(Vector2f* samples_begin, Vector2f* samples_end, unsigned int blue_noise_samples = 8);
+void fill_progressive_multijittered_bluenoise_samples(Vector2f* samples_begin, Vector2f* samples_end, unsigned int blue_noise_samples = 8,
+                                                      unsigned int seed = 19349669);
+
+// ------------------------------------------------------------------------------------------------
+// Generate progressive multi-jittered (0,2) samples, PMJ02, with an optional blue noise approximation.
+// Besides being multi-jittered, every power of two prefix of the samples is stratified in all
+// two-dimensional elementary intervals, fx 2x8, 4x4 and 8x2 for 16 samples.
+// The number of samples must be a power of two.
+// ------------------------------------------------------------------------------------------------
+void fill_progressive_multijittered02_samples(Vector2f* samples_begin, Vector2f* samples_end, unsigned int blue_noise_samples = 1,
+                                              unsigned int seed = 19349669);
 
 // ------------------------------------------------------------------------------------------------
 // Linear congruential random number generator
@@ -120,6 +132,85 @@ public:
     __always_inline__ Vector3f sample3f() { return Vector3f(sample1f(), sample1f(), sample1f()); }
 };
 
+// ------------------------------------------------------------------------------------------------
+// Owen scrambled Sobol sequence.
+// Practical Hash-based Owen Scrambling, Burley, 2020.
+// The first SOBOL_DIMENSION_COUNT dimensions are the Sobol sequence with the direction numbers of
+// Joe and Kuo, 2008. Higher dimensions reuse the Sobol dimensions in blocks of SOBOL_DIMENSION_COUNT,
+// where each block shuffles the sample indices differently, such that the blocks are decorrelated.
+// Every power of two prefix of the samples is stratified in all dimensions and the indices are
+// shuffled by a nested uniform scramble, which preserves that property.
+// ------------------------------------------------------------------------------------------------
+const unsigned int SOBOL_DIMENSION_COUNT = 16;
+
+// Generator matrices of the Sobol dimensions, stored as one column pr bit of the sample index.
+extern const unsigned int sobol_matrices[SOBOL_DIMENSION_COUNT][32];
+
+__always_inline__ unsigned int sobol(unsigned int n, unsigned int dimension) {
+    const unsigned int* matrix = sobol_matrices[dimension];
+    unsigned int result = 0;
+    for (unsigned int b = 0; n != 0; n >>= 1u, ++b)
+        if (n & 0x1) result ^= matrix[b];
+    return result;
+}
+
+// Hash based permutation where every bit only depends on itself and the less significant bits.
+__always_inline__ unsigned int laine_karras_permutation(unsigned int x, unsigned int seed) {
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return x;
+}
+
+// Owen scrambling, i.e. every bit is flipped based on a hash of the more significant bits.
+__always_inline__ unsigned int nested_uniform_scramble(unsigned int x, unsigned int seed) {
+    return reverse_bits(laine_karras_permutation(reverse_bits(x), seed));
+}
+
+__always_inline__ unsigned int hash_combine(unsigned int seed, unsigned int value) {
+    return jenkins_hash(seed ^ (jenkins_hash(value) + 0x9e3779b9u + (seed << 6) + (seed >> 2)));
+}
+
+// Converts to a float in [0, 1), using the 24 most significant bits to avoid rounding up to one.
+__always_inline__ float uint_to_unit_float(unsigned int x) { return (x >> 8) * (1.0f / 16777216.0f); }
+
+struct OwenScrambledSobol final {
+private:
+    unsigned int m_seed;
+
+public:
+    explicit OwenScrambledSobol(unsigned int seed) : m_seed(seed) { }
+
+    // Decorrelates the samples of different pixels by deriving the seed from the pixel coordinates.
+    static __always_inline__ OwenScrambledSobol for_pixel(unsigned int x, unsigned int y, unsigned int seed = 0) {
+        return OwenScrambledSobol(hash_combine(hash_combine(seed, x), y));
+    }
+
+    __always_inline__ unsigned int get_seed() const { return m_seed; }
+
+    __always_inline__ unsigned int sample1ui(unsigned int index, unsigned int dimension) const {
+        unsigned int block = dimension / SOBOL_DIMENSION_COUNT;
+        unsigned int shuffled_index = nested_uniform_scramble(index, hash_combine(m_seed, block));
+        unsigned int x = sobol(shuffled_index, dimension % SOBOL_DIMENSION_COUNT);
+        return nested_uniform_scramble(x, hash_combine(m_seed ^ 0xa511e9b3u, dimension));
+    }
+
+    __always_inline__ float sample1f(unsigned int index, unsigned int dimension) const { return uint_to_unit_float(sample1ui(index, dimension)); }
+    __always_inline__ Vector2f sample2f(unsigned int index, unsigned int dimension) const {
+        return Vector2f(sample1f(index, dimension), sample1f(index, dimension + 1));
+    }
+    __always_inline__ Vector3f sample3f(unsigned int index, unsigned int dimension) const {
+        return Vector3f(sample1f(index, dimension), sample1f(index, dimension + 1), sample1f(index, dimension + 2));
+    }
+
+    // Generates the samples of index_count consecutive indices in dimension_count consecutive dimensions.
+    // The samples are stored pr dimension, i.e. sample i of dimension d is stored at samples[(d - dimension_begin) * index_count + i].
+    // The inner loops over the indices are branchless, so the compiler can vectorize them.
+    void fill(unsigned int index_begin, unsigned int index_count, unsigned int dimension_begin, unsigned int dimension_count, float* samples) const;
+};
+
 } // NS RNG
 } // NS Math
 } // NS Bifrost
@@ -0,0 +1,106 @@
+// Bifrost tables of progressive sample sequences.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#include <Bifrost/Math/SampleTable.h>
+
+#include <Bifrost/Core/BinaryFile.h>
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Math/RNG.h>
+#include <Bifrost/Math/Utils.h>
+
+#include <cstdio>
+
+namespace Bifrost {
+namespace Math {
+
+// File layout: header followed by the samples of all sets.
+static const unsigned int sample_table_magic = 0x4C504D53; // 'SMPL' in little endian.
+static const unsigned int sample_table_format_version = 1;
+
+struct SampleTableHeader {
+    unsigned int type;
+    unsigned int sample_count;
+    unsigned int set_count;
+    unsigned int blue_noise_samples;
+    unsigned int seed;
+};
+
+SampleTable::SampleTable(Type type, unsigned int sample_count, unsigned int set_count, unsigned int blue_noise_samples, unsigned int seed)
+    : m_type(type), m_sample_count(sample_count), m_set_count(set_count), m_blue_noise_samples(blue_noise_samples), m_seed(seed) {
+    if (!is_power_of_two(sample_count) || set_count == 0) {
+        printf("Sample tables require a power of two sample count and at least one set, but %u samples and %u sets were requested.\n", sample_count, set_count);
+        m_sample_count = m_set_count = 0;
+        return;
+    }
+
+    m_samples.resize(size_t(sample_count) * set_count);
+}
+
+SampleTable SampleTable::generate(Type type, unsigned int sample_count, unsigned int set_count, unsigned int blue_noise_samples, unsigned int seed) {
+    SampleTable table = SampleTable(type, sample_count, set_count, blue_noise_samples, seed);
+    if (!table.is_valid())
+        return table;
+
+    Core::Parallel::parallel_for(0, int(set_count), [&](int set) {
+        Vector2f* samples_begin = table.get_samples(set);
+        Vector2f* samples_end = samples_begin + sample_count;
+        unsigned int set_seed = RNG::jenkins_hash(seed + set);
+        if (type == Type::PMJBN)
+            RNG::fill_progressive_multijittered_bluenoise_samples(samples_begin, samples_end, blue_noise_samples, set_seed);
+        else
+            RNG::fill_progressive_multijittered02_samples(samples_begin, samples_end, blue_noise_samples, set_seed);
+    }, 1);
+
+    return table;
+}
+
+bool SampleTable::write(const std::filesystem::path& path) const {
+    if (!is_valid())
+        return false;
+
+    Core::BinaryFileWriter file = Core::BinaryFileWriter(path, sample_table_magic, sample_table_format_version);
+    SampleTableHeader header = { (unsigned int)m_type, m_sample_count, m_set_count, m_blue_noise_samples, m_seed };
+    file.write(header);
+    file.write(m_samples.data(), m_samples.size());
+    return file.is_good();
+}
+
+SampleTable SampleTable::read(const std::filesystem::path& path) {
+    Core::BinaryFileReader file = Core::BinaryFileReader(path, sample_table_magic, sample_table_format_version);
+    SampleTableHeader header;
+    file.read(header);
+    if (!file.is_good() || header.type > (unsigned int)Type::PMJ02BN)
+        return SampleTable();
+
+    unsigned long long total_sample_count = (unsigned long long)header.sample_count * header.set_count;
+    file.expect_remaining_size(total_sample_count * sizeof(Vector2f));
+    if (total_sample_count == 0 || !file.is_good())
+        return SampleTable();
+
+    SampleTable table = SampleTable(Type(header.type), header.sample_count, header.set_count, header.blue_noise_samples, header.seed);
+    if (!table.is_valid())
+        return SampleTable();
+    file.read(table.m_samples.data(), table.m_samples.size());
+    return file.is_good() ? table : SampleTable();
+}
+
+SampleTable SampleTable::load_or_generate(const std::filesystem::path& path, Type type, unsigned int sample_count, unsigned int set_count,
+                                          unsigned int blue_noise_samples, unsigned int seed) {
+    SampleTable table = read(path);
+    if (table.is_valid() && table.get_type() == type && table.get_sample_count() == sample_count && table.get_set_count() == set_count &&
+        table.get_blue_noise_samples() == blue_noise_samples && table.get_seed() == seed)
+        return table;
+
+    table = generate(type, sample_count, set_count, blue_noise_samples, seed);
+    if (!table.write(path))
+        printf("Could not write sample table to '%s'\n", path.string().c_str());
+    return table;
+}
+
+} // NS Math
+} // NS Bifrost
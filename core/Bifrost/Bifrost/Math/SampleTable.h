@@ -0,0 +1,82 @@
+// Bifrost tables of progressive sample sequences.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_SAMPLE_TABLE_H_
+#define _BIFROST_MATH_SAMPLE_TABLE_H_
+
+#include <Bifrost/Math/Vector.h>
+
+#include <filesystem>
+#include <vector>
+
+namespace Bifrost {
+namespace Math {
+
+// ------------------------------------------------------------------------------------------------
+// Table of independent sets of progressive two-dimensional samples.
+// Renderers index a set, fx by pixel or dimension, and use the first N samples of it for any N.
+// The sets are stored consecutively, so the samples of set s start at s * sample_count.
+// ------------------------------------------------------------------------------------------------
+class SampleTable final {
+public:
+    enum class Type : unsigned int {
+        PMJBN,  // Progressive multi-jittered samples with a blue noise approximation.
+        PMJ02BN // Progressive multi-jittered (0,2) samples with a blue noise approximation.
+    };
+
+    SampleTable() = default;
+    SampleTable(Type type, unsigned int sample_count, unsigned int set_count, unsigned int blue_noise_samples, unsigned int seed);
+
+    //*********************************************************************************************
+    // Getters.
+    //*********************************************************************************************
+    inline bool is_valid() const { return !m_samples.empty(); }
+    inline Type get_type() const { return m_type; }
+    inline unsigned int get_sample_count() const { return m_sample_count; }
+    inline unsigned int get_set_count() const { return m_set_count; }
+    inline unsigned int get_blue_noise_samples() const { return m_blue_noise_samples; }
+    inline unsigned int get_seed() const { return m_seed; }
+
+    inline const Vector2f* get_samples(unsigned int set = 0) const { return m_samples.data() + set * m_sample_count; }
+    inline Vector2f* get_samples(unsigned int set = 0) { return m_samples.data() + set * m_sample_count; }
+    inline Vector2f get_sample(unsigned int set, unsigned int sample_index) const { return m_samples[set * m_sample_count + sample_index]; }
+
+    //*********************************************************************************************
+    // Generation.
+    // The sets are generated in parallel. Each set is seeded by hashing the seed and the set index,
+    // so the result is independent of the number of threads and the first sets of a table
+    // are identical to the sets of a smaller table with the same seed.
+    // The sample count must be a power of two.
+    //*********************************************************************************************
+    static SampleTable generate(Type type, unsigned int sample_count, unsigned int set_count,
+                                unsigned int blue_noise_samples = 4, unsigned int seed = 19349669);
+
+    //*********************************************************************************************
+    // Binary cache.
+    // Reading fails if the file is missing, corrupt or written by a different format version.
+    //*********************************************************************************************
+    bool write(const std::filesystem::path& path) const;
+    static SampleTable read(const std::filesystem::path& path);
+
+    // Reads the table from path or generates and writes it if the file does not contain a table generated with the same parameters.
+    static SampleTable load_or_generate(const std::filesystem::path& path, Type type, unsigned int sample_count, unsigned int set_count,
+                                        unsigned int blue_noise_samples = 4, unsigned int seed = 19349669);
+
+private:
+    Type m_type = Type::PMJBN;
+    unsigned int m_sample_count = 0;
+    unsigned int m_set_count = 0;
+    unsigned int m_blue_noise_samples = 0;
+    unsigned int m_seed = 0;
+    std::vector<Vector2f> m_samples;
+};
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_SAMPLE_TABLE_H_
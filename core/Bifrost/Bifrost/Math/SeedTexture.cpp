@@ -0,0 +1,264 @@
+// Bifrost screen space seed textures.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#include <Bifrost/Math/SeedTexture.h>
+
+#include <Bifrost/Core/BinaryFile.h>
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Math/RNG.h>
+#include <Bifrost/Math/Utils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace Bifrost {
+namespace Math {
+namespace RNG {
+
+// File layout: header followed by the seeds.
+static const unsigned int seed_texture_magic = 0x44454553; // 'SEED' in little endian.
+static const unsigned int seed_texture_format_version = 1;
+
+struct SeedTextureHeader {
+    unsigned int width;
+    unsigned int height;
+    unsigned int sample_count;
+};
+
+// Heaviside function that is one on the positive side of a line through the unit square.
+struct HeavisideIntegrand {
+    Vector2f point;
+    Vector2f normal;
+    float reference;
+
+    inline float evaluate(Vector2f sample) const { return dot(sample - point, normal) > 0.0f ? 1.0f : 0.0f; }
+};
+
+SeedTexture::SeedTexture(unsigned int width, unsigned int height, unsigned int sample_count)
+    : m_width(width), m_height(height), m_sample_count(sample_count), m_seeds(width * height, 0u) {}
+
+SeedTexture SeedTexture::optimize(const OptimizationSettings& settings, OptimizationReport* report) {
+    auto start_time = std::chrono::steady_clock::now();
+
+    const int block_size = BLOCK_SIZE, radius = NEIGHBOURHOOD_RADIUS;
+    int width = int(settings.width), height = int(settings.height);
+    if (width == 0 || height == 0 || width % (2 * block_size) != 0 || height % (2 * block_size) != 0 || settings.sample_count == 0) {
+        printf("Seed textures must have a size that is a multiple of %u and at least one sample, but a %ux%u texture with %u samples was requested.\n",
+               2 * block_size, settings.width, settings.height, settings.sample_count);
+        return SeedTexture();
+    }
+
+    SeedTexture texture = SeedTexture(width, height, settings.sample_count);
+    int pixel_count = width * height;
+    for (int p = 0; p < pixel_count; ++p)
+        texture.m_seeds[p] = hash_combine(settings.seed, p);
+
+    // Random integrands with references computed by quasi Monte Carlo.
+    auto integrands = std::vector<HeavisideIntegrand>(settings.integrand_count);
+    auto rng = LinearCongruential(settings.seed);
+    for (HeavisideIntegrand& integrand : integrands) {
+        integrand.point = rng.sample2f();
+        float angle = 2.0f * PI<float>() * rng.sample1f();
+        integrand.normal = Vector2f(cosf(angle), sinf(angle));
+    }
+    Core::Parallel::parallel_for(0, int(settings.integrand_count), [&](int i) {
+        const unsigned int reference_sample_count = 65536;
+        unsigned int inside_count = 0;
+        for (unsigned int s = 0; s < reference_sample_count; ++s)
+            inside_count += unsigned int(integrands[i].evaluate(Vector2f(sobol(s, 0) * uint_normalizer, sobol(s, 1) * uint_normalizer)));
+        integrands[i].reference = inside_count / float(reference_sample_count);
+    }, 1);
+
+    // The errors of a pixel for all integrands and all power of two sample counts up to and including the sample count.
+    int level_count = 1;
+    while ((1u << level_count) <= settings.sample_count)
+        ++level_count;
+    int error_count = int(settings.integrand_count) * level_count;
+    auto errors = std::vector<float>(pixel_count * error_count);
+    Core::Parallel::parallel_for(0, pixel_count, [&](int p) {
+        auto sampler = OwenScrambledSobol(texture.m_seeds[p]);
+        float* pixel_errors = errors.data() + p * error_count;
+        for (int i = 0; i < int(settings.integrand_count); ++i) {
+            float sum = 0.0f;
+            unsigned int next_level_sample_count = 1;
+            int level = 0;
+            for (unsigned int s = 0; level < level_count; ++s) {
+                sum += integrands[i].evaluate(sampler.sample2f(s, 0));
+                if (s + 1 == next_level_sample_count) {
+                    pixel_errors[i * level_count + level++] = sum / next_level_sample_count - integrands[i].reference;
+                    next_level_sample_count *= 2;
+                }
+            }
+        }
+    });
+
+    // Normalize the errors, such that all integrands and sample counts contribute equally to the energy.
+    // The seeds are only swapped, so the normalization is valid throughout the optimization.
+    for (int e = 0; e < error_count; ++e) {
+        double squared_error_sum = 0.0;
+        for (int p = 0; p < pixel_count; ++p)
+            squared_error_sum += errors[p * error_count + e] * errors[p * error_count + e];
+        float rms = float(sqrt(squared_error_sum / pixel_count));
+        float normalizer = rms > 0.0f ? 1.0f / rms : 0.0f;
+        for (int p = 0; p < pixel_count; ++p)
+            errors[p * error_count + e] *= normalizer;
+    }
+
+    // Spatial weights of the neighbourhood.
+    const int window_size = 2 * radius + 1;
+    float pixel_weights[window_size * window_size];
+    for (int y = -radius; y <= radius; ++y)
+        for (int x = -radius; x <= radius; ++x)
+            pixel_weights[(x + radius) + (y + radius) * window_size] = expf(-(x * x + y * y) / (settings.pixel_sigma * settings.pixel_sigma));
+
+    // Energy of the pixel at (x, y) if its errors were pixel_errors, i.e. the weighted correlation of its errors
+    // with the errors of its neighbours. The pixel at excluded_index is ignored, as its pair energy with the pixel
+    // is unchanged when the two are swapped.
+    float error_normalizer = 1.0f / error_count;
+    auto pixel_energy = [&](int x, int y, const float* pixel_errors, int excluded_index) -> float {
+        float energy = 0.0f;
+        for (int dy = -radius; dy <= radius; ++dy)
+            for (int dx = -radius; dx <= radius; ++dx) {
+                int neighbour_index = (x + dx + width) % width + ((y + dy + height) % height) * width;
+                if ((dx == 0 && dy == 0) || neighbour_index == excluded_index)
+                    continue;
+                const float* neighbour_errors = errors.data() + neighbour_index * error_count;
+                float correlation = 0.0f;
+                for (int e = 0; e < error_count; ++e)
+                    correlation += pixel_errors[e] * neighbour_errors[e];
+                energy += pixel_weights[(dx + radius) + (dy + radius) * window_size] * correlation * error_normalizer;
+            }
+        return energy;
+    };
+
+    auto texture_energy = [&]() -> double {
+        double energy = Core::Parallel::parallel_reduce(0, pixel_count, 0.0, [&](int begin, int end, double sum) -> double {
+            for (int p = begin; p < end; ++p)
+                sum += pixel_energy(p % width, p / width, errors.data() + p * error_count, -1);
+            return sum;
+        }, [](double lhs, double rhs) { return lhs + rhs; }, width);
+        return energy / pixel_count;
+    };
+
+    double initial_energy = report != nullptr ? texture_energy() : 0.0;
+
+    // Swap pixels inside blocks. Blocks of the same color in a 2x2 checkerboard pattern are separated by a block,
+    // so their neighbourhoods do not overlap and they can be optimized in parallel.
+    int block_count_x = width / block_size, block_count_y = height / block_size;
+    int color_block_count = block_count_x * block_count_y / 4;
+    auto accepted_swap_counts = std::vector<unsigned int>(color_block_count, 0u);
+    for (unsigned int pass = 0; pass < settings.pass_count; ++pass) {
+        unsigned int pass_seed = hash_combine(settings.seed, pass);
+        auto pass_rng = LinearCongruential(pass_seed);
+        int offset_x = pass_rng.sample1ui() % block_size, offset_y = pass_rng.sample1ui() % block_size;
+
+        for (int color = 0; color < 4; ++color) {
+            Core::Parallel::parallel_for(0, color_block_count, [&](int b) {
+                int block_x = 2 * (b % (block_count_x / 2)) + (color & 1);
+                int block_y = 2 * (b / (block_count_x / 2)) + (color >> 1);
+                int block_index = block_x + block_y * block_count_x;
+                auto block_rng = LinearCongruential(hash_combine(pass_seed, block_index));
+
+                for (unsigned int s = 0; s < settings.swap_count_pr_block; ++s) {
+                    unsigned int local_a = block_rng.sample1ui() % (block_size * block_size);
+                    unsigned int local_b = block_rng.sample1ui() % (block_size * block_size);
+                    if (local_a == local_b)
+                        continue;
+
+                    int ax = (offset_x + block_x * block_size + local_a % block_size) % width;
+                    int ay = (offset_y + block_y * block_size + local_a / block_size) % height;
+                    int bx = (offset_x + block_x * block_size + local_b % block_size) % width;
+                    int by = (offset_y + block_y * block_size + local_b / block_size) % height;
+                    int a_index = ax + ay * width, b_index = bx + by * width;
+                    float* a_errors = errors.data() + a_index * error_count;
+                    float* b_errors = errors.data() + b_index * error_count;
+
+                    float current_energy = pixel_energy(ax, ay, a_errors, b_index) + pixel_energy(bx, by, b_errors, a_index);
+                    float swapped_energy = pixel_energy(ax, ay, b_errors, b_index) + pixel_energy(bx, by, a_errors, a_index);
+                    if (swapped_energy < current_energy) {
+                        std::swap_ranges(a_errors, a_errors + error_count, b_errors);
+                        std::swap(texture.m_seeds[a_index], texture.m_seeds[b_index]);
+                        ++accepted_swap_counts[b];
+                    }
+                }
+            }, 1);
+        }
+    }
+
+    if (report != nullptr) {
+        report->initial_energy = initial_energy;
+        report->energy = texture_energy();
+        report->accepted_swap_count = 0;
+        for (unsigned int accepted_swap_count : accepted_swap_counts)
+            report->accepted_swap_count += accepted_swap_count;
+        report->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    }
+
+    return texture;
+}
+
+double SeedTexture::filtered_rms_error(const SeedTexture& texture, unsigned int sample_count) {
+    auto integrand = [](Vector2f s) -> float { return (s.x - 0.5f) * (s.x - 0.5f) + (s.y - 0.5f) * (s.y - 0.5f) < 0.16f ? 1.0f : 0.0f; };
+    float reference = PI<float>() * 0.16f;
+
+    int width = texture.get_width(), height = texture.get_height();
+    auto errors = std::vector<float>(width * height);
+    Core::Parallel::parallel_for(0, width * height, [&](int i) {
+        auto sampler = OwenScrambledSobol(texture.m_seeds[i]);
+        float estimate = 0.0f;
+        for (unsigned int s = 0; s < sample_count; ++s)
+            estimate += integrand(sampler.sample2f(s, 0));
+        errors[i] = estimate / sample_count - reference;
+    });
+
+    double squared_error_sum = 0.0;
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x) {
+            float filtered_error = 0.0f;
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx)
+                    filtered_error += errors[(x + dx + width) % width + ((y + dy + height) % height) * width];
+            filtered_error /= 9.0f;
+            squared_error_sum += filtered_error * filtered_error;
+        }
+    return sqrt(squared_error_sum / (width * height));
+}
+
+bool SeedTexture::write(const std::filesystem::path& path) const {
+    if (!is_valid())
+        return false;
+
+    Core::BinaryFileWriter file = Core::BinaryFileWriter(path, seed_texture_magic, seed_texture_format_version);
+    SeedTextureHeader header = { m_width, m_height, m_sample_count };
+    file.write(header);
+    file.write(m_seeds.data(), m_seeds.size());
+    return file.is_good();
+}
+
+SeedTexture SeedTexture::read(const std::filesystem::path& path) {
+    Core::BinaryFileReader file = Core::BinaryFileReader(path, seed_texture_magic, seed_texture_format_version);
+    SeedTextureHeader header;
+    file.read(header);
+    if (!file.is_good())
+        return SeedTexture();
+
+    unsigned long long pixel_count = (unsigned long long)header.width * header.height;
+    file.expect_remaining_size(pixel_count * sizeof(unsigned int));
+    if (pixel_count == 0 || !file.is_good())
+        return SeedTexture();
+
+    SeedTexture texture = SeedTexture(header.width, header.height, header.sample_count);
+    file.read(texture.m_seeds.data(), texture.m_seeds.size());
+    return file.is_good() ? texture : SeedTexture();
+}
+
+} // NS RNG
+} // NS Math
+} // NS Bifrost
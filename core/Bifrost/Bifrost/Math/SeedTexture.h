@@ -0,0 +1,106 @@
+// Bifrost screen space seed textures.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_SEED_TEXTURE_H_
+#define _BIFROST_MATH_SEED_TEXTURE_H_
+
+#include <filesystem>
+#include <vector>
+
+namespace Bifrost {
+namespace Math {
+namespace RNG {
+
+// ------------------------------------------------------------------------------------------------
+// Tileable texture of pr pixel seeds for OwenScrambledSobol.
+// The seeds can be optimized such that the Monte Carlo error of the first samples is distributed
+// as blue noise in screen space, which is perceptually less visible than white noise.
+// A Low-Discrepancy Sampler that Distributes Monte Carlo Errors as a Blue Noise in Screen Space, Heitz et al., 2019.
+// Distributing Monte Carlo Errors as a Blue Noise in Screen Space by Permuting Pixel Seeds Between Frames, Heitz and Belcour, 2019.
+// ------------------------------------------------------------------------------------------------
+class SeedTexture final {
+public:
+    // Pixels are only swapped inside blocks of BLOCK_SIZE x BLOCK_SIZE pixels, such that every other block
+    // can be optimized in parallel. The blocks are shifted toroidally between passes.
+    static const int BLOCK_SIZE = 8;
+    static const int NEIGHBOURHOOD_RADIUS = 3;
+
+    // --------------------------------------------------------------------------------------------
+    // Settings for optimizing textures.
+    // The error of a pixel is measured by integrating integrand_count random 2D heaviside functions with
+    // the first 1, 2, 4, ..., sample_count samples of the first two dimensions of its sampler.
+    // The energy of the texture is the correlation of the errors of neighbouring pixels weighted by a
+    // gaussian with standard deviation pixel_sigma, which is the energy of the gaussian filtered error.
+    // The width and height must be multiples of 2 * BLOCK_SIZE.
+    // --------------------------------------------------------------------------------------------
+    struct OptimizationSettings {
+        unsigned int width = 64;
+        unsigned int height = 64;
+        unsigned int sample_count = 4;
+        unsigned int integrand_count = 32;
+        unsigned int pass_count = 256;
+        unsigned int swap_count_pr_block = 32;
+        float pixel_sigma = 2.1f;
+        unsigned int seed = 19349669;
+    };
+
+    struct OptimizationReport {
+        double seconds;
+        double initial_energy;
+        double energy;
+        unsigned int accepted_swap_count;
+    };
+
+    SeedTexture() = default;
+    SeedTexture(unsigned int width, unsigned int height, unsigned int sample_count);
+
+    //*********************************************************************************************
+    // Getters.
+    //*********************************************************************************************
+    inline bool is_valid() const { return !m_seeds.empty(); }
+    inline unsigned int get_width() const { return m_width; }
+    inline unsigned int get_height() const { return m_height; }
+    inline unsigned int get_sample_count() const { return m_sample_count; }
+
+    inline const unsigned int* get_seeds() const { return m_seeds.data(); }
+    inline unsigned int* get_seeds() { return m_seeds.data(); }
+
+    // The texture is tiled, so any pixel coordinate is valid.
+    inline unsigned int get_seed(unsigned int x, unsigned int y) const { return m_seeds[(x % m_width) + (y % m_height) * m_width]; }
+
+    //*********************************************************************************************
+    // Optimization.
+    // Initializes the seeds with white noise and then greedily swaps seeds within blocks when the swap lowers
+    // the energy of the texture. The optimization is multi-threaded and independent of the number of threads.
+    //*********************************************************************************************
+    static SeedTexture optimize(const OptimizationSettings& settings, OptimizationReport* report = nullptr);
+
+    // RMS of the 3x3 box filtered error when integrating a disc with the first sample_count samples of every pixel.
+    // The integrand is not one of the heaviside functions used in the optimization, so it measures how well the
+    // optimization generalizes. White noise errors are reduced by a factor of three by the filter.
+    static double filtered_rms_error(const SeedTexture& texture, unsigned int sample_count);
+
+    //*********************************************************************************************
+    // Binary file.
+    // Reading fails if the file is missing, corrupt or written by a different format version.
+    //*********************************************************************************************
+    bool write(const std::filesystem::path& path) const;
+    static SeedTexture read(const std::filesystem::path& path);
+
+private:
+    unsigned int m_width = 0;
+    unsigned int m_height = 0;
+    unsigned int m_sample_count = 0;
+    std::vector<unsigned int> m_seeds;
+};
+
+} // NS RNG
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_SEED_TEXTURE_H_
@@ -0,0 +1,168 @@
+// Bifrost real spherical harmonics.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_SPHERICAL_HARMONICS_H_
+#define _BIFROST_MATH_SPHERICAL_HARMONICS_H_
+
+#include <Bifrost/Core/Defines.h>
+#include <Bifrost/Math/Color.h>
+#include <Bifrost/Math/Constants.h>
+#include <Bifrost/Math/Vector.h>
+
+#include <cmath>
+
+namespace Bifrost {
+namespace Math {
+
+// ------------------------------------------------------------------------------------------------
+// Real spherical harmonics with up to three bands, i.e. order 3 and nine coefficients.
+// The coefficients are ordered by band, [Y00, Y1-1, Y10, Y11, Y2-2, Y2-1, Y20, Y21, Y22].
+// The band index l of coefficient i is floor(sqrt(i)).
+// See Sloan, Stupid Spherical Harmonics (SH) Tricks, 2008, and
+// Ramamoorthi and Hanrahan, An Efficient Representation for Irradiance Environment Maps, 2001.
+// ------------------------------------------------------------------------------------------------
+template <typename T, int ORDER>
+struct SphericalHarmonics final {
+    static_assert(1 <= ORDER && ORDER <= 3, "Only spherical harmonics with one to three bands are supported.");
+
+    static const int COEFFICIENT_COUNT = ORDER * ORDER;
+
+    T coefficients[COEFFICIENT_COUNT];
+
+    //*********************************************************************************************
+    // Constructors.
+    //*********************************************************************************************
+    SphericalHarmonics() = default;
+
+    static __always_inline__ SphericalHarmonics<T, ORDER> zero() {
+        SphericalHarmonics<T, ORDER> res;
+        for (int i = 0; i < COEFFICIENT_COUNT; ++i)
+            res.coefficients[i] = T(0.0f);
+        return res;
+    }
+
+    //*********************************************************************************************
+    // Basis.
+    //*********************************************************************************************
+
+    // Evaluates the basis functions in the normalized direction.
+    static __always_inline__ void evaluate_basis(Vector3f direction, float* basis) {
+        float x = direction.x, y = direction.y, z = direction.z;
+        basis[0] = 0.282094792f;
+        if (ORDER > 1) {
+            basis[1] = 0.488602512f * y;
+            basis[2] = 0.488602512f * z;
+            basis[3] = 0.488602512f * x;
+        }
+        if (ORDER > 2) {
+            basis[4] = 1.092548431f * x * y;
+            basis[5] = 1.092548431f * y * z;
+            basis[6] = 0.315391565f * (3.0f * z * z - 1.0f);
+            basis[7] = 1.092548431f * x * z;
+            basis[8] = 0.546274215f * (x * x - y * y);
+        }
+    }
+
+    static __always_inline__ int band_of(int coefficient_index) {
+        return coefficient_index == 0 ? 0 : (coefficient_index < 4 ? 1 : 2);
+    }
+
+    //*********************************************************************************************
+    // Projection.
+    //*********************************************************************************************
+
+    // Adds the contribution of a value in the given direction, weighted by fx the solid angle it covers.
+    __always_inline__ void add(Vector3f direction, T value, float weight) {
+        float basis[COEFFICIENT_COUNT];
+        evaluate_basis(direction, basis);
+        for (int i = 0; i < COEFFICIENT_COUNT; ++i)
+            coefficients[i] += value * (basis[i] * weight);
+    }
+
+    __always_inline__ SphericalHarmonics<T, ORDER>& operator+=(const SphericalHarmonics<T, ORDER>& rhs) {
+        for (int i = 0; i < COEFFICIENT_COUNT; ++i)
+            coefficients[i] += rhs.coefficients[i];
+        return *this;
+    }
+
+    __always_inline__ SphericalHarmonics<T, ORDER> operator+(const SphericalHarmonics<T, ORDER>& rhs) const {
+        SphericalHarmonics<T, ORDER> res = *this;
+        return res += rhs;
+    }
+
+    //*********************************************************************************************
+    // Windowing.
+    // Truncating the expansion of a function with high frequencies, fx a small bright light source,
+    // causes ringing, which can produce negative values. Windowing attenuates the higher bands to reduce ringing.
+    // The window width w is the band where the window reaches zero and should be larger than the highest band.
+    //*********************************************************************************************
+
+    // Scales band l by the Hanning window (1 + cos(pi * l / w)) / 2.
+    inline SphericalHarmonics<T, ORDER> hanning_windowed(float window_width) const {
+        return windowed([=](int band) -> float {
+            return band < window_width ? 0.5f * (1.0f + cosf(PI<float>() * band / window_width)) : 0.0f;
+        });
+    }
+
+    // Scales band l by the Lanczos sigma factor sinc(pi * l / w).
+    inline SphericalHarmonics<T, ORDER> lanczos_windowed(float window_width) const {
+        return windowed([=](int band) -> float {
+            if (band == 0)
+                return 1.0f;
+            float x = PI<float>() * band / window_width;
+            return band < window_width ? sinf(x) / x : 0.0f;
+        });
+    }
+
+    template <typename WindowFunction>
+    inline SphericalHarmonics<T, ORDER> windowed(WindowFunction window_function) const {
+        SphericalHarmonics<T, ORDER> res;
+        for (int i = 0; i < COEFFICIENT_COUNT; ++i)
+            res.coefficients[i] = coefficients[i] * window_function(band_of(i));
+        return res;
+    }
+
+    //*********************************************************************************************
+    // Evaluation.
+    //*********************************************************************************************
+
+    // Reconstructs the projected function in the given direction.
+    __always_inline__ T evaluate(Vector3f direction) const {
+        float basis[COEFFICIENT_COUNT];
+        evaluate_basis(direction, basis);
+        T res = coefficients[0] * basis[0];
+        for (int i = 1; i < COEFFICIENT_COUNT; ++i)
+            res += coefficients[i] * basis[i];
+        return res;
+    }
+
+    // Convolves the projected radiance with the clamped cosine lobe around the normal, returning the irradiance.
+    __always_inline__ T evaluate_irradiance(Vector3f normal) const {
+        // The zonal harmonics coefficients of the clamped cosine, pi, 2pi/3 and pi/4, for band 0, 1 and 2.
+        const float cosine_lobe[3] = { PI<float>(), 2.0f * PI<float>() / 3.0f, 0.25f * PI<float>() };
+        float basis[COEFFICIENT_COUNT];
+        evaluate_basis(normal, basis);
+        T res = coefficients[0] * (basis[0] * cosine_lobe[0]);
+        for (int i = 1; i < COEFFICIENT_COUNT; ++i)
+            res += coefficients[i] * (basis[i] * cosine_lobe[band_of(i)]);
+        return res;
+    }
+
+    // The radiance reflected by a white Lambertian surface with the given normal, i.e. irradiance / pi.
+    __always_inline__ T evaluate_diffuse(Vector3f normal) const {
+        return evaluate_irradiance(normal) * (1.0f / PI<float>());
+    }
+};
+
+typedef SphericalHarmonics<RGB, 2> SphericalHarmonics2RGB;
+typedef SphericalHarmonics<RGB, 3> SphericalHarmonics3RGB;
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_SPHERICAL_HARMONICS_H_
@@ -10,6 +10,11 @@
 #define _BIFROST_MATH_STATISTICS_H_
 
 #include <Bifrost/Core/Defines.h>
+#include <Bifrost/Core/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace Bifrost {
 namespace Math {
@@ -18,45 +23,42 @@ namespace Math {
 // Statistics of a list of values.
 // Contains the minimum, maximum, mean and the variance.
 // See https://en.wikipedia.org/wiki/Moment_(mathematics) for a list of other interesting values.
+// The moments are accumulated in a single pass using Welford's algorithm and merged using Chan et al.'s
+// pairwise update, see https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance.
+// The running sums are accumulated in double precision with Neumaier compensation.
 //-------------------------------------------------------------------------------------------------
 template <typename T>
 struct Statistics final {
     T minimum;
     T maximum;
     T mean;
-    T m2;
+    T m2; // The second raw moment, i.e. the mean of the squared values.
     size_t sample_count;
 
     //---------------------------------------------------------------------------------------------
     // Constructors
     //---------------------------------------------------------------------------------------------
     Statistics()
-        : minimum(T(-1e30)), maximum(T(1e30)), mean(0), m2(0), sample_count(0) {}
+        : minimum(std::numeric_limits<T>::max()), maximum(std::numeric_limits<T>::lowest()), mean(0), m2(0), sample_count(0)
+        , m_mean(0.0), m_mean_compensation(0.0), m_squared_deviations(0.0), m_squared_deviations_compensation(0.0) {}
 
+    // Computes the statistics of predicate(itr) for all itr in [first, last).
+    // Ranges are accumulated in parallel, so the predicate must be safe to call concurrently.
+    // The result is independent of the number of threads.
     template <typename RandomAccessItr, class UnaryPredicate>
     Statistics(RandomAccessItr first, RandomAccessItr last, UnaryPredicate predicate) {
-        sample_count = last - first;
-
-        minimum = 1e30f;
-        maximum = -1e30f;
-
-        double* means = new double[sample_count];
-        double* means_sqrd = new double[sample_count];
-        while (first != last) {
-            T val = T(predicate(first));
-            minimum = std::min(minimum, val);
-            maximum = std::max(maximum, val);
-            *means = val;
-            *means_sqrd = val* val;
-            ++first; ++means; ++means_sqrd;
-        }
-        means -= sample_count; means_sqrd -= sample_count;
-
-        mean = T(sort_and_pairwise_summation(means, means + sample_count) / sample_count);
-        m2 = T(sort_and_pairwise_summation(means_sqrd, means_sqrd + sample_count) / sample_count);
-
-        delete[] means;
-        delete[] means_sqrd;
+        auto accumulate_range = [&](int range_begin, int range_end, Statistics stats) -> Statistics {
+            for (int i = range_begin; i < range_end; ++i)
+                stats.add(T(predicate(first + i)));
+            return stats;
+        };
+        auto merge = [](Statistics lhs, const Statistics& rhs) -> Statistics {
+            lhs.merge_with(rhs);
+            return lhs;
+        };
+
+        const int grain_size = 4096;
+        *this = Core::Parallel::parallel_reduce(0, int(last - first), Statistics(), accumulate_range, merge, grain_size);
     }
 
     template <typename RandomAccessItr>
@@ -67,7 +69,7 @@ struct Statistics final {
     // Getters
     //---------------------------------------------------------------------------------------------
     __always_inline__ T rms() const { return (T)sqrt(m2); }
-    __always_inline__ T variance() const { return m2 - mean * mean; }
+    __always_inline__ T variance() const { return sample_count == 0 ? T(0) : T((m_squared_deviations + m_squared_deviations_compensation) / sample_count); }
     __always_inline__ T standard_deviation() const { return (T)sqrt(variance()); }
 
     //---------------------------------------------------------------------------------------------
@@ -77,20 +79,34 @@ struct Statistics final {
         minimum = std::min(minimum, v);
         maximum = std::max(maximum, v);
 
-        size_t total_sample_count = sample_count + 1;
-        mean = (mean * sample_count + v) / total_sample_count;
-        m2 = (m2 * sample_count + v * v) / total_sample_count;
-        sample_count = total_sample_count;
+        ++sample_count;
+        double value = double(v);
+        double delta = value - precise_mean();
+        compensated_add(m_mean, m_mean_compensation, delta / sample_count);
+        compensated_add(m_squared_deviations, m_squared_deviations_compensation, delta * (value - precise_mean()));
+        update_moments();
     }
 
-    inline void merge_with(Statistics other) {
+    inline void merge_with(const Statistics& other) {
+        if (other.sample_count == 0)
+            return;
+        if (sample_count == 0) {
+            *this = other;
+            return;
+        }
+
         minimum = std::min(minimum, other.minimum);
         maximum = std::max(maximum, other.maximum);
-        
+
         size_t total_sample_count = sample_count + other.sample_count;
-        mean = (mean * sample_count + other.mean * other.sample_count) / total_sample_count;
-        m2 = (m2 * sample_count + other.m2 * other.sample_count) / total_sample_count;
+        double delta = other.precise_mean() - precise_mean();
+        double other_weight = double(other.sample_count) / total_sample_count;
+        compensated_add(m_mean, m_mean_compensation, delta * other_weight);
+        compensated_add(m_squared_deviations, m_squared_deviations_compensation, other.m_squared_deviations);
+        compensated_add(m_squared_deviations, m_squared_deviations_compensation, other.m_squared_deviations_compensation);
+        compensated_add(m_squared_deviations, m_squared_deviations_compensation, delta * delta * sample_count * other_weight);
         sample_count = total_sample_count;
+        update_moments();
     }
 
     template <typename RandomAccessItr>
@@ -100,6 +116,30 @@ struct Statistics final {
             res.merge_with(*first);
         return res;
     }
+
+private:
+    // Running mean and sum of squared deviations from the mean with their compensation terms.
+    double m_mean, m_mean_compensation;
+    double m_squared_deviations, m_squared_deviations_compensation;
+
+    __always_inline__ double precise_mean() const { return m_mean + m_mean_compensation; }
+
+    // Neumaier's improved Kahan summation. The lost low order bits are accumulated in the compensation term.
+    static __always_inline__ void compensated_add(double& sum, double& compensation, double value) {
+        double new_sum = sum + value;
+        if (std::abs(sum) >= std::abs(value))
+            compensation += (sum - new_sum) + value;
+        else
+            compensation += (value - new_sum) + sum;
+        sum = new_sum;
+    }
+
+    inline void update_moments() {
+        double precise_mean = this->precise_mean();
+        double variance = (m_squared_deviations + m_squared_deviations_compensation) / sample_count;
+        mean = T(precise_mean);
+        m2 = T(variance + precise_mean * precise_mean);
+    }
 };
 
 } // NS Math
@@ -0,0 +1,140 @@
+// Bifrost fitting of parameter tables.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_TABLE_FITTING_H_
+#define _BIFROST_MATH_TABLE_FITTING_H_
+
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Math/NelderMead.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace Bifrost {
+namespace Math {
+
+// ------------------------------------------------------------------------------------------------
+// The fitted parameters of a table cell.
+// ------------------------------------------------------------------------------------------------
+template <int DIM>
+struct TableFit {
+    float parameters[DIM];
+    float error;
+    NelderMeadStatistics statistics;
+};
+
+struct TableFittingSettings {
+    int width;
+    int height;
+    float simplex_size = 0.05f;
+    float tolerance = 1e-5f;
+    int max_iterations = 200;
+    // Number of starting points that are refined pr cell. The candidate starting points are the initial guess
+    // and the fits of the left and lower neighbouring cells, ordered by their error.
+    int start_count = 1;
+};
+
+struct TableFittingReport {
+    double seconds;
+    double mean_error;
+    float max_error;
+    double mean_iteration_count;
+    double mean_evaluation_count;
+    int unconverged_cell_count;
+};
+
+// ------------------------------------------------------------------------------------------------
+// Fits DIM parameters to every cell in a width x height table by minimizing the error function with nelder_mead.
+// Cells are fitted in parallel in anti-diagonal wavefronts, such that the left, (x-1, y), and lower, (x, y-1),
+// neighbours of a cell have been fitted before the cell. The neighbouring fits are used to warm start the cell,
+// which both reduces the number of iterations and the variation between neighbouring cells.
+// initial_guess(x, y, parameters) initializes the parameters of a cell without neighbours to warm start from
+// and error_function(x, y, parameters) -> float returns the error of the parameters in the cell.
+// Both must be safe to call concurrently. The error function may move the parameters into their valid domain.
+// The fits are stored in fits[x + y * width].
+// ------------------------------------------------------------------------------------------------
+template <int DIM, typename InitialGuess, typename ErrorFunction>
+TableFittingReport fit_table(const TableFittingSettings& settings, TableFit<DIM>* fits, InitialGuess initial_guess, ErrorFunction error_function) {
+    auto start_time = std::chrono::steady_clock::now();
+
+    int width = settings.width, height = settings.height;
+    for (int diagonal = 0; diagonal < width + height - 1; ++diagonal) {
+        int y_begin = std::max(0, diagonal - width + 1);
+        int y_end = std::min(height, diagonal + 1);
+        Core::Parallel::parallel_for(y_begin, y_end, [&](int y) {
+            int x = diagonal - y;
+
+            // Gather candidate starting points.
+            const int MAX_CANDIDATE_COUNT = 3;
+            float candidates[MAX_CANDIDATE_COUNT][DIM];
+            float candidate_errors[MAX_CANDIDATE_COUNT];
+            int candidate_count = 0;
+            auto add_candidate = [&](const float* parameters) {
+                float* candidate = candidates[candidate_count];
+                std::copy(parameters, parameters + DIM, candidate);
+                candidate_errors[candidate_count++] = error_function(x, y, candidate);
+            };
+            if (x > 0)
+                add_candidate(fits[x - 1 + y * width].parameters);
+            if (y > 0)
+                add_candidate(fits[x + (y - 1) * width].parameters);
+            if (candidate_count < settings.start_count || candidate_count == 0) {
+                float guess[DIM];
+                initial_guess(x, y, guess);
+                add_candidate(guess);
+            }
+
+            // Refine the best candidates and keep the best fit.
+            int candidate_indices[MAX_CANDIDATE_COUNT] = { 0, 1, 2 };
+            std::sort(candidate_indices, candidate_indices + candidate_count,
+                      [&](int lhs, int rhs) { return candidate_errors[lhs] < candidate_errors[rhs]; });
+            int start_count = std::min(std::max(settings.start_count, 1), candidate_count);
+
+            TableFit<DIM>& fit = fits[x + y * width];
+            fit.error = 1e30f;
+            fit.statistics = { 0, candidate_count, false };
+            for (int s = 0; s < start_count; ++s) {
+                float parameters[DIM];
+                NelderMeadStatistics statistics;
+                auto objective_function = [&](float* parameters) -> float { return error_function(x, y, parameters); };
+                float error = nelder_mead<DIM>(parameters, candidates[candidate_indices[s]], settings.simplex_size, settings.tolerance,
+                                               settings.max_iterations, objective_function, &statistics);
+
+                fit.statistics.iteration_count += statistics.iteration_count;
+                fit.statistics.evaluation_count += statistics.evaluation_count;
+                if (error < fit.error) {
+                    std::copy(parameters, parameters + DIM, fit.parameters);
+                    fit.error = error;
+                    fit.statistics.converged = statistics.converged;
+                }
+            }
+        }, 1);
+    }
+
+    TableFittingReport report = {};
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    int cell_count = width * height;
+    for (int i = 0; i < cell_count; ++i) {
+        const TableFit<DIM>& fit = fits[i];
+        report.mean_error += fit.error;
+        report.max_error = std::max(report.max_error, fit.error);
+        report.mean_iteration_count += fit.statistics.iteration_count;
+        report.mean_evaluation_count += fit.statistics.evaluation_count;
+        report.unconverged_cell_count += fit.statistics.converged ? 0 : 1;
+    }
+    report.mean_error /= cell_count;
+    report.mean_iteration_count /= cell_count;
+    report.mean_evaluation_count /= cell_count;
+
+    return report;
+}
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_TABLE_FITTING_H_
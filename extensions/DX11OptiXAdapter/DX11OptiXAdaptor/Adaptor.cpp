@@ -12,6 +12,8 @@
 #include <OptiXRenderer/Defines.h>
 #include <OptiXRenderer/Renderer.h>
 
+#include <Bifrost/Core/Profiler.h>
+
 #include <cuda_runtime.h>
 #include <cuda_d3d11_interop.h>
 
@@ -142,6 +144,7 @@ public:
     }
 
     void handle_updates() {
+        BIFROST_PROFILE_FUNCTION();
         m_optix_renderer->handle_updates();
     }
 
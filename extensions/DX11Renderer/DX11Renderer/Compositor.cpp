@@ -10,6 +10,8 @@
 #include <DX11Renderer/CameraEffects.h>
 #include <DX11Renderer/Utils.h>
 
+#include <Bifrost/Core/Profiler.h>
+
 #include <filesystem>
 
 using namespace Bifrost::Assets;
@@ -255,10 +257,12 @@ public:
             m_backbuffer_size = current_backbuffer_size;
         }
 
-        // Tell all renderers to update.
-        for (auto& renderer : m_renderers)
-            if (renderer)
-                renderer->handle_updates();
+        { // Tell all renderers to update.
+            BIFROST_PROFILE_SCOPE("Compositor::handle_updates");
+            for (auto& renderer : m_renderers)
+                if (renderer)
+                    renderer->handle_updates();
+        }
 
         // Render.
         for (Cameras::UID camera_ID : Cameras::get_z_sorted_IDs()) {
@@ -11,6 +11,7 @@
 #include "Dx11Renderer/Utils.h"
 
 #include "Bifrost/Assets/InfiniteAreaLight.h"
+#include "Bifrost/Core/Profiler.h"
 #include "Bifrost/Math/RNG.h"
 #include "Bifrost/Scene/SceneRoot.h"
 
@@ -94,6 +95,7 @@ bool EnvironmentManager::render(ID3D11DeviceContext1& render_context, int enviro
 }
 
 void EnvironmentManager::handle_updates(ID3D11Device1& device, ID3D11DeviceContext1& device_context) {
+    BIFROST_PROFILE_FUNCTION();
     if (!SceneRoots::get_changed_scenes().is_empty()) {
         if (m_envs.size() < SceneRoots::capacity())
             m_envs.resize(SceneRoots::capacity());
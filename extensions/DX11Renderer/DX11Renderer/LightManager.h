@@ -13,6 +13,7 @@
 #include "Dx11Renderer/Utils.h"
 
 #include "Bifrost/Core/Array.h"
+#include "Bifrost/Core/Profiler.h"
 #include "Bifrost/Scene/LightSource.h"
 
 namespace DX11Renderer {
@@ -95,6 +96,7 @@ public:
     inline ID3D11Buffer** light_buffer_addr() { return &m_lights_buffer; }
 
     void handle_updates(ID3D11DeviceContext1& device_context) {
+        BIFROST_PROFILE_FUNCTION();
         if (!LightSources::get_changed_lights().is_empty()) {
             if (m_ID_to_index.size() < LightSources::capacity()) {
                 // Resize the light buffer to hold the new capacity.
@@ -10,6 +10,7 @@
 #include "Dx11Renderer/Utils.h"
 
 #include <Bifrost/Assets/Material.h>
+#include <Bifrost/Core/Profiler.h>
 #include <Bifrost/Assets/Shading/Fittings.h>
 
 using namespace Bifrost::Assets;
@@ -88,6 +89,7 @@ MaterialManager::MaterialManager(ID3D11Device1& device, ID3D11DeviceContext1& co
 }
 
 void MaterialManager::handle_updates(ID3D11Device1& device, ID3D11DeviceContext1& context) {
+    BIFROST_PROFILE_FUNCTION();
     if (Materials::get_changed_materials().is_empty())
         return;
 
@@ -18,6 +18,7 @@
 #include <Bifrost/Assets/Mesh.h>
 #include <Bifrost/Assets/MeshModel.h>
 #include <Bifrost/Core/Engine.h>
+#include <Bifrost/Core/Profiler.h>
 #include <Bifrost/Core/Window.h>
 #include <Bifrost/Math/OctahedralNormal.h>
 #include <Bifrost/Scene/Camera.h>
@@ -743,6 +744,7 @@ public:
     }
 
     void handle_updates() {
+        BIFROST_PROFILE_FUNCTION();
         m_environments->handle_updates(m_device, *m_render_context);
         m_lights.manager.handle_updates(*m_render_context);
         m_materials.handle_updates(m_device, *m_render_context);
@@ -11,6 +11,7 @@
 
 #include <Bifrost/Assets/Image.h>
 #include <Bifrost/Assets/Texture.h>
+#include <Bifrost/Core/Profiler.h>
 
 using namespace Bifrost::Assets;
 
@@ -45,6 +46,7 @@ TextureManager::TextureManager(ID3D11Device1& device) {
 }
 
 void TextureManager::handle_updates(ID3D11Device1& device, ID3D11DeviceContext1& device_context) {
+    BIFROST_PROFILE_FUNCTION();
     { // Image updates.
         if (!Images::get_changed_images().is_empty()) {
             if (m_images.size() < Images::capacity())
@@ -62,6 +64,18 @@ void TextureManager::handle_updates(ID3D11Device1& device, ID3D11DeviceContext1&
                     return DXGI_FORMAT_R32G32B32_FLOAT;
                 case PixelFormat::RGBA_Float:
                     return DXGI_FORMAT_R32G32B32A32_FLOAT;
+                case PixelFormat::RGBA_Half:
+                    return DXGI_FORMAT_R16G16B16A16_FLOAT;
+                case PixelFormat::BC1_RGB:
+                    return DXGI_FORMAT_BC1_UNORM_SRGB;
+                case PixelFormat::BC4_Intensity:
+                    return DXGI_FORMAT_BC4_UNORM;
+                case PixelFormat::BC5_RG:
+                    return DXGI_FORMAT_BC5_UNORM;
+                case PixelFormat::BC6H_RGB:
+                    return DXGI_FORMAT_BC6H_UF16;
+                case PixelFormat::BC7_RGBA:
+                    return DXGI_FORMAT_BC7_UNORM_SRGB;
                 case PixelFormat::Unknown:
                 default:
                     return DXGI_FORMAT_UNKNOWN;
@@ -111,13 +125,25 @@ void TextureManager::handle_updates(ID3D11Device1& device, ID3D11DeviceContext1&
                     }
 
                     if (tex_desc.Format != DXGI_FORMAT_UNKNOWN) {
-                        resource_data.SysMemPitch = sizeof_dx_format(tex_desc.Format) *  image.get_width();
+                        bool is_compressed = is_block_compressed(image.get_pixel_format());
+                        if (!is_compressed)
+                            resource_data.SysMemPitch = sizeof_dx_format(tex_desc.Format) *  image.get_width();
 
-                        bool generate_mipmaps = image.is_mipmapable();
+                        // Block compressed textures cannot be render targets, so their mipmaps cannot be generated on the GPU.
+                        bool generate_mipmaps = image.is_mipmapable() && !is_compressed;
 
                         OTexture2D texture;
                         HRESULT hr;
-                        if (generate_mipmaps) {
+                        if (is_compressed) {
+                            // Upload the full mipmap chain of the compressed image.
+                            std::vector<D3D11_SUBRESOURCE_DATA> mipmap_data(image.get_mipmap_count());
+                            for (unsigned int m = 0; m < image.get_mipmap_count(); ++m) {
+                                mipmap_data[m].pSysMem = image.get_pixels(m);
+                                mipmap_data[m].SysMemPitch = ((image.get_width(m) + 3) / 4) * block_size_of(image.get_pixel_format());
+                                mipmap_data[m].SysMemSlicePitch = 0;
+                            }
+                            hr = device.CreateTexture2D(&tex_desc, mipmap_data.data(), &texture);
+                        } else if (generate_mipmaps) {
                             // Additional mipmap generation settings.
                             tex_desc.MipLevels = 0;
                             tex_desc.BindFlags |= D3D11_BIND_RENDER_TARGET;
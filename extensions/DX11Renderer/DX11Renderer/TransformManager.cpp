@@ -9,6 +9,7 @@
 #include "Dx11Renderer/TransformManager.h"
 #include "Dx11Renderer/Utils.h"
 
+#include <Bifrost/Core/Profiler.h>
 #include <Bifrost/Math/Conversions.h>
 #include <Bifrost/Scene/SceneNode.h>
 
@@ -27,6 +28,7 @@ TransformManager::TransformManager(ID3D11Device1& device, ID3D11DeviceContext1&
 }
 
 void TransformManager::handle_updates(ID3D11Device1& device, ID3D11DeviceContext1& context) {
+    BIFROST_PROFILE_FUNCTION();
     if (SceneNodes::get_changed_nodes().is_empty())
         return;
 
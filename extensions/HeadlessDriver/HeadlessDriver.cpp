@@ -0,0 +1,127 @@
+// Bifrost headless driver.
+// ----------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ----------------------------------------------------------------------------
+
+#include <HeadlessDriver.h>
+
+#include <Bifrost/Core/Engine.h>
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Input/Keyboard.h>
+#include <Bifrost/Input/Mouse.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using Bifrost::Core::Engine;
+using Bifrost::Input::Keyboard;
+using Bifrost::Input::Mouse;
+using Clock = std::chrono::steady_clock;
+
+namespace HeadlessDriver {
+
+inline double seconds_between(Clock::time_point begin, Clock::time_point end) {
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+// Nearest rank percentile of sorted samples.
+inline double percentile(const std::vector<double>& sorted_samples, double p) {
+    int index = int(p * sorted_samples.size() + 0.5) - 1;
+    index = std::max(0, std::min(index, int(sorted_samples.size()) - 1));
+    return sorted_samples[index];
+}
+
+TickStatistics compute_statistics(std::vector<double> tick_durations, double total_time) {
+    TickStatistics statistics = {};
+    statistics.tick_count = unsigned(tick_durations.size());
+    statistics.total_time = total_time;
+    if (tick_durations.empty())
+        return statistics;
+
+    std::sort(tick_durations.begin(), tick_durations.end());
+    double duration_sum = 0.0;
+    for (double duration : tick_durations)
+        duration_sum += duration;
+
+    statistics.mean = duration_sum / tick_durations.size();
+    statistics.min = tick_durations.front();
+    statistics.percentile_50 = percentile(tick_durations, 0.5);
+    statistics.percentile_90 = percentile(tick_durations, 0.9);
+    statistics.percentile_99 = percentile(tick_durations, 0.99);
+    statistics.max = tick_durations.back();
+    return statistics;
+}
+
+int run(OnLaunchCallback on_launch, OnWindowCreatedCallback on_window_created, const Settings& settings, TickStatistics* statistics) {
+    Bifrost::Core::Parallel::set_thread_count(settings.thread_count, settings.pin_threads);
+    if (settings.pin_threads)
+        Bifrost::Core::Parallel::pin_current_thread(0);
+
+    // Idle input devices, as callbacks expect the engine to have a keyboard and a mouse.
+    Keyboard keyboard;
+    Mouse mouse = Mouse(Bifrost::Math::Vector2i(0, 0));
+
+    Engine engine(settings.data_directory);
+    engine.set_keyboard(&keyboard);
+    engine.set_mouse(&mouse);
+    if (on_launch != nullptr) {
+        int error_code = on_launch(engine);
+        if (error_code != 0)
+            return error_code;
+    }
+
+    Bifrost::Core::Window& engine_window = engine.get_window();
+    engine_window.resize(0, 0);
+    if (on_window_created != nullptr) {
+        int error_code = on_window_created(engine, engine_window);
+        if (error_code != 0)
+            return error_code;
+    }
+
+    std::vector<double> tick_durations;
+    if (settings.max_tick_count != 0xFFFFFFFF)
+        tick_durations.reserve(settings.max_tick_count);
+
+    auto run_begin = Clock::now();
+    auto previous_tick_begin = run_begin;
+    auto next_tick_begin = run_begin;
+    unsigned int tick_count = 0;
+    while (tick_count < settings.max_tick_count && !engine.is_quit_requested() &&
+           !(settings.stop_condition && settings.stop_condition(engine))) {
+
+        if (settings.real_time) {
+            std::this_thread::sleep_until(next_tick_begin);
+            next_tick_begin += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(settings.time_step));
+        }
+
+        auto tick_begin = Clock::now();
+        double delta_time = settings.time_step > 0.0 ? settings.time_step : seconds_between(previous_tick_begin, tick_begin);
+        previous_tick_begin = tick_begin;
+
+        keyboard.per_frame_reset();
+        mouse.per_frame_reset();
+        engine.do_tick(delta_time);
+
+        tick_durations.push_back(seconds_between(tick_begin, Clock::now()));
+        ++tick_count;
+    }
+
+    TickStatistics tick_statistics = compute_statistics(tick_durations, seconds_between(run_begin, Clock::now()));
+    if (settings.print_statistics && tick_statistics.tick_count > 0)
+        printf("HeadlessDriver: %u ticks in %.3fs. Tick latency mean %.3fms, min %.3fms, p50 %.3fms, p90 %.3fms, p99 %.3fms, max %.3fms\n",
+               tick_statistics.tick_count, tick_statistics.total_time, tick_statistics.mean * 1000.0, tick_statistics.min * 1000.0,
+               tick_statistics.percentile_50 * 1000.0, tick_statistics.percentile_90 * 1000.0,
+               tick_statistics.percentile_99 * 1000.0, tick_statistics.max * 1000.0);
+    if (statistics != nullptr)
+        *statistics = tick_statistics;
+
+    return 0;
+}
+
+} // NS HeadlessDriver
@@ -0,0 +1,80 @@
+// Bifrost headless driver.
+// ----------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ----------------------------------------------------------------------------
+
+#ifndef _BIFROST_HEADLESS_DRIVER_H_
+#define _BIFROST_HEADLESS_DRIVER_H_
+
+#include <filesystem>
+#include <functional>
+
+//----------------------------------------------------------------------------
+// Forward declerations
+//----------------------------------------------------------------------------
+namespace Bifrost {
+namespace Core {
+class Engine;
+class Window;
+}
+}
+
+//----------------------------------------------------------------------------
+// Driver that ticks the engine without a window system or graphics context,
+// fx for batch processing on render servers or benchmarks in CI.
+// The engine's window is resized to 0x0 before on_window_created is called,
+// which is how modules detect that they are running headless.
+// The engine is given a keyboard and a mouse that never receive any input,
+// so callbacks can query them as they would with a window.
+// The tick loop runs until the engine requests to quit, the stop condition
+// returns true or max_tick_count ticks have been run.
+//----------------------------------------------------------------------------
+namespace HeadlessDriver {
+
+typedef int (*OnLaunchCallback)(Bifrost::Core::Engine&);
+typedef int (*OnWindowCreatedCallback)(Bifrost::Core::Engine&, Bifrost::Core::Window&);
+
+struct Settings {
+    std::filesystem::path data_directory;
+
+    // The delta time passed to the engine pr tick. If positive, every tick advances the engine by exactly this amount,
+    // which makes runs reproducible. If zero, the measured wall clock time since the previous tick is used.
+    double time_step = 1.0 / 60.0;
+
+    // Sleep between ticks so they are spaced time_step apart in wall clock time.
+    // Otherwise the ticks run back to back as fast as possible.
+    bool real_time = false;
+
+    unsigned int max_tick_count = 0xFFFFFFFF;
+    std::function<bool(const Bifrost::Core::Engine&)> stop_condition = nullptr;
+
+    // Number of threads executing tasks. Zero uses all hardware threads.
+    int thread_count = 0;
+    // Pin the calling thread and the task threads to their own hardware threads.
+    bool pin_threads = false;
+
+    bool print_statistics = true;
+};
+
+// Tick latency statistics in seconds.
+struct TickStatistics {
+    unsigned int tick_count;
+    double total_time;
+    double mean;
+    double min;
+    double percentile_50;
+    double percentile_90;
+    double percentile_99;
+    double max;
+};
+
+// Runs the engine until it is stopped and returns the error code of the callbacks or zero.
+// The tick statistics are written to statistics if it is not null.
+int run(OnLaunchCallback on_launch, OnWindowCreatedCallback on_window_created, const Settings& settings, TickStatistics* statistics = nullptr);
+
+} // NS HeadlessDriver
+
+#endif // _BIFROST_HEADLESS_DRIVER_H_
@@ -0,0 +1,331 @@
+// Camera effects on the CPU.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#include <ImageOperations/CameraEffects.h>
+
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Core/Profiler.h>
+
+#include <vector>
+
+using namespace Bifrost::Assets;
+using namespace Bifrost::Core;
+using namespace Bifrost::Math;
+using namespace Bifrost::Math::CameraEffects;
+
+namespace ImageOperations {
+namespace CameraEffects {
+
+// ------------------------------------------------------------------------------------------------
+// Utilities.
+// ------------------------------------------------------------------------------------------------
+
+// Grid of square tiles covering an image. The last row and column of tiles may be partial.
+struct TileGrid final {
+    static const int tile_size = 64;
+
+    int width, height;
+    int tile_count_x, tile_count_y;
+
+    TileGrid(int width, int height)
+        : width(width), height(height),
+          tile_count_x((width + tile_size - 1) / tile_size), tile_count_y((height + tile_size - 1) / tile_size) {}
+
+    int tile_count() const { return tile_count_x * tile_count_y; }
+
+    // Calls body(x, y, pixel_index) for all pixels in the tile, row by row.
+    template <typename Body>
+    void for_each_pixel(int tile_index, Body body) const {
+        int x_begin = (tile_index % tile_count_x) * tile_size;
+        int y_begin = (tile_index / tile_count_x) * tile_size;
+        int x_end = min(x_begin + tile_size, width);
+        int y_end = min(y_begin + tile_size, height);
+        for (int y = y_begin; y < y_end; ++y)
+            for (int x = x_begin; x < x_end; ++x)
+                body(x, y, x + y * width);
+    }
+};
+
+// Returns the linear RGB pixels of the first mipmap level.
+// Linear RGB_Float images are accessed directly, all other images are converted into the storage.
+static const RGB* get_linear_pixels(Image image, std::vector<RGB>& storage) {
+    if (image.get_pixel_format() == PixelFormat::RGB_Float && image.get_gamma() == 1.0f)
+        return image.get_pixels<RGB>();
+
+    Images::UID image_ID = image.get_ID();
+    int width = image.get_width();
+    int height = image.get_height();
+    storage.resize(width * height);
+    Parallel::parallel_for(0, height, [&](int y) {
+        for (int x = 0; x < width; ++x)
+            storage[x + y * width] = Images::get_pixel(image_ID, Vector2ui(x, y)).rgb();
+    });
+    return storage.data();
+}
+
+inline float log_luminance(RGB pixel) {
+    return log2(fmaxf(luminance(pixel), 0.0001f));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Exposure. See ReduceExposureHistogram.hlsl and ReduceLogAverageLuminance.hlsl.
+// ------------------------------------------------------------------------------------------------
+
+static Histogram exposure_histogram(const RGB* pixels, int width, int height, float min_log_luminance, float max_log_luminance) {
+    TileGrid tiles = TileGrid(width, height);
+    Histogram empty_histogram = {};
+    auto reduce_tiles = [&](int tile_begin, int tile_end, Histogram histogram) -> Histogram {
+        for (int t = tile_begin; t < tile_end; ++t)
+            tiles.for_each_pixel(t, [&](int x, int y, int pixel_index) {
+                float normalized_index = inverse_lerp(min_log_luminance, max_log_luminance, log_luminance(pixels[pixel_index]));
+                int bin_index = clamp(int(normalized_index * histogram_size + 0.5f), 0, histogram_size - 1);
+                ++histogram[bin_index];
+            });
+        return histogram;
+    };
+    auto merge_histograms = [](Histogram lhs, const Histogram& rhs) -> Histogram {
+        for (int b = 0; b < histogram_size; ++b)
+            lhs[b] += rhs[b];
+        return lhs;
+    };
+    return Parallel::parallel_reduce(0, tiles.tile_count(), empty_histogram, reduce_tiles, merge_histograms, 1);
+}
+
+Histogram exposure_histogram(Images::UID image_ID, const Settings& settings) {
+    Image image = image_ID;
+    std::vector<RGB> storage;
+    const RGB* pixels = get_linear_pixels(image, storage);
+    return exposure_histogram(pixels, image.get_width(), image.get_height(), settings.exposure.min_log_luminance, settings.exposure.max_log_luminance);
+}
+
+// Average luminance of the pixels between the min and max histogram percentages.
+static float histogram_average_luminance(const Histogram& histogram, const Settings& settings) {
+    // Exclusive prefix sum of the histogram with the total pixel count as the last element.
+    double prefix_sum[histogram_size + 1];
+    prefix_sum[0] = 0.0;
+    for (int b = 0; b < histogram_size; ++b)
+        prefix_sum[b + 1] = prefix_sum[b] + histogram[b];
+
+    // Clamp the prefix sum to the max boundary and zero values below the min boundary.
+    double max_pixel_count = prefix_sum[histogram_size] * settings.exposure.max_histogram_percentage;
+    double min_pixel_count = prefix_sum[histogram_size] * settings.exposure.min_histogram_percentage;
+    for (int b = 0; b < histogram_size; ++b)
+        prefix_sum[b] = fmax(0.0, fmin(prefix_sum[b], max_pixel_count) - min_pixel_count);
+    prefix_sum[histogram_size] = max_pixel_count - min_pixel_count;
+
+    double weighted_luminance = 0.0;
+    for (int b = 0; b < histogram_size; ++b) {
+        double bin_count = prefix_sum[b + 1] - prefix_sum[b];
+        float normalized_index = (b + 0.5f) / histogram_size;
+        float bin_log_luminance = lerp(settings.exposure.min_log_luminance, settings.exposure.max_log_luminance, normalized_index);
+        weighted_luminance += exp2(bin_log_luminance) * bin_count;
+    }
+
+    return float(weighted_luminance / (max_pixel_count - min_pixel_count));
+}
+
+static double summed_log_luminance(const RGB* pixels, int width, int height) {
+    TileGrid tiles = TileGrid(width, height);
+    auto reduce_tiles = [&](int tile_begin, int tile_end, double summed_log_luminance) -> double {
+        for (int t = tile_begin; t < tile_end; ++t)
+            tiles.for_each_pixel(t, [&](int x, int y, int pixel_index) { summed_log_luminance += log_luminance(pixels[pixel_index]); });
+        return summed_log_luminance;
+    };
+    return Parallel::parallel_reduce(0, tiles.tile_count(), 0.0, reduce_tiles, [](double lhs, double rhs) { return lhs + rhs; }, 1);
+}
+
+// Computes linear exposure from the geometric mean. See MJP's tonemapping sample.
+inline float geometric_mean_linear_exposure(float log_average_luminance) {
+    float key_value = 1.03f - (2.0f / (2 + log10(log_average_luminance + 1)));
+    return key_value / log_average_luminance;
+}
+
+float eye_adaptation(float current_linear_exposure, float target_linear_exposure, const Settings& settings, float delta_time) {
+    if (!settings.exposure.eye_adaptation_enabled)
+        return target_linear_exposure;
+
+    float delta_exposure = target_linear_exposure - current_linear_exposure;
+    float adaption_speed = (delta_exposure > 0.0f) ? settings.exposure.eye_adaptation_brightness : settings.exposure.eye_adaptation_darkness;
+    float factor = 1.0f - exp2(-delta_time * adaption_speed);
+    return current_linear_exposure + delta_exposure * factor;
+}
+
+static float compute_linear_exposure(const RGB* pixels, int width, int height, const Settings& settings, float delta_time, float previous_linear_exposure) {
+    float target_linear_exposure = exp2(settings.exposure.log_lumiance_bias);
+    if (settings.exposure.mode == ExposureMode::LogAverage) {
+        float average_log_luminance = float(summed_log_luminance(pixels, width, height) / (width * height));
+        average_log_luminance = clamp(average_log_luminance, settings.exposure.min_log_luminance, settings.exposure.max_log_luminance);
+        target_linear_exposure *= geometric_mean_linear_exposure(exp2(average_log_luminance));
+    } else if (settings.exposure.mode == ExposureMode::Histogram) {
+        Histogram histogram = exposure_histogram(pixels, width, height, settings.exposure.min_log_luminance, settings.exposure.max_log_luminance);
+        target_linear_exposure /= histogram_average_luminance(histogram, settings);
+    }
+
+    return eye_adaptation(previous_linear_exposure, target_linear_exposure, settings, delta_time);
+}
+
+float compute_linear_exposure(Images::UID image_ID, const Settings& settings, float delta_time, float previous_linear_exposure) {
+    Image image = image_ID;
+    std::vector<RGB> storage;
+    const RGB* pixels = get_linear_pixels(image, storage);
+    return compute_linear_exposure(pixels, image.get_width(), image.get_height(), settings, delta_time, previous_linear_exposure);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Bloom. See Bloom.hlsl.
+// ------------------------------------------------------------------------------------------------
+
+// Bilinear filter tap at a constant offset from the pixel being filtered.
+// The offset is the same for all pixels, so the integer shift and the interpolation weight are precomputed.
+struct BilinearOffset final {
+    int shift;
+    float weight;
+
+    BilinearOffset(float offset) {
+        float floored_offset = floorf(offset);
+        shift = int(floored_offset);
+        weight = offset - floored_offset;
+    }
+
+    // Samples the pixel at index + offset with clamp to edge addressing. Stride is the distance between neighbouring pixels.
+    inline RGB sample(const RGB* pixels, int index, int pixel_count, int stride) const {
+        int index0 = clamp(index + shift, 0, pixel_count - 1);
+        int index1 = clamp(index + shift + 1, 0, pixel_count - 1);
+        return lerp(pixels[index0 * stride], pixels[index1 * stride], weight);
+    }
+};
+
+inline RGB high_intensity(RGB color, float threshold) {
+    return RGB(fmaxf(0.0f, color.r - threshold), fmaxf(0.0f, color.g - threshold), fmaxf(0.0f, color.b - threshold));
+}
+
+static void bloom(const RGB* pixels, int width, int height, float threshold, int support, RGB* bloom_pixels) {
+    // The DX11 renderer fills ceil(support / 2) taps, but only filters with the first support / 2 taps.
+    int sample_count = support / 2;
+    if (sample_count == 0) {
+        std::fill_n(bloom_pixels, width * height, RGB::black());
+        return;
+    }
+    std::vector<Tap> taps = std::vector<Tap>(ceil_divide(support, 2));
+    fill_bilinear_gaussian_samples(support * 0.25f, taps.data(), taps.data() + taps.size());
+
+    std::vector<BilinearOffset> lower_offsets, upper_offsets;
+    for (int s = 0; s < sample_count; ++s) {
+        lower_offsets.push_back(BilinearOffset(-taps[s].offset));
+        upper_offsets.push_back(BilinearOffset(taps[s].offset));
+    }
+
+    // High intensity pass and horizontal filter.
+    std::vector<RGB> horizontal_pixels = std::vector<RGB>(width * height);
+    Parallel::parallel_for(0, height, [&](int y) {
+        const RGB* row = pixels + y * width;
+        RGB* filtered_row = horizontal_pixels.data() + y * width;
+        for (int x = 0; x < width; ++x)
+            filtered_row[x] = RGB::black();
+        for (int s = 0; s < sample_count; ++s)
+            for (int x = 0; x < width; ++x) {
+                RGB lower_sample = lower_offsets[s].sample(row, x, width, 1);
+                RGB upper_sample = upper_offsets[s].sample(row, x, width, 1);
+                filtered_row[x] += (high_intensity(lower_sample, threshold) + high_intensity(upper_sample, threshold)) * taps[s].weight;
+            }
+    });
+
+    // Vertical filter. Filters full rows at a time, so the inner loop reads and writes contiguous pixels.
+    Parallel::parallel_for(0, height, [&](int y) {
+        RGB* bloom_row = bloom_pixels + y * width;
+        for (int x = 0; x < width; ++x)
+            bloom_row[x] = RGB::black();
+        for (int s = 0; s < sample_count; ++s)
+            for (int x = 0; x < width; ++x) {
+                const RGB* column = horizontal_pixels.data() + x;
+                RGB lower_sample = lower_offsets[s].sample(column, y, height, width);
+                RGB upper_sample = upper_offsets[s].sample(column, y, height, width);
+                bloom_row[x] += (lower_sample + upper_sample) * taps[s].weight;
+            }
+    });
+}
+
+void bloom(Images::UID image_ID, float threshold, int support, RGB* bloom_pixels) {
+    Image image = image_ID;
+    std::vector<RGB> storage;
+    const RGB* pixels = get_linear_pixels(image, storage);
+    bloom(pixels, image.get_width(), image.get_height(), threshold, support, bloom_pixels);
+}
+
+// ------------------------------------------------------------------------------------------------
+// Vignette and tonemapping. See Tonemapping.hlsl.
+// ------------------------------------------------------------------------------------------------
+
+inline float smoothstep(float edge0, float edge1, float x) {
+    float t = clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+    return t * t * (3.0f - 2.0f * t);
+}
+
+// Simple vignette using smoothstep.
+// Adapted from https://github.com/mattdesl/lwjgl-basics/wiki/ShaderLesson3
+inline float simple_vignette_tint(float x, float y, float width, float height, float scale) {
+    float outer_radius = 0.9f;
+    float coord_x = x / width - 0.5f;
+    float coord_y = y / height - 0.5f;
+    return 1.0f - smoothstep(0.1f, outer_radius, sqrtf(coord_x * coord_x + coord_y * coord_y) * 1.5f * scale);
+}
+
+inline RGB tonemap(RGB color, const Settings& settings) {
+    switch (settings.tonemapping.mode) {
+    case TonemappingMode::Filmic:
+        return unreal4(color, settings.tonemapping.filmic);
+    case TonemappingMode::Uncharted2:
+        return uncharted2(color, settings.tonemapping.uncharted2);
+    default:
+        return color;
+    }
+}
+
+Images::UID process(Images::UID image_ID, const Settings& settings, float delta_time, float& linear_exposure) {
+    BIFROST_PROFILE_FUNCTION();
+
+    Image image = image_ID;
+    int width = image.get_width();
+    int height = image.get_height();
+    std::vector<RGB> storage;
+    const RGB* pixels = get_linear_pixels(image, storage);
+
+    linear_exposure = compute_linear_exposure(pixels, width, height, settings, delta_time, linear_exposure);
+
+    float bloom_threshold = settings.bloom.threshold;
+    std::vector<RGB> bloom_pixels;
+    if (bloom_threshold < INFINITY) {
+        bloom_pixels.resize(width * height);
+        bloom(pixels, width, height, bloom_threshold, int(settings.bloom.support * height), bloom_pixels.data());
+    }
+
+    Images::UID output_ID = Images::create2D(image.get_name() + " postprocessed", PixelFormat::RGB_Float, 1.0f, Vector2ui(width, height));
+    RGB* output_pixels = Images::get_pixels<RGB>(output_ID);
+
+    TileGrid tiles = TileGrid(width, height);
+    float exposure = linear_exposure;
+    Parallel::parallel_for(0, tiles.tile_count(), [&](int t) {
+        tiles.for_each_pixel(t, [&](int x, int y, int pixel_index) {
+            // Bloom and exposure
+            RGB pixel = pixels[pixel_index];
+            RGB low_intensity_color = RGB(fminf(pixel.r, bloom_threshold), fminf(pixel.g, bloom_threshold), fminf(pixel.b, bloom_threshold));
+            RGB bloom_color = bloom_pixels.empty() ? RGB::black() : bloom_pixels[pixel_index];
+            RGB color = (low_intensity_color + bloom_color) * exposure;
+
+            // Vignette
+            color *= simple_vignette_tint(x + 0.5f, y + 0.5f, float(width), float(height), settings.vignette);
+
+            output_pixels[pixel_index] = tonemap(color, settings);
+        });
+    }, 1);
+
+    return output_ID;
+}
+
+} // NS CameraEffects
+} // NS ImageOperations
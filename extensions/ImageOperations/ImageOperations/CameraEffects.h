@@ -0,0 +1,56 @@
+// Camera effects on the CPU.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _IMAGE_OPERATIONS_CAMERA_EFFECTS_H_
+#define _IMAGE_OPERATIONS_CAMERA_EFFECTS_H_
+
+#include <Bifrost/Assets/Image.h>
+#include <Bifrost/Math/CameraEffects.h>
+
+#include <array>
+
+// ------------------------------------------------------------------------------------------------
+// CPU port of the DX11 renderer's camera effects, i.e. exposure, bloom, vignette and tonemapping,
+// for offline output of HDR images.
+// The effects follow the formulas of the DX11 shaders, so the output matches the GPU output
+// up to floating point precision and the GPU's bilinear filtering precision.
+// Images are processed in tiles in parallel. Reductions are merged in tile order, so the results
+// are independent of the number of threads.
+// ------------------------------------------------------------------------------------------------
+namespace ImageOperations {
+namespace CameraEffects {
+
+using Settings = Bifrost::Math::CameraEffects::Settings;
+
+static const int histogram_size = 64;
+typedef std::array<unsigned int, histogram_size> Histogram;
+
+// Histogram of the image's log luminance in the range [settings.exposure.min_log_luminance, settings.exposure.max_log_luminance].
+Histogram exposure_histogram(Bifrost::Assets::Images::UID image_ID, const Settings& settings);
+
+// Moves the current exposure towards the target exposure, see eye_adaptation in the DX11 shaders.
+// If eye adaptation is disabled the target exposure is returned.
+float eye_adaptation(float current_linear_exposure, float target_linear_exposure, const Settings& settings, float delta_time);
+
+// Computes the linear exposure of the image using the exposure mode in the settings.
+// The exposure is adapted from the previous exposure if eye adaptation is enabled.
+float compute_linear_exposure(Bifrost::Assets::Images::UID image_ID, const Settings& settings, float delta_time, float previous_linear_exposure);
+
+// Gaussian bloom of the intensities above the threshold. The support is in pixels.
+// bloom_pixels must hold width * height pixels.
+void bloom(Bifrost::Assets::Images::UID image_ID, float threshold, int support, Bifrost::Math::RGB* bloom_pixels);
+
+// Applies exposure, bloom, vignette and tonemapping to the image.
+// The linear exposure is read as the previous frame's exposure and updated with the exposure used.
+// Returns a linear RGB_Float image with the tonemapped pixels. Use Images::change_format to encode it for output, fx as sRGB.
+Bifrost::Assets::Images::UID process(Bifrost::Assets::Images::UID image_ID, const Settings& settings, float delta_time, float& linear_exposure);
+
+} // NS CameraEffects
+} // NS ImageOperations
+
+#endif // _IMAGE_OPERATIONS_CAMERA_EFFECTS_H_
@@ -0,0 +1,269 @@
+// 3D color lookup tables.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#include <ImageOperations/ColorLUT.h>
+#include <ImageOperations/Exposure.h>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace Bifrost::Core;
+using namespace Bifrost::Math;
+
+namespace ImageOperations {
+namespace ColorLUT {
+
+// ------------------------------------------------------------------------------------------------
+// 3D LUT.
+// ------------------------------------------------------------------------------------------------
+
+LUT3D LUT3D::linear(int resolution, RGB domain_min, RGB domain_max) {
+    LUT3D lut;
+    lut.m_resolution = resolution;
+    lut.m_encoding = Encoding::Linear;
+    lut.m_domain_min = domain_min;
+    lut.m_domain_max = domain_max;
+    lut.m_entries.resize(resolution * resolution * resolution, RGBA::black());
+    return lut;
+}
+
+LUT3D LUT3D::log2(int resolution, float min_log2, float max_log2) {
+    LUT3D lut = linear(resolution, RGB(min_log2), RGB(max_log2));
+    lut.m_encoding = Encoding::Log2;
+    return lut;
+}
+
+Vector3f LUT3D::encode(RGB color) const {
+    Vector3f coordinates;
+    for (int c = 0; c < 3; ++c) {
+        float recip_domain_size = 1.0f / (m_domain_max[c] - m_domain_min[c]);
+        float value = color[c];
+        if (m_encoding == Encoding::Log2)
+            value = Exposure::fast_log2(fmaxf(value, 0.0f) + exp2(m_domain_min[c]));
+        coordinates[c] = fminf(fmaxf((value - m_domain_min[c]) * recip_domain_size, 0.0f), 1.0f);
+    }
+    return coordinates;
+}
+
+RGB LUT3D::decode(Vector3f coordinates) const {
+    RGB color;
+    for (int c = 0; c < 3; ++c) {
+        float value = lerp(m_domain_min[c], m_domain_max[c], coordinates[c]);
+        color[c] = m_encoding == Encoding::Log2 ? exp2(value) - exp2(m_domain_min[c]) : value;
+    }
+    return color;
+}
+
+// Sums the weighted entries at the offsets from the base entry.
+template <int count>
+inline RGB weighted_sum(const RGBA* base, const int (&offsets)[count], const float (&weights)[count]) {
+#ifdef IMAGE_OPERATIONS_SSE2
+    __m128 sum = _mm_mul_ps(_mm_loadu_ps(&base[offsets[0]].r), _mm_set1_ps(weights[0]));
+    for (int i = 1; i < count; ++i)
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&base[offsets[i]].r), _mm_set1_ps(weights[i])));
+    float result[4];
+    _mm_storeu_ps(result, sum);
+    return RGB(result[0], result[1], result[2]);
+#else
+    RGB sum = base[offsets[0]].rgb() * weights[0];
+    for (int i = 1; i < count; ++i)
+        sum += base[offsets[i]].rgb() * weights[i];
+    return sum;
+#endif
+}
+
+RGB LUT3D::lookup(float r, float g, float b, Interpolation interpolation) const {
+    int last_index = m_resolution - 1;
+    float position[3] = { r * last_index, g * last_index, b * last_index };
+    int index[3];
+    float fraction[3];
+    for (int c = 0; c < 3; ++c) {
+        index[c] = min(int(position[c]), last_index - 1);
+        fraction[c] = position[c] - index[c];
+    }
+    const RGBA* base = m_entries.data() + entry_index(index[0], index[1], index[2]);
+    int stride[3] = { 1, m_resolution, m_resolution * m_resolution };
+
+    if (interpolation == Interpolation::Trilinear) {
+        int offsets[8];
+        float weights[8];
+        for (int corner = 0; corner < 8; ++corner) {
+            offsets[corner] = 0;
+            weights[corner] = 1.0f;
+            for (int c = 0; c < 3; ++c) {
+                bool upper = (corner >> c) & 1;
+                offsets[corner] += upper ? stride[c] : 0;
+                weights[corner] *= upper ? fraction[c] : 1.0f - fraction[c];
+            }
+        }
+        return weighted_sum(base, offsets, weights);
+    } else {
+        // Sort the axes by decreasing fraction. The vertices of the tetrahedron containing the position
+        // are then found by stepping from the base entry along the axes in sorted order.
+        auto sort_axes = [&](int a0, int a1) {
+            if (fraction[a0] < fraction[a1]) {
+                std::swap(fraction[a0], fraction[a1]);
+                std::swap(stride[a0], stride[a1]);
+            }
+        };
+        sort_axes(0, 1);
+        sort_axes(1, 2);
+        sort_axes(0, 1);
+
+        int offsets[4] = { 0, stride[0], stride[0] + stride[1], stride[0] + stride[1] + stride[2] };
+        float weights[4] = { 1.0f - fraction[0], fraction[0] - fraction[1], fraction[1] - fraction[2], fraction[2] };
+        return weighted_sum(base, offsets, weights);
+    }
+}
+
+RGB LUT3D::apply(RGB color, Interpolation interpolation) const {
+    Vector3f coordinates = encode(color);
+    return lookup(coordinates.x, coordinates.y, coordinates.z, interpolation);
+}
+
+void LUT3D::apply(const RGB* colors, RGB* results, int count, Interpolation interpolation) const {
+    // Colors are encoded four at a time in batches before they are looked up.
+    const int batch_size = 64;
+    Parallel::parallel_for_range(0, count, [&](int range_begin, int range_end) {
+        float coordinates[3][batch_size];
+        for (int batch_begin = range_begin; batch_begin < range_end; batch_begin += batch_size) {
+            int batch_count = min(batch_size, range_end - batch_begin);
+            const RGB* batch_colors = colors + batch_begin;
+
+            int i = 0;
+#ifdef IMAGE_OPERATIONS_SSE2
+            for (; i + 4 <= batch_count; i += 4)
+                for (int c = 0; c < 3; ++c) {
+                    __m128 value = _mm_set_ps(batch_colors[i + 3][c], batch_colors[i + 2][c], batch_colors[i + 1][c], batch_colors[i][c]);
+                    __m128 domain_min = _mm_set1_ps(m_domain_min[c]);
+                    if (m_encoding == Encoding::Log2)
+                        value = Exposure::fast_log2(_mm_add_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(exp2(m_domain_min[c]))));
+                    value = _mm_mul_ps(_mm_sub_ps(value, domain_min), _mm_set1_ps(1.0f / (m_domain_max[c] - m_domain_min[c])));
+                    value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+                    _mm_storeu_ps(coordinates[c] + i, value);
+                }
+#endif
+            for (; i < batch_count; ++i) {
+                Vector3f color_coordinates = encode(batch_colors[i]);
+                for (int c = 0; c < 3; ++c)
+                    coordinates[c][i] = color_coordinates[c];
+            }
+
+            for (i = 0; i < batch_count; ++i)
+                results[batch_begin + i] = lookup(coordinates[0][i], coordinates[1][i], coordinates[2][i], interpolation);
+        }
+    }, 4096);
+}
+
+// ------------------------------------------------------------------------------------------------
+// .cube import and export.
+// ------------------------------------------------------------------------------------------------
+
+LUT3D read_cube(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        printf("ColorLUT::read_cube(%s) error: 'Could not open file'\n", path.c_str());
+        return LUT3D();
+    }
+
+    int resolution = 0;
+    RGB domain_min = RGB::black(), domain_max = RGB::white();
+    bool is_log2_encoded = false;
+    float min_log2 = 0.0f, max_log2 = 0.0f;
+    std::vector<RGB> values;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream tokens(line);
+        std::string keyword;
+        if (!(tokens >> keyword))
+            continue;
+
+        if (keyword[0] == '#') {
+            std::string comment_keyword;
+            if (keyword == "#" && tokens >> comment_keyword && comment_keyword == "BIFROST_LOG2_DOMAIN")
+                is_log2_encoded = bool(tokens >> min_log2 >> max_log2);
+        } else if (keyword == "TITLE")
+            continue;
+        else if (keyword == "LUT_3D_SIZE")
+            tokens >> resolution;
+        else if (keyword == "DOMAIN_MIN")
+            tokens >> domain_min.r >> domain_min.g >> domain_min.b;
+        else if (keyword == "DOMAIN_MAX")
+            tokens >> domain_max.r >> domain_max.g >> domain_max.b;
+        else if (keyword == "LUT_3D_INPUT_RANGE") {
+            float range_min, range_max;
+            tokens >> range_min >> range_max;
+            domain_min = RGB(range_min);
+            domain_max = RGB(range_max);
+        } else if (keyword == "LUT_1D_SIZE") {
+            printf("ColorLUT::read_cube(%s) error: '1D LUTs are not supported'\n", path.c_str());
+            return LUT3D();
+        } else {
+            std::istringstream value_tokens(line);
+            RGB value;
+            if (!(value_tokens >> value.r >> value.g >> value.b)) {
+                printf("ColorLUT::read_cube(%s) error: 'Could not parse line \"%s\"'\n", path.c_str(), line.c_str());
+                return LUT3D();
+            }
+            values.push_back(value);
+        }
+    }
+
+    if (resolution < 2 || int(values.size()) != resolution * resolution * resolution) {
+        printf("ColorLUT::read_cube(%s) error: 'Expected %d entries, but found %d'\n", path.c_str(), resolution * resolution * resolution, int(values.size()));
+        return LUT3D();
+    }
+
+    LUT3D lut = is_log2_encoded ? LUT3D::log2(resolution, min_log2, max_log2) : LUT3D::linear(resolution, domain_min, domain_max);
+    int v = 0;
+    for (int b = 0; b < resolution; ++b)
+        for (int g = 0; g < resolution; ++g)
+            for (int r = 0; r < resolution; ++r)
+                lut.set_entry(r, g, b, values[v++]);
+    return lut;
+}
+
+bool write_cube(const LUT3D& lut, const std::string& path, const std::string& title) {
+    if (!lut.is_valid())
+        return false;
+
+    std::ofstream file(path);
+    if (!file)
+        return false;
+
+    if (!title.empty())
+        file << "TITLE \"" << title << "\"\n";
+
+    // Write enough digits to read back the exact values.
+    file << std::setprecision(9);
+    if (lut.get_encoding() == LUT3D::Encoding::Log2) {
+        file << "# BIFROST_LOG2_DOMAIN " << lut.get_min_log2() << " " << lut.get_max_log2() << "\n";
+        file << "DOMAIN_MIN 0 0 0\n";
+        file << "DOMAIN_MAX 1 1 1\n";
+    } else {
+        RGB domain_min = lut.get_domain_min(), domain_max = lut.get_domain_max();
+        file << "DOMAIN_MIN " << domain_min.r << " " << domain_min.g << " " << domain_min.b << "\n";
+        file << "DOMAIN_MAX " << domain_max.r << " " << domain_max.g << " " << domain_max.b << "\n";
+    }
+    file << "LUT_3D_SIZE " << lut.get_resolution() << "\n";
+
+    int resolution = lut.get_resolution();
+    for (int b = 0; b < resolution; ++b)
+        for (int g = 0; g < resolution; ++g)
+            for (int r = 0; r < resolution; ++r) {
+                RGB entry = lut.get_entry(r, g, b);
+                file << entry.r << " " << entry.g << " " << entry.b << "\n";
+            }
+
+    return file.good();
+}
+
+} // NS ColorLUT
+} // NS ImageOperations
@@ -0,0 +1,101 @@
+// 3D color lookup tables.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _IMAGE_OPERATIONS_COLOR_LUT_H_
+#define _IMAGE_OPERATIONS_COLOR_LUT_H_
+
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Math/Color.h>
+#include <Bifrost/Math/Vector.h>
+
+#include <string>
+#include <vector>
+
+namespace ImageOperations {
+namespace ColorLUT {
+
+enum class Interpolation { Trilinear, Tetrahedral };
+
+// ------------------------------------------------------------------------------------------------
+// 3D color lookup table for baking color grading operators.
+// The input is either encoded linearly in the per channel domain [domain_min, domain_max] or
+// logarithmically as log2(color + 2^min_log2) in [min_log2, max_log2]. The log encoding distributes
+// the entries evenly over the stops of HDR input and maps black to the first entry.
+// Input outside the domain is clamped.
+// The entries are stored with red varying fastest, as in .cube files.
+// ------------------------------------------------------------------------------------------------
+class LUT3D final {
+public:
+    enum class Encoding { Linear, Log2 };
+
+    LUT3D() : m_resolution(0), m_encoding(Encoding::Linear), m_domain_min(0.0f), m_domain_max(1.0f) {}
+    static LUT3D linear(int resolution, Bifrost::Math::RGB domain_min = Bifrost::Math::RGB::black(), Bifrost::Math::RGB domain_max = Bifrost::Math::RGB::white());
+    static LUT3D log2(int resolution, float min_log2, float max_log2);
+
+    inline bool is_valid() const { return m_resolution >= 2; }
+    inline int get_resolution() const { return m_resolution; }
+    inline Encoding get_encoding() const { return m_encoding; }
+    inline Bifrost::Math::RGB get_domain_min() const { return m_domain_min; }
+    inline Bifrost::Math::RGB get_domain_max() const { return m_domain_max; }
+    inline float get_min_log2() const { return m_domain_min.r; }
+    inline float get_max_log2() const { return m_domain_max.r; }
+
+    inline int entry_index(int r, int g, int b) const { return r + (g + b * m_resolution) * m_resolution; }
+    inline Bifrost::Math::RGB get_entry(int r, int g, int b) const { return m_entries[entry_index(r, g, b)].rgb(); }
+    inline void set_entry(int r, int g, int b, Bifrost::Math::RGB value) { m_entries[entry_index(r, g, b)] = Bifrost::Math::RGBA(value, 1.0f); }
+
+    // Maps a color to normalized LUT coordinates in [0, 1].
+    Bifrost::Math::Vector3f encode(Bifrost::Math::RGB color) const;
+    // Maps normalized LUT coordinates to the color they encode.
+    Bifrost::Math::RGB decode(Bifrost::Math::Vector3f coordinates) const;
+
+    // Sets all entries to color_operator(color), where color is the color encoded by the entry.
+    // The entries are evaluated in parallel, so the operator must be thread safe.
+    template <typename ColorOperator>
+    void bake(ColorOperator color_operator) {
+        float normalizer = 1.0f / (m_resolution - 1);
+        Bifrost::Core::Parallel::parallel_for(0, m_resolution * m_resolution, [&](int gb) {
+            int g = gb % m_resolution, b = gb / m_resolution;
+            for (int r = 0; r < m_resolution; ++r) {
+                Bifrost::Math::Vector3f coordinates = Bifrost::Math::Vector3f(float(r), float(g), float(b)) * normalizer;
+                set_entry(r, g, b, color_operator(decode(coordinates)));
+            }
+        }, 1);
+    }
+
+    Bifrost::Math::RGB apply(Bifrost::Math::RGB color, Interpolation interpolation = Interpolation::Tetrahedral) const;
+
+    // Applies the LUT to count colors in parallel. The colors and results may alias.
+    void apply(const Bifrost::Math::RGB* colors, Bifrost::Math::RGB* results, int count, Interpolation interpolation = Interpolation::Tetrahedral) const;
+
+private:
+    Bifrost::Math::RGB lookup(float r, float g, float b, Interpolation interpolation) const;
+
+    int m_resolution;
+    Encoding m_encoding;
+    // The linear domain or the log2 domain in the red channel.
+    Bifrost::Math::RGB m_domain_min;
+    Bifrost::Math::RGB m_domain_max;
+    // RGBA entries, so an entry can be loaded as a four wide vector.
+    std::vector<Bifrost::Math::RGBA> m_entries;
+};
+
+// ------------------------------------------------------------------------------------------------
+// .cube import and export. See the Adobe Cube LUT Specification 1.0.
+// Log2 encoded LUTs are stored with a normalized domain and a '# BIFROST_LOG2_DOMAIN min max' comment,
+// so other applications must apply the log2 shaper to the input before applying the LUT.
+// ------------------------------------------------------------------------------------------------
+
+// Returns an invalid LUT if the file could not be read.
+LUT3D read_cube(const std::string& path);
+bool write_cube(const LUT3D& lut, const std::string& path, const std::string& title = "");
+
+} // NS ColorLUT
+} // NS ImageOperations
+
+#endif // _IMAGE_OPERATIONS_COLOR_LUT_H_
@@ -2,22 +2,148 @@
 // ------------------------------------------------------------------------------------------------
 // Copyright (C) Bifrost. See AUTHORS.txt for authors.
 //
-// This program is open source and distributed under the New BSD License. 
+// This program is open source and distributed under the New BSD License.
 // See LICENSE.txt for more detail.
 // ------------------------------------------------------------------------------------------------
 
 #include <ImageOperations/Exposure.h>
 
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Core/Profiler.h>
+
 using namespace Bifrost::Assets;
+using namespace Bifrost::Core;
 using namespace Bifrost::Math;
 
 namespace ImageOperations {
 namespace Exposure {
 
+// Number of pixels reduced pr range. Fixed to make the results independent of the number of threads.
+static const int range_size = 16384;
+
+// Number of log luminances computed at a time. Small enough to stay in the L1 cache.
+static const int batch_size = 256;
+
+// ------------------------------------------------------------------------------------------------
+// Log luminance of batches of pixels.
+// ------------------------------------------------------------------------------------------------
+
+class LogLuminanceReader final {
+public:
+    LogLuminanceReader(Images::UID image_ID)
+        : m_image_ID(image_ID), m_format(Images::get_pixel_format(image_ID)), m_pixels(Images::get_pixels(image_ID)) {
+        float gamma = Images::get_gamma(image_ID);
+        bool is_float_format = m_format == PixelFormat::RGB_Float || m_format == PixelFormat::RGBA_Float || m_format == PixelFormat::Intensity_Float;
+        bool is_byte_format = m_format == PixelFormat::RGB24 || m_format == PixelFormat::RGBA32 || m_format == PixelFormat::Intensity8;
+        m_raw_access = (is_float_format && gamma == 1.0f) || is_byte_format;
+        if (is_byte_format)
+            for (int i = 0; i < 256; ++i)
+                m_byte_to_linear[i] = powf(i / 255.0f, gamma);
+    }
+
+    // Writes the log luminance of the pixels in [begin, end) to log_luminances.
+    void read(int begin, int end, float* log_luminances) const {
+        int count = end - begin;
+        compute_luminances(begin, end, log_luminances);
+        for (int i = 0; i < count; ++i)
+            log_luminances[i] = fmaxf(log_luminances[i], 0.0001f);
+
+        int i = 0;
+#ifdef IMAGE_OPERATIONS_SSE2
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(log_luminances + i, fast_log2(_mm_loadu_ps(log_luminances + i)));
+#endif
+        for (; i < count; ++i)
+            log_luminances[i] = fast_log2(log_luminances[i]);
+    }
+
+private:
+    void compute_luminances(int begin, int end, float* luminances) const {
+        int count = end - begin;
+        if (!m_raw_access) {
+            for (int i = 0; i < count; ++i)
+                luminances[i] = luminance(Images::get_pixel(m_image_ID, begin + i).rgb());
+            return;
+        }
+
+        switch (m_format) {
+        case PixelFormat::RGB_Float: {
+            const RGB* pixels = (const RGB*)m_pixels + begin;
+            for (int i = 0; i < count; ++i)
+                luminances[i] = luminance(pixels[i]);
+            break;
+        }
+        case PixelFormat::RGBA_Float: {
+            const RGBA* pixels = (const RGBA*)m_pixels + begin;
+            for (int i = 0; i < count; ++i)
+                luminances[i] = luminance(pixels[i].rgb());
+            break;
+        }
+        case PixelFormat::Intensity_Float: {
+            const float* pixels = (const float*)m_pixels + begin;
+            for (int i = 0; i < count; ++i)
+                luminances[i] = pixels[i];
+            break;
+        }
+        case PixelFormat::RGB24: {
+            const unsigned char* pixels = (const unsigned char*)m_pixels + begin * 3;
+            for (int i = 0; i < count; ++i)
+                luminances[i] = luminance(RGB(m_byte_to_linear[pixels[3 * i]], m_byte_to_linear[pixels[3 * i + 1]], m_byte_to_linear[pixels[3 * i + 2]]));
+            break;
+        }
+        case PixelFormat::RGBA32: {
+            const unsigned char* pixels = (const unsigned char*)m_pixels + begin * 4;
+            for (int i = 0; i < count; ++i)
+                luminances[i] = luminance(RGB(m_byte_to_linear[pixels[4 * i]], m_byte_to_linear[pixels[4 * i + 1]], m_byte_to_linear[pixels[4 * i + 2]]));
+            break;
+        }
+        case PixelFormat::Intensity8: {
+            const unsigned char* pixels = (const unsigned char*)m_pixels + begin;
+            for (int i = 0; i < count; ++i)
+                luminances[i] = m_byte_to_linear[pixels[i]];
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    Images::UID m_image_ID;
+    PixelFormat m_format;
+    const void* m_pixels;
+    bool m_raw_access;
+    float m_byte_to_linear[256];
+};
+
+// Calls batch_operation(log_luminances, count) for batches of the log luminances of the pixels in [begin, end).
+template <typename BatchOperation>
+inline void for_each_log_luminance_batch(const LogLuminanceReader& reader, int begin, int end, BatchOperation batch_operation) {
+    float log_luminances[batch_size];
+    for (int batch_begin = begin; batch_begin < end; batch_begin += batch_size) {
+        int batch_end = std::min(batch_begin + batch_size, end);
+        reader.read(batch_begin, batch_end, log_luminances);
+        batch_operation(log_luminances, batch_end - batch_begin);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// Luminance statistics.
+// ------------------------------------------------------------------------------------------------
+
 float summed_log_luminance(Images::UID image_ID) {
-    double summed_log_luminance = 0.0;
-    Images::iterate_pixels(image_ID, [&](RGBA pixel) { summed_log_luminance += log2(fmaxf(luminance(pixel.rgb()), 0.0001f)); });
-    return float(summed_log_luminance);
+    BIFROST_PROFILE_FUNCTION();
+    LogLuminanceReader reader = LogLuminanceReader(image_ID);
+    int pixel_count = Images::get_pixel_count(image_ID);
+
+    auto sum_range = [&](int begin, int end, double summed_log_luminance) -> double {
+        for_each_log_luminance_batch(reader, begin, end, [&](const float* log_luminances, int count) {
+            for (int i = 0; i < count; ++i)
+                summed_log_luminance += log_luminances[i];
+        });
+        return summed_log_luminance;
+    };
+    auto add = [](double lhs, double rhs) { return lhs + rhs; };
+    return float(Parallel::parallel_reduce(0, pixel_count, 0.0, sum_range, add, range_size));
 }
 
 float log_average_luminance(Images::UID image_ID) {
@@ -27,5 +153,29 @@ float log_average_luminance(Images::UID image_ID) {
     return exp2(summed_log_luminance(image_ID) / image.get_pixel_count());
 }
 
+std::vector<unsigned int> log_luminance_histogram(Images::UID image_ID, float min_log_luminance, float max_log_luminance, int bin_count) {
+    BIFROST_PROFILE_FUNCTION();
+    LogLuminanceReader reader = LogLuminanceReader(image_ID);
+    int pixel_count = Images::get_pixel_count(image_ID);
+
+    auto bin_range = [&](int begin, int end, std::vector<unsigned int> histogram) -> std::vector<unsigned int> {
+        for_each_log_luminance_batch(reader, begin, end, [&](const float* log_luminances, int count) {
+            for (int i = 0; i < count; ++i) {
+                float normalized_index = inverse_lerp(min_log_luminance, max_log_luminance, log_luminances[i]);
+                int index = clamp(int(normalized_index * bin_count), 0, bin_count - 1);
+                ++histogram[index];
+            }
+        });
+        return histogram;
+    };
+    auto merge = [](std::vector<unsigned int> lhs, const std::vector<unsigned int>& rhs) {
+        for (int b = 0; b < int(lhs.size()); ++b)
+            lhs[b] += rhs[b];
+        return lhs;
+    };
+    auto empty_histogram = std::vector<unsigned int>(bin_count, 0u);
+    return Parallel::parallel_reduce(0, pixel_count, empty_histogram, bin_range, merge, range_size);
+}
+
 } // NS Exposure
 } // NS ImageOperations
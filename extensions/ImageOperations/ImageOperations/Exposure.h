@@ -11,26 +11,80 @@
 
 #include <Bifrost/Assets/Image.h>
 
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_OPERATIONS_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace ImageOperations {
 namespace Exposure {
 
+// ------------------------------------------------------------------------------------------------
+// Luminance statistics.
+// The statistics are computed in parallel directly on the pixel data of RGB_Float, RGBA_Float,
+// Intensity_Float and 8 bit images. Other formats are read through Images::get_pixel.
+// Pixels are reduced in fixed size ranges that are combined in order, so the results are
+// independent of the number of threads.
+// Log luminance is computed with fast_log2 and luminance is clamped to 0.0001 before taking the log.
+// ------------------------------------------------------------------------------------------------
+
+// Approximates log2 of positive normalized floats. The error is below 2e-7 * max(1, |log2(x)|).
+// x = m * 2^e with m in [sqrt(0.5), sqrt(2)), so log2(x) = e + log2(m), where log2(m) is
+// approximated by the series 2 / ln(2) * atanh(t) with t = (m - 1) / (m + 1) and |t| < 0.172.
+inline float fast_log2(float x) {
+    int bits;
+    memcpy(&bits, &x, sizeof(float));
+    int exponent = (bits - 0x3F3504F3) >> 23; // 0x3F3504F3 is sqrt(0.5).
+    bits -= exponent << 23;
+    float mantissa;
+    memcpy(&mantissa, &bits, sizeof(float));
+
+    float t = (mantissa - 1.0f) / (mantissa + 1.0f);
+    float t2 = t * t;
+    float log2_mantissa = t * (2.885390082f + t2 * (0.961796694f + t2 * (0.577078016f + t2 * 0.412198583f)));
+    return exponent + log2_mantissa;
+}
+
+#ifdef IMAGE_OPERATIONS_SSE2
+// Four wide fast_log2. Performs the same operations as the scalar version and produces identical results.
+inline __m128 fast_log2(__m128 x) {
+    __m128i bits = _mm_castps_si128(x);
+    __m128i exponent = _mm_srai_epi32(_mm_sub_epi32(bits, _mm_set1_epi32(0x3F3504F3)), 23);
+    __m128 mantissa = _mm_castsi128_ps(_mm_sub_epi32(bits, _mm_slli_epi32(exponent, 23)));
+
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 t = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+    __m128 t2 = _mm_mul_ps(t, t);
+    __m128 polynomial = _mm_add_ps(_mm_set1_ps(0.577078016f), _mm_mul_ps(t2, _mm_set1_ps(0.412198583f)));
+    polynomial = _mm_add_ps(_mm_set1_ps(0.961796694f), _mm_mul_ps(t2, polynomial));
+    polynomial = _mm_add_ps(_mm_set1_ps(2.885390082f), _mm_mul_ps(t2, polynomial));
+    __m128 log2_mantissa = _mm_mul_ps(t, polynomial);
+    return _mm_add_ps(_mm_cvtepi32_ps(exponent), log2_mantissa);
+}
+#endif
+
 float summed_log_luminance(Bifrost::Assets::Images::UID image_ID);
 
 // Implements equation (1) in Reinhard et al, 2002, Photographic Tone Reproduction for Digital Images.
 float log_average_luminance(Bifrost::Assets::Images::UID image_ID);
 
+// Histogram with bin_count bins of the log luminance in the range [min_log_luminance, max_log_luminance].
+// Log luminances outside the range are added to the first or last bin.
+std::vector<unsigned int> log_luminance_histogram(Bifrost::Assets::Images::UID image_ID, float min_log_luminance, float max_log_luminance, int bin_count);
+
+// Adds the log luminance histogram of the image to the bins in [begin, end).
 template <typename ForwardIterator>
 inline void log_luminance_histogram(Bifrost::Assets::Images::UID image_ID, float min_log_luminance, float max_log_luminance,
                                     ForwardIterator begin, ForwardIterator end) {
-    using namespace Bifrost::Math;
-
-    int size = unsigned int(end - begin);
-    Bifrost::Assets::Images::iterate_pixels(image_ID, [&](RGBA pixel) {
-        float log_luminance = log2(fmaxf(luminance(pixel.rgb()), 0.0001f));
-        float normalized_index = inverse_lerp(min_log_luminance, max_log_luminance, log_luminance);
-        int index = clamp(int(normalized_index * size), 0, size - 1);
-        ++begin[index];
-    });
+    int bin_count = int(std::distance(begin, end));
+    for (unsigned int count : log_luminance_histogram(image_ID, min_log_luminance, max_log_luminance, bin_count)) {
+        *begin += count;
+        ++begin;
+    }
 }
 
 } // NS Exposure
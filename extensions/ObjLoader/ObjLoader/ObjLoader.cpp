@@ -14,11 +14,14 @@
 #include <Bifrost/Assets/Mesh.h>
 #include <Bifrost/Assets/MeshModel.h>
 #include <Bifrost/Core/Array.h>
+#include <Bifrost/Core/Profiler.h>
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <ObjLoader/tiny_obj_loader.h>
 
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 using namespace Bifrost;
 using namespace Bifrost::Assets;
@@ -49,6 +52,7 @@ void split_path(std::string& directory, std::string& filename, const std::string
 }
 
 SceneNodes::UID load(const std::string& path, ImageLoader image_loader) {
+    BIFROST_PROFILE_SCOPE("ObjLoader::load");
     std::string directory, filename;
     split_path(directory, filename, path);
 
@@ -70,6 +74,20 @@ SceneNodes::UID load(const std::string& path, ImageLoader image_loader) {
 
     SceneNodes::UID root_ID = shapes.size() > 1u ? SceneNodes::create(std::string(filename.begin(), filename.end()-4)) : SceneNodes::UID::invalid_UID();
 
+    // Identical images are shared between materials. Only the final images are shared, as the intermediate images are modified.
+    auto shared_images = std::unordered_map<unsigned long long, Images::UID>();
+    auto create_shared_texture = [&](Images::UID image_ID) -> Textures::UID {
+        unsigned long long hash = ImageUtils::hash(image_ID);
+        auto shared_image_itr = shared_images.find(hash);
+        if (shared_image_itr == shared_images.end())
+            shared_images.insert({ hash, image_ID });
+        else if (ImageUtils::has_identical_pixels(image_ID, shared_image_itr->second)) {
+            Images::destroy(image_ID);
+            image_ID = shared_image_itr->second;
+        }
+        return Textures::create2D(image_ID);
+    };
+
     Core::Array<Materials::UID> materials = Core::Array<Materials::UID>(unsigned int(tiny_materials.size()));
     for (int i = 0; i < int(tiny_materials.size()); ++i) {
         tinyobj::material_t tiny_mat = tiny_materials[i];
@@ -97,10 +115,11 @@ SceneNodes::UID load(const std::string& path, ImageLoader image_loader) {
             else {
                 if (Images::get_pixel_format(image_ID) != PixelFormat::Alpha8)
                     Images::change_format(image_ID, PixelFormat::Alpha8, 1.0f);
-                material_data.coverage_texture_ID = Textures::create2D(image_ID);
+                material_data.coverage_texture_ID = create_shared_texture(image_ID);
             }
         }
 
+        Image tint_roughness_image;
         if (!tiny_mat.diffuse_texname.empty()) {
             Image image = image_loader(directory + tiny_mat.diffuse_texname);
             if (!image.exists())
@@ -128,10 +147,10 @@ SceneNodes::UID load(const std::string& path, ImageLoader image_loader) {
                             }
 
                     if (min_coverage < 1.0f)
-                        material_data.coverage_texture_ID = Textures::create2D(coverage_image.get_ID());
+                        material_data.coverage_texture_ID = create_shared_texture(coverage_image.get_ID());
                 }
 
-                material_data.tint_roughness_texture_ID = Textures::create2D(image.get_ID());
+                tint_roughness_image = image;
             }
         }
 
@@ -140,19 +159,21 @@ SceneNodes::UID load(const std::string& path, ImageLoader image_loader) {
             if (!roughness_map.exists())
                 printf("ObjLoader::load error: Could not load image at '%s'.\n", (directory + tiny_mat.roughness_texname).c_str());
             else {
-                Texture old_tex = material_data.tint_roughness_texture_ID;
-                Image new_tint_roughness_image = ImageUtils::combine_tint_roughness(old_tex.get_image(), roughness_map.get_ID(), 0);
-                if (new_tint_roughness_image != old_tex.get_image()) {
-                    Textures::destroy(old_tex.get_ID());
-                    Images::destroy(old_tex.get_image().get_ID());
-                }
-                material_data.tint_roughness_texture_ID = Textures::create2D(new_tint_roughness_image.get_ID());;
+                Image new_tint_roughness_image = ImageUtils::combine_tint_roughness(tint_roughness_image, roughness_map.get_ID(), 0);
+                if (new_tint_roughness_image != tint_roughness_image && tint_roughness_image.exists())
+                    Images::destroy(tint_roughness_image.get_ID());
+                tint_roughness_image = new_tint_roughness_image;
             }
         }
 
+        if (tint_roughness_image.exists())
+            material_data.tint_roughness_texture_ID = create_shared_texture(tint_roughness_image.get_ID());
+
         materials[unsigned int(i)] = Materials::create(tiny_mat.name, material_data);
     }
 
+    auto mesh_IDs = std::vector<Meshes::UID>();
+    mesh_IDs.reserve(shapes.size());
     for (int s = 0; s < int(shapes.size()); ++s) {
         tinyobj::shape_t shape = shapes[s];
 
@@ -230,6 +251,7 @@ SceneNodes::UID load(const std::string& path, ImageLoader image_loader) {
         }
 
         bifrost_mesh.compute_bounds();
+        mesh_IDs.push_back(bifrost_mesh.get_ID());
 
         SceneNodes::UID node_ID = SceneNodes::create(shape.name);
         if (root_ID != SceneNodes::UID::invalid_UID())
@@ -242,6 +264,9 @@ SceneNodes::UID load(const std::string& path, ImageLoader image_loader) {
         MeshModels::UID model_ID = MeshModels::create(node_ID, bifrost_mesh.get_ID(), material_ID);
     }
 
+    // Reorder primitives and vertices for faster rendering.
+    MeshUtils::optimize(mesh_IDs.data(), mesh_IDs.data() + mesh_IDs.size());
+
     return root_ID;
 }
 
@@ -21,6 +21,8 @@
 #include <Bifrost/Assets/Texture.h>
 #include <Bifrost/Core/Array.h>
 #include <Bifrost/Core/Engine.h>
+#include <Bifrost/Core/Profiler.h>
+#include <Bifrost/Math/HalfFloat.h>
 #include <Bifrost/Math/OctahedralNormal.h>
 #include <Bifrost/Scene/Camera.h>
 #include <Bifrost/Scene/LightSource.h>
@@ -515,6 +517,8 @@ struct Renderer::Implementation {
     inline bool is_valid() const { return device_IDs.optix >= 0; }
 
     void handle_updates() {
+        BIFROST_PROFILE_FUNCTION();
+
         bool should_reset_accumulations = false;
 
         { // Camera updates.
@@ -600,6 +604,15 @@ struct Renderer::Implementation {
                             pixel_format = RT_FORMAT_FLOAT3; break;
                         case PixelFormat::RGBA_Float:
                             pixel_format = RT_FORMAT_FLOAT4; break;
+                        case PixelFormat::RGBA_Half:
+                            pixel_format = RT_FORMAT_HALF4; break;
+                        case PixelFormat::BC1_RGB: // OptiX does not support block compressed buffers. Decompress to ubyte4 buffers.
+                        case PixelFormat::BC4_Intensity:
+                        case PixelFormat::BC5_RG:
+                        case PixelFormat::BC7_RGBA:
+                            pixel_format = RT_FORMAT_UNSIGNED_BYTE4; break;
+                        case PixelFormat::BC6H_RGB: // Decompress HDR blocks to half4 buffers.
+                            pixel_format = RT_FORMAT_HALF4; break;
                         }
 
                         // NOTE setting the depth to 1 result in invalid 2D textures for some reason.
@@ -619,6 +632,26 @@ struct Renderer::Implementation {
                                 *optix_pixel_data++ = *pixel_data++;
                                 *optix_pixel_data++ = 255;
                             }
+                        } else if (image.get_pixel_format() == PixelFormat::BC6H_RGB) {
+                            // Decompress the linear HDR pixels.
+                            half* optix_half_data = (half*)optix_pixel_data;
+                            for (unsigned int p = 0; p < image.get_pixel_count(); ++p) {
+                                RGBA pixel = image.get_pixel(p);
+                                *optix_half_data++ = to_half(pixel.r);
+                                *optix_half_data++ = to_half(pixel.g);
+                                *optix_half_data++ = to_half(pixel.b);
+                                *optix_half_data++ = to_half(1.0f);
+                            }
+                        } else if (is_block_compressed(image.get_pixel_format())) {
+                            // Decompress the pixels and store them with the gamma of the image.
+                            float inverse_gamma = 1.0f / image.get_gamma();
+                            for (unsigned int p = 0; p < image.get_pixel_count(); ++p) {
+                                RGBA pixel = gammacorrect(image.get_pixel(p), inverse_gamma);
+                                *optix_pixel_data++ = unsigned char(clamp(pixel.r * 255.0f + 0.5f, 0.0f, 255.0f));
+                                *optix_pixel_data++ = unsigned char(clamp(pixel.g * 255.0f + 0.5f, 0.0f, 255.0f));
+                                *optix_pixel_data++ = unsigned char(clamp(pixel.b * 255.0f + 0.5f, 0.0f, 255.0f));
+                                *optix_pixel_data++ = unsigned char(clamp(pixel.a * 255.0f + 0.5f, 0.0f, 255.0f));
+                            }
                         } else
                             std::memcpy(optix_pixel_data, image.get_pixels(), images[image_ID]->getElementSize() * image.get_pixel_count());
                         images[image_ID]->unmap();
@@ -10,6 +10,9 @@
 
 #include <StbImageLoader/StbImageLoader.h>
 
+#include <Bifrost/Core/Profiler.h>
+#include <Bifrost/Math/HalfFloat.h>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <StbImageLoader/stb_image.h>
 
@@ -22,13 +25,13 @@ bool check_HDR_fileformat(const std::string& path) {
     return memcmp(path.c_str() + path.size() - 4, ".hdr", sizeof(unsigned char) * 4) == 0;
 }
 
-static PixelFormat resolve_format(int channels, bool is_HDR) {
+static PixelFormat resolve_format(int channels, bool is_HDR, bool store_HDR_as_half) {
     if (is_HDR) {
         switch (channels) {
         case 3:
-            return PixelFormat::RGB_Float;
+            return store_HDR_as_half ? PixelFormat::RGB_Half : PixelFormat::RGB_Float;
         case 4:
-            return PixelFormat::RGBA_Float;
+            return store_HDR_as_half ? PixelFormat::RGBA_Half : PixelFormat::RGBA_Float;
         }
     } else {
         switch (channels) {
@@ -63,13 +66,13 @@ unsigned int sizeof_format(PixelFormat format) {
     return 0u;
 }
 
-inline Images::UID convert_image(const std::string& name, void* loaded_pixels, int width, int height, int channel_count, bool is_HDR) {
+inline Images::UID convert_image(const std::string& name, void* loaded_pixels, int width, int height, int channel_count, bool is_HDR, bool store_HDR_as_half = false) {
     if (loaded_pixels == nullptr) {
         printf("StbImageLoader::load(%s) error: '%s'\n", name.c_str(), stbi_failure_reason());
         return Images::UID::invalid_UID();
     }
 
-    PixelFormat pixel_format = resolve_format(channel_count, is_HDR);
+    PixelFormat pixel_format = resolve_format(channel_count, is_HDR, store_HDR_as_half);
     if (pixel_format == PixelFormat::Unknown) {
         printf("StbImageLoader::load(%s) error: 'Could not resolve format'\n", name.c_str());
         return Images::UID::invalid_UID();
@@ -88,6 +91,8 @@ inline Images::UID convert_image(const std::string& name, void* loaded_pixels, i
             pixel_data_uc4[4 * i + 3] = loaded_data_uc2[2 * i + 1];
         }
     }
+    else if (is_half_format(pixel_format))
+        to_half((float*)loaded_pixels, (half*)pixel_data, channel_count * width * height);
     else
         memcpy(pixel_data, loaded_pixels, sizeof_format(pixel_format) * width * height);
 
@@ -96,7 +101,8 @@ inline Images::UID convert_image(const std::string& name, void* loaded_pixels, i
     return image_ID;
 }
 
-Images::UID load(const std::string& path) {
+Images::UID load(const std::string& path, bool store_HDR_as_half) {
+    BIFROST_PROFILE_SCOPE("StbImageLoader::load");
     stbi_set_flip_vertically_on_load(true);
 
     void* loaded_pixels = nullptr;
@@ -107,10 +113,11 @@ Images::UID load(const std::string& path) {
     else
         loaded_pixels = stbi_load(path.c_str(), &width, &height, &channel_count, 0);
 
-    return convert_image(path, loaded_pixels, width, height, channel_count, is_HDR);
+    return convert_image(path, loaded_pixels, width, height, channel_count, is_HDR, store_HDR_as_half);
 }
 
 Bifrost::Assets::Images::UID load_from_memory(const std::string& name, const void* const data, int data_byte_count) {
+    BIFROST_PROFILE_SCOPE("StbImageLoader::load_from_memory");
     stbi_set_flip_vertically_on_load(false);
 
     int width, height, channel_count;
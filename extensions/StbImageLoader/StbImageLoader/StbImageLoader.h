@@ -17,8 +17,9 @@ namespace StbImageLoader {
 // -----------------------------------------------------------------------
 // Loads an image file.
 // Basic support for png, exr, jpg and more.
+// HDR images are stored with half precision if store_HDR_as_half is true.
 // -----------------------------------------------------------------------
-Bifrost::Assets::Images::UID load(const std::string& filename);
+Bifrost::Assets::Images::UID load(const std::string& filename, bool store_HDR_as_half = false);
 Bifrost::Assets::Images::UID load_from_memory(const std::string& name, const void* const data, int data_byte_count);
 
 } // NS StbImageLoader
@@ -10,6 +10,9 @@
 
 #include <TinyExr/TinyExr.h>
 
+#include <Bifrost/Core/Profiler.h>
+#include <Bifrost/Math/HalfFloat.h>
+
 #define TINYEXR_IMPLEMENTATION
 #include <TinyExr/tiny_exr.h>
 
@@ -18,7 +21,8 @@ using namespace Bifrost::Math;
 
 namespace TinyExr {
 
-Result load_verbose(const std::string& filename, Bifrost::Assets::Images::UID& image_ID) {
+Result load_verbose(const std::string& filename, Bifrost::Assets::Images::UID& image_ID, bool store_as_half) {
+    BIFROST_PROFILE_SCOPE("TinyExr::load");
 
     float* rgba = nullptr;
     int width, height;
@@ -27,9 +31,13 @@ Result load_verbose(const std::string& filename, Bifrost::Assets::Images::UID& i
 
     if (res == Result::Success) {
         float image_gamma = 1.0f;
-        image_ID = Images::create2D(filename, PixelFormat::RGBA_Float, image_gamma, Vector2ui(width, height));
+        PixelFormat pixel_format = store_as_half ? PixelFormat::RGBA_Half : PixelFormat::RGBA_Float;
+        image_ID = Images::create2D(filename, pixel_format, image_gamma, Vector2ui(width, height));
         Images::PixelData pixel_data = Images::get_pixels(image_ID);
-        memcpy(pixel_data, rgba, sizeof(float) * 4 * width * height);
+        if (store_as_half)
+            to_half(rgba, (half*)pixel_data, 4 * width * height);
+        else
+            memcpy(pixel_data, rgba, sizeof(float) * 4 * width * height);
     }
     else
     {
@@ -43,6 +51,7 @@ Result load_verbose(const std::string& filename, Bifrost::Assets::Images::UID& i
 }
 
 Result store(Bifrost::Assets::Images::UID image_ID, const std::string& filename) {
+    BIFROST_PROFILE_SCOPE("TinyExr::store");
     Result res;
     const char* error_msg = nullptr;
 
@@ -51,6 +60,17 @@ Result store(Bifrost::Assets::Images::UID image_ID, const std::string& filename)
         int save_as_fp16 = 0;
         res = (Result)SaveEXR((float*)image.get_pixels(), image.get_width(), image.get_height(), channel_count(image.get_pixel_format()),
                               save_as_fp16, filename.c_str(), &error_msg);
+    } else if (is_half_format(image.get_pixel_format()) && image.get_gamma() == 1.0f) {
+        // Widen the halfs to floats and let tinyexr store them as halfs again without loss.
+        int value_count = image.get_pixel_count() * channel_count(image.get_pixel_format());
+        float* pixel_data = new float[value_count];
+        to_float((half*)image.get_pixels(), pixel_data, value_count);
+
+        int save_as_fp16 = 1;
+        res = (Result)SaveEXR(pixel_data, image.get_width(), image.get_height(), channel_count(image.get_pixel_format()),
+                              save_as_fp16, filename.c_str(), &error_msg);
+
+        delete[] pixel_data;
     } else {
         RGBA* pixel_data = new RGBA[image.get_pixel_count()];
         for (unsigned int y = 0; y < image.get_height(); ++y)
@@ -29,17 +29,19 @@ enum class Result {
 
 // -----------------------------------------------------------------------
 // Load an exr image file.
+// The image is stored as RGBA_Float or as RGBA_Half if store_as_half is true.
 // -----------------------------------------------------------------------
-Result load_verbose(const std::string& filename, Bifrost::Assets::Images::UID& image_ID);
+Result load_verbose(const std::string& filename, Bifrost::Assets::Images::UID& image_ID, bool store_as_half = false);
 
-inline Bifrost::Assets::Images::UID load(const std::string& filename) {
+inline Bifrost::Assets::Images::UID load(const std::string& filename, bool store_as_half = false) {
     Bifrost::Assets::Images::UID image_ID;
-    load_verbose(filename, image_ID);
+    load_verbose(filename, image_ID, store_as_half);
     return image_ID;
 }
 
 // -----------------------------------------------------------------------
 // Store an exr image file.
+// Float images are stored with full precision and all other images with half precision.
 // -----------------------------------------------------------------------
 Result store(Bifrost::Assets::Images::UID image_ID, const std::string& filename);
 
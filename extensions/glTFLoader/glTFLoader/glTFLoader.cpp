@@ -13,6 +13,8 @@
 #include <Bifrost/Assets/Material.h>
 #include <Bifrost/Assets/Mesh.h>
 #include <Bifrost/Assets/MeshModel.h>
+#include <Bifrost/Core/Hash.h>
+#include <Bifrost/Core/Profiler.h>
 #include <Bifrost/Math/Conversions.h>
 
 #include <StbImageLoader/StbImageLoader.h>
@@ -22,6 +24,7 @@
 #define TINYGLTF_NO_STB_IMAGE_WRITE 1
 #include <glTFLoader/tiny_gltf.h>
 
+#include <algorithm>
 #include <unordered_map>
 
 using namespace Bifrost::Assets;
@@ -49,6 +52,66 @@ struct LoadedMesh {
     Meshes::UID ID;
     bool is_used;
 };
+
+// ------------------------------------------------------------------------------------------------
+// Asset deduplication.
+// Identical meshes and images are shared instead of duplicated. Assets are looked up by their
+// content hash and only shared if their content is identical, so hash collisions are harmless.
+// ------------------------------------------------------------------------------------------------
+
+using MeshTable = std::unordered_map<unsigned long long, Meshes::UID>;
+using ImageTable = std::unordered_map<unsigned long long, Images::UID>;
+
+// Returns an identical image from the table and destroys the given image if one exists. Otherwise the image is added to the table.
+inline Images::UID share_identical_image(Images::UID image_ID, ImageTable& images) {
+    unsigned long long hash = ImageUtils::hash(image_ID);
+    auto shared_image_itr = images.find(hash);
+    if (shared_image_itr == images.end()) {
+        images.insert({ hash, image_ID });
+        return image_ID;
+    }
+
+    Images::UID shared_image_ID = shared_image_itr->second;
+    if (!ImageUtils::has_identical_pixels(image_ID, shared_image_ID))
+        return image_ID;
+
+    Images::destroy(image_ID);
+    return shared_image_ID;
+}
+
+// Replaces meshes by identical meshes earlier in the list and destroys the duplicates.
+void share_identical_meshes(std::vector<LoadedMesh>& meshes) {
+    auto hashes = std::vector<unsigned long long>(meshes.size());
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int m = 0; m < int(meshes.size()); ++m)
+        hashes[m] = MeshUtils::hash(meshes[m].ID);
+
+    MeshTable shared_meshes;
+    for (int m = 0; m < int(meshes.size()); ++m) {
+        auto shared_mesh_itr = shared_meshes.find(hashes[m]);
+        if (shared_mesh_itr == shared_meshes.end())
+            shared_meshes.insert({ hashes[m], meshes[m].ID });
+        else if (MeshUtils::has_identical_buffers(meshes[m].ID, shared_mesh_itr->second)) {
+            Meshes::destroy(meshes[m].ID);
+            meshes[m].ID = shared_mesh_itr->second;
+        }
+    }
+}
+
+// Meshes with a residual transformation applied, keyed by the source mesh and the residual transformation.
+struct TransformedMeshKey {
+    Meshes::UID mesh_ID;
+    Matrix3x4f transform;
+
+    inline bool operator==(const TransformedMeshKey& rhs) const { return memcmp(this, &rhs, sizeof(TransformedMeshKey)) == 0; }
+};
+
+struct TransformedMeshKeyHasher {
+    inline size_t operator()(const TransformedMeshKey& key) const { return size_t(hash64(&key, sizeof(TransformedMeshKey))); }
+};
+
+using TransformedMeshTable = std::unordered_map<TransformedMeshKey, Meshes::UID, TransformedMeshKeyHasher>;
+
 // ------------------------------------------------------------------------------------------------
 // Texture sampler conversion utils.
 // ------------------------------------------------------------------------------------------------
@@ -268,7 +331,7 @@ bool decompose_transformation(Matrix3x4d matrix, Transform& transform) {
 
 SceneNodes::UID import_node(const tinygltf::Model& model, const tinygltf::Node& node, const Matrix3x4d parent_transform, 
                             const std::vector<int>& meshes_start_index, std::vector<LoadedMesh>& meshes,
-                            const std::vector<Materials::UID>& material_IDs) {
+                            const std::vector<Materials::UID>& material_IDs, TransformedMeshTable& transformed_meshes) {
     // Local transform and scene node.
     Matrix3x4d local_transform;
     if (node.matrix.size() == 16) {
@@ -321,10 +384,18 @@ SceneNodes::UID import_node(const tinygltf::Model& model, const tinygltf::Node&
             auto& mesh = meshes[mesh_index++];
             Meshes::UID mesh_ID = mesh.ID;
             if (apply_residual_transformation) {
-                mesh_ID = MeshUtils::deep_clone(mesh_ID);
-                MeshUtils::transform_mesh(mesh_ID, residual_transformation);
+                // Reuse the transformed mesh if the mesh has already been transformed by the same residual transformation.
+                auto transformed_mesh_key = TransformedMeshKey{ mesh.ID, residual_transformation };
+                auto transformed_mesh_itr = transformed_meshes.find(transformed_mesh_key);
+                if (transformed_mesh_itr != transformed_meshes.end())
+                    mesh_ID = transformed_mesh_itr->second;
+                else {
+                    mesh_ID = MeshUtils::deep_clone(mesh_ID);
+                    MeshUtils::transform_mesh(mesh_ID, residual_transformation);
+                    transformed_meshes.insert({ transformed_mesh_key, mesh_ID });
+                }
             }
-            mesh.is_used = mesh_ID == mesh.ID;
+            mesh.is_used |= mesh_ID == mesh.ID;
             auto material_ID = material_IDs[primitive.material];
             MeshModels::create(scene_node_ID, mesh_ID, material_ID);
         }
@@ -333,7 +404,7 @@ SceneNodes::UID import_node(const tinygltf::Model& model, const tinygltf::Node&
     // Recurse over children.
     for (const int child_node_index : node.children) {
         const auto& node = model.nodes[child_node_index];
-        SceneNode child_node = import_node(model, node, global_transform, meshes_start_index, meshes, material_IDs);
+        SceneNode child_node = import_node(model, node, global_transform, meshes_start_index, meshes, material_IDs, transformed_meshes);
         child_node.set_parent(scene_node_ID);
     }
 
@@ -354,6 +425,7 @@ void copy_indices(unsigned int* bifrost_indices, const T* glTF_indices, size_t c
 // Loads a glTF file.
 // ------------------------------------------------------------------------------------------------
 SceneNodes::UID load(const std::string& filename) {
+    BIFROST_PROFILE_SCOPE("glTFLoader::load");
 
     // See https://github.com/syoyo/tinygltf/blob/master/loader_example.cc
 
@@ -396,14 +468,20 @@ SceneNodes::UID load(const std::string& filename) {
         glTF_image->width = image.get_width();
         glTF_image->height = image.get_height();
         glTF_image->component = channel_count(image.get_pixel_format());
+
+        // Share the image with previously loaded identical images.
+        ImageTable& loaded_images = *(ImageTable*)user_data;
+        Images::UID image_ID = share_identical_image(image.get_ID(), loaded_images);
+
         // HACK Store image ID in pixels instead of pixel data.
         glTF_image->image.resize(4);
-        memcpy(glTF_image->image.data(), &image.get_ID(), sizeof(Images::UID));
+        memcpy(glTF_image->image.data(), &image_ID, sizeof(Images::UID));
 
         return true;
     };
 
-    glTF_ctx.SetImageLoader(image_loader, nullptr);
+    ImageTable loaded_images;
+    glTF_ctx.SetImageLoader(image_loader, &loaded_images);
 
     bool ret = false;
     if (string_ends_with(filename, "glb"))
@@ -494,13 +572,24 @@ SceneNodes::UID load(const std::string& filename) {
         loaded_material_IDs[i] = Materials::create(glTF_mat.name, mat_data);
     }
 
-    // Delete images not used by the datamodel.
-    for (int i = 0; i < image_is_used.size(); ++i) {
-        if (!image_is_used[i]) {
-            const auto& glTF_image = model.images[i];
+    { // Delete images not used by the datamodel.
+        // Identical images are shared between glTF images, so an image is only deleted if none of the glTF images referencing it are used.
+        auto get_image_ID = [&](int glTF_image_index) -> Images::UID {
             Images::UID image_ID;
-            memcpy(&image_ID, glTF_image.image.data(), sizeof(image_ID));
-            Images::destroy(image_ID);
+            memcpy(&image_ID, model.images[glTF_image_index].image.data(), sizeof(image_ID));
+            return image_ID;
+        };
+
+        auto used_image_IDs = std::vector<Images::UID>();
+        for (int i = 0; i < image_is_used.size(); ++i)
+            if (image_is_used[i])
+                used_image_IDs.push_back(get_image_ID(i));
+
+        for (int i = 0; i < image_is_used.size(); ++i) {
+            Images::UID image_ID = get_image_ID(i);
+            bool is_used = std::find(used_image_IDs.begin(), used_image_IDs.end(), image_ID) != used_image_IDs.end();
+            if (!is_used && Images::has(image_ID))
+                Images::destroy(image_ID);
         }
     }
 
@@ -646,6 +735,17 @@ SceneNodes::UID load(const std::string& filename) {
     // Finally push the total number of meshes to allow fetching begin and end indices as [index] and [index+1]
     loaded_meshes_start_index.push_back(loaded_meshes.size());
 
+    { // Reorder primitives and vertices for faster rendering. Done before the meshes are cloned by the scene import.
+        auto mesh_IDs = std::vector<Meshes::UID>();
+        mesh_IDs.reserve(loaded_meshes.size());
+        for (const auto& mesh : loaded_meshes)
+            mesh_IDs.push_back(mesh.ID);
+        MeshUtils::optimize(mesh_IDs.data(), mesh_IDs.data() + mesh_IDs.size());
+    }
+
+    // Share identical meshes. Done after optimization, as the optimized buffers are a deterministic function of the input buffers.
+    share_identical_meshes(loaded_meshes);
+
     // KHR_lights_cmn not supported.
     if (model.lights.size() > 0)
         printf("GLTFLoader::load warning: KHR_lights_cmn not supported. Light sources will be ignored.\n");
@@ -659,17 +759,25 @@ SceneNodes::UID load(const std::string& filename) {
             return SceneNodes::UID::invalid_UID();
 
         static auto destroy_unused_meshes = [](const std::vector<LoadedMesh>& meshes) {
+            // Identical meshes are shared between loaded meshes, so a mesh is only destroyed if none of the loaded meshes referencing it are used.
+            auto mesh_is_used = std::vector<bool>(Meshes::capacity(), false);
+            for (auto mesh : meshes)
+                if (mesh.is_used)
+                    mesh_is_used[mesh.ID.get_index()] = true;
+
             for (auto mesh : meshes)
-                if (!mesh.is_used)
+                if (!mesh_is_used[mesh.ID.get_index()] && Meshes::has(mesh.ID))
                     Meshes::destroy(mesh.ID);
         };
 
+        TransformedMeshTable transformed_meshes;
+
         const tinygltf::Scene& scene = model.scenes[model.defaultScene];
         Matrix3x4d identity_transform = { {1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0 } };
         if (scene.nodes.size() == 1) {
             // Only one node. Import it and return.
             const auto& node = model.nodes[scene.nodes[0]];
-            SceneNodes::UID root_node_ID = import_node(model, node, identity_transform, loaded_meshes_start_index, loaded_meshes, loaded_material_IDs);
+            SceneNodes::UID root_node_ID = import_node(model, node, identity_transform, loaded_meshes_start_index, loaded_meshes, loaded_material_IDs, transformed_meshes);
             destroy_unused_meshes(loaded_meshes);
             return root_node_ID;
         } else {
@@ -677,7 +785,7 @@ SceneNodes::UID load(const std::string& filename) {
             SceneNode root_node = SceneNodes::create("Scene root");
             for (size_t i = 0; i < scene.nodes.size(); i++) {
                 const auto& node = model.nodes[scene.nodes[i]];
-                SceneNode child_node = import_node(model, node, identity_transform, loaded_meshes_start_index, loaded_meshes, loaded_material_IDs);
+                SceneNode child_node = import_node(model, node, identity_transform, loaded_meshes_start_index, loaded_meshes, loaded_material_IDs, transformed_meshes);
                 child_node.set_parent(root_node);
             }
             destroy_unused_meshes(loaded_meshes);
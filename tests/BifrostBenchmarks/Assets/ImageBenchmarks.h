@@ -0,0 +1,80 @@
+// Bifrost image benchmarks.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_ASSETS_IMAGE_BENCHMARKS_H_
+#define _BIFROST_ASSETS_IMAGE_BENCHMARKS_H_
+
+#include <Benchmark.h>
+
+#include <Bifrost/Assets/Image.h>
+
+namespace Bifrost {
+namespace Assets {
+
+inline Image create_gradient_image(PixelFormat format, Math::Vector2ui size) {
+    Image image = Images::create2D("Gradient", format, 2.2f, size);
+    for (unsigned int y = 0; y < size.y; ++y)
+        for (unsigned int x = 0; x < size.x; ++x) {
+            float u = x / float(size.x), v = y / float(size.y);
+            image.set_pixel(Math::RGBA(u, v, 1.0f - u, 1.0f - v), Math::Vector2ui(x, y));
+        }
+    return image;
+}
+
+BIFROST_BENCHMARK(Images, pixel_access) {
+    Images::allocate(2u);
+
+    for (PixelFormat format : { PixelFormat::RGBA32, PixelFormat::RGBA_Float }) {
+        Image image = create_gradient_image(format, Math::Vector2ui(256, 256));
+        unsigned int pixel_count = image.get_pixel_count();
+        std::string format_name = format == PixelFormat::RGBA32 ? "RGBA32" : "RGBA_Float";
+
+        context.measure("get_pixel/" + format_name, [&]() {
+            Math::RGBA sum = Math::RGBA(0, 0, 0, 0);
+            for (unsigned int p = 0; p < pixel_count; ++p) {
+                Math::RGBA pixel = image.get_pixel(p);
+                sum.r += pixel.r; sum.g += pixel.g; sum.b += pixel.b; sum.a += pixel.a;
+            }
+            Benchmarks::do_not_optimize(sum);
+        }, pixel_count);
+
+        context.measure("set_pixel/" + format_name, [&]() {
+            for (unsigned int p = 0; p < pixel_count; ++p)
+                image.set_pixel(Math::RGBA(0.25f, 0.5f, 0.75f, 1.0f), p);
+        }, pixel_count);
+
+        Images::destroy(image.get_ID());
+    }
+
+    Images::deallocate();
+}
+
+BIFROST_BENCHMARK(Images, change_format) {
+    Images::allocate(1u);
+
+    Image image = create_gradient_image(PixelFormat::RGBA32, Math::Vector2ui(256, 256));
+    unsigned int pixel_count = image.get_pixel_count();
+
+    // Convert back and forth, so every iteration starts from the same format.
+    context.measure("RGBA32_RGBA_Float_round_trip", [&]() {
+        image.change_format(PixelFormat::RGBA_Float, 1.0f);
+        image.change_format(PixelFormat::RGBA32, 2.2f);
+    }, 2.0 * pixel_count);
+
+    context.measure("RGBA32_RGB24_round_trip", [&]() {
+        image.change_format(PixelFormat::RGB24, 2.2f);
+        image.change_format(PixelFormat::RGBA32, 2.2f);
+    }, 2.0 * pixel_count);
+
+    Images::deallocate();
+}
+
+} // NS Assets
+} // NS Bifrost
+
+#endif // _BIFROST_ASSETS_IMAGE_BENCHMARKS_H_
@@ -0,0 +1,60 @@
+// Bifrost infinite area light benchmarks.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_ASSETS_INFINITE_AREA_LIGHT_BENCHMARKS_H_
+#define _BIFROST_ASSETS_INFINITE_AREA_LIGHT_BENCHMARKS_H_
+
+#include <Benchmark.h>
+#include <Assets/ImageBenchmarks.h>
+
+#include <Bifrost/Assets/InfiniteAreaLight.h>
+#include <Bifrost/Math/RNG.h>
+
+namespace Bifrost {
+namespace Assets {
+
+BIFROST_BENCHMARK(InfiniteAreaLight, build_and_sample) {
+    Images::allocate(1u);
+    Textures::allocate(1u);
+
+    Image image = create_gradient_image(PixelFormat::RGBA_Float, Math::Vector2ui(512, 256));
+    Textures::UID latlong_ID = Textures::create2D(image.get_ID(), MagnificationFilter::Linear, MinificationFilter::Linear, WrapMode::Repeat, WrapMode::Clamp);
+
+    context.measure("build", [&]() {
+        InfiniteAreaLight light = InfiniteAreaLight(latlong_ID);
+        Benchmarks::do_not_optimize(light.get_width());
+    }, image.get_pixel_count());
+
+    const InfiniteAreaLight light = InfiniteAreaLight(latlong_ID);
+    const int sample_count = 4096;
+
+    context.measure("sample", [&]() {
+        float PDF_sum = 0.0f;
+        for (int s = 0; s < sample_count; ++s)
+            PDF_sum += light.sample(Math::RNG::sample02(s)).PDF;
+        Benchmarks::do_not_optimize(PDF_sum);
+    }, sample_count);
+
+    context.measure("evaluate", [&]() {
+        Math::RGB sum = Math::RGB::black();
+        for (int s = 0; s < sample_count; ++s) {
+            Math::Vector2f uv = Math::RNG::sample02(s);
+            Math::Vector3f direction = Math::Vector3f(uv.x * 2.0f - 1.0f, uv.y * 2.0f - 1.0f, 0.5f);
+            sum += light.evaluate(Math::normalize(direction));
+        }
+        Benchmarks::do_not_optimize(sum);
+    }, sample_count);
+
+    Textures::deallocate();
+    Images::deallocate();
+}
+
+} // NS Assets
+} // NS Bifrost
+
+#endif // _BIFROST_ASSETS_INFINITE_AREA_LIGHT_BENCHMARKS_H_
@@ -0,0 +1,56 @@
+// Bifrost mesh benchmarks.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_ASSETS_MESH_BENCHMARKS_H_
+#define _BIFROST_ASSETS_MESH_BENCHMARKS_H_
+
+#include <Benchmark.h>
+
+#include <Bifrost/Assets/Mesh.h>
+#include <Bifrost/Assets/MeshCreation.h>
+
+#include <vector>
+
+namespace Bifrost {
+namespace Assets {
+
+BIFROST_BENCHMARK(MeshUtils, compute_normals) {
+    Meshes::allocate(1u);
+
+    Mesh sphere = MeshCreation::revolved_sphere(256, 128);
+    unsigned int vertex_count = sphere.get_vertex_count();
+
+    context.measure("area_weighted", [&]() { MeshUtils::compute_normals(sphere.get_ID(), NormalWeighting::Area); }, vertex_count);
+    context.measure("angle_weighted", [&]() { MeshUtils::compute_normals(sphere.get_ID(), NormalWeighting::Angle); }, vertex_count);
+
+    Meshes::deallocate();
+}
+
+BIFROST_BENCHMARK(MeshUtils, combine) {
+    Meshes::allocate(2u);
+
+    Meshes::UID cube_ID = MeshCreation::cube(8);
+    const int cube_count = 64;
+    std::vector<MeshUtils::TransformedMesh> cubes(cube_count);
+    for (int c = 0; c < cube_count; ++c)
+        cubes[c] = { cube_ID, Math::Transform(Math::Vector3f(float(c % 8), float(c / 8), 0.0f)) };
+    unsigned int vertex_count = cube_count * Meshes::get_vertex_count(cube_ID);
+
+    context.measure([&]() {
+        Meshes::UID combined_ID = MeshUtils::combine("Combined cubes", cubes.data(), cubes.data() + cube_count);
+        Meshes::destroy(combined_ID);
+        Meshes::reset_change_notifications();
+    }, vertex_count);
+
+    Meshes::deallocate();
+}
+
+} // NS Assets
+} // NS Bifrost
+
+#endif // _BIFROST_ASSETS_MESH_BENCHMARKS_H_
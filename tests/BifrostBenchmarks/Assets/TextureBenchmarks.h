@@ -0,0 +1,56 @@
+// Bifrost texture benchmarks.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_ASSETS_TEXTURE_BENCHMARKS_H_
+#define _BIFROST_ASSETS_TEXTURE_BENCHMARKS_H_
+
+#include <Benchmark.h>
+#include <Assets/ImageBenchmarks.h>
+
+#include <Bifrost/Assets/Texture.h>
+#include <Bifrost/Math/RNG.h>
+
+namespace Bifrost {
+namespace Assets {
+
+BIFROST_BENCHMARK(Textures, sample2D) {
+    Images::allocate(2u);
+    Textures::allocate(2u);
+
+    const int sample_count = 4096;
+    for (PixelFormat format : { PixelFormat::RGBA32, PixelFormat::RGBA_Float }) {
+        Image image = create_gradient_image(format, Math::Vector2ui(512, 256));
+        std::string format_name = format == PixelFormat::RGBA32 ? "RGBA32" : "RGBA_Float";
+
+        for (MagnificationFilter filter : { MagnificationFilter::None, MagnificationFilter::Linear }) {
+            Textures::UID texture_ID = Textures::create2D(image.get_ID(), filter, MinificationFilter::None);
+            std::string filter_name = filter == MagnificationFilter::None ? "nearest" : "linear";
+
+            context.measure(format_name + "/" + filter_name, [&]() {
+                Math::RGBA sum = Math::RGBA(0, 0, 0, 0);
+                for (int s = 0; s < sample_count; ++s) {
+                    Math::RGBA sample = sample2D(texture_ID, Math::RNG::sample02(s));
+                    sum.r += sample.r; sum.g += sample.g; sum.b += sample.b; sum.a += sample.a;
+                }
+                Benchmarks::do_not_optimize(sum);
+            }, sample_count);
+
+            Textures::destroy(texture_ID);
+        }
+
+        Images::destroy(image.get_ID());
+    }
+
+    Textures::deallocate();
+    Images::deallocate();
+}
+
+} // NS Assets
+} // NS Bifrost
+
+#endif // _BIFROST_ASSETS_TEXTURE_BENCHMARKS_H_
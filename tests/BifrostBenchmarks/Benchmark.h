@@ -0,0 +1,243 @@
+// Bifrost micro-benchmark harness.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_BENCHMARKS_BENCHMARK_H_
+#define _BIFROST_BENCHMARKS_BENCHMARK_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Bifrost {
+namespace Benchmarks {
+
+// ---------------------------------------------------------------------------
+// Benchmark options, set from the command line.
+// ---------------------------------------------------------------------------
+struct Options {
+    std::string filter; // Only run benchmarks whose name contains the filter.
+    int warmup_repetitions = 2;
+    int repetitions = 10;
+    double min_repetition_time = 0.02; // Seconds. The iteration count is doubled until a repetition takes at least this long.
+};
+
+// ---------------------------------------------------------------------------
+// Summary of the nanoseconds pr iteration measured in each repetition.
+// ---------------------------------------------------------------------------
+struct Statistics {
+    double mean;
+    double median;
+    double standard_deviation;
+    double min;
+    double max;
+
+    static Statistics compute(std::vector<double> samples) {
+        std::sort(samples.begin(), samples.end());
+        int count = int(samples.size());
+
+        double sum = 0.0;
+        for (double sample : samples)
+            sum += sample;
+        double mean = sum / count;
+
+        double squared_deviation_sum = 0.0;
+        for (double sample : samples)
+            squared_deviation_sum += (sample - mean) * (sample - mean);
+        double standard_deviation = count > 1 ? sqrt(squared_deviation_sum / (count - 1)) : 0.0;
+
+        double median = count % 2 == 1 ? samples[count / 2] : 0.5 * (samples[count / 2 - 1] + samples[count / 2]);
+
+        return { mean, median, standard_deviation, samples.front(), samples.back() };
+    }
+};
+
+struct Result {
+    std::string name;
+    int repetitions;
+    unsigned long long iterations; // Iterations pr repetition.
+    double items_per_iteration;
+    Statistics nanoseconds_per_iteration;
+
+    double items_per_second() const { return items_per_iteration * 1e9 / nanoseconds_per_iteration.median; }
+};
+
+// ---------------------------------------------------------------------------
+// Prevents the compiler from discarding a value that is only computed for benchmarking.
+// ---------------------------------------------------------------------------
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    static volatile unsigned char sink;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    unsigned char folded_bytes = 0;
+    for (int i = 0; i < int(sizeof(T)); ++i)
+        folded_bytes ^= bytes[i];
+    sink = folded_bytes;
+}
+
+// ---------------------------------------------------------------------------
+// Passed to each benchmark. Benchmarks set up their data, measure one or more bodies and clean up.
+// ---------------------------------------------------------------------------
+class Context final {
+public:
+    Context(const std::string& name, const Options& options, std::vector<Result>& results)
+        : m_name(name), m_options(options), m_results(results) { }
+
+    // Measures the body, which processes items_per_iteration items, fx pixels or nodes, pr call.
+    template <typename Body>
+    void measure(const std::string& label, Body body, double items_per_iteration = 1.0) {
+        using Clock = std::chrono::steady_clock;
+        auto run_iterations = [&](unsigned long long iteration_count) -> double {
+            auto start = Clock::now();
+            for (unsigned long long i = 0; i < iteration_count; ++i)
+                body();
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        };
+
+        // Find an iteration count that makes a repetition long enough to be timed reliably. Doubles as warm-up.
+        unsigned long long iteration_count = 1;
+        while (run_iterations(iteration_count) < m_options.min_repetition_time && iteration_count < (1ull << 40))
+            iteration_count *= 2;
+
+        for (int r = 0; r < m_options.warmup_repetitions; ++r)
+            run_iterations(iteration_count);
+
+        std::vector<double> nanoseconds_per_iteration(m_options.repetitions);
+        for (int r = 0; r < m_options.repetitions; ++r)
+            nanoseconds_per_iteration[r] = run_iterations(iteration_count) * 1e9 / iteration_count;
+
+        std::string name = label.empty() ? m_name : m_name + "/" + label;
+        Result result = { name, m_options.repetitions, iteration_count, items_per_iteration, Statistics::compute(nanoseconds_per_iteration) };
+        printf("%-56s %14.1f ns %8.2f%% %14.3f Mitems/s\n", result.name.c_str(), result.nanoseconds_per_iteration.median,
+               100.0 * result.nanoseconds_per_iteration.standard_deviation / result.nanoseconds_per_iteration.mean,
+               result.items_per_second() * 1e-6);
+        m_results.push_back(result);
+    }
+
+    template <typename Body>
+    void measure(Body body, double items_per_iteration = 1.0) { measure("", body, items_per_iteration); }
+
+private:
+    std::string m_name;
+    const Options& m_options;
+    std::vector<Result>& m_results;
+};
+
+// ---------------------------------------------------------------------------
+// Benchmark registry.
+// ---------------------------------------------------------------------------
+typedef void(*BenchmarkFunction)(Context& context);
+
+struct Registration {
+    std::string name;
+    BenchmarkFunction function;
+};
+
+inline std::vector<Registration>& get_registrations() {
+    static std::vector<Registration> registrations;
+    return registrations;
+}
+
+struct Registrar {
+    Registrar(const char* name, BenchmarkFunction function) { get_registrations().push_back({ name, function }); }
+};
+
+#define BIFROST_BENCHMARK(group, name) \
+    static void group##_##name##_benchmark(Bifrost::Benchmarks::Context& context); \
+    static const Bifrost::Benchmarks::Registrar group##_##name##_registrar(#group "." #name, group##_##name##_benchmark); \
+    static void group##_##name##_benchmark(Bifrost::Benchmarks::Context& context)
+
+inline std::vector<Result> run_benchmarks(const Options& options) {
+    std::vector<Result> results;
+    for (const Registration& registration : get_registrations()) {
+        if (registration.name.find(options.filter) == std::string::npos)
+            continue;
+        Context context = Context(registration.name, options, results);
+        registration.function(context);
+    }
+    return results;
+}
+
+// ---------------------------------------------------------------------------
+// JSON output and comparison with a baseline.
+// The results are written one benchmark pr line, which keeps diffs between commits readable
+// and lets the baseline be read back without a JSON parser.
+// ---------------------------------------------------------------------------
+inline bool write_json(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream output(path);
+    if (!output)
+        return false;
+
+    output << "{\n\"benchmarks\": [\n";
+    for (int r = 0; r < int(results.size()); ++r) {
+        const Result& result = results[r];
+        const Statistics& stats = result.nanoseconds_per_iteration;
+        output << "{\"name\": \"" << result.name << "\", \"repetitions\": " << result.repetitions
+               << ", \"iterations\": " << result.iterations << ", \"items_per_iteration\": " << result.items_per_iteration
+               << ", \"mean_ns\": " << stats.mean << ", \"median_ns\": " << stats.median
+               << ", \"stddev_ns\": " << stats.standard_deviation << ", \"min_ns\": " << stats.min << ", \"max_ns\": " << stats.max
+               << ", \"items_per_second\": " << result.items_per_second() << "}" << (r + 1 < int(results.size()) ? ",\n" : "\n");
+    }
+    output << "]\n}\n";
+    return output.good();
+}
+
+struct BaselineEntry {
+    std::string name;
+    double median_ns;
+};
+
+inline std::vector<BaselineEntry> read_baseline(const std::string& path) {
+    std::vector<BaselineEntry> baseline;
+    std::ifstream input(path);
+    std::string line;
+    while (std::getline(input, line)) {
+        size_t name_begin = line.find("\"name\": \"");
+        size_t median_begin = line.find("\"median_ns\": ");
+        if (name_begin == std::string::npos || median_begin == std::string::npos)
+            continue;
+        name_begin += 9;
+        size_t name_end = line.find('"', name_begin);
+        double median_ns = atof(line.c_str() + median_begin + 13);
+        baseline.push_back({ line.substr(name_begin, name_end - name_begin), median_ns });
+    }
+    return baseline;
+}
+
+// Prints the relative change in median time compared to the baseline.
+// Changes larger than the threshold are flagged as regressions or improvements.
+inline int compare_with_baseline(const std::vector<Result>& results, const std::vector<BaselineEntry>& baseline, double threshold) {
+    int regression_count = 0;
+    printf("\n%-56s %14s %14s %9s\n", "Benchmark", "Baseline ns", "Current ns", "Change");
+    for (const Result& result : results) {
+        auto baseline_itr = std::find_if(baseline.begin(), baseline.end(), [&](const BaselineEntry& entry) { return entry.name == result.name; });
+        if (baseline_itr == baseline.end())
+            continue;
+
+        double current_ns = result.nanoseconds_per_iteration.median;
+        double change = current_ns / baseline_itr->median_ns - 1.0;
+        const char* verdict = "";
+        if (change > threshold) {
+            verdict = " regression";
+            ++regression_count;
+        } else if (change < -threshold)
+            verdict = " improvement";
+        printf("%-56s %14.1f %14.1f %+8.2f%%%s\n", result.name.c_str(), baseline_itr->median_ns, current_ns, 100.0 * change, verdict);
+    }
+    return regression_count;
+}
+
+} // NS Benchmarks
+} // NS Bifrost
+
+#endif // _BIFROST_BENCHMARKS_BENCHMARK_H_
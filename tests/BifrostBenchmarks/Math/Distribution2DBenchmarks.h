@@ -0,0 +1,55 @@
+// Bifrost 2D distribution benchmarks.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_DISTRIBUTION2D_BENCHMARKS_H_
+#define _BIFROST_MATH_DISTRIBUTION2D_BENCHMARKS_H_
+
+#include <Benchmark.h>
+
+#include <Bifrost/Math/Distribution2D.h>
+#include <Bifrost/Math/RNG.h>
+
+#include <memory>
+
+namespace Bifrost {
+namespace Math {
+
+BIFROST_BENCHMARK(Distribution2D, build_and_sample) {
+    const int width = 512, height = 256;
+    auto function = std::unique_ptr<float[]>(new float[width * height]);
+    RNG::LinearCongruential rng = RNG::LinearCongruential(73856093);
+    for (int i = 0; i < width * height; ++i)
+        function[i] = rng.sample1f();
+
+    context.measure("build", [&]() {
+        Distribution2D<double> distribution = Distribution2D<double>(function.get(), width, height);
+        Benchmarks::do_not_optimize(distribution.get_integral());
+    }, width * height);
+
+    const Distribution2D<double> distribution = Distribution2D<double>(function.get(), width, height);
+    const int sample_count = 4096;
+
+    context.measure("sample_discrete", [&]() {
+        int index_sum = 0;
+        for (int s = 0; s < sample_count; ++s)
+            index_sum += distribution.sample_discrete(RNG::sample02(s)).index.x;
+        Benchmarks::do_not_optimize(index_sum);
+    }, sample_count);
+
+    context.measure("sample_continuous", [&]() {
+        double PDF_sum = 0.0;
+        for (int s = 0; s < sample_count; ++s)
+            PDF_sum += distribution.sample_continuous(RNG::sample02(s)).PDF;
+        Benchmarks::do_not_optimize(PDF_sum);
+    }, sample_count);
+}
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_DISTRIBUTION2D_BENCHMARKS_H_
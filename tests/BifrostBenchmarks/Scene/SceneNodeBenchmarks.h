@@ -0,0 +1,74 @@
+// Bifrost scene node benchmarks.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_SCENE_SCENE_NODE_BENCHMARKS_H_
+#define _BIFROST_SCENE_SCENE_NODE_BENCHMARKS_H_
+
+#include <Benchmark.h>
+
+#include <Bifrost/Scene/SceneNode.h>
+
+namespace Bifrost {
+namespace Scene {
+
+// Creates a tree where every node below the root has branching_factor children, down to the given depth.
+inline SceneNodes::UID create_node_tree(int branching_factor, int depth) {
+    SceneNodes::UID root_ID = SceneNodes::create("Root");
+    std::vector<SceneNodes::UID> parent_IDs = { root_ID };
+    for (int d = 0; d < depth; ++d) {
+        std::vector<SceneNodes::UID> child_IDs;
+        for (SceneNodes::UID parent_ID : parent_IDs)
+            for (int c = 0; c < branching_factor; ++c) {
+                Math::Transform local_transform = Math::Transform(Math::Vector3f(float(c), 1.0f, 0.0f));
+                SceneNodes::UID child_ID = SceneNodes::create("Child", local_transform);
+                SceneNodes::set_parent(child_ID, parent_ID);
+                child_IDs.push_back(child_ID);
+            }
+        parent_IDs = child_IDs;
+    }
+    return root_ID;
+}
+
+BIFROST_BENCHMARK(SceneNodes, transform_propagation) {
+    SceneNodes::allocate(1u);
+
+    // 1 + 8 + 64 + 512 + 4096 nodes.
+    SceneNodes::UID root_ID = create_node_tree(8, 4);
+    int node_count = 4681;
+
+    int iteration = 0;
+    context.measure([&]() {
+        float angle = 0.01f * (iteration++ % 628);
+        Math::Quaternionf rotation = Math::Quaternionf::from_angle_axis(angle, Math::Vector3f::up());
+        SceneNodes::set_global_transform(root_ID, Math::Transform(Math::Vector3f::zero(), rotation));
+        SceneNodes::reset_change_notifications();
+    }, node_count);
+
+    SceneNodes::deallocate();
+}
+
+BIFROST_BENCHMARK(SceneNodes, UID_iteration) {
+    SceneNodes::allocate(1u);
+
+    create_node_tree(8, 4);
+    int node_count = 4681;
+
+    context.measure([&]() {
+        Math::Vector3f translation_sum = Math::Vector3f::zero();
+        for (SceneNodes::UID node_ID : SceneNodes::get_iterable())
+            translation_sum += SceneNodes::get_global_transform(node_ID).translation;
+        Benchmarks::do_not_optimize(translation_sum);
+    }, node_count);
+
+    SceneNodes::deallocate();
+}
+
+} // NS Scene
+} // NS Bifrost
+
+#endif // _BIFROST_SCENE_SCENE_NODE_BENCHMARKS_H_
@@ -0,0 +1,87 @@
+// Bifrost micro-benchmarks.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#include <Benchmark.h>
+
+#include <Assets/ImageBenchmarks.h>
+#include <Assets/InfiniteAreaLightBenchmarks.h>
+#include <Assets/MeshBenchmarks.h>
+#include <Assets/TextureBenchmarks.h>
+
+#include <Math/Distribution2DBenchmarks.h>
+
+#include <Scene/SceneNodeBenchmarks.h>
+
+#include <cstring>
+
+using namespace Bifrost::Benchmarks;
+
+void print_usage() {
+    const char* usage =
+        "usage BifrostBenchmarks:\n"
+        "  -h | --help: Show command line usage for BifrostBenchmarks.\n"
+        "     --filter <substring>: Only run benchmarks whose name contains the substring.\n"
+        "     --repetitions <count>: Number of timed repetitions pr benchmark. Default is 10.\n"
+        "     --warmup <count>: Number of untimed repetitions pr benchmark. Default is 2.\n"
+        "     --json <path>: Write the results as JSON.\n"
+        "     --baseline <path>: Compare the median times with results previously written with --json.\n"
+        "     --threshold <fraction>: Relative change considered a regression when comparing. Default is 0.05.\n";
+    printf("%s", usage);
+}
+
+// NOTE
+// Benchmark release builds. Debug builds measure the asserts and unoptimized code.
+int main(int argc, char** argv) {
+    Options options;
+    std::string json_path, baseline_path;
+    double regression_threshold = 0.05;
+
+    for (int argument = 1; argument < argc; ++argument) {
+        bool has_value = argument + 1 < argc;
+        if (strcmp(argv[argument], "--help") == 0 || strcmp(argv[argument], "-h") == 0) {
+            print_usage();
+            return 0;
+        } else if (strcmp(argv[argument], "--filter") == 0 && has_value)
+            options.filter = argv[++argument];
+        else if (strcmp(argv[argument], "--repetitions") == 0 && has_value)
+            options.repetitions = std::max(1, atoi(argv[++argument]));
+        else if (strcmp(argv[argument], "--warmup") == 0 && has_value)
+            options.warmup_repetitions = std::max(0, atoi(argv[++argument]));
+        else if (strcmp(argv[argument], "--json") == 0 && has_value)
+            json_path = argv[++argument];
+        else if (strcmp(argv[argument], "--baseline") == 0 && has_value)
+            baseline_path = argv[++argument];
+        else if (strcmp(argv[argument], "--threshold") == 0 && has_value)
+            regression_threshold = atof(argv[++argument]);
+        else {
+            printf("Unknown argument: '%s'\n", argv[argument]);
+            print_usage();
+            return 1;
+        }
+    }
+
+    printf("%-56s %17s %9s %23s\n", "Benchmark", "Median", "Stddev", "Throughput");
+    std::vector<Result> results = run_benchmarks(options);
+
+    if (!json_path.empty() && !write_json(json_path, results)) {
+        printf("Could not write results to '%s'\n", json_path.c_str());
+        return 1;
+    }
+
+    if (!baseline_path.empty()) {
+        std::vector<BaselineEntry> baseline = read_baseline(baseline_path);
+        if (baseline.empty()) {
+            printf("Could not read baseline from '%s'\n", baseline_path.c_str());
+            return 1;
+        }
+        int regression_count = compare_with_baseline(results, baseline, regression_threshold);
+        return regression_count == 0 ? 0 : 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,487 @@
+// Test Bifrost block compression.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_ASSETS_BLOCK_COMPRESSION_TEST_H_
+#define _BIFROST_ASSETS_BLOCK_COMPRESSION_TEST_H_
+
+#include <Bifrost/Assets/BlockCompression.h>
+#include <Bifrost/Core/Parallel.h>
+#include <Bifrost/Math/RNG.h>
+
+#include <Expects.h>
+
+namespace Bifrost {
+namespace Assets {
+namespace BlockCompression {
+
+using namespace Bifrost::Math;
+
+class Assets_BlockCompression : public ::testing::Test {
+protected:
+    // Per-test set-up and tear-down logic.
+    virtual void SetUp() {
+        Images::allocate(8u);
+    }
+    virtual void TearDown() {
+        Images::deallocate();
+    }
+};
+
+inline int squared_error(RGBA32 lhs, RGBA32 rhs) {
+    int dr = lhs.r - rhs.r, dg = lhs.g - rhs.g, db = lhs.b - rhs.b;
+    return dr * dr + dg * dg + db * db;
+}
+
+// Smooth color ramps with a bit of noise, as found in most textures.
+inline void create_test_block(int seed, RGBA32 texels[16]) {
+    RNG::LinearCongruential rng(seed);
+    Vector3f color0 = rng.sample3f() * 255.0f;
+    Vector3f color1 = rng.sample3f() * 255.0f;
+    for (int t = 0; t < 16; ++t) {
+        Vector3f color = lerp(color0, color1, (t % 4 + t / 4) / 6.0f) + rng.sample3f() * 24.0f;
+        color = clamp(color, Vector3f::zero(), Vector3f(255.0f));
+        texels[t] = { (unsigned char)color.x, (unsigned char)color.y, (unsigned char)color.z, 255 };
+    }
+}
+
+// HDR color ramps of a few stops, with exposures spanning several orders of magnitude and a bit of multiplicative noise.
+inline void create_HDR_test_block(int seed, RGB texels[16]) {
+    RNG::LinearCongruential rng(seed);
+    Vector3f log_color0 = rng.sample3f() * 16.0f - 8.0f;
+    Vector3f log_color1 = log_color0 + rng.sample3f() * 4.0f - 2.0f;
+    for (int t = 0; t < 16; ++t) {
+        Vector3f log_color = lerp(log_color0, log_color1, (t % 4 + t / 4) / 6.0f) + rng.sample3f() * 0.1f;
+        texels[t] = RGB(exp2(log_color.x), exp2(log_color.y), exp2(log_color.z));
+    }
+}
+
+// Writes the value to the bits of a block, starting at the given bit.
+inline void write_bits(unsigned char block[16], int& bit, int value, int bit_count) {
+    for (int b = 0; b < bit_count; ++b, ++bit)
+        block[bit / 8] |= ((value >> b) & 1) << (bit % 8);
+}
+
+TEST_F(Assets_BlockCompression, decode_BC1_block) {
+    // Red and blue endpoints with texel t using palette index t % 4.
+    unsigned char block[8] = { 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0xE4, 0xE4, 0xE4 };
+    RGBA32 texels[16];
+    decode_BC1(block, texels);
+
+    RGBA32 expected_palette[4] = { { 255, 0, 0, 255 }, { 0, 0, 255, 255 }, { 170, 0, 85, 255 }, { 85, 0, 170, 255 } };
+    for (int t = 0; t < 16; ++t) {
+        RGBA32 expected = expected_palette[t % 4];
+        EXPECT_EQ(expected.r, texels[t].r);
+        EXPECT_EQ(expected.g, texels[t].g);
+        EXPECT_EQ(expected.b, texels[t].b);
+        EXPECT_EQ(255, texels[t].a);
+    }
+}
+
+TEST_F(Assets_BlockCompression, decode_BC4_block) {
+    // Eight value mode with all texels using palette index 2, except the first, which uses index 1.
+    unsigned char eight_value_block[8] = { 255, 0, 0x91, 0x24, 0x49, 0x92, 0x24, 0x49 };
+    unsigned char values[16];
+    decode_BC4(eight_value_block, values);
+    EXPECT_EQ(0, values[0]);
+    for (int t = 1; t < 16; ++t)
+        EXPECT_EQ(219, values[t]);
+
+    // Six value mode, where index 6 and 7 are 0 and 255.
+    unsigned long long indices = 0;
+    for (int t = 0; t < 16; ++t)
+        indices |= (unsigned long long)(t % 8) << (3 * t);
+    unsigned char six_value_block[8] = { 50, 100 };
+    for (int i = 0; i < 6; ++i)
+        six_value_block[2 + i] = (unsigned char)(indices >> (8 * i));
+    decode_BC4(six_value_block, values);
+    unsigned char expected_palette[8] = { 50, 100, 60, 70, 80, 90, 0, 255 };
+    for (int t = 0; t < 16; ++t)
+        EXPECT_EQ(expected_palette[t % 8], values[t]);
+}
+
+TEST_F(Assets_BlockCompression, decode_BC6H_block) {
+    // Mode 11 with a black and a white endpoint, where texel t uses index t.
+    unsigned char block[16] = {};
+    int bit = 0;
+    write_bits(block, bit, 0x03, 5);
+    for (int c = 0; c < 3; ++c)
+        write_bits(block, bit, 0, 10);
+    for (int c = 0; c < 3; ++c)
+        write_bits(block, bit, 1023, 10);
+    for (int t = 0; t < 16; ++t)
+        write_bits(block, bit, t, t == 0 ? 3 : 4);
+    EXPECT_EQ(128, bit);
+
+    RGB texels[16];
+    decode_BC6H(block, texels);
+    EXPECT_RGB_EQ(RGB::black(), texels[0]);
+    EXPECT_RGB_EQ(RGB(65504.0f), texels[15]);
+    for (int t = 1; t < 16; ++t) {
+        EXPECT_LT(texels[t - 1].r, texels[t].r);
+        EXPECT_EQ(texels[t].r, texels[t].g);
+        EXPECT_EQ(texels[t].r, texels[t].b);
+    }
+
+    // Reserved modes decode to black.
+    unsigned char reserved_block[16] = { 0x13 };
+    decode_BC6H(reserved_block, texels);
+    for (int t = 0; t < 16; ++t)
+        EXPECT_RGB_EQ(RGB::black(), texels[t]);
+}
+
+TEST_F(Assets_BlockCompression, decode_BC7_block) {
+    // Mode 6 with a transparent black and an opaque white endpoint, where texel t uses index t.
+    unsigned char block[16] = {};
+    int bit = 0;
+    write_bits(block, bit, 1 << 6, 7);
+    for (int c = 0; c < 4; ++c) {
+        write_bits(block, bit, 0, 7);
+        write_bits(block, bit, 127, 7);
+    }
+    write_bits(block, bit, 0, 1);
+    write_bits(block, bit, 1, 1);
+    for (int t = 0; t < 16; ++t)
+        write_bits(block, bit, t, t == 0 ? 3 : 4);
+    EXPECT_EQ(128, bit);
+
+    RGBA32 texels[16];
+    decode_BC7(block, texels);
+    int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+    for (int t = 0; t < 16; ++t) {
+        int expected = (weights[t] * 255 + 32) >> 6;
+        EXPECT_EQ(expected, texels[t].r);
+        EXPECT_EQ(expected, texels[t].g);
+        EXPECT_EQ(expected, texels[t].b);
+        EXPECT_EQ(expected, texels[t].a);
+    }
+
+    // The reserved mode decodes to transparent black.
+    unsigned char reserved_block[16] = {};
+    decode_BC7(reserved_block, texels);
+    for (int t = 0; t < 16; ++t) {
+        EXPECT_EQ(0, texels[t].r);
+        EXPECT_EQ(0, texels[t].a);
+    }
+}
+
+TEST_F(Assets_BlockCompression, BC1_round_trip) {
+    // Constant blocks are only limited by the 565 quantization.
+    RGBA32 constant_texels[16];
+    for (int t = 0; t < 16; ++t)
+        constant_texels[t] = { 200, 100, 50, 255 };
+    for (Quality quality : { Quality::Fast, Quality::Normal, Quality::High }) {
+        unsigned char block[8];
+        encode_BC1(constant_texels, block, quality);
+        RGBA32 decoded_texels[16];
+        decode_BC1(block, decoded_texels);
+        for (int t = 0; t < 16; ++t)
+            EXPECT_LE(squared_error(constant_texels[t], decoded_texels[t]), 4 * 4 + 2 * 2 + 4 * 4);
+    }
+
+    // Higher quality never increases the total error.
+    int total_errors[3] = { 0, 0, 0 };
+    for (int seed = 0; seed < 256; ++seed) {
+        RGBA32 texels[16];
+        create_test_block(seed, texels);
+        for (Quality quality : { Quality::Fast, Quality::Normal, Quality::High }) {
+            unsigned char block[8];
+            encode_BC1(texels, block, quality);
+            RGBA32 decoded_texels[16];
+            decode_BC1(block, decoded_texels);
+            for (int t = 0; t < 16; ++t)
+                total_errors[int(quality)] += squared_error(texels[t], decoded_texels[t]);
+        }
+    }
+    EXPECT_LE(total_errors[int(Quality::High)], total_errors[int(Quality::Normal)]);
+    EXPECT_LE(total_errors[int(Quality::Normal)], total_errors[int(Quality::Fast)]);
+
+    // The root mean squared error pr channel stays well below the amplitude of the added noise.
+    float normal_rmse = sqrt(total_errors[int(Quality::Normal)] / (256.0f * 16 * 3));
+    EXPECT_LT(normal_rmse, 12.0f);
+}
+
+TEST_F(Assets_BlockCompression, BC4_round_trip) {
+    RNG::LinearCongruential rng(73856093);
+
+    int total_errors[3] = { 0, 0, 0 };
+    for (int b = 0; b < 256; ++b) {
+        // Every fourth block contains black and white texels, which six value mode represents exactly.
+        unsigned char values[16];
+        int offset = int(rng.sample1f() * 200);
+        for (int t = 0; t < 16; ++t)
+            values[t] = (unsigned char)(offset + rng.sample1f() * 55);
+        if (b % 4 == 0) {
+            values[3] = 0;
+            values[12] = 255;
+        }
+
+        for (Quality quality : { Quality::Fast, Quality::Normal, Quality::High }) {
+            unsigned char block[8];
+            encode_BC4(values, block, quality);
+            unsigned char decoded_values[16];
+            decode_BC4(block, decoded_values);
+            for (int t = 0; t < 16; ++t)
+                total_errors[int(quality)] += (values[t] - decoded_values[t]) * (values[t] - decoded_values[t]);
+        }
+    }
+    EXPECT_LE(total_errors[int(Quality::High)], total_errors[int(Quality::Normal)]);
+    EXPECT_LT(total_errors[int(Quality::Normal)], total_errors[int(Quality::Fast)]);
+    EXPECT_LT(sqrt(total_errors[int(Quality::Normal)] / (256.0f * 16)), 4.0f);
+
+    // Constant blocks are exact.
+    unsigned char constant_values[16];
+    memset(constant_values, 42, 16);
+    unsigned char block[8];
+    encode_BC4(constant_values, block, Quality::Fast);
+    unsigned char decoded_values[16];
+    decode_BC4(block, decoded_values);
+    for (int t = 0; t < 16; ++t)
+        EXPECT_EQ(42, decoded_values[t]);
+}
+
+TEST_F(Assets_BlockCompression, BC6H_round_trip) {
+    // Constant blocks are exact, except in Fast mode, which only uses 10 bit endpoints.
+    RGB constant_texels[16];
+    for (int t = 0; t < 16; ++t)
+        constant_texels[t] = RGB(1000.0f, 0.5f, 0.001f);
+    for (Quality quality : { Quality::Fast, Quality::Normal, Quality::High }) {
+        unsigned char block[16];
+        encode_BC6H(constant_texels, block, quality);
+        RGB decoded_texels[16];
+        decode_BC6H(block, decoded_texels);
+        float tolerance = quality == Quality::Fast ? 0.02f : 0.001f;
+        for (int t = 0; t < 16; ++t)
+            for (int c = 0; c < 3; ++c)
+                EXPECT_FLOAT_EQ_PCT(constant_texels[t][c], decoded_texels[t][c], tolerance);
+    }
+
+    // Higher quality never increases the total error.
+    double total_errors[3] = { 0, 0, 0 };
+    for (int seed = 0; seed < 256; ++seed) {
+        RGB texels[16];
+        create_HDR_test_block(seed, texels);
+        for (Quality quality : { Quality::Fast, Quality::Normal, Quality::High }) {
+            unsigned char block[16];
+            encode_BC6H(texels, block, quality);
+            RGB decoded_texels[16];
+            decode_BC6H(block, decoded_texels);
+            for (int t = 0; t < 16; ++t)
+                for (int c = 0; c < 3; ++c) {
+                    double log_error = log2(decoded_texels[t][c] / texels[t][c]);
+                    total_errors[int(quality)] += log_error * log_error;
+                }
+        }
+    }
+    EXPECT_LE(total_errors[int(Quality::High)], total_errors[int(Quality::Normal)]);
+    EXPECT_LE(total_errors[int(Quality::Normal)], total_errors[int(Quality::Fast)]);
+
+    // The root mean squared error in stops is close to the standard deviation of the added noise.
+    double normal_rmse = sqrt(total_errors[int(Quality::Normal)] / (256.0 * 16 * 3));
+    EXPECT_LT(normal_rmse, 0.05);
+
+    // Negative values are clamped to zero.
+    RGB negative_texels[16];
+    for (int t = 0; t < 16; ++t)
+        negative_texels[t] = RGB(-1.0f, 2.0f, 4.0f);
+    unsigned char block[16];
+    encode_BC6H(negative_texels, block, Quality::Normal);
+    RGB decoded_texels[16];
+    decode_BC6H(block, decoded_texels);
+    for (int t = 0; t < 16; ++t)
+        EXPECT_RGB_EQ(RGB(0.0f, 2.0f, 4.0f), decoded_texels[t]);
+}
+
+TEST_F(Assets_BlockCompression, BC7_round_trip) {
+    // Opaque blocks and blocks with an alpha ramp that does not follow the color ramp.
+    for (bool has_alpha : { false, true }) {
+        int total_errors[3] = { 0, 0, 0 };
+        int total_alpha_errors[3] = { 0, 0, 0 };
+        for (int seed = 0; seed < 256; ++seed) {
+            RGBA32 texels[16];
+            create_test_block(seed, texels);
+            if (has_alpha)
+                for (int t = 0; t < 16; ++t)
+                    texels[t].a = (unsigned char)(255 - 85 * (t % 4));
+
+            for (Quality quality : { Quality::Fast, Quality::Normal, Quality::High }) {
+                unsigned char block[16];
+                encode_BC7(texels, block, quality);
+                RGBA32 decoded_texels[16];
+                decode_BC7(block, decoded_texels);
+                for (int t = 0; t < 16; ++t) {
+                    total_errors[int(quality)] += squared_error(texels[t], decoded_texels[t]);
+                    int alpha_error = texels[t].a - decoded_texels[t].a;
+                    total_alpha_errors[int(quality)] += alpha_error * alpha_error;
+                }
+            }
+        }
+        EXPECT_LE(total_errors[int(Quality::High)] + total_alpha_errors[int(Quality::High)],
+                  total_errors[int(Quality::Normal)] + total_alpha_errors[int(Quality::Normal)]);
+        EXPECT_LE(total_errors[int(Quality::Normal)] + total_alpha_errors[int(Quality::Normal)],
+                  total_errors[int(Quality::Fast)] + total_alpha_errors[int(Quality::Fast)]);
+
+        // Opaque blocks have at most half the color error of BC1, while blocks with alpha spend bits on the alpha.
+        float normal_rmse = sqrt(total_errors[int(Quality::Normal)] / (256.0f * 16 * 3));
+        EXPECT_LT(normal_rmse, has_alpha ? 12.0f : 6.0f);
+
+        // Opaque blocks stay opaque and the alpha ramp is close to exact.
+        if (has_alpha)
+            EXPECT_LT(sqrt(total_alpha_errors[int(Quality::Normal)] / (256.0f * 16)), 2.0f);
+        else
+            for (int q = 0; q < 3; ++q)
+                EXPECT_EQ(0, total_alpha_errors[q]);
+    }
+}
+
+TEST_F(Assets_BlockCompression, compress_image_with_mipmaps) {
+    // Non multiple of four sizes to test partial blocks.
+    // The colors of a block lie on a line in color space, which BC1 and BC5 can represent.
+    unsigned int width = 13, height = 6, mipmap_count = 3;
+    Image image = Images::create2D("Test image", PixelFormat::RGBA32, 2.2f, Vector2ui(width, height), mipmap_count);
+    RGBA32* pixels = image.get_pixels<RGBA32>();
+    for (unsigned int y = 0; y < height; ++y)
+        for (unsigned int x = 0; x < width; ++x) {
+            int t = 3 * (x + y);
+            pixels[x + y * width] = { (unsigned char)(20 + t), (unsigned char)(200 - t / 2), 128, 255 };
+        }
+    ImageUtils::fill_mipmap_chain(image.get_ID());
+
+    for (PixelFormat format : { PixelFormat::BC1_RGB, PixelFormat::BC4_Intensity, PixelFormat::BC5_RG, PixelFormat::BC7_RGBA }) {
+        Image compressed_image = compress(image.get_ID(), format);
+        EXPECT_EQ(format, compressed_image.get_pixel_format());
+        EXPECT_EQ(2.2f, compressed_image.get_gamma());
+        EXPECT_EQ(mipmap_count, compressed_image.get_mipmap_count());
+        unsigned int block_size = block_size_of(format);
+        EXPECT_EQ(8u * block_size, compressed_image.get_pixel_data_size(0));
+        EXPECT_EQ(2u * block_size, compressed_image.get_pixel_data_size(1));
+        EXPECT_EQ(1u * block_size, compressed_image.get_pixel_data_size(2));
+
+        for (unsigned int m = 0; m < mipmap_count; ++m)
+            for (unsigned int y = 0; y < image.get_height(m); ++y)
+                for (unsigned int x = 0; x < image.get_width(m); ++x) {
+                    // Compare the gamma encoded colors, as those are what is compressed.
+                    RGBA expected = gammacorrect(image.get_pixel(Vector2ui(x, y), m), 1.0f / 2.2f);
+                    RGBA actual = gammacorrect(compressed_image.get_pixel(Vector2ui(x, y), m), 1.0f / 2.2f);
+                    EXPECT_FLOAT_EQ_EPS(expected.r, actual.r, 0.03f);
+                    if (format == PixelFormat::BC1_RGB || format == PixelFormat::BC7_RGBA) {
+                        EXPECT_FLOAT_EQ_EPS(expected.g, actual.g, 0.03f);
+                        EXPECT_FLOAT_EQ_EPS(expected.b, actual.b, 0.03f);
+                    } else if (format == PixelFormat::BC5_RG)
+                        EXPECT_FLOAT_EQ_EPS(expected.g, actual.g, 0.03f);
+                    EXPECT_EQ(1.0f, actual.a);
+                }
+    }
+}
+
+TEST_F(Assets_BlockCompression, compress_HDR_image_with_mipmaps) {
+    unsigned int width = 13, height = 6, mipmap_count = 3;
+    Image image = Images::create2D("Test image", PixelFormat::RGB_Float, 1.0f, Vector2ui(width, height), mipmap_count);
+    RGB* pixels = image.get_pixels<RGB>();
+    for (unsigned int y = 0; y < height; ++y)
+        for (unsigned int x = 0; x < width; ++x)
+            pixels[x + y * width] = RGB(exp2(x - 6.0f), 100.0f - y, 0.25f);
+    ImageUtils::fill_mipmap_chain(image.get_ID());
+
+    Image compressed_image = compress(image.get_ID(), PixelFormat::BC6H_RGB);
+    EXPECT_EQ(PixelFormat::BC6H_RGB, compressed_image.get_pixel_format());
+    EXPECT_EQ(1.0f, compressed_image.get_gamma());
+    EXPECT_EQ(mipmap_count, compressed_image.get_mipmap_count());
+    EXPECT_EQ(8u * 16u, compressed_image.get_pixel_data_size(0));
+
+    for (unsigned int m = 0; m < mipmap_count; ++m)
+        for (unsigned int y = 0; y < image.get_height(m); ++y)
+            for (unsigned int x = 0; x < image.get_width(m); ++x) {
+                RGBA expected = image.get_pixel(Vector2ui(x, y), m);
+                RGBA actual = compressed_image.get_pixel(Vector2ui(x, y), m);
+                EXPECT_FLOAT_EQ_PCT(expected.r, actual.r, 0.05f);
+                EXPECT_FLOAT_EQ_PCT(expected.g, actual.g, 0.05f);
+                EXPECT_FLOAT_EQ_PCT(expected.b, actual.b, 0.05f);
+                EXPECT_EQ(1.0f, actual.a);
+            }
+}
+
+TEST_F(Assets_BlockCompression, change_format) {
+    unsigned int width = 8, height = 8;
+    Image image = Images::create2D("Test image", PixelFormat::RGB_Float, 1.0f, Vector2ui(width, height));
+    for (unsigned int y = 0; y < height; ++y)
+        for (unsigned int x = 0; x < width; ++x)
+            image.set_pixel(RGBA(x / float(width), 0.25f, x / float(width), 1.0f), Vector2ui(x, y));
+
+    Image reference_image = ImageUtils::copy_with_new_format(image.get_ID(), PixelFormat::RGB_Float);
+
+    image.change_format(PixelFormat::BC1_RGB, 1.0f);
+    EXPECT_EQ(PixelFormat::BC1_RGB, image.get_pixel_format());
+    std::vector<RGBA> compressed_pixels(width * height);
+    for (unsigned int p = 0; p < width * height; ++p) {
+        compressed_pixels[p] = image.get_pixel(p);
+        EXPECT_RGB_EQ_EPS(reference_image.get_pixel(p).rgb(), compressed_pixels[p].rgb(), 0.03f);
+    }
+
+    image.change_format(PixelFormat::RGB_Float, 1.0f);
+    EXPECT_EQ(PixelFormat::RGB_Float, image.get_pixel_format());
+    for (unsigned int p = 0; p < width * height; ++p)
+        EXPECT_RGBA_EQ(compressed_pixels[p], image.get_pixel(p));
+}
+
+TEST_F(Assets_BlockCompression, change_format_to_linear_formats_ignores_gamma) {
+    unsigned int width = 8, height = 8;
+
+    // Alpha is not affected by gamma, so BC4 stores the alpha values linearly.
+    Image alpha_image = Images::create2D("Alpha image", PixelFormat::Alpha8, 1.0f, Vector2ui(width, height));
+    for (unsigned int y = 0; y < height; ++y)
+        for (unsigned int x = 0; x < width; ++x)
+            alpha_image.get_pixels<unsigned char>()[x + y * width] = (unsigned char)(64 + x * 8 + y * 4);
+    alpha_image.change_format(PixelFormat::BC4_Intensity, 2.2f);
+    EXPECT_EQ(PixelFormat::BC4_Intensity, alpha_image.get_pixel_format());
+    EXPECT_EQ(1.0f, alpha_image.get_gamma());
+    for (unsigned int y = 0; y < height; ++y)
+        for (unsigned int x = 0; x < width; ++x)
+            EXPECT_FLOAT_EQ_EPS((64 + x * 8 + y * 4) / 255.0f, alpha_image.get_pixel(Vector2ui(x, y)).r, 0.01f);
+
+    // BC6H stores HDR values linearly.
+    Image HDR_image = Images::create2D("HDR image", PixelFormat::RGB_Float, 1.0f, Vector2ui(width, height));
+    for (unsigned int y = 0; y < height; ++y)
+        for (unsigned int x = 0; x < width; ++x)
+            HDR_image.set_pixel(RGBA(RGB(32.0f, 4.0f, 0.5f) * (1.0f + 0.125f * (x + y)), 1.0f), Vector2ui(x, y));
+    Image reference_image = ImageUtils::copy_with_new_format(HDR_image.get_ID(), PixelFormat::RGB_Float);
+    HDR_image.change_format(PixelFormat::BC6H_RGB, 2.2f);
+    EXPECT_EQ(PixelFormat::BC6H_RGB, HDR_image.get_pixel_format());
+    EXPECT_EQ(1.0f, HDR_image.get_gamma());
+    for (unsigned int p = 0; p < width * height; ++p) {
+        RGB expected = reference_image.get_pixel(p).rgb();
+        RGB actual = HDR_image.get_pixel(p).rgb();
+        EXPECT_FLOAT_EQ_PCT(expected.r, actual.r, 0.05f);
+        EXPECT_FLOAT_EQ_PCT(expected.g, actual.g, 0.05f);
+        EXPECT_FLOAT_EQ_PCT(expected.b, actual.b, 0.05f);
+    }
+}
+
+TEST_F(Assets_BlockCompression, compression_is_independent_of_thread_count) {
+    unsigned int width = 64, height = 48;
+    Image image = Images::create2D("Test image", PixelFormat::RGB24, 2.2f, Vector2ui(width, height));
+    RGB24* pixels = image.get_pixels<RGB24>();
+    for (unsigned int i = 0; i < width * height; ++i)
+        pixels[i] = { (unsigned char)(i * 7), (unsigned char)(i / 3), (unsigned char)(i * 13) };
+
+    for (PixelFormat format : { PixelFormat::BC1_RGB, PixelFormat::BC6H_RGB, PixelFormat::BC7_RGBA }) {
+        int thread_count = Core::Parallel::get_thread_count();
+        Core::Parallel::set_thread_count(1);
+        Image single_threaded_image = compress(image.get_ID(), format, Quality::High);
+        Core::Parallel::set_thread_count(thread_count);
+        Image multi_threaded_image = compress(image.get_ID(), format, Quality::High);
+
+        unsigned int size = single_threaded_image.get_pixel_data_size();
+        EXPECT_EQ(0, memcmp(single_threaded_image.get_pixels(), multi_threaded_image.get_pixels(), size));
+    }
+}
+
+} // NS BlockCompression
+} // NS Assets
+} // NS Bifrost
+
+#endif // _BIFROST_ASSETS_BLOCK_COMPRESSION_TEST_H_
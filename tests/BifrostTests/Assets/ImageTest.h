@@ -241,6 +241,61 @@ TEST_F(Assets_Images, mipmapable_events) {
     }
 }
 
+TEST_F(Assets_Images, half_pixel_formats) {
+    using namespace Bifrost::Math;
+
+    EXPECT_EQ(2, size_of(PixelFormat::Intensity_Half));
+    EXPECT_EQ(6, size_of(PixelFormat::RGB_Half));
+    EXPECT_EQ(8, size_of(PixelFormat::RGBA_Half));
+
+    // Pixel values are exactly representable as halfs.
+    RGBA pixels[] = { RGBA(1.0f, 2.5f, -3.25f, 0.5f), RGBA(0.0f, 1024.0f, 0.125f, 1.0f), RGBA(65504.0f, -0.5f, 7.75f, 0.25f) };
+    for (PixelFormat format : { PixelFormat::Intensity_Half, PixelFormat::RGB_Half, PixelFormat::RGBA_Half }) {
+        Image image = Images::create2D("Test image", format, 1.0f, Vector2ui(3, 1));
+        for (unsigned int x = 0; x < 3; ++x)
+            image.set_pixel(pixels[x], Vector2ui(x, 0));
+
+        for (unsigned int x = 0; x < 3; ++x) {
+            RGBA pixel = image.get_pixel(Vector2ui(x, 0));
+            EXPECT_EQ(pixels[x].r, pixel.r);
+            if (format != PixelFormat::Intensity_Half) {
+                EXPECT_EQ(pixels[x].g, pixel.g);
+                EXPECT_EQ(pixels[x].b, pixel.b);
+            }
+            EXPECT_EQ(format == PixelFormat::RGBA_Half ? pixels[x].a : 1.0f, pixel.a);
+        }
+    }
+}
+
+TEST_F(Assets_Images, change_format_between_float_and_half) {
+    using namespace Bifrost::Math;
+
+    Image image = Images::create2D("Test image", PixelFormat::RGBA_Float, 1.0f, Vector2ui(5, 3), 2);
+    int total_pixel_count = image.get_pixel_count(0) + image.get_pixel_count(1);
+    RGBA* float_pixels = image.get_pixels<RGBA>();
+    for (int i = 0; i < total_pixel_count; ++i)
+        float_pixels[i] = RGBA(i * 0.1f, i * 1.7f, -i * 31.3f, 1.0f / (i + 1));
+    std::vector<RGBA> original_pixels(float_pixels, float_pixels + total_pixel_count);
+
+    image.change_format(PixelFormat::RGBA_Half, 1.0f);
+    EXPECT_EQ(PixelFormat::RGBA_Half, image.get_pixel_format());
+
+    image.change_format(PixelFormat::RGBA_Float, 1.0f);
+    EXPECT_EQ(PixelFormat::RGBA_Float, image.get_pixel_format());
+    float_pixels = image.get_pixels<RGBA>();
+    for (int i = 0; i < total_pixel_count; ++i)
+        for (int c = 0; c < 4; ++c)
+            EXPECT_FLOAT_EQ_EPS(original_pixels[i][c], float_pixels[i][c], abs(original_pixels[i][c]) / 2048.0f);
+
+    // Converting from bytes also updates the gamma.
+    Image byte_image = Images::create2D("Test image", PixelFormat::RGB24, 2.2f, Vector2ui(2, 1));
+    byte_image.set_pixel(RGBA(0.5f, 0.25f, 1.0f, 1.0f), Vector2ui(0, 0));
+    RGBA expected_pixel = byte_image.get_pixel(Vector2ui(0, 0));
+    byte_image.change_format(PixelFormat::RGB_Half, 1.0f);
+    EXPECT_EQ(1.0f, byte_image.get_gamma());
+    EXPECT_RGB_EQ_EPS(expected_pixel.rgb(), byte_image.get_pixel(Vector2ui(0, 0)).rgb(), 0.001f);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Image utils tests.
 // ------------------------------------------------------------------------------------------------
@@ -285,6 +340,25 @@ TEST_F(Assets_ImageUtils, fill_mipmaps) {
     // EXPECT_RGBA_EQ(RGBA(3.0f, 2.0f, 0.0f, 1.0f), image.get_pixel(Vector2ui(0, 0), 2)); // NOTE The curent mipmap chain fill can tend to scew the result if textures are non-power-of-two.
 }
 
+TEST_F(Assets_ImageUtils, fill_half_mipmaps) {
+    using namespace Bifrost::Math;
+
+    unsigned int width = 4, height = 4, mipmap_count = 3u;
+    Image image = Images::create2D("Test image", PixelFormat::RGBA_Half, 1.0f, Vector2ui(width, height), mipmap_count);
+
+    for (unsigned int y = 0; y < height; ++y)
+        for (unsigned int x = 0; x < width; ++x)
+            image.set_pixel(RGBA(float(x), float(y), 0.0f, 1.0f), Vector2ui(x, y));
+
+    ImageUtils::fill_mipmap_chain(image.get_ID());
+
+    EXPECT_RGBA_EQ(RGBA(0.5f, 0.5f, 0.0f, 1.0f), image.get_pixel(Vector2ui(0, 0), 1));
+    EXPECT_RGBA_EQ(RGBA(2.5f, 0.5f, 0.0f, 1.0f), image.get_pixel(Vector2ui(1, 0), 1));
+    EXPECT_RGBA_EQ(RGBA(0.5f, 2.5f, 0.0f, 1.0f), image.get_pixel(Vector2ui(0, 1), 1));
+    EXPECT_RGBA_EQ(RGBA(2.5f, 2.5f, 0.0f, 1.0f), image.get_pixel(Vector2ui(1, 1), 1));
+    EXPECT_RGBA_EQ(RGBA(1.5f, 1.5f, 0.0f, 1.0f), image.get_pixel(Vector2ui(0, 0), 2));
+}
+
 TEST_F(Assets_ImageUtils, summed_area_table_from_image) {
     using namespace Bifrost::Math;
 
@@ -318,6 +392,34 @@ TEST_F(Assets_ImageUtils, summed_area_table_from_image) {
         }
 }
 
+TEST_F(Assets_ImageUtils, hash_and_identical_pixels) {
+    using namespace Bifrost::Math;
+
+    Vector2ui size = Vector2ui(4, 3);
+    Image image = Images::create2D("Image", PixelFormat::RGBA32, 2.2f, size, 2);
+    Image identical_image = Images::create2D("Identical image", PixelFormat::RGBA32, 2.2f, size, 2);
+    for (unsigned int m = 0; m < image.get_mipmap_count(); ++m)
+        for (unsigned int p = 0; p < image.get_pixel_count(m); ++p) {
+            RGBA pixel = RGBA(p / 16.0f, m / 2.0f, 0.5f, 1.0f);
+            image.set_pixel(pixel, p, m);
+            identical_image.set_pixel(pixel, p, m);
+        }
+
+    // The name is not part of the content.
+    EXPECT_EQ(ImageUtils::hash(image.get_ID()), ImageUtils::hash(identical_image.get_ID()));
+    EXPECT_TRUE(ImageUtils::has_identical_pixels(image.get_ID(), identical_image.get_ID()));
+
+    // Changing a pixel in the last mipmap changes the content.
+    identical_image.set_pixel(RGBA(0.0f, 0.0f, 0.0f, 0.0f), 0, 1);
+    EXPECT_NE(ImageUtils::hash(image.get_ID()), ImageUtils::hash(identical_image.get_ID()));
+    EXPECT_FALSE(ImageUtils::has_identical_pixels(image.get_ID(), identical_image.get_ID()));
+
+    // Changing the gamma changes the content.
+    Image gamma_image = ImageUtils::copy_with_new_format(image.get_ID(), PixelFormat::RGBA32, 1.0f);
+    EXPECT_NE(ImageUtils::hash(image.get_ID()), ImageUtils::hash(gamma_image.get_ID()));
+    EXPECT_FALSE(ImageUtils::has_identical_pixels(image.get_ID(), gamma_image.get_ID()));
+}
+
 TEST_F(Assets_ImageUtils, combine_tint_and_roughness) {
     using namespace Bifrost::Math;
 
@@ -15,6 +15,8 @@
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
+
 namespace Bifrost {
 namespace Assets {
 
@@ -88,6 +90,109 @@ TEST_F(Assets_InfiniteAreaLight, diffuse_integrates_to_white) {
     }
 }
 
+TEST_F(Assets_InfiniteAreaLight, spherical_harmonics_irradiance) {
+    using namespace Bifrost::Math;
+
+    { // A white environment reflects white from a diffuse surface.
+        Image image = Images::create2D("White", PixelFormat::Alpha8, 2.2f, Vector2ui(512, 256));
+        unsigned char* pixels = image.get_pixels<unsigned char>();
+        std::fill(pixels, pixels + image.get_pixel_count(), 255);
+        Textures::UID latlong_ID = Textures::create2D(image.get_ID(), MagnificationFilter::Linear, MinificationFilter::Linear, WrapMode::Repeat, WrapMode::Clamp);
+        const InfiniteAreaLight light = InfiniteAreaLight(latlong_ID);
+
+        auto sh = InfiniteAreaLightUtils::project_to_spherical_harmonics<3>(light);
+        Vector3f normals[] = { Vector3f::up(), -Vector3f::up(), Vector3f::forward(), normalize(Vector3f(1, -2, 3)) };
+        for (Vector3f normal : normals)
+            EXPECT_RGB_EQ_EPS(RGB::white(), sh.evaluate_diffuse(normal), 0.0001f);
+
+        Textures::destroy(latlong_ID);
+        Images::destroy(image.get_ID());
+    }
+
+    { // Radiance that varies linearly along the up axis, 1 + w.y, is represented exactly and reflects 1 + 2/3 * n.y.
+        int width = 128, height = 64;
+        Image image = Images::create2D("Gradient", PixelFormat::RGB_Float, 1.0f, Vector2ui(width, height));
+        RGB* pixels = image.get_pixels<RGB>();
+        for (int y = 0; y < height; ++y) {
+            Vector3f direction = latlong_texcoord_to_direction(Vector2f(0.5f, (y + 0.5f) / height));
+            std::fill(pixels + y * width, pixels + (y + 1) * width, RGB(1.0f + direction.y));
+        }
+        Textures::UID latlong_ID = Textures::create2D(image.get_ID(), MagnificationFilter::Linear, MinificationFilter::Linear, WrapMode::Repeat, WrapMode::Clamp);
+        const InfiniteAreaLight light = InfiniteAreaLight(latlong_ID);
+
+        auto sh = InfiniteAreaLightUtils::project_to_spherical_harmonics<2>(light);
+        Vector3f normals[] = { Vector3f::up(), -Vector3f::up(), Vector3f::forward(), normalize(Vector3f(1, -2, 3)) };
+        for (Vector3f normal : normals)
+            EXPECT_RGB_EQ_EPS(RGB(1.0f + 2.0f / 3.0f * normal.y), sh.evaluate_diffuse(normal), 0.001f);
+    }
+}
+
+TEST_F(Assets_InfiniteAreaLight, prefiltering_matches_convolution) {
+    using namespace Bifrost::Math;
+    using namespace InfiniteAreaLightUtils;
+
+    // Smooth environment that is brighter towards the sky.
+    int width = 64, height = 32;
+    Image image = Images::create2D("Sky", PixelFormat::RGB_Float, 1.0f, Vector2ui(width, height));
+    RGB* pixels = image.get_pixels<RGB>();
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x) {
+            Vector3f direction = latlong_texcoord_to_direction(Vector2f((x + 0.5f) / width, (y + 0.5f) / height));
+            pixels[x + y * width] = RGB(1.0f + direction.y, 1.0f, 1.0f + 0.5f * direction.x);
+        }
+    Textures::UID latlong_ID = Textures::create2D(image.get_ID(), MagnificationFilter::Linear, MinificationFilter::Linear, WrapMode::Repeat, WrapMode::Clamp);
+    const InfiniteAreaLight light = InfiniteAreaLight(latlong_ID);
+
+    const int convolution_count = 3;
+    const int pixel_count = 16 * 8;
+    RGB prefiltered_pixels[convolution_count * pixel_count];
+    RGB convoluted_pixels[convolution_count * pixel_count];
+    IBLConvolution<RGB> prefilterings[convolution_count];
+    IBLConvolution<RGB> convolutions[convolution_count];
+    for (int c = 0; c < convolution_count; ++c) {
+        prefilterings[c] = { prefiltered_pixels + c * pixel_count, 16, 8, c / (convolution_count - 1.0f), 64 };
+        convolutions[c] = { convoluted_pixels + c * pixel_count, 16, 8, c / (convolution_count - 1.0f), 2048 };
+    }
+
+    prefilter(light, prefilterings, prefilterings + convolution_count);
+    convolute(light, convolutions, convolutions + convolution_count);
+
+    for (int i = 0; i < convolution_count * pixel_count; ++i)
+        EXPECT_RGB_EQ_EPS(convoluted_pixels[i], prefiltered_pixels[i], 0.05f);
+}
+
+TEST_F(Assets_InfiniteAreaLight, prefiltering_is_cached) {
+    using namespace Bifrost::Math;
+    using namespace InfiniteAreaLightUtils;
+
+    Image image = Images::create2D("Noisy", PixelFormat::Alpha8, 1.0f, Vector2ui(4, 4));
+    unsigned char f[] = { 0, 5, 0, 3, 1, 2, 1, 4, 3, 7, 5, 1, 9, 4, 1, 1 };
+    std::memcpy(image.get_pixels<unsigned char>(), f, image.get_pixel_count());
+    Textures::UID latlong_ID = Textures::create2D(image.get_ID(), MagnificationFilter::Linear, MinificationFilter::Linear, WrapMode::Repeat, WrapMode::Clamp);
+    const InfiniteAreaLight light = InfiniteAreaLight(latlong_ID);
+
+    std::filesystem::path cache_directory = std::filesystem::temp_directory_path() / "BifrostTests_IBLCache";
+    std::filesystem::remove_all(cache_directory);
+
+    auto identity = [](RGB c) -> RGB { return c; };
+    RGB prefiltered_pixels[32], cached_pixels[32];
+    IBLConvolution<RGB> prefiltering = { prefiltered_pixels, 8, 4, 0.5f, 16 };
+    EXPECT_FALSE(prefilter_cached(light, &prefiltering, &prefiltering + 1, identity, cache_directory));
+
+    IBLConvolution<RGB> cached_prefiltering = { cached_pixels, 8, 4, 0.5f, 16 };
+    EXPECT_TRUE(prefilter_cached(light, &cached_prefiltering, &cached_prefiltering + 1, identity, cache_directory));
+    for (int i = 0; i < 32; ++i)
+        EXPECT_EQ(prefiltered_pixels[i], cached_pixels[i]);
+
+    // Changing the parameters or the environment invalidates the cache.
+    cached_prefiltering.Roughness = 0.75f;
+    EXPECT_FALSE(prefilter_cached(light, &cached_prefiltering, &cached_prefiltering + 1, identity, cache_directory));
+    image.get_pixels<unsigned char>()[0] = 255;
+    EXPECT_FALSE(prefilter_cached(light, &prefiltering, &prefiltering + 1, identity, cache_directory));
+
+    std::filesystem::remove_all(cache_directory);
+}
+
 } // NS Assets
 } // NS Bifrost
 
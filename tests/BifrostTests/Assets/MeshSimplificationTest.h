@@ -0,0 +1,79 @@
+// Test Bifrost mesh simplification.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_ASSETS_MESH_SIMPLIFICATION_TEST_H_
+#define _BIFROST_ASSETS_MESH_SIMPLIFICATION_TEST_H_
+
+#include <Bifrost/Assets/MeshCreation.h>
+#include <Bifrost/Assets/MeshSimplification.h>
+
+#include <gtest/gtest.h>
+
+namespace Bifrost {
+namespace Assets {
+
+class Assets_MeshSimplification : public ::testing::Test {
+protected:
+    // Per-test set-up and tear-down logic.
+    virtual void SetUp() {
+        Meshes::allocate(8u);
+    }
+    virtual void TearDown() {
+        Meshes::deallocate();
+    }
+};
+
+TEST_F(Assets_MeshSimplification, simplify_plane_without_error) {
+    Mesh plane = MeshCreation::plane(16);
+
+    float error;
+    Mesh simplified_plane = MeshSimplification::simplify(plane.get_ID(), 0, 0.0f, &error);
+
+    // All interior vertices of the plane can be collapsed without error. Border vertices are locked.
+    EXPECT_EQ(0.0f, error);
+    EXPECT_LT(simplified_plane.get_primitive_count(), plane.get_primitive_count() / 4);
+    EXPECT_FALSE(MeshTests::has_invalid_indices(simplified_plane.get_ID()));
+    EXPECT_EQ(0, MeshTests::normals_correspond_to_winding_order(simplified_plane.get_ID()));
+}
+
+TEST_F(Assets_MeshSimplification, simplify_respects_max_error) {
+    Mesh sphere = MeshCreation::revolved_sphere(64, 32);
+
+    float max_error = 0.01f;
+    float error;
+    Mesh simplified_sphere = MeshSimplification::simplify(sphere.get_ID(), 0, max_error, &error);
+
+    EXPECT_LE(error, max_error);
+    EXPECT_LT(simplified_sphere.get_primitive_count(), sphere.get_primitive_count());
+    EXPECT_FALSE(MeshTests::has_invalid_indices(simplified_sphere.get_ID()));
+    EXPECT_EQ(0, MeshTests::normals_correspond_to_winding_order(simplified_sphere.get_ID()));
+}
+
+TEST_F(Assets_MeshSimplification, LOD_chain) {
+    Mesh sphere = MeshCreation::revolved_sphere(64, 32);
+
+    float max_error = 0.1f;
+    MeshSimplification::LODChain LODs = MeshSimplification::create_LOD_chain(sphere.get_ID(), max_error, 4);
+
+    EXPECT_LE(2u, LODs.size());
+    EXPECT_GE(4u, LODs.size());
+    EXPECT_EQ(sphere.get_ID(), LODs[0].mesh_ID);
+    EXPECT_EQ(0.0f, LODs[0].error);
+    for (size_t l = 1; l < LODs.size(); ++l) {
+        Mesh previous_LOD = LODs[l - 1].mesh_ID;
+        Mesh LOD = LODs[l].mesh_ID;
+        EXPECT_LT(LOD.get_primitive_count(), previous_LOD.get_primitive_count());
+        EXPECT_LE(LODs[l - 1].error, LODs[l].error);
+        EXPECT_LE(LODs[l].error, max_error);
+    }
+}
+
+} // NS Assets
+} // NS Bifrost
+
+#endif // _BIFROST_ASSETS_MESH_SIMPLIFICATION_TEST_H_
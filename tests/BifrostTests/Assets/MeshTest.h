@@ -11,6 +11,8 @@
 
 #include <Bifrost/Assets/Mesh.h>
 #include <Bifrost/Assets/MeshCreation.h>
+#include <Bifrost/Math/Conversions.h>
+#include <Bifrost/Scene/Camera.h>
 
 #include <gtest/gtest.h>
 
@@ -224,6 +226,170 @@ TEST_F(Assets_Mesh, hard_normal_computation) {
     }
 }
 
+TEST_F(Assets_Mesh, hash_and_identical_buffers) {
+    Mesh mesh = MeshCreation::cube(2);
+    Mesh clone = MeshUtils::deep_clone(mesh.get_ID());
+    EXPECT_EQ(MeshUtils::hash(mesh.get_ID()), MeshUtils::hash(clone.get_ID()));
+    EXPECT_TRUE(MeshUtils::has_identical_buffers(mesh.get_ID(), clone.get_ID()));
+
+    clone.get_texcoords()[3].x += 0.5f;
+    EXPECT_NE(MeshUtils::hash(mesh.get_ID()), MeshUtils::hash(clone.get_ID()));
+    EXPECT_FALSE(MeshUtils::has_identical_buffers(mesh.get_ID(), clone.get_ID()));
+
+    Mesh positions_only = MeshCreation::cube(2, Math::Vector3f::one(), MeshFlag::Position);
+    EXPECT_NE(MeshUtils::hash(mesh.get_ID()), MeshUtils::hash(positions_only.get_ID()));
+    EXPECT_FALSE(MeshUtils::has_identical_buffers(mesh.get_ID(), positions_only.get_ID()));
+}
+
+TEST_F(Assets_Mesh, compute_normals) {
+    using namespace Math;
+
+    Mesh cube = MeshCreation::cube(3);
+    auto reference_normals = std::vector<Vector3f>(cube.get_normals(), cube.get_normals() + cube.get_vertex_count());
+
+    for (MeshUtils::NormalWeighting weighting : { MeshUtils::NormalWeighting::Area, MeshUtils::NormalWeighting::Angle }) {
+        std::fill_n(cube.get_normals(), cube.get_vertex_count(), Vector3f::zero());
+        MeshUtils::compute_normals(cube.get_ID(), weighting);
+        for (unsigned int v = 0; v < cube.get_vertex_count(); ++v)
+            EXPECT_NORMAL_EQ(reference_normals[v], cube.get_normals()[v], 0.000001);
+    }
+}
+
+TEST_F(Assets_Mesh, compute_creased_normals) {
+    using namespace Math;
+
+    // Unit cube with vertices shared between the sides.
+    Mesh cube = Meshes::create("shared_cube", 12, 8, MeshFlag::Position);
+    for (int v = 0; v < 8; ++v)
+        cube.get_positions()[v] = Vector3f(float(v & 1), float((v >> 1) & 1), float((v >> 2) & 1));
+    unsigned int sides[6][4] = { { 0, 2, 3, 1 }, { 4, 5, 7, 6 }, { 0, 1, 5, 4 }, { 2, 6, 7, 3 }, { 0, 4, 6, 2 }, { 1, 3, 7, 5 } };
+    for (int s = 0; s < 6; ++s) {
+        cube.get_primitives()[2 * s] = Vector3ui(sides[s][0], sides[s][1], sides[s][2]);
+        cube.get_primitives()[2 * s + 1] = Vector3ui(sides[s][0], sides[s][2], sides[s][3]);
+    }
+
+    { // A crease angle below 90 degrees splits the corners into three vertices with the normals of the sides.
+        Mesh creased_cube = MeshUtils::compute_creased_normals(cube.get_ID(), PI<float>() / 4.0f);
+        EXPECT_EQ(24u, creased_cube.get_vertex_count());
+        EXPECT_EQ(0u, MeshTests::normals_correspond_to_winding_order(creased_cube.get_ID()));
+        for (Vector3ui primitive : creased_cube.get_primitive_iterable()) {
+            Vector3f p0 = creased_cube.get_positions()[primitive.x];
+            Vector3f primitive_normal = normalize(cross(creased_cube.get_positions()[primitive.y] - p0, creased_cube.get_positions()[primitive.z] - p0));
+            for (int i = 0; i < 3; ++i)
+                EXPECT_NORMAL_EQ(primitive_normal, creased_cube.get_normals()[primitive[i]], 0.000001);
+        }
+    }
+
+    { // A crease angle above 90 degrees smooths the corners.
+        Mesh smooth_cube = MeshUtils::compute_creased_normals(cube.get_ID(), PI<float>() * 0.75f, MeshUtils::NormalWeighting::Angle);
+        EXPECT_EQ(8u, smooth_cube.get_vertex_count());
+        for (unsigned int v = 0; v < 8; ++v) {
+            Vector3f expected_normal = normalize(smooth_cube.get_positions()[v] - Vector3f(0.5f));
+            EXPECT_NORMAL_EQ(expected_normal, smooth_cube.get_normals()[v], 0.000001);
+        }
+    }
+}
+
+TEST_F(Assets_Mesh, optimize) {
+    using namespace Math;
+
+    Mesh mesh = MeshCreation::plane(16);
+    // Scramble the primitives to get a poor vertex cache order.
+    Vector3ui* primitives = mesh.get_primitives();
+    unsigned int primitive_count = mesh.get_primitive_count();
+    for (unsigned int p = 0; p < primitive_count; ++p)
+        std::swap(primitives[p], primitives[(p * 7919) % primitive_count]);
+    Mesh reference_mesh = MeshUtils::deep_clone(mesh.get_ID());
+
+    MeshUtils::OptimizationReport report = MeshUtils::optimize(mesh.get_ID());
+    EXPECT_LT(report.after.ACMR, report.before.ACMR);
+    EXPECT_LT(report.after.ATVR, report.before.ATVR);
+    EXPECT_FALSE(MeshTests::has_invalid_indices(mesh.get_ID()));
+
+    // Test that the vertices are ordered by first use.
+    unsigned int next_vertex_index = 0;
+    for (unsigned int i = 0; i < mesh.get_index_count(); ++i) {
+        unsigned int vertex_index = mesh.get_indices()[i];
+        EXPECT_LE(vertex_index, next_vertex_index);
+        if (vertex_index == next_vertex_index)
+            ++next_vertex_index;
+    }
+
+    // Test that all reference primitives are still present with the same winding and vertex attributes.
+    for (Vector3ui reference_primitive : reference_mesh.get_primitive_iterable()) {
+        bool primitive_found = false;
+        for (Vector3ui primitive : mesh.get_primitive_iterable())
+            for (int offset = 0; offset < 3 && !primitive_found; ++offset) {
+                bool vertices_equal = true;
+                for (int i = 0; i < 3; ++i) {
+                    unsigned int reference_index = reference_primitive[i];
+                    unsigned int index = primitive[(i + offset) % 3];
+                    vertices_equal &= reference_mesh.get_positions()[reference_index] == mesh.get_positions()[index];
+                    vertices_equal &= reference_mesh.get_normals()[reference_index] == mesh.get_normals()[index];
+                    vertices_equal &= reference_mesh.get_texcoords()[reference_index] == mesh.get_texcoords()[index];
+                }
+                primitive_found = vertices_equal;
+            }
+        EXPECT_TRUE(primitive_found);
+    }
+}
+
+TEST_F(Assets_Mesh, build_and_cull_clusters) {
+    using namespace Math;
+
+    Mesh cube = MeshCreation::cube(4);
+    unsigned int cluster_count = MeshUtils::build_clusters(cube.get_ID(), 64, 32);
+    EXPECT_EQ(cluster_count, cube.get_cluster_count());
+    EXPECT_GE(cluster_count, 6u);
+
+    // Test that the clusters cover all primitives, respect the limits and contain their primitives.
+    unsigned int primitive_offset = 0;
+    for (MeshCluster cluster : cube.get_cluster_iterable()) {
+        EXPECT_EQ(primitive_offset, cluster.primitive_offset);
+        EXPECT_LE(cluster.primitive_count, 32u);
+        EXPECT_LE(cluster.vertex_count, 64u);
+        for (unsigned int p = cluster.primitive_offset; p < cluster.primitive_offset + cluster.primitive_count; ++p)
+            for (int i = 0; i < 3; ++i) {
+                Vector3f position = cube.get_positions()[cube.get_primitives()[p][i]];
+                EXPECT_LE(magnitude(position - cluster.sphere_center), cluster.sphere_radius * 1.0001f);
+            }
+        primitive_offset += cluster.primitive_count;
+    }
+    EXPECT_EQ(cube.get_primitive_count(), primitive_offset);
+
+    // View the cube from the front. The back of the cube should be culled.
+    Matrix4x4f projection_matrix, inverse_projection_matrix;
+    Scene::CameraUtils::compute_perspective_projection(0.1f, 100.0f, PI<float>() / 4.0f, 1.0f, projection_matrix, inverse_projection_matrix);
+    Vector3f view_position = Vector3f(0, 0, -5);
+    Transform view_transform = Transform(-view_position);
+    Matrix4x4f view_projection_matrix = projection_matrix * to_matrix4x4(view_transform);
+
+    std::vector<unsigned int> visible_clusters;
+    unsigned int visible_primitive_count = MeshUtils::cull_clusters(cube.get_ID(), Transform::identity(), view_projection_matrix, 
+                                                                    view_position, visible_clusters);
+    EXPECT_LT(visible_primitive_count, cube.get_primitive_count());
+
+    // Test that all primitives facing the camera are in a visible cluster.
+    for (unsigned int c = 0; c < cluster_count; ++c) {
+        MeshCluster cluster = cube.get_clusters()[c];
+        bool cluster_visible = std::find(visible_clusters.begin(), visible_clusters.end(), c) != visible_clusters.end();
+        for (unsigned int p = cluster.primitive_offset; p < cluster.primitive_offset + cluster.primitive_count; ++p) {
+            Vector3ui primitive = cube.get_primitives()[p];
+            Vector3f p0 = cube.get_positions()[primitive.x];
+            Vector3f normal = cross(cube.get_positions()[primitive.y] - p0, cube.get_positions()[primitive.z] - p0);
+            if (dot(normal, view_position - p0) > 0.0f)
+                EXPECT_TRUE(cluster_visible);
+        }
+    }
+
+    // Move the cube out of the frustum.
+    visible_clusters.clear();
+    visible_primitive_count = MeshUtils::cull_clusters(cube.get_ID(), Transform(Vector3f(100, 0, 0)), view_projection_matrix, 
+                                                       view_position, visible_clusters);
+    EXPECT_EQ(0u, visible_primitive_count);
+    EXPECT_TRUE(visible_clusters.empty());
+}
+
 } // NS Assets
 } // NS Bifrost
 
@@ -0,0 +1,201 @@
+// Test Bifrost rho tables.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_ASSETS_RHO_TABLE_TEST_H_
+#define _BIFROST_ASSETS_RHO_TABLE_TEST_H_
+
+#include <Bifrost/Assets/Shading/RhoTable.h>
+#include <Bifrost/Math/RNG.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+
+namespace Bifrost {
+namespace Assets {
+namespace Shading {
+
+class Assets_RhoTable : public ::testing::Test {
+protected:
+    // A Lambertian BSDF with an albedo of 0.5 in the first channel and 1.0 in the second.
+    // Sampled uniformly on the hemisphere, the throughput is 2 * albedo * cos(theta), where cos(theta) is uniformly distributed.
+    // The samples are independent instead of stratified, so the batch estimates have the Monte Carlo variance.
+    static void uniform_sampled_lambert(float wo_dot_normal, float roughness, unsigned int sample_index,
+                                        const Math::RNG::OwenScrambledSobol& sampler, float* throughputs) {
+        float cos_theta = Math::RNG::uint_to_unit_float(Math::RNG::hash_combine(sampler.get_seed(), sample_index));
+        throughputs[0] = cos_theta;
+        throughputs[1] = 2.0f * cos_theta;
+    }
+
+    static RhoTable::Settings create_settings() {
+        RhoTable::Settings settings;
+        settings.angle_sample_count = 4;
+        settings.roughness_sample_count = 3;
+        settings.channel_count = 2;
+        settings.batch_sample_count = 64;
+        settings.max_sample_count = 8192;
+        settings.max_standard_error = 0.01f;
+        return settings;
+    }
+};
+
+TEST_F(Assets_RhoTable, zero_variance_estimator_converges_after_min_batch_count) {
+    RhoTable::Settings settings = create_settings();
+    settings.channel_count = 1;
+    RhoTable table = RhoTable::generate(settings, [](float wo_dot_normal, float roughness, unsigned int sample_index,
+                                                     const Math::RNG::OwenScrambledSobol& sampler, float* throughputs) {
+        throughputs[0] = 0.5f; // Cosine sampled Lambert.
+    });
+
+    EXPECT_TRUE(table.is_valid());
+    for (unsigned int e = 0; e < table.get_entry_count(); ++e) {
+        EXPECT_FLOAT_EQ(0.5f, table.get_rho()[e]);
+        EXPECT_EQ(0.0f, table.get_standard_errors()[e]);
+        EXPECT_EQ(settings.min_batch_count * settings.batch_sample_count, table.get_sample_counts()[e]);
+    }
+}
+
+TEST_F(Assets_RhoTable, progressive_convergence) {
+    RhoTable::Settings settings = create_settings();
+    RhoTable table = RhoTable::generate(settings, uniform_sampled_lambert);
+
+    // The variance of 2 * albedo * cos(theta) is albedo^2 / 3, so the second channel needs around 3333 samples to converge,
+    // while the first channel would converge with a quarter of the samples.
+    // The estimated standard error is itself noisy, so individual entries may stop a bit before or after that.
+    EXPECT_LE(table.get_max_standard_error(), settings.max_standard_error);
+    unsigned int total_sample_count = 0;
+    for (unsigned int e = 0; e < table.get_entry_count(); ++e) {
+        EXPECT_NEAR(0.5f, table.get_rho()[2 * e], 4 * settings.max_standard_error);
+        EXPECT_NEAR(1.0f, table.get_rho()[2 * e + 1], 4 * settings.max_standard_error);
+        EXPECT_GT(table.get_sample_counts()[e], settings.min_batch_count * settings.batch_sample_count);
+        EXPECT_LT(table.get_sample_counts()[e], settings.max_sample_count);
+        total_sample_count += table.get_sample_counts()[e];
+    }
+    float mean_sample_count = total_sample_count / float(table.get_entry_count());
+    EXPECT_GT(mean_sample_count, 2500.0f);
+    EXPECT_LT(mean_sample_count, 4500.0f);
+
+    // Capping the sample count stops estimation before the error threshold is reached.
+    settings.max_sample_count = 1024;
+    RhoTable capped_table = RhoTable::generate(settings, uniform_sampled_lambert);
+    EXPECT_GT(capped_table.get_max_standard_error(), settings.max_standard_error);
+    for (unsigned int e = 0; e < capped_table.get_entry_count(); ++e)
+        EXPECT_EQ(1024u, capped_table.get_sample_counts()[e]);
+}
+
+TEST_F(Assets_RhoTable, at_least_two_batches_are_used) {
+    // A single batch has no estimated standard error, so two batches are used even if fewer are requested.
+    RhoTable::Settings settings = create_settings();
+    settings.min_batch_count = 1;
+    settings.max_sample_count = settings.batch_sample_count;
+    RhoTable table = RhoTable::generate(settings, uniform_sampled_lambert);
+
+    for (unsigned int e = 0; e < table.get_entry_count(); ++e) {
+        EXPECT_EQ(2 * settings.batch_sample_count, table.get_sample_counts()[e]);
+        for (unsigned int c = 0; c < table.get_channel_count(); ++c)
+            EXPECT_TRUE(std::isfinite(table.get_standard_errors()[e * table.get_channel_count() + c]));
+    }
+}
+
+TEST_F(Assets_RhoTable, scrambled_samples_converge_faster_than_independent_samples) {
+    RhoTable::Settings settings = create_settings();
+    RhoTable table = RhoTable::generate(settings, [](float wo_dot_normal, float roughness, unsigned int sample_index,
+                                                     const Math::RNG::OwenScrambledSobol& sampler, float* throughputs) {
+        float cos_theta = sampler.sample1f(sample_index, 0);
+        throughputs[0] = cos_theta;
+        throughputs[1] = 2.0f * cos_theta;
+    });
+
+    // The stratified batches of the smooth integrand converge after the minimal number of batches,
+    // and the standard error estimated from the batches bounds the actual error.
+    for (unsigned int e = 0; e < table.get_entry_count(); ++e) {
+        EXPECT_EQ(settings.min_batch_count * settings.batch_sample_count, table.get_sample_counts()[e]);
+        EXPECT_NEAR(0.5f, table.get_rho()[2 * e], 4 * table.get_standard_errors()[2 * e] + 1e-6f);
+        EXPECT_NEAR(1.0f, table.get_rho()[2 * e + 1], 4 * table.get_standard_errors()[2 * e + 1] + 1e-6f);
+    }
+}
+
+TEST_F(Assets_RhoTable, early_termination_does_not_bias_lobe_selection) {
+    // Two lobes with rho 0.25 and 0.75, each selected with probability 0.5 by the third dimension.
+    // Lobe selection converges quickly, so estimation terminates long before the sample budget is used,
+    // which must not change the estimate, i.e. the selection must not depend on the budget.
+    auto two_lobe_estimator = [](float wo_dot_normal, float roughness, unsigned int sample_index,
+                                 const Math::RNG::OwenScrambledSobol& sampler, float* throughputs) {
+        bool select_first_lobe = sampler.sample1f(sample_index, 2) < 0.5f;
+        throughputs[0] = (select_first_lobe ? 0.25f : 0.75f) / 0.5f;
+    };
+
+    RhoTable::Settings settings = create_settings();
+    settings.channel_count = 1;
+    for (unsigned int max_sample_count : { 1024u, 65536u }) {
+        settings.max_sample_count = max_sample_count;
+        RhoTable table = RhoTable::generate(settings, two_lobe_estimator);
+        for (unsigned int e = 0; e < table.get_entry_count(); ++e) {
+            EXPECT_LT(table.get_sample_counts()[e], max_sample_count);
+            EXPECT_FLOAT_EQ(1.0f, table.get_rho()[e]);
+        }
+    }
+}
+
+TEST_F(Assets_RhoTable, sample) {
+    RhoTable table = RhoTable(4, 3, 1);
+    for (unsigned int e = 0; e < table.get_entry_count(); ++e)
+        table.get_rho()[e] = float(e);
+
+    EXPECT_EQ(0.0f, table.sample(0.0f, 0.0f));
+    EXPECT_EQ(1.0f, table.sample(0.4f, 0.0f));
+    EXPECT_EQ(3.0f, table.sample(1.0f, 0.0f));
+    EXPECT_EQ(4.0f, table.sample(0.0f, 0.5f));
+    EXPECT_EQ(11.0f, table.sample(1.0f, 1.0f));
+}
+
+TEST_F(Assets_RhoTable, cache) {
+    std::filesystem::path cache_directory = std::filesystem::temp_directory_path() / "BifrostTests_RhoTableCache";
+    std::filesystem::remove_all(cache_directory);
+
+    RhoTable::Settings settings = create_settings();
+    std::atomic_int estimator_calls = 0;
+    auto counting_estimator = [&](float wo_dot_normal, float roughness, unsigned int sample_index,
+                                  const Math::RNG::OwenScrambledSobol& sampler, float* throughputs) {
+        if (sample_index == 0)
+            ++estimator_calls;
+        throughputs[0] = throughputs[1] = 0.25f;
+    };
+
+    // The constant estimate converges after the minimal number of batches in every entry.
+    RhoTable table = RhoTable::load_or_generate(cache_directory, "Constant", 1, settings, counting_estimator);
+    int batch_count = settings.min_batch_count * int(table.get_entry_count());
+    EXPECT_EQ(batch_count, estimator_calls);
+
+    // The second load reads the table from the cache.
+    RhoTable cached_table = RhoTable::load_or_generate(cache_directory, "Constant", 1, settings, counting_estimator);
+    EXPECT_EQ(batch_count, estimator_calls);
+    EXPECT_EQ(table.get_angle_sample_count(), cached_table.get_angle_sample_count());
+    EXPECT_EQ(table.get_roughness_sample_count(), cached_table.get_roughness_sample_count());
+    EXPECT_EQ(table.get_channel_count(), cached_table.get_channel_count());
+    for (unsigned int i = 0; i < table.get_entry_count() * table.get_channel_count(); ++i)
+        EXPECT_EQ(table.get_rho()[i], cached_table.get_rho()[i]);
+
+    // A different version or different settings invalidates the cache.
+    EXPECT_FALSE(RhoTable::read(cache_directory / "Constant.rho", 2).is_valid());
+    RhoTable::load_or_generate(cache_directory, "Constant", 2, settings, counting_estimator);
+    EXPECT_EQ(2 * batch_count, estimator_calls);
+    settings.angle_sample_count = 5;
+    RhoTable resized_table = RhoTable::load_or_generate(cache_directory, "Constant", 2, settings, counting_estimator);
+    EXPECT_EQ(5u, resized_table.get_angle_sample_count());
+
+    std::filesystem::remove_all(cache_directory);
+}
+
+} // NS Shading
+} // NS Assets
+} // NS Bifrost
+
+#endif // _BIFROST_ASSETS_RHO_TABLE_TEST_H_
@@ -0,0 +1,96 @@
+// Test Bifrost versioned binary files.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_CORE_BINARY_FILE_TEST_H_
+#define _BIFROST_CORE_BINARY_FILE_TEST_H_
+
+#include <Bifrost/Core/BinaryFile.h>
+
+#include <gtest/gtest.h>
+
+namespace Bifrost {
+namespace Core {
+
+class Core_BinaryFile : public ::testing::Test {
+protected:
+    static const unsigned int magic = 0x54534554; // 'TEST' in little endian.
+
+    std::filesystem::path m_directory = std::filesystem::temp_directory_path() / "BifrostTests_BinaryFile";
+
+    void SetUp() override { std::filesystem::remove_all(m_directory); }
+    void TearDown() override { std::filesystem::remove_all(m_directory); }
+
+    // Writes a value count followed by that many values.
+    bool write_values(const std::filesystem::path& path, unsigned int format_version, unsigned int count) {
+        BinaryFileWriter file = BinaryFileWriter(path, magic, format_version);
+        file.write(count);
+        for (unsigned int i = 0; i < count; ++i)
+            file.write(float(i));
+        return file.is_good();
+    }
+};
+
+TEST_F(Core_BinaryFile, round_trip) {
+    // The writer creates the missing parent directories.
+    std::filesystem::path path = m_directory / "Nested" / "values.bin";
+    EXPECT_TRUE(write_values(path, 1, 4));
+    EXPECT_EQ(2 * sizeof(unsigned int) + sizeof(unsigned int) + 4 * sizeof(float), std::filesystem::file_size(path));
+
+    BinaryFileReader file = BinaryFileReader(path, magic, 1);
+    unsigned int count = 0;
+    file.read(count);
+    EXPECT_EQ(4u, count);
+    file.expect_remaining_size(count * sizeof(float));
+    float values[4];
+    file.read(values, count);
+    EXPECT_TRUE(file.is_good());
+    for (unsigned int i = 0; i < count; ++i)
+        EXPECT_EQ(float(i), values[i]);
+}
+
+TEST_F(Core_BinaryFile, magic_and_format_version_mismatch) {
+    std::filesystem::path path = m_directory / "values.bin";
+    write_values(path, 1, 4);
+
+    EXPECT_FALSE(BinaryFileReader(path, magic + 1, 1).is_good());
+    EXPECT_FALSE(BinaryFileReader(path, magic, 2).is_good());
+    EXPECT_TRUE(BinaryFileReader(path, magic, 1).is_good());
+}
+
+TEST_F(Core_BinaryFile, missing_file) {
+    BinaryFileReader file = BinaryFileReader(m_directory / "missing.bin", magic, 1);
+    EXPECT_FALSE(file.is_good());
+    file.expect_remaining_size(0);
+    EXPECT_FALSE(file.is_good());
+}
+
+TEST_F(Core_BinaryFile, remaining_size) {
+    std::filesystem::path path = m_directory / "values.bin";
+    write_values(path, 1, 4);
+
+    auto remaining_size_matches = [&](unsigned long long byte_count) {
+        BinaryFileReader file = BinaryFileReader(path, magic, 1);
+        unsigned int count;
+        file.read(count);
+        file.expect_remaining_size(byte_count);
+        return file.is_good();
+    };
+    EXPECT_TRUE(remaining_size_matches(4 * sizeof(float)));
+    EXPECT_FALSE(remaining_size_matches(3 * sizeof(float)));
+    EXPECT_FALSE(remaining_size_matches(5 * sizeof(float)));
+    EXPECT_FALSE(remaining_size_matches(~0ull));
+
+    // Truncated files are rejected.
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_FALSE(remaining_size_matches(4 * sizeof(float)));
+}
+
+} // NS Core
+} // NS Bifrost
+
+#endif // _BIFROST_CORE_BINARY_FILE_TEST_H_
@@ -0,0 +1,136 @@
+// Test Bifrost engine.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_CORE_ENGINE_TEST_H_
+#define _BIFROST_CORE_ENGINE_TEST_H_
+
+#include <Bifrost/Core/Engine.h>
+#include <Bifrost/Core/Parallel.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Bifrost {
+namespace Core {
+
+class Core_Engine : public ::testing::Test {
+protected:
+    // Non-mutating callbacks only run on the thread pool if there is more than one thread.
+    void SetUp() override {
+        m_thread_count = Parallel::get_thread_count();
+        Parallel::set_thread_count(4);
+    }
+
+    void TearDown() override { Parallel::set_thread_count(m_thread_count); }
+
+    int m_thread_count;
+};
+
+TEST_F(Core_Engine, non_mutating_callbacks_respect_dependencies) {
+    Engine engine(std::filesystem::temp_directory_path());
+
+    std::mutex order_mutex;
+    std::vector<std::string> order;
+    auto record = [&](const char* name) {
+        return [&, name] {
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(name);
+        };
+    };
+
+    using Thread = Engine::CallbackThread;
+    auto a = engine.add_non_mutating_callback(record("a"), "a", Thread::Any);
+    auto b = engine.add_non_mutating_callback(record("b"), "b", Thread::Any, { a });
+    auto c = engine.add_non_mutating_callback(record("c"), "c", Thread::Main, { a });
+    engine.add_non_mutating_callback(record("d"), "d", Thread::Any, { b, c });
+    engine.add_non_mutating_callback(record("e"), "e", Thread::Main);
+    engine.add_non_mutating_callback(record("f"), "f", Thread::Main);
+
+    for (int tick = 0; tick < 20; ++tick) {
+        order.clear();
+        engine.do_tick(1.0 / 60.0);
+
+        ASSERT_EQ(6u, order.size());
+        auto position = [&](const char* name) { return std::find(order.begin(), order.end(), name) - order.begin(); };
+        EXPECT_LT(position("a"), position("b"));
+        EXPECT_LT(position("a"), position("c"));
+        EXPECT_LT(position("b"), position("d"));
+        EXPECT_LT(position("c"), position("d"));
+        // Main thread callbacks without dependencies keep their registration order.
+        EXPECT_LT(position("e"), position("f"));
+    }
+}
+
+TEST_F(Core_Engine, thread_safe_callbacks_run_concurrently) {
+    Engine engine(std::filesystem::temp_directory_path());
+
+    // Each thread safe callback waits for the other to start, which only succeeds if they run concurrently.
+    std::atomic<int> running_count(0);
+    std::atomic<int> concurrent_count(0);
+    auto wait_for_other = [&] {
+        ++running_count;
+        auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (running_count.load() < 2 && std::chrono::steady_clock::now() < timeout)
+            std::this_thread::yield();
+        if (running_count.load() == 2)
+            ++concurrent_count;
+    };
+    engine.add_non_mutating_callback(wait_for_other, "first", Engine::CallbackThread::Any);
+    engine.add_non_mutating_callback(wait_for_other, "second", Engine::CallbackThread::Any);
+
+    std::thread::id main_thread_callback_thread;
+    engine.add_non_mutating_callback([&] { main_thread_callback_thread = std::this_thread::get_id(); }, "main");
+
+    engine.do_tick(1.0 / 60.0);
+
+    EXPECT_EQ(2, concurrent_count.load());
+    EXPECT_EQ(std::this_thread::get_id(), main_thread_callback_thread);
+}
+
+TEST_F(Core_Engine, callback_timings) {
+    Engine engine(std::filesystem::temp_directory_path());
+
+    auto sleep = [](int milliseconds) { return [=] { std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds)); }; };
+    engine.add_mutating_callback(sleep(2), "mutate");
+    engine.add_non_mutating_callback(sleep(5), "render", Engine::CallbackThread::Any);
+    engine.add_non_mutating_callback(sleep(1), "present");
+    engine.add_tick_cleanup_callback(sleep(1), "cleanup");
+
+    // No callbacks have run before the first tick.
+    for (auto timing : engine.get_callback_timings())
+        EXPECT_EQ(0.0, timing.duration);
+
+    engine.do_tick(1.0 / 60.0);
+
+    auto timings = engine.get_callback_timings();
+    ASSERT_EQ(4u, timings.size());
+    EXPECT_EQ("mutate", timings[0].name);
+    EXPECT_EQ(Engine::CallbackPhase::Mutating, timings[0].phase);
+    EXPECT_GE(timings[0].duration, 0.002);
+    EXPECT_EQ("render", timings[1].name);
+    EXPECT_EQ(Engine::CallbackPhase::NonMutating, timings[1].phase);
+    EXPECT_GE(timings[1].duration, 0.005);
+    EXPECT_EQ("present", timings[2].name);
+    EXPECT_EQ(Engine::CallbackPhase::NonMutating, timings[2].phase);
+    EXPECT_GE(timings[2].duration, 0.001);
+    EXPECT_EQ("cleanup", timings[3].name);
+    EXPECT_EQ(Engine::CallbackPhase::TickCleanup, timings[3].phase);
+    EXPECT_GE(timings[3].duration, 0.001);
+}
+
+} // NS Core
+} // NS Bifrost
+
+#endif // _BIFROST_CORE_ENGINE_TEST_H_
@@ -0,0 +1,121 @@
+// Test Bifrost parallel utilities.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_CORE_PARALLEL_TEST_H_
+#define _BIFROST_CORE_PARALLEL_TEST_H_
+
+#include <Bifrost/Core/Parallel.h>
+
+#include <gtest/gtest.h>
+
+namespace Bifrost {
+namespace Core {
+
+GTEST_TEST(Core_Parallel, parallel_for_visits_all_indices_once) {
+    for (int grain_size : { 0, 1, 7, 1000 }) {
+        auto visits = std::vector<int>(10007, 0);
+        Parallel::parallel_for(3, int(visits.size()), [&](int i) { ++visits[i]; }, grain_size);
+
+        EXPECT_EQ(0, visits[0]);
+        EXPECT_EQ(0, visits[2]);
+        for (int i = 3; i < int(visits.size()); ++i)
+            EXPECT_EQ(1, visits[i]);
+    }
+}
+
+GTEST_TEST(Core_Parallel, nested_parallel_for) {
+    std::atomic<int> count(0);
+    Parallel::parallel_for(0, 64, [&](int) {
+        Parallel::parallel_for(0, 100, [&](int) { ++count; });
+    }, 1);
+    EXPECT_EQ(6400, count.load());
+}
+
+GTEST_TEST(Core_Parallel, parallel_reduce_is_independent_of_thread_count) {
+    auto harmonic_sum = []() -> double {
+        return Parallel::parallel_reduce(0, 1000000, 0.0,
+            [](int begin, int end, double sum) -> double {
+                for (int i = begin; i < end; ++i)
+                    sum += 1.0 / (i + 1.0);
+                return sum;
+            },
+            [](double lhs, double rhs) -> double { return lhs + rhs; }, 1024);
+    };
+
+    int thread_count = Parallel::get_thread_count();
+    Parallel::set_thread_count(1);
+    double reference_sum = harmonic_sum();
+    Parallel::set_thread_count(4);
+    double sum = harmonic_sum();
+    Parallel::set_thread_count(thread_count);
+
+    EXPECT_EQ(reference_sum, sum);
+    EXPECT_NEAR(14.392726722864, sum, 1e-9);
+}
+
+GTEST_TEST(Core_Parallel, parallel_reduce_bool) {
+    // Neighbouring range results are written by different threads, which must not race for bools.
+    auto values = std::vector<int>(4096, 2);
+    auto all_even = [&]() -> bool {
+        return Parallel::parallel_reduce(0, int(values.size()), true,
+            [&](int begin, int end, bool even) -> bool {
+                for (int i = begin; i < end; ++i)
+                    even = even && values[i] % 2 == 0;
+                return even;
+            },
+            [](bool lhs, bool rhs) -> bool { return lhs && rhs; }, 1);
+    };
+
+    int thread_count = Parallel::get_thread_count();
+    Parallel::set_thread_count(4);
+    EXPECT_TRUE(all_even());
+    values[1234] = 3;
+    EXPECT_FALSE(all_even());
+    Parallel::set_thread_count(thread_count);
+}
+
+GTEST_TEST(Core_Parallel, task_group_continuations) {
+    std::atomic<int> task_count(0);
+    std::atomic<int> tasks_completed_before_continuation(0);
+    std::atomic<int> continuation_count(0);
+
+    Parallel::TaskGroup group;
+    for (int t = 0; t < 100; ++t)
+        group.run([&]() { ++task_count; });
+    group.then([&]() {
+        tasks_completed_before_continuation = task_count.load();
+        ++continuation_count;
+        // Tasks added by the continuation are part of the group.
+        group.run([&]() { ++task_count; });
+    });
+    group.wait();
+
+    EXPECT_EQ(100, tasks_completed_before_continuation.load());
+    EXPECT_EQ(1, continuation_count.load());
+    EXPECT_EQ(101, task_count.load());
+    EXPECT_TRUE(group.is_idle());
+
+    // Continuations on an idle group are scheduled immediately.
+    group.then([&]() { ++continuation_count; });
+    group.wait();
+    EXPECT_EQ(2, continuation_count.load());
+}
+
+GTEST_TEST(Core_Parallel, for_range_with_local_state) {
+    long long sum = 0;
+    Parallel::for_range(0, 1000,
+        []() -> long long { return 0; },
+        [](int i, long long& local_sum) { local_sum += i; },
+        [&](long long local_sum) { sum += local_sum; });
+    EXPECT_EQ(499500, sum);
+}
+
+} // NS Core
+} // NS Bifrost
+
+#endif // _BIFROST_CORE_PARALLEL_TEST_H_
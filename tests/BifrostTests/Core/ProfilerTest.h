@@ -0,0 +1,110 @@
+// Test Bifrost profiler.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_CORE_PROFILER_TEST_H_
+#define _BIFROST_CORE_PROFILER_TEST_H_
+
+#include <Bifrost/Core/Profiler.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+namespace Bifrost {
+namespace Core {
+
+GTEST_TEST(Core_Profiler, tick_summary_of_nested_scopes) {
+    Profiler::clear();
+
+    Profiler::begin_tick();
+    {
+        Profiler::ScopedTimer outer("outer");
+        for (int i = 0; i < 3; ++i) {
+            Profiler::ScopedTimer inner("inner");
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    Profiler::end_tick();
+
+    // Scopes outside the tick are not part of the summary.
+    { Profiler::ScopedTimer after_tick("after tick"); }
+
+    auto summary = Profiler::get_tick_summary();
+    ASSERT_EQ(2u, summary.size());
+
+    const Profiler::ScopeSummary& outer = summary[0];
+    EXPECT_STREQ("outer", outer.name);
+    EXPECT_EQ(1u, outer.call_count);
+
+    const Profiler::ScopeSummary& inner = summary[1];
+    EXPECT_STREQ("inner", inner.name);
+    EXPECT_EQ(3u, inner.call_count);
+    EXPECT_GE(inner.total_duration, 0.003);
+    EXPECT_DOUBLE_EQ(inner.total_duration, inner.self_duration);
+    EXPECT_LE(inner.max_duration, inner.total_duration);
+
+    EXPECT_GE(outer.total_duration, inner.total_duration);
+    EXPECT_NEAR(outer.total_duration - inner.total_duration, outer.self_duration, 1e-9);
+}
+
+GTEST_TEST(Core_Profiler, scopes_from_multiple_threads) {
+    Profiler::clear();
+
+    auto record_scopes = []() {
+        for (int i = 0; i < 10; ++i)
+            Profiler::ScopedTimer timer("worker");
+    };
+    std::thread worker0(record_scopes), worker1(record_scopes);
+    worker0.join();
+    worker1.join();
+
+    std::vector<unsigned int> thread_indices;
+    auto events = Profiler::get_events(&thread_indices);
+    ASSERT_EQ(20u, events.size());
+    ASSERT_EQ(20u, thread_indices.size());
+    EXPECT_NE(thread_indices.front(), thread_indices.back());
+    for (const Profiler::Event& event : events) {
+        EXPECT_STREQ("worker", event.name);
+        EXPECT_EQ(0u, event.depth);
+        EXPECT_LE(event.begin, event.end);
+    }
+}
+
+GTEST_TEST(Core_Profiler, ring_buffer_keeps_newest_scopes) {
+    Profiler::clear();
+
+    std::thread worker([]() {
+        for (unsigned int i = 0; i < Profiler::ring_buffer_capacity + 10; ++i)
+            Profiler::ScopedTimer timer(i < 10 ? "old" : "new");
+    });
+    worker.join();
+
+    auto events = Profiler::get_events();
+    ASSERT_EQ(Profiler::ring_buffer_capacity, events.size());
+    for (const Profiler::Event& event : events)
+        EXPECT_STREQ("new", event.name);
+}
+
+GTEST_TEST(Core_Profiler, chrome_trace_export) {
+    Profiler::clear();
+    { Profiler::ScopedTimer timer("quoted \"scope\""); }
+
+    std::ostringstream trace;
+    Profiler::write_chrome_trace(trace);
+    std::string json = trace.str();
+    EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("\"name\":\"quoted \\\"scope\\\"\""));
+    EXPECT_NE(std::string::npos, json.find("\"ph\":\"X\""));
+}
+
+} // NS Core
+} // NS Bifrost
+
+#endif // _BIFROST_CORE_PROFILER_TEST_H_
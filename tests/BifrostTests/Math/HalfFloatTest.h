@@ -0,0 +1,75 @@
+// Test Bifrost half precision floating point conversions.
+// ------------------------------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ------------------------------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_HALF_FLOAT_TEST_H_
+#define _BIFROST_MATH_HALF_FLOAT_TEST_H_
+
+#include <Bifrost/Math/HalfFloat.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+namespace Bifrost {
+namespace Math {
+
+inline unsigned short half_bits(half value) {
+    unsigned short bits;
+    memcpy(&bits, &value, sizeof(half));
+    return bits;
+}
+
+GTEST_TEST(Math_HalfFloat, all_halfs_survive_round_trip) {
+    // Create all halfs except NaNs.
+    std::vector<half> halfs;
+    for (int bits = 0; bits < 65536; ++bits) {
+        bool is_NaN = (bits & 0x7C00) == 0x7C00 && (bits & 0x03FF) != 0;
+        if (!is_NaN) {
+            unsigned short half_bits = (unsigned short)bits;
+            half value;
+            memcpy(&value, &half_bits, sizeof(half));
+            halfs.push_back(value);
+        }
+    }
+    int count = int(halfs.size());
+
+    std::vector<float> floats(count);
+    to_float(halfs.data(), floats.data(), count);
+    std::vector<half> round_tripped_halfs(count);
+    to_half(floats.data(), round_tripped_halfs.data(), count);
+
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(to_float(halfs[i]), floats[i]);
+        EXPECT_EQ(half_bits(halfs[i]), half_bits(round_tripped_halfs[i]));
+        EXPECT_EQ(half_bits(halfs[i]), half_bits(to_half(floats[i])));
+    }
+}
+
+GTEST_TEST(Math_HalfFloat, bulk_conversion_rounds_to_nearest) {
+    // Odd count to exercise both the vectorized and the scalar conversion.
+    const int count = 1001;
+    std::vector<float> floats(count);
+    for (int i = 0; i < count; ++i)
+        floats[i] = (i - 500) * 0.123457f;
+
+    std::vector<half> halfs(count);
+    to_half(floats.data(), halfs.data(), count);
+
+    for (int i = 0; i < count; ++i) {
+        // Half has an 11 bit significand, so the relative error is at most 2^-11.
+        float value = to_float(halfs[i]);
+        EXPECT_LE(abs(value - floats[i]), abs(floats[i]) / 2048.0f);
+        EXPECT_EQ(half_bits(to_half(floats[i])), half_bits(halfs[i]));
+    }
+}
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_HALF_FLOAT_TEST_H_
@@ -0,0 +1,179 @@
+// Test Bifrost SIMD packets.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_PACKET_TEST_H_
+#define _BIFROST_MATH_PACKET_TEST_H_
+
+#include <Bifrost/Math/Conversions.h>
+#include <Bifrost/Math/Packet.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace Bifrost {
+namespace Math {
+
+class Math_Packet : public ::testing::Test {
+protected:
+    // Redefine comparison methods as gtest's EXPECT_PRED and argument overloading doesn't play well with each other.
+    static bool compare_vector(Vector3f lhs, Vector3f rhs, unsigned short max_ulps) {
+        return almost_equal(lhs, rhs, max_ulps);
+    }
+
+    // Vectors with a count that is not a multiple of the packet width, so the tail is exercised.
+    static std::vector<Vector3f> create_vectors() {
+        int vector_count = 3 * FloatPacket::width + 3;
+        std::vector<Vector3f> vectors(vector_count);
+        for (int i = 0; i < vector_count; ++i)
+            vectors[i] = Vector3f(float(i) - 7.0f, 0.5f * i + 1.0f, 3.0f - 0.25f * i * i);
+        return vectors;
+    }
+};
+
+TEST_F(Math_Packet, load_and_store_vectors) {
+    auto vectors = create_vectors();
+
+    for (int count = 1; count <= FloatPacket::width; ++count) {
+        Vector3fPacket packet = Vector3fPacket::load(vectors.data(), count);
+        for (int lane = 0; lane < count; ++lane)
+            EXPECT_EQ(vectors[lane], packet[lane]);
+
+        std::vector<Vector3f> stored_vectors(FloatPacket::width, Vector3f(42.0f));
+        packet.store(stored_vectors.data(), count);
+        for (int i = 0; i < count; ++i)
+            EXPECT_EQ(vectors[i], stored_vectors[i]);
+        for (int i = count; i < FloatPacket::width; ++i)
+            EXPECT_EQ(Vector3f(42.0f), stored_vectors[i]);
+    }
+}
+
+TEST_F(Math_Packet, vector_operations) {
+    auto vectors = create_vectors();
+    Vector3fPacket lhs = Vector3fPacket::load(vectors.data());
+    Vector3fPacket rhs = Vector3fPacket::load(vectors.data() + FloatPacket::width);
+
+    Vector3fPacket sum = lhs + rhs;
+    FloatPacket dots = dot(lhs, rhs);
+    Vector3fPacket crosses = cross(lhs, rhs);
+    Vector3fPacket minimums = min(lhs, rhs);
+    for (int lane = 0; lane < FloatPacket::width; ++lane) {
+        EXPECT_EQ(lhs[lane] + rhs[lane], sum[lane]);
+        EXPECT_FLOAT_EQ(dot(lhs[lane], rhs[lane]), dots[lane]);
+        EXPECT_EQ(cross(lhs[lane], rhs[lane]), crosses[lane]);
+        EXPECT_EQ(min(lhs[lane], rhs[lane]), minimums[lane]);
+    }
+}
+
+TEST_F(Math_Packet, masks) {
+    float values[FloatPacket::width];
+    for (int i = 0; i < FloatPacket::width; ++i)
+        values[i] = float(i);
+    FloatPacket packet = FloatPacket::load(values);
+
+    FloatPacket less_than_two = packet < FloatPacket::broadcast(2.0f);
+    EXPECT_EQ(0x3, to_bitmask(less_than_two));
+    EXPECT_TRUE(any(less_than_two));
+    EXPECT_FALSE(all(less_than_two));
+    EXPECT_TRUE(all(less_than_two | (packet >= FloatPacket::broadcast(2.0f))));
+    EXPECT_FALSE(any(less_than_two & (packet > FloatPacket::broadcast(1.0f))));
+
+    FloatPacket selected = select(less_than_two, FloatPacket::broadcast(-1.0f), packet);
+    for (int i = 0; i < FloatPacket::width; ++i)
+        EXPECT_EQ(i < 2 ? -1.0f : float(i), selected[i]);
+}
+
+TEST_F(Math_Packet, compute_bounds) {
+    auto points = create_vectors();
+
+    for (int count = 1; count <= int(points.size()); ++count) {
+        AABB expected_bounds = AABB(points[0], points[0]);
+        for (int i = 1; i < count; ++i)
+            expected_bounds.grow_to_contain(points[i]);
+
+        AABB bounds = compute_bounds(points.data(), count);
+        EXPECT_EQ(expected_bounds.minimum, bounds.minimum);
+        EXPECT_EQ(expected_bounds.maximum, bounds.maximum);
+    }
+}
+
+TEST_F(Math_Packet, transform_points_by_matrix) {
+    auto points = create_vectors();
+    Transform transform = Transform(Vector3f(3, -4, 1), Quaternionf::from_angle_axis(0.7f, normalize(Vector3f(1, 2, 3))), 1.5f);
+    Matrix3x4f affine_transform = to_matrix3x4(transform);
+
+    Matrix3x3f rotation;
+    rotation.set_column(0, affine_transform.get_column(0));
+    rotation.set_column(1, affine_transform.get_column(1));
+    rotation.set_column(2, affine_transform.get_column(2));
+    Vector3f translation = affine_transform.get_column(3);
+
+    std::vector<Vector3f> transformed_points(points.size());
+    AABB bounds = transform_points(affine_transform, points.data(), transformed_points.data(), int(points.size()));
+
+    AABB expected_bounds = AABB::invalid();
+    for (int i = 0; i < int(points.size()); ++i) {
+        Vector3f expected_point = rotation * points[i] + translation;
+        EXPECT_PRED3(compare_vector, expected_point, transformed_points[i], 2);
+        expected_bounds.grow_to_contain(transformed_points[i]);
+    }
+    EXPECT_EQ(expected_bounds.minimum, bounds.minimum);
+    EXPECT_EQ(expected_bounds.maximum, bounds.maximum);
+
+    // Transform in place.
+    std::vector<Vector3f> vectors = points;
+    transform_vectors(rotation, vectors.data(), vectors.data(), int(vectors.size()));
+    for (int i = 0; i < int(points.size()); ++i)
+        EXPECT_PRED3(compare_vector, rotation * points[i], vectors[i], 2);
+}
+
+TEST_F(Math_Packet, apply_transform) {
+    auto points = create_vectors();
+    Transform transform = Transform(Vector3f(3, -4, 1), Quaternionf::from_angle_axis(0.7f, normalize(Vector3f(1, 2, 3))), 1.5f);
+
+    std::vector<Vector3f> transformed_points(points.size());
+    transform_points(transform, points.data(), transformed_points.data(), int(points.size()));
+    std::vector<Vector3f> rotated_points(points.size());
+    rotate_vectors(transform.rotation, points.data(), rotated_points.data(), int(points.size()));
+
+    for (int i = 0; i < int(points.size()); ++i) {
+        EXPECT_PRED3(compare_vector, transform * points[i], transformed_points[i], 2);
+        EXPECT_PRED3(compare_vector, transform.rotation * points[i], rotated_points[i], 2);
+    }
+}
+
+TEST_F(Math_Packet, ray_AABB_intersection) {
+    std::vector<AABB> aabbs(FloatPacket::width);
+    for (int i = 0; i < FloatPacket::width; ++i) {
+        // Boxes alternate between being on and off the ray along the z-axis.
+        float offset = (i % 2) == 0 ? 0.0f : 3.0f;
+        aabbs[i] = AABB(Vector3f(offset - 1.0f, -1.0f, 2.0f * i + 1.0f), Vector3f(offset + 1.0f, 1.0f, 2.0f * i + 2.0f));
+    }
+    AABBPacket aabb_packet = AABBPacket::load(aabbs.data());
+
+    Ray ray = Ray(Vector3f::zero(), Vector3f::forward());
+    int hit_mask = to_bitmask(intersect(ray, aabb_packet, 0.0f, 1e30f));
+    for (int i = 0; i < FloatPacket::width; ++i)
+        EXPECT_EQ((i % 2) == 0, (hit_mask & (1 << i)) != 0);
+
+    // Boxes beyond t_max are not intersected.
+    int near_hit_mask = to_bitmask(intersect(ray, aabb_packet, 0.0f, 1.5f));
+    EXPECT_EQ(0x1, near_hit_mask);
+
+    // Partial packets contain invalid boxes in the unused lanes.
+    AABBPacket partial_packet = AABBPacket::load(aabbs.data(), 1);
+    EXPECT_EQ(0x1, to_bitmask(intersect(ray, partial_packet, 0.0f, 1e30f)));
+    AABB bounds = partial_packet.reduce();
+    EXPECT_EQ(aabbs[0].minimum, bounds.minimum);
+    EXPECT_EQ(aabbs[0].maximum, bounds.maximum);
+}
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_PACKET_TEST_H_
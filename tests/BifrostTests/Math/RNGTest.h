@@ -0,0 +1,94 @@
+// Test Bifrost random number generators.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_RNG_TEST_H_
+#define _BIFROST_MATH_RNG_TEST_H_
+
+#include <Bifrost/Math/RNG.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace Bifrost {
+namespace Math {
+
+GTEST_TEST(Math_RNG, sobol_matches_low_discrepancy_sequences) {
+    for (unsigned int n = 0; n < 1024; ++n) {
+        EXPECT_EQ(RNG::reverse_bits(n), RNG::sobol(n, 0));
+        EXPECT_EQ(RNG::sobol2(n, 0), RNG::sobol(n, 1) * RNG::uint_normalizer);
+    }
+
+    // Third dimension, x^2 + x + 1.
+    float expected_dimension_2[] = { 0.0f, 0.5f, 0.75f, 0.25f, 0.375f, 0.875f, 0.625f, 0.125f };
+    for (unsigned int n = 0; n < 8; ++n)
+        EXPECT_EQ(expected_dimension_2[n], RNG::sobol(n, 2) * RNG::uint_normalizer);
+}
+
+GTEST_TEST(Math_RNG, owen_scrambled_sobol_is_stratified) {
+    auto sampler = RNG::OwenScrambledSobol::for_pixel(3, 7);
+
+    // Every power of two prefix is stratified in every dimension, including the padded dimensions.
+    for (unsigned int dimension = 0; dimension < 2 * RNG::SOBOL_DIMENSION_COUNT + 3; ++dimension)
+        for (unsigned int sample_count = 1; sample_count <= 256; sample_count *= 2) {
+            std::vector<int> strata(sample_count, 0);
+            for (unsigned int i = 0; i < sample_count; ++i) {
+                float sample = sampler.sample1f(i, dimension);
+                EXPECT_LE(0.0f, sample);
+                EXPECT_LT(sample, 1.0f);
+                ++strata[int(sample * sample_count)];
+            }
+            for (int stratum_sample_count : strata)
+                EXPECT_EQ(1, stratum_sample_count);
+        }
+
+    // The first two dimensions are stratified in all elementary intervals.
+    const unsigned int sample_count = 256;
+    for (unsigned int columns = 1; columns <= sample_count; columns *= 2) {
+        unsigned int rows = sample_count / columns;
+        std::vector<int> intervals(sample_count, 0);
+        for (unsigned int i = 0; i < sample_count; ++i) {
+            Vector2f sample = sampler.sample2f(i, 0);
+            ++intervals[int(sample.x * columns) + int(sample.y * rows) * columns];
+        }
+        for (int interval_sample_count : intervals)
+            EXPECT_EQ(1, interval_sample_count);
+    }
+}
+
+GTEST_TEST(Math_RNG, owen_scrambled_sobol_decorrelates_pixels_and_blocks) {
+    auto sampler = RNG::OwenScrambledSobol::for_pixel(0, 0);
+    auto neighbour_sampler = RNG::OwenScrambledSobol::for_pixel(1, 0);
+    EXPECT_NE(sampler.get_seed(), neighbour_sampler.get_seed());
+
+    // Corresponding dimensions of different pixels and blocks of padded dimensions should not be equal.
+    int equal_pixel_sample_count = 0, equal_block_sample_count = 0;
+    for (unsigned int i = 0; i < 64; ++i) {
+        equal_pixel_sample_count += sampler.sample1f(i, 0) == neighbour_sampler.sample1f(i, 0);
+        equal_block_sample_count += sampler.sample1f(i, 1) == sampler.sample1f(i, RNG::SOBOL_DIMENSION_COUNT + 1);
+    }
+    EXPECT_LT(equal_pixel_sample_count, 2);
+    EXPECT_LT(equal_block_sample_count, 2);
+}
+
+GTEST_TEST(Math_RNG, owen_scrambled_sobol_fill_matches_sample) {
+    auto sampler = RNG::OwenScrambledSobol(1234);
+
+    const unsigned int index_begin = 5, index_count = 37, dimension_begin = 11, dimension_count = 9;
+    std::vector<float> samples(index_count * dimension_count);
+    sampler.fill(index_begin, index_count, dimension_begin, dimension_count, samples.data());
+
+    for (unsigned int d = 0; d < dimension_count; ++d)
+        for (unsigned int i = 0; i < index_count; ++i)
+            EXPECT_EQ(sampler.sample1f(index_begin + i, dimension_begin + d), samples[d * index_count + i]);
+}
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_RNG_TEST_H_
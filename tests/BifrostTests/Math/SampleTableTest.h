@@ -0,0 +1,128 @@
+// Test Bifrost sample tables.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_SAMPLE_TABLE_TEST_H_
+#define _BIFROST_MATH_SAMPLE_TABLE_TEST_H_
+
+#include <Bifrost/Math/SampleTable.h>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <vector>
+
+namespace Bifrost {
+namespace Math {
+
+class Math_SampleTable : public ::testing::Test {
+protected:
+    // Tests that the sample_count first samples are stratified in the given number of columns and rows.
+    static bool is_stratified(const Vector2f* samples, unsigned int sample_count, unsigned int columns, unsigned int rows) {
+        std::vector<unsigned int> interval_sample_counts(columns * rows, 0u);
+        for (unsigned int s = 0; s < sample_count; ++s) {
+            unsigned int column = unsigned(samples[s].x * columns), row = unsigned(samples[s].y * rows);
+            if (column >= columns || row >= rows)
+                return false;
+            ++interval_sample_counts[column + row * columns];
+        }
+        for (unsigned int count : interval_sample_counts)
+            if (count != sample_count / (columns * rows))
+                return false;
+        return true;
+    }
+
+    // Tests that all power of two prefixes of the samples are multi-jittered, i.e. stratified in 1D in both dimensions.
+    static bool is_progressive_multijittered(const Vector2f* samples, unsigned int sample_count) {
+        for (unsigned int n = 1; n <= sample_count; n *= 2)
+            if (!is_stratified(samples, n, n, 1) || !is_stratified(samples, n, 1, n))
+                return false;
+        return true;
+    }
+
+    // Tests that all power of two prefixes of the samples are stratified in all elementary intervals.
+    static bool is_progressive_02(const Vector2f* samples, unsigned int sample_count) {
+        for (unsigned int n = 1; n <= sample_count; n *= 2)
+            for (unsigned int columns = 1; columns <= n; columns *= 2)
+                if (!is_stratified(samples, n, columns, n / columns))
+                    return false;
+        return true;
+    }
+};
+
+TEST_F(Math_SampleTable, progressive_multijittered_blue_noise) {
+    SampleTable table = SampleTable::generate(SampleTable::Type::PMJBN, 1024, 4);
+    EXPECT_TRUE(table.is_valid());
+    EXPECT_EQ(1024u, table.get_sample_count());
+    EXPECT_EQ(4u, table.get_set_count());
+    for (unsigned int set = 0; set < table.get_set_count(); ++set)
+        EXPECT_TRUE(is_progressive_multijittered(table.get_samples(set), table.get_sample_count()));
+}
+
+TEST_F(Math_SampleTable, progressive_multijittered02) {
+    SampleTable table = SampleTable::generate(SampleTable::Type::PMJ02BN, 1024, 4);
+    for (unsigned int set = 0; set < table.get_set_count(); ++set) {
+        EXPECT_TRUE(is_progressive_multijittered(table.get_samples(set), table.get_sample_count()));
+        EXPECT_TRUE(is_progressive_02(table.get_samples(set), table.get_sample_count()));
+    }
+}
+
+TEST_F(Math_SampleTable, more_than_65535_samples) {
+    SampleTable pmj_table = SampleTable::generate(SampleTable::Type::PMJBN, 65536, 1, 1);
+    EXPECT_TRUE(is_progressive_multijittered(pmj_table.get_samples(), pmj_table.get_sample_count()));
+
+    SampleTable pmj02_table = SampleTable::generate(SampleTable::Type::PMJ02BN, 65536, 1, 1);
+    EXPECT_TRUE(is_progressive_02(pmj02_table.get_samples(), pmj02_table.get_sample_count()));
+}
+
+TEST_F(Math_SampleTable, sets_are_independent_and_deterministic) {
+    SampleTable table = SampleTable::generate(SampleTable::Type::PMJ02BN, 64, 3);
+    EXPECT_NE(table.get_sample(0, 1).x, table.get_sample(1, 1).x);
+    EXPECT_NE(table.get_sample(1, 1).x, table.get_sample(2, 1).x);
+
+    // The first sets of a larger table match the smaller table.
+    SampleTable larger_table = SampleTable::generate(SampleTable::Type::PMJ02BN, 64, 8);
+    for (unsigned int set = 0; set < table.get_set_count(); ++set)
+        for (unsigned int s = 0; s < table.get_sample_count(); ++s)
+            EXPECT_EQ(table.get_sample(set, s), larger_table.get_sample(set, s));
+}
+
+TEST_F(Math_SampleTable, invalid_sample_count) {
+    SampleTable table = SampleTable::generate(SampleTable::Type::PMJBN, 100, 1);
+    EXPECT_FALSE(table.is_valid());
+    EXPECT_EQ(0u, table.get_sample_count());
+}
+
+TEST_F(Math_SampleTable, cache) {
+    std::filesystem::path cache_path = std::filesystem::temp_directory_path() / "BifrostTests_SampleTableCache" / "PMJ02BN.smpl";
+    std::filesystem::remove_all(cache_path.parent_path());
+
+    SampleTable table = SampleTable::load_or_generate(cache_path, SampleTable::Type::PMJ02BN, 256, 2);
+    EXPECT_TRUE(std::filesystem::exists(cache_path));
+
+    SampleTable cached_table = SampleTable::read(cache_path);
+    EXPECT_TRUE(cached_table.is_valid());
+    EXPECT_EQ(table.get_type(), cached_table.get_type());
+    EXPECT_EQ(table.get_sample_count(), cached_table.get_sample_count());
+    EXPECT_EQ(table.get_set_count(), cached_table.get_set_count());
+    EXPECT_EQ(table.get_blue_noise_samples(), cached_table.get_blue_noise_samples());
+    EXPECT_EQ(table.get_seed(), cached_table.get_seed());
+    for (unsigned int s = 0; s < table.get_sample_count(); ++s)
+        EXPECT_EQ(table.get_sample(1, s), cached_table.get_sample(1, s));
+
+    // Different parameters regenerate and overwrite the cached table.
+    SampleTable reseeded_table = SampleTable::load_or_generate(cache_path, SampleTable::Type::PMJ02BN, 256, 2, 4, 7);
+    EXPECT_EQ(7u, SampleTable::read(cache_path).get_seed());
+    EXPECT_NE(table.get_sample(0, 1).x, reseeded_table.get_sample(0, 1).x);
+
+    std::filesystem::remove_all(cache_path.parent_path());
+}
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_SAMPLE_TABLE_TEST_H_
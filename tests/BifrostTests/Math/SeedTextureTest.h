@@ -0,0 +1,89 @@
+// Test Bifrost seed textures.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_SEED_TEXTURE_TEST_H_
+#define _BIFROST_MATH_SEED_TEXTURE_TEST_H_
+
+#include <Bifrost/Math/SeedTexture.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace Bifrost {
+namespace Math {
+namespace RNG {
+
+GTEST_TEST(Math_SeedTexture, optimization_lowers_energy_and_filtered_error) {
+    SeedTexture::OptimizationSettings settings;
+    settings.width = settings.height = 32;
+    settings.pass_count = 32;
+    SeedTexture::OptimizationReport report;
+    SeedTexture texture = SeedTexture::optimize(settings, &report);
+
+    EXPECT_TRUE(texture.is_valid());
+    EXPECT_EQ(settings.width, texture.get_width());
+    EXPECT_EQ(settings.height, texture.get_height());
+    EXPECT_LT(report.energy, report.initial_energy);
+    EXPECT_GT(report.accepted_swap_count, 0u);
+
+    settings.pass_count = 0;
+    SeedTexture white_noise_texture = SeedTexture::optimize(settings);
+    for (unsigned int sample_count = 1; sample_count <= settings.sample_count; sample_count *= 2)
+        EXPECT_LT(SeedTexture::filtered_rms_error(texture, sample_count), SeedTexture::filtered_rms_error(white_noise_texture, sample_count));
+
+    // The optimization only swaps seeds.
+    std::vector<unsigned int> seeds(texture.get_seeds(), texture.get_seeds() + settings.width * settings.height);
+    std::vector<unsigned int> white_noise_seeds(white_noise_texture.get_seeds(), white_noise_texture.get_seeds() + settings.width * settings.height);
+    std::sort(seeds.begin(), seeds.end());
+    std::sort(white_noise_seeds.begin(), white_noise_seeds.end());
+    EXPECT_EQ(white_noise_seeds, seeds);
+}
+
+GTEST_TEST(Math_SeedTexture, invalid_size) {
+    SeedTexture::OptimizationSettings settings;
+    settings.width = 24;
+    EXPECT_FALSE(SeedTexture::optimize(settings).is_valid());
+}
+
+GTEST_TEST(Math_SeedTexture, tiling) {
+    SeedTexture texture = SeedTexture(16, 16, 1);
+    for (unsigned int i = 0; i < 16 * 16; ++i)
+        texture.get_seeds()[i] = i;
+
+    EXPECT_EQ(texture.get_seed(3, 5), texture.get_seed(16 + 3, 5));
+    EXPECT_EQ(texture.get_seed(3, 5), texture.get_seed(3, 32 + 5));
+}
+
+GTEST_TEST(Math_SeedTexture, file) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "BifrostTests_SeedTexture.seeds";
+
+    SeedTexture::OptimizationSettings settings;
+    settings.width = settings.height = 32;
+    settings.pass_count = 2;
+    SeedTexture texture = SeedTexture::optimize(settings);
+    EXPECT_TRUE(texture.write(path));
+
+    SeedTexture read_texture = SeedTexture::read(path);
+    EXPECT_TRUE(read_texture.is_valid());
+    EXPECT_EQ(texture.get_width(), read_texture.get_width());
+    EXPECT_EQ(texture.get_height(), read_texture.get_height());
+    EXPECT_EQ(texture.get_sample_count(), read_texture.get_sample_count());
+    for (unsigned int i = 0; i < texture.get_width() * texture.get_height(); ++i)
+        EXPECT_EQ(texture.get_seeds()[i], read_texture.get_seeds()[i]);
+
+    std::filesystem::remove(path);
+}
+
+} // NS RNG
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_SEED_TEXTURE_TEST_H_
@@ -0,0 +1,106 @@
+// Test Bifrost spherical harmonics.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_SPHERICAL_HARMONICS_TEST_H_
+#define _BIFROST_MATH_SPHERICAL_HARMONICS_TEST_H_
+
+#include <Bifrost/Math/SphericalHarmonics.h>
+#include <Bifrost/Math/Utils.h>
+
+#include <gtest/gtest.h>
+
+namespace Bifrost {
+namespace Math {
+
+class Math_SphericalHarmonics : public ::testing::Test {
+protected:
+    // Projects the function onto spherical harmonics by integrating over a fine latlong grid.
+    template <typename F>
+    static SphericalHarmonics<float, 3> project(F f) {
+        const int width = 256, height = 128;
+        auto sh = SphericalHarmonics<float, 3>::zero();
+        for (int y = 0; y < height; ++y) {
+            float pixel_solid_angle = 2.0f * PI<float>() * (cosf(PI<float>() * y / height) - cosf(PI<float>() * (y + 1) / height)) / width;
+            for (int x = 0; x < width; ++x) {
+                Vector3f direction = latlong_texcoord_to_direction(Vector2f((x + 0.5f) / width, (y + 0.5f) / height));
+                sh.add(direction, f(direction), pixel_solid_angle);
+            }
+        }
+        return sh;
+    }
+};
+
+TEST_F(Math_SphericalHarmonics, basis_is_orthonormal) {
+    for (int i = 0; i < 9; ++i) {
+        auto sh = project([=](Vector3f direction) -> float {
+            float basis[9];
+            SphericalHarmonics<float, 3>::evaluate_basis(direction, basis);
+            return basis[i];
+        });
+        for (int j = 0; j < 9; ++j)
+            EXPECT_NEAR(i == j ? 1.0f : 0.0f, sh.coefficients[j], 0.001f);
+    }
+}
+
+TEST_F(Math_SphericalHarmonics, constant_function) {
+    auto sh = project([](Vector3f direction) -> float { return 2.0f; });
+
+    Vector3f directions[] = { Vector3f::up(), Vector3f::forward(), normalize(Vector3f(1, -2, 3)) };
+    for (Vector3f direction : directions) {
+        EXPECT_NEAR(2.0f, sh.evaluate(direction), 0.001f);
+        EXPECT_NEAR(2.0f * PI<float>(), sh.evaluate_irradiance(direction), 0.001f);
+        EXPECT_NEAR(2.0f, sh.evaluate_diffuse(direction), 0.001f);
+    }
+}
+
+TEST_F(Math_SphericalHarmonics, linear_function_irradiance) {
+    // The irradiance from radiance 1 + dot(a, w) is pi + 2pi/3 * dot(a, n).
+    Vector3f a = Vector3f(0.25f, -0.5f, 0.125f);
+    auto sh = project([=](Vector3f direction) -> float { return 1.0f + dot(a, direction); });
+
+    Vector3f normals[] = { Vector3f::up(), Vector3f::forward(), normalize(Vector3f(1, -2, 3)) };
+    for (Vector3f normal : normals) {
+        EXPECT_NEAR(1.0f + dot(a, normal), sh.evaluate(normal), 0.001f);
+        float expected_irradiance = PI<float>() + 2.0f * PI<float>() / 3.0f * dot(a, normal);
+        EXPECT_NEAR(expected_irradiance, sh.evaluate_irradiance(normal), 0.001f);
+    }
+}
+
+TEST_F(Math_SphericalHarmonics, cosine_lobe_irradiance) {
+    // The irradiance from the clamped cosine lobe max(0, w.y) is known in closed form along the lobe axis and opposite it.
+    // Along the axis it is the integral of cos^2 over the hemisphere, 2pi/3, and opposite the axis it is zero.
+    // The order 3 approximation is accurate to within a few percent of the peak.
+    auto sh = project([](Vector3f direction) -> float { return fmaxf(0.0f, direction.y); });
+    EXPECT_NEAR(2.0f * PI<float>() / 3.0f, sh.evaluate_irradiance(Vector3f::up()), 0.05f);
+    EXPECT_NEAR(0.0f, sh.evaluate_irradiance(-Vector3f::up()), 0.05f);
+}
+
+TEST_F(Math_SphericalHarmonics, windowing) {
+    auto sh = project([](Vector3f direction) -> float { return fmaxf(0.0f, direction.y); });
+
+    auto hanning_sh = sh.hanning_windowed(4.0f);
+    auto lanczos_sh = sh.lanczos_windowed(4.0f);
+    float expected_hanning_scales[3] = { 1.0f, 0.5f * (1.0f + cosf(0.25f * PI<float>())), 0.5f };
+    float expected_lanczos_scales[3] = { 1.0f, sinf(0.25f * PI<float>()) / (0.25f * PI<float>()), sinf(0.5f * PI<float>()) / (0.5f * PI<float>()) };
+    for (int i = 0; i < 9; ++i) {
+        int band = SphericalHarmonics<float, 3>::band_of(i);
+        EXPECT_FLOAT_EQ(sh.coefficients[i] * expected_hanning_scales[band], hanning_sh.coefficients[i]);
+        EXPECT_FLOAT_EQ(sh.coefficients[i] * expected_lanczos_scales[band], lanczos_sh.coefficients[i]);
+    }
+
+    // Windowing removes the negative ringing perpendicular to a point light.
+    auto point_light_sh = SphericalHarmonics<float, 3>::zero();
+    point_light_sh.add(Vector3f::up(), 1.0f, 1.0f);
+    EXPECT_LT(point_light_sh.evaluate(Vector3f::forward()), 0.0f);
+    EXPECT_GT(point_light_sh.hanning_windowed(3.0f).evaluate(Vector3f::forward()), 0.0f);
+}
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_SPHERICAL_HARMONICS_TEST_H_
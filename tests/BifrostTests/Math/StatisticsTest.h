@@ -13,6 +13,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 namespace Bifrost {
 namespace Math {
 
@@ -53,6 +55,78 @@ GTEST_TEST(Math_Statistics, merging) {
     EXPECT_FLOAT_EQ(2.0f, float(stats.variance()));
 }
 
+GTEST_TEST(Math_Statistics, adding_to_empty) {
+    Statistics<float> stats;
+    EXPECT_EQ(0, stats.sample_count);
+    EXPECT_EQ(0.0f, stats.variance());
+
+    stats.add(-2.0f);
+    stats.add(-4.0f);
+    EXPECT_EQ(2, stats.sample_count);
+    EXPECT_FLOAT_EQ(-4.0f, stats.minimum);
+    EXPECT_FLOAT_EQ(-2.0f, stats.maximum);
+    EXPECT_FLOAT_EQ(-3.0f, stats.mean);
+    EXPECT_FLOAT_EQ(1.0f, stats.variance());
+
+    // Merging with empty statistics is a no-op in both directions.
+    Statistics<float> empty_stats;
+    empty_stats.merge_with(stats);
+    stats.merge_with(Statistics<float>());
+    EXPECT_EQ(stats.sample_count, empty_stats.sample_count);
+    EXPECT_EQ(stats.minimum, empty_stats.minimum);
+    EXPECT_EQ(stats.maximum, empty_stats.maximum);
+    EXPECT_EQ(stats.mean, empty_stats.mean);
+    EXPECT_EQ(stats.variance(), empty_stats.variance());
+}
+
+GTEST_TEST(Math_Statistics, variance_of_values_with_large_offset) {
+    // The variance of values with a large offset cannot be computed from the raw moments in double precision.
+    const int sample_count = 100000;
+    const double offset = 1e9;
+    std::vector<double> values(sample_count);
+    for (int i = 0; i < sample_count; ++i)
+        values[i] = offset + (i % 2 == 0 ? 1.0 : -1.0) * (1.0 + (i % 7) * 0.25);
+
+    double expected_mean = 0.0;
+    for (int i = 0; i < sample_count; ++i)
+        expected_mean += values[i] - offset;
+    expected_mean = offset + expected_mean / sample_count;
+    double expected_variance = 0.0;
+    for (int i = 0; i < sample_count; ++i)
+        expected_variance += (values[i] - expected_mean) * (values[i] - expected_mean);
+    expected_variance /= sample_count;
+
+    Statistics<double> stats = Statistics<double>(values.begin(), values.end());
+    EXPECT_EQ(sample_count, stats.sample_count);
+    EXPECT_DOUBLE_EQ(expected_mean, stats.mean);
+    EXPECT_NEAR(expected_variance, stats.variance(), expected_variance * 1e-9);
+
+    // Adding the values one at a time gives the same result.
+    Statistics<double> added_stats;
+    for (double v : values)
+        added_stats.add(v);
+    EXPECT_DOUBLE_EQ(expected_mean, added_stats.mean);
+    EXPECT_NEAR(expected_variance, added_stats.variance(), expected_variance * 1e-9);
+}
+
+GTEST_TEST(Math_Statistics, independent_of_thread_count) {
+    const int sample_count = 1000003;
+    auto predicate = [](int i) -> double { return sin(i * 0.001) * 1000.0 + i * 0.0001; };
+
+    int thread_count = Core::Parallel::get_thread_count();
+    Core::Parallel::set_thread_count(1);
+    Statistics<double> single_threaded_stats = Statistics<double>(0, sample_count, predicate);
+    Core::Parallel::set_thread_count(thread_count);
+    Statistics<double> multi_threaded_stats = Statistics<double>(0, sample_count, predicate);
+
+    EXPECT_EQ(single_threaded_stats.sample_count, multi_threaded_stats.sample_count);
+    EXPECT_EQ(single_threaded_stats.minimum, multi_threaded_stats.minimum);
+    EXPECT_EQ(single_threaded_stats.maximum, multi_threaded_stats.maximum);
+    EXPECT_EQ(single_threaded_stats.mean, multi_threaded_stats.mean);
+    EXPECT_EQ(single_threaded_stats.m2, multi_threaded_stats.m2);
+    EXPECT_EQ(single_threaded_stats.variance(), multi_threaded_stats.variance());
+}
+
 } // NS Math
 } // NS Bifrost
 
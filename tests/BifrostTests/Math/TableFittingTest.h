@@ -0,0 +1,105 @@
+// Test Bifrost table fitting.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _BIFROST_MATH_TABLE_FITTING_TEST_H_
+#define _BIFROST_MATH_TABLE_FITTING_TEST_H_
+
+#include <Bifrost/Math/TableFitting.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace Bifrost {
+namespace Math {
+
+GTEST_TEST(Math_TableFitting, nelder_mead_statistics) {
+    auto paraboloid = [](float* p) -> float { return 1.0f + (p[0] - 0.5f) * (p[0] - 0.5f) + (p[1] + 0.25f) * (p[1] + 0.25f); };
+    float start[2] = { 0.0f, 0.0f };
+    float minimum[2];
+    NelderMeadStatistics statistics;
+    float error = nelder_mead<2>(minimum, start, 0.1f, 1e-6f, 200, paraboloid, &statistics);
+
+    EXPECT_NEAR(1.0f, error, 1e-5f);
+    EXPECT_NEAR(0.5f, minimum[0], 0.01f);
+    EXPECT_NEAR(-0.25f, minimum[1], 0.01f);
+    EXPECT_TRUE(statistics.converged);
+    EXPECT_LT(statistics.iteration_count, 200);
+    EXPECT_GT(statistics.evaluation_count, statistics.iteration_count);
+
+    nelder_mead<2>(minimum, start, 0.1f, 1e-6f, 2, paraboloid, &statistics);
+    EXPECT_FALSE(statistics.converged);
+    EXPECT_EQ(2, statistics.iteration_count);
+}
+
+GTEST_TEST(Math_TableFitting, fit_smooth_table) {
+    TableFittingSettings settings;
+    settings.width = 7;
+    settings.height = 5;
+    settings.tolerance = 1e-7f;
+
+    // The optimal parameters of cell (x, y) are (0.1 * x, 0.2 * y).
+    auto initial_guess = [](int x, int y, float* parameters) { parameters[0] = parameters[1] = 0.0f; };
+    auto error_function = [](int x, int y, float* p) -> float {
+        return 1.0f + (p[0] - 0.1f * x) * (p[0] - 0.1f * x) + (p[1] - 0.2f * y) * (p[1] - 0.2f * y);
+    };
+
+    std::vector<TableFit<2>> fits(settings.width * settings.height);
+    TableFittingReport report = fit_table(settings, fits.data(), initial_guess, error_function);
+
+    for (int y = 0; y < settings.height; ++y)
+        for (int x = 0; x < settings.width; ++x) {
+            const TableFit<2>& fit = fits[x + y * settings.width];
+            EXPECT_NEAR(0.1f * x, fit.parameters[0], 0.005f);
+            EXPECT_NEAR(0.2f * y, fit.parameters[1], 0.005f);
+            EXPECT_TRUE(fit.statistics.converged);
+        }
+    EXPECT_NEAR(1.0f, report.mean_error, 1e-4f);
+    EXPECT_EQ(0, report.unconverged_cell_count);
+    EXPECT_GE(report.seconds, 0.0);
+}
+
+GTEST_TEST(Math_TableFitting, multi_start_escapes_local_minima) {
+    TableFittingSettings settings;
+    settings.width = 4;
+    settings.height = 3;
+
+    // A local minimum with error 1.5 at p0 = -1 and the global minimum with error 1 at p0 = 1.
+    // Only cells with an odd x guess a starting point in the basin of the global minimum.
+    auto initial_guess = [](int x, int y, float* parameters) {
+        parameters[0] = (x % 2) == 0 ? -1.0f : 1.0f;
+        parameters[1] = 0.0f;
+    };
+    auto error_function = [](int x, int y, float* p) -> float {
+        float local_error = 1.5f + (p[0] + 1.0f) * (p[0] + 1.0f);
+        float global_error = 1.0f + (p[0] - 1.0f) * (p[0] - 1.0f);
+        return fminf(local_error, global_error) + (p[1] - 0.5f) * (p[1] - 0.5f);
+    };
+
+    // With a single start, cells are warm started from their neighbours and stay in the local minimum of cell (0, 0).
+    std::vector<TableFit<2>> fits(settings.width * settings.height);
+    TableFittingReport report = fit_table(settings, fits.data(), initial_guess, error_function);
+    EXPECT_NEAR(1.5f, report.max_error, 0.001f);
+    EXPECT_NEAR(1.5f, fits[1].error, 0.001f);
+
+    // With multiple starts, the initial guess is refined as well and the global minimum propagates to the right.
+    // The first column only sees starting points in the local minimum's basin.
+    settings.start_count = 3;
+    report = fit_table(settings, fits.data(), initial_guess, error_function);
+    for (int y = 0; y < settings.height; ++y)
+        for (int x = 0; x < settings.width; ++x) {
+            const TableFit<2>& fit = fits[x + y * settings.width];
+            EXPECT_NEAR(x == 0 ? 1.5f : 1.0f, fit.error, 0.001f);
+            EXPECT_NEAR(x == 0 ? -1.0f : 1.0f, fit.parameters[0], 0.01f);
+        }
+}
+
+} // NS Math
+} // NS Bifrost
+
+#endif // _BIFROST_MATH_TABLE_FITTING_TEST_H_
@@ -8,25 +8,39 @@
 
 #include <gtest/gtest.h>
 
+#include <Assets/BlockCompressionTest.h>
 #include <Assets/ImageTest.h>
 #include <Assets/InfiniteAreaLightTest.h>
 #include <Assets/MaterialTest.h>
 #include <Assets/MeshTest.h>
 #include <Assets/MeshModelTest.h>
+#include <Assets/MeshSimplificationTest.h>
+#include <Assets/RhoTableTest.h>
 #include <Assets/TextureTest.h>
 
 #include <Core/ArrayTest.h>
+#include <Core/BinaryFileTest.h>
 #include <Core/BitmaskTest.h>
+#include <Core/EngineTest.h>
+#include <Core/ParallelTest.h>
+#include <Core/ProfilerTest.h>
 #include <Core/UniqueIDGeneratorTest.h>
 
 #include <Input/KeyboardTest.h>
 
 #include <Math/Distribution1DTest.h>
 #include <Math/Distribution2DTest.h>
+#include <Math/HalfFloatTest.h>
 #include <Math/MatrixTest.h>
 #include <Math/OctahedralNormalTest.h>
+#include <Math/PacketTest.h>
 #include <Math/QuaternionTest.h>
+#include <Math/RNGTest.h>
+#include <Math/SampleTableTest.h>
+#include <Math/SeedTextureTest.h>
+#include <Math/SphericalHarmonicsTest.h>
 #include <Math/StatisticsTest.h>
+#include <Math/TableFittingTest.h>
 #include <Math/TransformTest.h>
 #include <Math/TypeTraitsTest.h>
 #include <Math/UtilsTest.h>
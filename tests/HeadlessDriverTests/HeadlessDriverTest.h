@@ -0,0 +1,174 @@
+// Test the headless driver.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _HEADLESS_DRIVER_TEST_H_
+#define _HEADLESS_DRIVER_TEST_H_
+
+#include <HeadlessDriver.h>
+
+#include <Bifrost/Core/Engine.h>
+#include <Bifrost/Core/Window.h>
+#include <Bifrost/Input/Keyboard.h>
+#include <Bifrost/Input/Mouse.h>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <vector>
+
+namespace HeadlessDriver {
+
+using Bifrost::Core::Engine;
+using Bifrost::Core::Window;
+using Bifrost::Input::Keyboard;
+using Bifrost::Input::Mouse;
+
+class HeadlessDriverTest : public ::testing::Test {
+protected:
+    // The driver's callbacks are function pointers, so the state they record is static.
+    struct Recording {
+        int launch_count;
+        int window_created_count;
+        int window_width;
+        int window_height;
+        unsigned int mutating_callback_count;
+        unsigned int non_mutating_callback_count;
+        unsigned int quit_at_tick; // Quit is requested in the tick with this number. Zero never requests quit.
+        unsigned int idle_input_count; // Ticks where neither a key nor a mouse button was pressed.
+        std::vector<double> total_times;
+    };
+    static inline Recording s_recording = {};
+
+    void SetUp() override { s_recording = {}; }
+
+    static int on_launch(Engine& engine) {
+        ++s_recording.launch_count;
+        engine.add_mutating_callback([&engine] {
+            ++s_recording.mutating_callback_count;
+            s_recording.total_times.push_back(engine.get_time().get_total_time());
+            if (s_recording.mutating_callback_count == s_recording.quit_at_tick)
+                engine.request_quit();
+        });
+        engine.add_non_mutating_callback([] { ++s_recording.non_mutating_callback_count; });
+        return 0;
+    }
+
+    static int on_window_created(Engine& engine, Window& window) {
+        ++s_recording.window_created_count;
+        s_recording.window_width = window.get_width();
+        s_recording.window_height = window.get_height();
+        return 0;
+    }
+
+    // Queries the input devices every tick without checking them for null, like the apps do.
+    static int on_launch_with_input(Engine& engine) {
+        engine.add_mutating_callback([&engine] {
+            const Keyboard* keyboard = engine.get_keyboard();
+            const Mouse* mouse = engine.get_mouse();
+            if (keyboard->is_released(Keyboard::Key::Space) && !keyboard->was_pressed(Keyboard::Key::Escape) &&
+                mouse->is_released(Mouse::Button::Left) && mouse->get_delta() == Bifrost::Math::Vector2i::zero())
+                ++s_recording.idle_input_count;
+        });
+        return 0;
+    }
+
+    static int failing_on_launch(Engine& engine) { return 42; }
+    static int failing_on_window_created(Engine& engine, Window& window) { return 7; }
+
+    static Settings create_settings() {
+        Settings settings;
+        settings.data_directory = std::filesystem::temp_directory_path();
+        settings.max_tick_count = 10;
+        settings.thread_count = 2;
+        settings.print_statistics = false;
+        return settings;
+    }
+};
+
+TEST_F(HeadlessDriverTest, runs_fixed_number_of_ticks) {
+    Settings settings = create_settings();
+    TickStatistics statistics;
+    EXPECT_EQ(0, run(on_launch, on_window_created, settings, &statistics));
+
+    EXPECT_EQ(1, s_recording.launch_count);
+    EXPECT_EQ(1, s_recording.window_created_count);
+    EXPECT_EQ(0, s_recording.window_width);
+    EXPECT_EQ(0, s_recording.window_height);
+
+    EXPECT_EQ(10u, s_recording.mutating_callback_count);
+    EXPECT_EQ(10u, s_recording.non_mutating_callback_count);
+    EXPECT_EQ(10u, statistics.tick_count);
+
+    // Every tick advances the engine by exactly the time step.
+    ASSERT_EQ(10u, s_recording.total_times.size());
+    for (int t = 0; t < 10; ++t)
+        EXPECT_NEAR((t + 1) * settings.time_step, s_recording.total_times[t], 1e-9);
+
+    EXPECT_LE(statistics.min, statistics.percentile_50);
+    EXPECT_LE(statistics.percentile_50, statistics.percentile_90);
+    EXPECT_LE(statistics.percentile_90, statistics.percentile_99);
+    EXPECT_LE(statistics.percentile_99, statistics.max);
+    EXPECT_LE(statistics.mean, statistics.max);
+    EXPECT_LE(statistics.mean * statistics.tick_count, statistics.total_time);
+}
+
+TEST_F(HeadlessDriverTest, stops_when_quit_is_requested) {
+    s_recording.quit_at_tick = 3;
+    TickStatistics statistics;
+    EXPECT_EQ(0, run(on_launch, on_window_created, create_settings(), &statistics));
+
+    EXPECT_EQ(3u, s_recording.mutating_callback_count);
+    EXPECT_EQ(3u, s_recording.non_mutating_callback_count);
+    EXPECT_EQ(3u, statistics.tick_count);
+}
+
+TEST_F(HeadlessDriverTest, stops_on_stop_condition) {
+    Settings settings = create_settings();
+    settings.stop_condition = [](const Engine& engine) { return engine.get_time().get_ticks() >= 4; };
+    TickStatistics statistics;
+    EXPECT_EQ(0, run(on_launch, on_window_created, settings, &statistics));
+
+    EXPECT_EQ(4u, s_recording.mutating_callback_count);
+    EXPECT_EQ(4u, statistics.tick_count);
+}
+
+TEST_F(HeadlessDriverTest, real_time_ticks_are_spaced_by_the_time_step) {
+    Settings settings = create_settings();
+    settings.max_tick_count = 5;
+    settings.time_step = 0.01;
+    settings.real_time = true;
+    TickStatistics statistics;
+    EXPECT_EQ(0, run(on_launch, on_window_created, settings, &statistics));
+
+    EXPECT_EQ(5u, statistics.tick_count);
+    // The first tick starts immediately and the following four are each delayed by a time step.
+    EXPECT_GE(statistics.total_time, 0.04);
+}
+
+TEST_F(HeadlessDriverTest, input_devices_are_idle) {
+    TickStatistics statistics;
+    EXPECT_EQ(0, run(on_launch_with_input, on_window_created, create_settings(), &statistics));
+
+    EXPECT_EQ(10u, statistics.tick_count);
+    EXPECT_EQ(10u, s_recording.idle_input_count);
+}
+
+TEST_F(HeadlessDriverTest, callback_errors_are_returned_without_ticking) {
+    EXPECT_EQ(42, run(failing_on_launch, on_window_created, create_settings()));
+    EXPECT_EQ(0, s_recording.window_created_count);
+    EXPECT_EQ(0u, s_recording.mutating_callback_count);
+
+    EXPECT_EQ(7, run(on_launch, failing_on_window_created, create_settings()));
+    EXPECT_EQ(1, s_recording.launch_count);
+    EXPECT_EQ(0u, s_recording.mutating_callback_count);
+    EXPECT_EQ(0u, s_recording.non_mutating_callback_count);
+}
+
+} // NS HeadlessDriver
+
+#endif // _HEADLESS_DRIVER_TEST_H_
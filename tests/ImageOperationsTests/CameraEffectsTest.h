@@ -0,0 +1,155 @@
+// Test camera effects.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _IMAGE_OPERATIONS_CAMERA_EFFECTS_TEST_H_
+#define _IMAGE_OPERATIONS_CAMERA_EFFECTS_TEST_H_
+
+#include <ImageOperations/CameraEffects.h>
+
+#include <Bifrost/Core/Parallel.h>
+
+#include <../BifrostTests/Expects.h>
+
+namespace ImageOperations {
+namespace CameraEffects {
+
+using namespace Bifrost::Assets;
+using namespace Bifrost::Math;
+using namespace Bifrost::Math::CameraEffects;
+
+class ImageOperations_CameraEffects : public ::testing::Test {
+protected:
+    // Per-test set-up and tear-down logic.
+    virtual void SetUp() {
+        Images::allocate(4u);
+    }
+    virtual void TearDown() {
+        Images::deallocate();
+    }
+
+    static Settings linear_settings() {
+        Settings settings = Settings::default();
+        settings.exposure.mode = ExposureMode::Fixed;
+        settings.exposure.eye_adaptation_enabled = false;
+        settings.vignette = 0.0f;
+        settings.tonemapping.mode = TonemappingMode::Linear;
+        return settings;
+    }
+};
+
+inline Image create_constant_image(int width, int height, RGB color) {
+    Image image = Images::create2D("img", PixelFormat::RGB_Float, 1.0f, Vector2ui(width, height));
+    RGB* pixels = image.get_pixels<RGB>();
+    std::fill_n(pixels, width * height, color);
+    return image;
+}
+
+TEST_F(ImageOperations_CameraEffects, fixed_exposure) {
+    Image image = create_constant_image(5, 3, RGB(0.5f, 1.0f, 2.0f));
+    Settings settings = linear_settings();
+    settings.exposure.log_lumiance_bias = 1.0f;
+
+    float linear_exposure = 1.0f;
+    Image processed_image = process(image.get_ID(), settings, 1.0f / 60.0f, linear_exposure);
+    EXPECT_FLOAT_EQ(2.0f, linear_exposure);
+    EXPECT_EQ(PixelFormat::RGB_Float, processed_image.get_pixel_format());
+    for (unsigned int i = 0; i < processed_image.get_pixel_count(); ++i)
+        EXPECT_RGB_EQ(RGB(1.0f, 2.0f, 4.0f), processed_image.get_pixel(i).rgb());
+}
+
+TEST_F(ImageOperations_CameraEffects, histogram_exposure) {
+    // A luminance of one falls in bin 32, whose center has log luminance 0.0625 in the range [-4, 4].
+    Image image = create_constant_image(70, 70, RGB::white());
+    Settings settings = linear_settings();
+    settings.exposure.mode = ExposureMode::Histogram;
+
+    Histogram histogram = exposure_histogram(image.get_ID(), settings);
+    for (int b = 0; b < histogram_size; ++b)
+        EXPECT_EQ(b == 32 ? 70u * 70u : 0u, histogram[b]);
+
+    float linear_exposure = compute_linear_exposure(image.get_ID(), settings, 0.0f, 1.0f);
+    EXPECT_FLOAT_EQ(exp2(-0.0625f), linear_exposure);
+}
+
+TEST_F(ImageOperations_CameraEffects, log_average_exposure) {
+    Image image = create_constant_image(70, 70, RGB::white());
+    Settings settings = linear_settings();
+    settings.exposure.mode = ExposureMode::LogAverage;
+
+    float expected_linear_exposure = 1.03f - 2.0f / (2.0f + log10(2.0f));
+    float linear_exposure = compute_linear_exposure(image.get_ID(), settings, 0.0f, 1.0f);
+    EXPECT_FLOAT_EQ(expected_linear_exposure, linear_exposure);
+}
+
+TEST_F(ImageOperations_CameraEffects, eye_adaptation) {
+    Settings settings = linear_settings();
+    EXPECT_FLOAT_EQ(4.0f, eye_adaptation(1.0f, 4.0f, settings, 0.1f));
+
+    settings.exposure.eye_adaptation_enabled = true;
+    settings.exposure.eye_adaptation_brightness = 1.0f;
+    settings.exposure.eye_adaptation_darkness = 2.0f;
+    EXPECT_FLOAT_EQ(2.5f, eye_adaptation(1.0f, 4.0f, settings, 1.0f));
+    EXPECT_FLOAT_EQ(1.75f, eye_adaptation(4.0f, 1.0f, settings, 1.0f));
+}
+
+TEST_F(ImageOperations_CameraEffects, bloom_preserves_energy) {
+    const int size = 65;
+    Image image = create_constant_image(size, size, RGB::black());
+    image.set_pixel(RGBA(RGB(10.0f, 5.0f, 0.0f), 1.0f), Vector2ui(size / 2, size / 2));
+
+    // Thresholding is applied to the bilinearly filtered samples, so a zero threshold is needed to preserve energy.
+    std::vector<RGB> bloom_pixels = std::vector<RGB>(size * size);
+    bloom(image.get_ID(), 0.0f, 16, bloom_pixels.data());
+
+    RGB total_bloom = RGB::black();
+    for (RGB bloom_pixel : bloom_pixels)
+        total_bloom += bloom_pixel;
+    EXPECT_RGB_EQ_EPS(RGB(10.0f, 5.0f, 0.0f), total_bloom, 0.001f);
+
+    // The bloom is symmetric around the bright pixel.
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x) {
+            RGB bloom_pixel = bloom_pixels[x + y * size];
+            EXPECT_RGB_EQ_EPS(bloom_pixel, bloom_pixels[(size - 1 - x) + y * size], 0.000001f);
+            EXPECT_RGB_EQ_EPS(bloom_pixel, bloom_pixels[y + x * size], 0.000001f);
+        }
+}
+
+TEST_F(ImageOperations_CameraEffects, results_are_independent_of_thread_count) {
+    const int width = 300, height = 200;
+    Image image = Images::create2D("img", PixelFormat::RGB_Float, 1.0f, Vector2ui(width, height));
+    RGB* pixels = image.get_pixels<RGB>();
+    for (int i = 0; i < width * height; ++i)
+        pixels[i] = RGB(float(i % 7), float(i % 13) * 0.1f, float(i % 101) * 0.05f);
+
+    Settings settings = linear_settings();
+    settings.exposure.mode = ExposureMode::LogAverage;
+    settings.bloom.threshold = 2.0f;
+    settings.vignette = 1.0f;
+    settings.tonemapping.mode = TonemappingMode::Filmic;
+
+    Bifrost::Core::Parallel::set_thread_count(1);
+    float single_threaded_exposure = 1.0f;
+    Image single_threaded_image = process(image.get_ID(), settings, 0.0f, single_threaded_exposure);
+
+    Bifrost::Core::Parallel::set_thread_count(4);
+    float multi_threaded_exposure = 1.0f;
+    Image multi_threaded_image = process(image.get_ID(), settings, 0.0f, multi_threaded_exposure);
+    Bifrost::Core::Parallel::set_thread_count(0);
+
+    EXPECT_EQ(single_threaded_exposure, multi_threaded_exposure);
+    const RGB* single_threaded_pixels = single_threaded_image.get_pixels<RGB>();
+    const RGB* multi_threaded_pixels = multi_threaded_image.get_pixels<RGB>();
+    for (int i = 0; i < width * height; ++i)
+        EXPECT_EQ(single_threaded_pixels[i], multi_threaded_pixels[i]);
+}
+
+} // NS CameraEffects
+} // NS ImageOperations
+
+#endif // _IMAGE_OPERATIONS_CAMERA_EFFECTS_TEST_H_
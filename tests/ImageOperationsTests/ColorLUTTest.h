@@ -0,0 +1,133 @@
+// Test 3D color lookup tables.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _IMAGE_OPERATIONS_COLOR_LUT_TEST_H_
+#define _IMAGE_OPERATIONS_COLOR_LUT_TEST_H_
+
+#include <ImageOperations/ColorLUT.h>
+
+#include <Bifrost/Math/CameraEffects.h>
+
+#include <../BifrostTests/Expects.h>
+
+#include <filesystem>
+#include <fstream>
+
+namespace ImageOperations {
+namespace ColorLUT {
+
+using namespace Bifrost::Math;
+
+inline std::vector<RGB> create_test_colors(int count, float max_value) {
+    std::vector<RGB> colors(count);
+    for (int i = 0; i < count; ++i) {
+        float t = i / float(count);
+        colors[i] = RGB(t, fmodf(t * 7.0f, 1.0f), fmodf(t * 31.0f, 1.0f)) * max_value;
+    }
+    return colors;
+}
+
+GTEST_TEST(ImageOperations_ColorLUT, identity_is_reproduced) {
+    LUT3D lut = LUT3D::linear(5, RGB(-1.0f), RGB(2.0f));
+    lut.bake([](RGB color) { return color; });
+
+    for (RGB color : create_test_colors(101, 2.0f)) {
+        EXPECT_RGB_EQ_EPS(color, lut.apply(color, Interpolation::Trilinear), 0.00001f);
+        EXPECT_RGB_EQ_EPS(color, lut.apply(color, Interpolation::Tetrahedral), 0.00001f);
+    }
+
+    // Colors outside the domain are clamped.
+    EXPECT_RGB_EQ_EPS(RGB(-1.0f, 2.0f, 0.5f), lut.apply(RGB(-3.0f, 5.0f, 0.5f)), 0.00001f);
+
+    // Black is encoded exactly by the first entry of log2 encoded LUTs.
+    LUT3D log2_lut = LUT3D::log2(5, -8.0f, 4.0f);
+    log2_lut.bake([](RGB color) { return color; });
+    EXPECT_EQ(RGB::black(), log2_lut.get_entry(0, 0, 0));
+    EXPECT_EQ(RGB::black(), log2_lut.apply(RGB::black()));
+}
+
+GTEST_TEST(ImageOperations_ColorLUT, log2_encoded_tonemapper) {
+    auto settings = CameraEffects::Uncharted2Settings::default();
+    auto tonemap = [=](RGB color) { return gammacorrect(CameraEffects::uncharted2(color, settings), 1.0f / 2.2f); };
+    LUT3D lut = LUT3D::log2(65, -12.0f, 8.0f);
+    lut.bake(tonemap);
+
+    // Black is encoded by the first entry.
+    EXPECT_RGB_EQ(tonemap(RGB::black()), lut.get_entry(0, 0, 0));
+    EXPECT_RGB_EQ(tonemap(RGB::black()), lut.apply(RGB::black()));
+
+    for (RGB color : create_test_colors(1000, 16.0f)) {
+        RGB expected = tonemap(color);
+        EXPECT_RGB_EQ_EPS(expected, lut.apply(color, Interpolation::Trilinear), 0.005f);
+        EXPECT_RGB_EQ_EPS(expected, lut.apply(color, Interpolation::Tetrahedral), 0.005f);
+    }
+}
+
+GTEST_TEST(ImageOperations_ColorLUT, batched_apply_matches_single_apply) {
+    LUT3D lut = LUT3D::log2(17, -8.0f, 4.0f);
+    lut.bake([](RGB color) { return CameraEffects::uncharted2(color, CameraEffects::Uncharted2Settings::default()); });
+
+    std::vector<RGB> colors = create_test_colors(10007, 8.0f);
+    std::vector<RGB> results(colors.size());
+    for (Interpolation interpolation : { Interpolation::Trilinear, Interpolation::Tetrahedral }) {
+        lut.apply(colors.data(), results.data(), int(colors.size()), interpolation);
+        for (int i = 0; i < int(colors.size()); ++i)
+            EXPECT_EQ(lut.apply(colors[i], interpolation), results[i]);
+    }
+}
+
+GTEST_TEST(ImageOperations_ColorLUT, cube_round_trip) {
+    std::string path = (std::filesystem::temp_directory_path() / "bifrost_color_lut_test.cube").string();
+
+    LUT3D lut = LUT3D::log2(9, -6.0f, 3.0f);
+    lut.bake([](RGB color) { return CameraEffects::unreal4(color); });
+    EXPECT_TRUE(write_cube(lut, path, "Test LUT"));
+
+    LUT3D read_lut = read_cube(path);
+    ASSERT_TRUE(read_lut.is_valid());
+    EXPECT_EQ(LUT3D::Encoding::Log2, read_lut.get_encoding());
+    EXPECT_EQ(-6.0f, read_lut.get_min_log2());
+    EXPECT_EQ(3.0f, read_lut.get_max_log2());
+    for (int b = 0; b < 9; ++b)
+        for (int g = 0; g < 9; ++g)
+            for (int r = 0; r < 9; ++r)
+                EXPECT_EQ(lut.get_entry(r, g, b), read_lut.get_entry(r, g, b));
+
+    std::filesystem::remove(path);
+}
+
+GTEST_TEST(ImageOperations_ColorLUT, read_cube) {
+    std::string path = (std::filesystem::temp_directory_path() / "bifrost_color_lut_read_test.cube").string();
+    {
+        std::ofstream file(path);
+        file << "# Swaps red and blue.\n"
+                "TITLE \"Swap\"\n"
+                "LUT_3D_SIZE 2\n"
+                "DOMAIN_MIN 0 0 0\n"
+                "DOMAIN_MAX 2 2 2\n"
+                "\n"
+                "0 0 0\n" "0 0 2\n" "0 2 0\n" "0 2 2\n"
+                "2 0 0\n" "2 0 2\n" "2 2 0\n" "2 2 2\n";
+    }
+
+    LUT3D lut = read_cube(path);
+    ASSERT_TRUE(lut.is_valid());
+    EXPECT_EQ(LUT3D::Encoding::Linear, lut.get_encoding());
+    EXPECT_EQ(2, lut.get_resolution());
+    EXPECT_RGB_EQ(RGB(2.0f), lut.get_domain_max());
+    EXPECT_RGB_EQ_EPS(RGB(0.25f, 0.5f, 1.5f), lut.apply(RGB(1.5f, 0.5f, 0.25f)), 0.00001f);
+
+    std::filesystem::remove(path);
+
+    EXPECT_FALSE(read_cube(path).is_valid());
+}
+
+} // NS ColorLUT
+} // NS ImageOperations
+
+#endif // _IMAGE_OPERATIONS_COLOR_LUT_TEST_H_
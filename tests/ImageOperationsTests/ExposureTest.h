@@ -0,0 +1,126 @@
+// Test exposure operations.
+// ---------------------------------------------------------------------------
+// Copyright (C) Bifrost. See AUTHORS.txt for authors.
+//
+// This program is open source and distributed under the New BSD License.
+// See LICENSE.txt for more detail.
+// ---------------------------------------------------------------------------
+
+#ifndef _IMAGE_OPERATIONS_EXPOSURE_TEST_H_
+#define _IMAGE_OPERATIONS_EXPOSURE_TEST_H_
+
+#include <ImageOperations/Exposure.h>
+
+#include <Bifrost/Core/Parallel.h>
+
+#include <../BifrostTests/Expects.h>
+
+#include <array>
+
+namespace ImageOperations {
+namespace Exposure {
+
+using namespace Bifrost::Assets;
+using namespace Bifrost::Math;
+
+class ImageOperations_Exposure : public ::testing::Test {
+protected:
+    // Per-test set-up and tear-down logic.
+    virtual void SetUp() {
+        Images::allocate(2u);
+    }
+    virtual void TearDown() {
+        Images::deallocate();
+    }
+
+    static Image create_image(PixelFormat format, float gamma, int width, int height) {
+        Image image = Images::create2D("img", format, gamma, Vector2ui(width, height));
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x) {
+                float scale = format == PixelFormat::RGB24 || format == PixelFormat::RGBA32 ? 1.0f : 16.0f;
+                RGB pixel = RGB(float(x % 17) / 16.0f, float(y % 5) / 4.0f, float((x * y) % 11) / 10.0f) * scale;
+                image.set_pixel(RGBA(pixel, 1.0f), Vector2ui(x, y));
+            }
+        return image;
+    }
+
+    static double reference_summed_log_luminance(Image image) {
+        double summed_log_luminance = 0.0;
+        image.iterate_pixels([&](RGBA pixel) { summed_log_luminance += log2(fmax(luminance(pixel.rgb()), 0.0001)); });
+        return summed_log_luminance;
+    }
+};
+
+TEST_F(ImageOperations_Exposure, fast_log2_error_is_bounded) {
+    for (float x = 1e-6f; x < 1e6f; x *= 1.001f) {
+        double exact_log2 = log2(double(x));
+        double max_error = 2e-7 * fmax(1.0, abs(exact_log2));
+        EXPECT_LE(abs(fast_log2(x) - exact_log2), max_error) << "x: " << x;
+    }
+}
+
+TEST_F(ImageOperations_Exposure, summed_log_luminance) {
+    PixelFormat formats[] = { PixelFormat::RGB_Float, PixelFormat::RGBA_Float, PixelFormat::RGB24, PixelFormat::RGBA32 };
+    for (PixelFormat format : formats) {
+        float gamma = format == PixelFormat::RGB24 || format == PixelFormat::RGBA32 ? 2.2f : 1.0f;
+        Image image = create_image(format, gamma, 211, 97);
+
+        double reference = reference_summed_log_luminance(image);
+        double max_error = 1e-6 * image.get_pixel_count();
+        EXPECT_DOUBLE_EQ_EPS(reference, summed_log_luminance(image.get_ID()), max_error);
+
+        float reference_log_average = float(exp2(reference / image.get_pixel_count()));
+        EXPECT_FLOAT_EQ_EPS(reference_log_average, log_average_luminance(image.get_ID()), 0.0001f);
+
+        Images::destroy(image.get_ID());
+    }
+}
+
+TEST_F(ImageOperations_Exposure, log_luminance_histogram) {
+    Image image = create_image(PixelFormat::RGB_Float, 1.0f, 211, 97);
+    const float min_log_luminance = -4.0f, max_log_luminance = 4.0f;
+    const int bin_count = 32;
+
+    std::vector<unsigned int> reference_histogram = std::vector<unsigned int>(bin_count, 0u);
+    image.iterate_pixels([&](RGBA pixel) {
+        float log_luminance = log2(fmaxf(luminance(pixel.rgb()), 0.0001f));
+        float normalized_index = inverse_lerp(min_log_luminance, max_log_luminance, log_luminance);
+        ++reference_histogram[clamp(int(normalized_index * bin_count), 0, bin_count - 1)];
+    });
+
+    std::vector<unsigned int> histogram = log_luminance_histogram(image.get_ID(), min_log_luminance, max_log_luminance, bin_count);
+    unsigned int total_count = 0;
+    for (int b = 0; b < bin_count; ++b) {
+        EXPECT_EQ(reference_histogram[b], histogram[b]);
+        total_count += histogram[b];
+    }
+    EXPECT_EQ(image.get_pixel_count(), total_count);
+
+    // The iterator version adds to the existing bins.
+    std::array<unsigned int, bin_count> summed_histogram;
+    summed_histogram.fill(1u);
+    log_luminance_histogram(image.get_ID(), min_log_luminance, max_log_luminance, summed_histogram.begin(), summed_histogram.end());
+    for (int b = 0; b < bin_count; ++b)
+        EXPECT_EQ(histogram[b] + 1u, summed_histogram[b]);
+}
+
+TEST_F(ImageOperations_Exposure, results_are_independent_of_thread_count) {
+    Image image = create_image(PixelFormat::RGBA_Float, 1.0f, 512, 300);
+
+    Bifrost::Core::Parallel::set_thread_count(1);
+    float single_threaded_sum = summed_log_luminance(image.get_ID());
+    auto single_threaded_histogram = log_luminance_histogram(image.get_ID(), -4.0f, 4.0f, 64);
+
+    Bifrost::Core::Parallel::set_thread_count(4);
+    float multi_threaded_sum = summed_log_luminance(image.get_ID());
+    auto multi_threaded_histogram = log_luminance_histogram(image.get_ID(), -4.0f, 4.0f, 64);
+    Bifrost::Core::Parallel::set_thread_count(0);
+
+    EXPECT_EQ(single_threaded_sum, multi_threaded_sum);
+    EXPECT_EQ(single_threaded_histogram, multi_threaded_histogram);
+}
+
+} // NS Exposure
+} // NS ImageOperations
+
+#endif // _IMAGE_OPERATIONS_EXPOSURE_TEST_H_
@@ -9,7 +9,10 @@
 #include <gtest/gtest.h>
 
 #include <BlurTest.h>
+#include <CameraEffectsTest.h>
+#include <ColorLUTTest.h>
 #include <CompareTest.h>
+#include <ExposureTest.h>
 #include <StatisticsTest.h>
 
 int main(int argc, char** argv) {